@@ -70,6 +70,12 @@ namespace ViconCGStream
       }
     }
 
+    // Returns true if a filter has been set for an item type, even one that lets nothing through
+    bool IsFiltered( ViconCGStreamType::Enum i_Type ) const
+    {
+      return m_FilterMap.find( i_Type ) != m_FilterMap.end();
+    }
+
     // Reset the filter to empty
     void ClearAll()
     {
@@ -0,0 +1,334 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+/// \file
+/// Contains the declaration of the ViconCGStream::VGreyscaleBlobsPacked class.
+
+#include "Item.h"
+#include <cstddef>
+#include <vector>
+
+namespace ViconCGStream
+{
+//-------------------------------------------------------------------------------------------------
+
+/// Contains a frame of greyscale blobs, read from the same stream block as VGreyscaleBlobs or VGreyscaleSubsampledBlobs.
+/// Rather than a vector per blob and per line, every line of the frame is held in one array and every pixel in another,
+/// so reading a frame makes three allocations however many blobs it has.
+class VGreyscaleBlobsPacked : public VItem
+{
+public:
+
+  /// A read-only view of a run of values held by the blobs.
+  /// Valid for as long as the blobs it was taken from.
+  template< typename T >
+  class VSpan
+  {
+  public:
+    VSpan()
+    : m_pBegin( nullptr )
+    , m_Size( 0 )
+    {
+    }
+
+    VSpan( const T * i_pBegin, std::size_t i_Size )
+    : m_pBegin( i_pBegin )
+    , m_Size( i_Size )
+    {
+    }
+
+    const T * data() const { return m_pBegin; }
+    const T * begin() const { return m_pBegin; }
+    const T * end() const { return m_pBegin + m_Size; }
+    std::size_t size() const { return m_Size; }
+    bool empty() const { return m_Size == 0; }
+    const T & operator[]( std::size_t i_Index ) const { return m_pBegin[ i_Index ]; }
+
+  private:
+    const T * m_pBegin;
+    std::size_t m_Size;
+  };
+
+  /// A line of a blob. Its greyscale values are m_PixelCount values of m_Pixels, starting at m_PixelOffset.
+  class VLine
+  {
+  public:
+    /// Offset of the first greyscale value in m_Pixels
+    ViconCGStreamType::UInt32 m_PixelOffset;
+
+    /// Number of greyscale values
+    ViconCGStreamType::UInt32 m_PixelCount;
+
+    /// 2D position
+    ViconCGStreamType::Int16 m_Position[ 2 ];
+  };
+
+  /// Constructor. i_bSubsampled selects the VGreyscaleSubsampledBlobs stream format.
+  explicit VGreyscaleBlobsPacked( bool i_bSubsampled = false )
+  : m_bSubsampled( i_bSubsampled )
+  , m_FrameID( 0 )
+  , m_CameraID( 0 )
+  , m_BlobLines( 1, 0 )
+  {
+  }
+
+  /// True if read from, and written as, a VGreyscaleSubsampledBlobs block
+  bool m_bSubsampled;
+
+  /// Camera frame number
+  ViconCGStreamType::UInt32 m_FrameID;
+
+  /// Camera identifier
+  ViconCGStreamType::UInt32 m_CameraID;
+
+  /// Double the Offset in X
+  ViconCGStreamType::UInt16 m_TwiceOffsetX = 0;
+  /// Double the offset in Y
+  ViconCGStreamType::UInt16 m_TwiceOffsetY = 0;
+  /// Image pixels per sensor pixel in the X axis (horizontally)
+  ViconCGStreamType::UInt8 m_SensorPixelsPerImagePixelX = 1;
+  /// Image pixels per sensor pixel in the Y axis (vertically)
+  ViconCGStreamType::UInt8 m_SensorPixelsPerImagePixelY = 1;
+
+  /// Index into m_Lines of the first line of each blob, followed by the total number of lines
+  std::vector< ViconCGStreamType::UInt32 > m_BlobLines;
+
+  /// Lines of every blob, in blob order
+  std::vector< VLine > m_Lines;
+
+  /// Greyscale values of every line, in line order
+  std::vector< ViconCGStreamType::UInt8 > m_Pixels;
+
+  /// Number of blobs
+  std::size_t BlobCount() const
+  {
+    return m_BlobLines.size() - 1;
+  }
+
+  /// Lines of a blob
+  VSpan< VLine > BlobLines( std::size_t i_Blob ) const
+  {
+    const ViconCGStreamType::UInt32 Begin = m_BlobLines[ i_Blob ];
+    return VSpan< VLine >( m_Lines.data() + Begin, m_BlobLines[ i_Blob + 1 ] - Begin );
+  }
+
+  /// Greyscale values of a line
+  VSpan< ViconCGStreamType::UInt8 > LinePixels( const VLine & i_rLine ) const
+  {
+    return VSpan< ViconCGStreamType::UInt8 >( m_Pixels.data() + i_rLine.m_PixelOffset, i_rLine.m_PixelCount );
+  }
+
+  /// Equality operator
+  bool operator == ( const VGreyscaleBlobsPacked & i_rOther ) const
+  {
+    if( m_bSubsampled != i_rOther.m_bSubsampled ||
+        m_FrameID != i_rOther.m_FrameID ||
+        m_CameraID != i_rOther.m_CameraID ||
+        m_TwiceOffsetX != i_rOther.m_TwiceOffsetX ||
+        m_TwiceOffsetY != i_rOther.m_TwiceOffsetY ||
+        m_SensorPixelsPerImagePixelX != i_rOther.m_SensorPixelsPerImagePixelX ||
+        m_SensorPixelsPerImagePixelY != i_rOther.m_SensorPixelsPerImagePixelY ||
+        m_BlobLines != i_rOther.m_BlobLines ||
+        m_Pixels != i_rOther.m_Pixels )
+    {
+      return false;
+    }
+
+    // Pixels are packed in line order, so equal pixel arrays leave only the counts and positions to compare
+    for( std::size_t Line = 0; Line != m_Lines.size(); ++Line )
+    {
+      const VLine & rLine = m_Lines[ Line ];
+      const VLine & rOtherLine = i_rOther.m_Lines[ Line ];
+      if( rLine.m_PixelCount != rOtherLine.m_PixelCount ||
+          rLine.m_Position[ 0 ] != rOtherLine.m_Position[ 0 ] ||
+          rLine.m_Position[ 1 ] != rOtherLine.m_Position[ 1 ] )
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Object type enum.
+  virtual ViconCGStreamType::Enum TypeID() const
+  {
+    return m_bSubsampled ? ViconCGStreamEnum::GreyscaleSubsampledBlobs : ViconCGStreamEnum::GreyscaleBlobs;
+  }
+
+  /// Filter ID
+  virtual ViconCGStreamType::UInt32 FilterID() const
+  {
+    return m_CameraID;
+  }
+
+  /// Read function.
+  virtual bool Read( const ViconCGStreamIO::VBuffer & i_rBuffer )
+  {
+    if( !i_rBuffer.Read( m_FrameID ) || !i_rBuffer.Read( m_CameraID ) )
+    {
+      return false;
+    }
+
+    if( m_bSubsampled )
+    {
+      if( !i_rBuffer.Read( m_TwiceOffsetX ) ||
+          !i_rBuffer.Read( m_TwiceOffsetY ) ||
+          !i_rBuffer.Read( m_SensorPixelsPerImagePixelX ) ||
+          !i_rBuffer.Read( m_SensorPixelsPerImagePixelY ) )
+      {
+        return false;
+      }
+    }
+
+    // Walk the blobs once to size the arrays, then again to fill them
+    const unsigned int Start = i_rBuffer.Offset();
+    std::size_t NumLines = 0;
+    std::size_t NumPixels = 0;
+    if( !ReadBlobs( i_rBuffer, nullptr, NumLines, NumPixels ) )
+    {
+      return false;
+    }
+
+    const unsigned int End = i_rBuffer.Offset();
+    i_rBuffer.SetOffset( Start );
+
+    m_BlobLines.clear();
+    m_Lines.clear();
+    m_Pixels.clear();
+    m_Lines.reserve( NumLines );
+    m_Pixels.reserve( NumPixels );
+    const bool bOk = ReadBlobs( i_rBuffer, this, NumLines, NumPixels );
+
+    i_rBuffer.SetOffset( End );
+    return bOk;
+  }
+
+  /// Write function.
+  virtual void Write( ViconCGStreamIO::VBuffer & i_rBuffer ) const
+  {
+    i_rBuffer.Write( m_FrameID );
+    i_rBuffer.Write( m_CameraID );
+    if( m_bSubsampled )
+    {
+      i_rBuffer.Write( m_TwiceOffsetX );
+      i_rBuffer.Write( m_TwiceOffsetY );
+      i_rBuffer.Write( m_SensorPixelsPerImagePixelX );
+      i_rBuffer.Write( m_SensorPixelsPerImagePixelY );
+    }
+
+    const std::size_t NumBlobs = BlobCount();
+    i_rBuffer.Write( static_cast< ViconCGStreamType::UInt32 >( NumBlobs ) );
+    for( std::size_t Blob = 0; Blob != NumBlobs; ++Blob )
+    {
+      const VSpan< VLine > Lines = BlobLines( Blob );
+      i_rBuffer.Write( static_cast< ViconCGStreamType::UInt32 >( Lines.size() ) );
+      for( const VLine & rLine : Lines )
+      {
+        i_rBuffer.Write( rLine.m_PixelCount );
+        i_rBuffer.BufferImpl().WritePodArray( m_Pixels.data() + rLine.m_PixelOffset, rLine.m_PixelCount );
+        i_rBuffer.Write( rLine.m_Position );
+      }
+    }
+  }
+
+private:
+
+  // Read blobs in the stream format of std::vector< ViconCGStreamDetail::VGreyscaleBlobs_GreyscaleBlob >.
+  // Without o_pBlobs, only counts the lines and pixels, checking that every line lies within the buffer.
+  static bool ReadBlobs( const ViconCGStreamIO::VBuffer & i_rBuffer, VGreyscaleBlobsPacked * o_pBlobs, std::size_t & io_rNumLines, std::size_t & io_rNumPixels )
+  {
+    ViconCGStreamType::UInt32 NumBlobs = 0;
+    if( !i_rBuffer.Read( NumBlobs ) )
+    {
+      return false;
+    }
+
+    if( o_pBlobs )
+    {
+      o_pBlobs->m_BlobLines.reserve( NumBlobs + 1 );
+      o_pBlobs->m_BlobLines.push_back( 0 );
+    }
+
+    for( ViconCGStreamType::UInt32 Blob = 0; Blob != NumBlobs; ++Blob )
+    {
+      ViconCGStreamType::UInt32 NumLines = 0;
+      if( !i_rBuffer.Read( NumLines ) )
+      {
+        return false;
+      }
+
+      for( ViconCGStreamType::UInt32 Line = 0; Line != NumLines; ++Line )
+      {
+        ViconCGStreamType::UInt32 NumPixels = 0;
+        if( !i_rBuffer.Read( NumPixels ) )
+        {
+          return false;
+        }
+
+        const unsigned int Offset = i_rBuffer.Offset();
+        if( static_cast< std::size_t >( Offset ) + NumPixels > i_rBuffer.Length() )
+        {
+          return false;
+        }
+        i_rBuffer.SetOffset( Offset + NumPixels );
+
+        ViconCGStreamType::Int16 Position[ 2 ];
+        if( !i_rBuffer.Read( Position ) )
+        {
+          return false;
+        }
+
+        if( o_pBlobs )
+        {
+          VLine NewLine;
+          NewLine.m_PixelOffset = static_cast< ViconCGStreamType::UInt32 >( o_pBlobs->m_Pixels.size() );
+          NewLine.m_PixelCount = NumPixels;
+          NewLine.m_Position[ 0 ] = Position[ 0 ];
+          NewLine.m_Position[ 1 ] = Position[ 1 ];
+          o_pBlobs->m_Lines.push_back( NewLine );
+
+          const unsigned char * pPixels = i_rBuffer.Raw() + Offset;
+          o_pBlobs->m_Pixels.insert( o_pBlobs->m_Pixels.end(), pPixels, pPixels + NumPixels );
+        }
+        else
+        {
+          ++io_rNumLines;
+          io_rNumPixels += NumPixels;
+        }
+      }
+
+      if( o_pBlobs )
+      {
+        o_pBlobs->m_BlobLines.push_back( static_cast< ViconCGStreamType::UInt32 >( o_pBlobs->m_Lines.size() ) );
+      }
+    }
+
+    return true;
+  }
+};
+
+//-------------------------------------------------------------------------------------------------
+};
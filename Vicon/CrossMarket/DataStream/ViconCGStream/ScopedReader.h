@@ -26,6 +26,7 @@
 
 #include <StreamCommon/Buffer.h>
 #include "Enum.h"
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -89,12 +90,36 @@ public:
     return m_Enum;
   }
 
+  /// Get the length of the block body, as given in the block header.
+  ViconCGStreamType::UInt32 Length() const
+  {
+    return m_End - m_Start;
+  }
+
   /// Read a single item from the buffer.
   bool Read( ViconCGStream::VItem & o_rItem ) const
   {
     return m_rBuffer.Read( o_rItem );
   }
 
+  /// Copy the body of the block into a separate buffer.
+  /// This allows the block to be read after the underlying buffer has been refilled.
+  bool Copy( VBuffer & o_rBuffer ) const
+  {
+    if( m_End < m_Start || m_rBuffer.Length() < m_End )
+    {
+      return false;
+    }
+
+    o_rBuffer.Clear();
+    o_rBuffer.SetLength( m_End - m_Start );
+    if( m_End != m_Start )
+    {
+      std::memcpy( o_rBuffer.Raw(), m_rBuffer.Raw() + m_Start, m_End - m_Start );
+    }
+    return true;
+  }
+
 private:
   VBuffer&                  m_rBuffer;
   ViconCGStreamType::Enum   m_Enum;
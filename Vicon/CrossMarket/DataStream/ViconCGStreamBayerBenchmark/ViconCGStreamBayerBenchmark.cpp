@@ -0,0 +1,170 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include <ViconCGStreamClient/ViconCGStreamBayer.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+  typedef std::chrono::steady_clock hrc;
+
+  struct VResolution
+  {
+    const char * m_pCamera;
+    unsigned int m_Width;
+    unsigned int m_Height;
+  };
+
+  // Video resolutions of the cameras that stream Bayer video
+  const VResolution s_Resolutions[] =
+  {
+    { "Bonita Video", 640, 480 },
+    { "Vero v1.3", 1280, 1024 },
+    { "Vue", 1920, 1080 },
+    { "Vero v2.2", 2048, 1088 },
+  };
+
+  typedef void ( *TConversion )( unsigned int, unsigned int, const unsigned char *, unsigned char *, VViconCGStreamBayer::EInstructionSet );
+
+  struct VPattern
+  {
+    const char * m_pName;
+    TConversion m_Conversion;
+  };
+
+  const VPattern s_Patterns[] =
+  {
+    { "GB8", &VViconCGStreamBayer::BayerGBToBGR },
+    { "BG8", &VViconCGStreamBayer::BayerBGToBGR },
+    { "RG8", &VViconCGStreamBayer::BayerRGToBGR },
+  };
+
+  const char * InstructionSetName( VViconCGStreamBayer::EInstructionSet i_InstructionSet )
+  {
+    switch( i_InstructionSet )
+    {
+    case VViconCGStreamBayer::EAVX2:  return "AVX2";
+    case VViconCGStreamBayer::ESSSE3: return "SSSE3";
+    default:                          return "Portable";
+    }
+  }
+
+  // Median time of one conversion, in milliseconds
+  double Time( const VPattern & i_rPattern, VViconCGStreamBayer::EInstructionSet i_InstructionSet, unsigned int i_Width, unsigned int i_Height,
+               const std::vector< unsigned char > & i_rBayer, std::vector< unsigned char > & o_rBGR, unsigned int i_Repeats )
+  {
+    std::vector< double > Durations;
+    Durations.reserve( i_Repeats );
+    for( unsigned int Repeat = 0; Repeat < i_Repeats; ++Repeat )
+    {
+      const hrc::time_point Start = hrc::now();
+      i_rPattern.m_Conversion( i_Width, i_Height, i_rBayer.data(), o_rBGR.data(), i_InstructionSet );
+      Durations.push_back( std::chrono::duration< double, std::milli >( hrc::now() - Start ).count() );
+    }
+
+    std::sort( Durations.begin(), Durations.end() );
+    return Durations[ Durations.size() / 2 ];
+  }
+}
+
+int main( int argc, char* argv[] )
+{
+  std::cout << "CGStream Bayer Benchmark" << std::endl;
+
+  unsigned int Repeats = 50;
+
+  for( int a = 1; a < argc; ++a )
+  {
+    std::string arg = argv[a];
+    try
+    {
+      if( arg == "--help" )
+      {
+        std::cout << argv[0] << ": allowed options include:\n --repeats <n>" << std::endl;
+        return 0;
+      }
+      else if( arg == "--repeats" && a + 1 < argc )
+      {
+        Repeats = std::max( boost::lexical_cast< unsigned int >( argv[++a] ), 1u );
+      }
+    }
+    catch( boost::bad_lexical_cast & e )
+    {
+      std::cerr << arg << ": " << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  const VViconCGStreamBayer::EInstructionSet Supported = VViconCGStreamBayer::SupportedInstructionSet();
+  std::cout << "Best supported kernel: " << InstructionSetName( Supported ) << ", repeats: " << Repeats << std::endl;
+  std::cout << "Times are the median for one frame, in milliseconds; output is checked against the portable kernel" << std::endl << std::endl;
+  std::cout << std::setw( 14 ) << "Camera" << std::setw( 12 ) << "Size" << std::setw( 9 ) << "Pattern" << std::setw( 10 ) << "Kernel"
+            << std::setw( 10 ) << "Time" << std::setw( 12 ) << "MPixel/s" << std::setw( 10 ) << "Speedup" << std::setw( 8 ) << "Exact" << std::endl;
+
+  std::mt19937 Random( 1 );
+  bool bAllExact = true;
+
+  std::cout << std::fixed << std::setprecision( 2 );
+  for( const VResolution & rResolution : s_Resolutions )
+  {
+    const unsigned int Width = rResolution.m_Width;
+    const unsigned int Height = rResolution.m_Height;
+
+    std::vector< unsigned char > Bayer( Width * Height );
+    std::generate( Bayer.begin(), Bayer.end(), [&Random](){ return static_cast< unsigned char >( Random() ); } );
+
+    std::vector< unsigned char > Reference( Width * Height * 3 );
+    std::vector< unsigned char > BGR( Width * Height * 3 );
+
+    for( const VPattern & rPattern : s_Patterns )
+    {
+      const double PortableTime = Time( rPattern, VViconCGStreamBayer::EPortable, Width, Height, Bayer, Reference, Repeats );
+
+      for( int Set = VViconCGStreamBayer::EPortable; Set <= Supported; ++Set )
+      {
+        const VViconCGStreamBayer::EInstructionSet InstructionSet = static_cast< VViconCGStreamBayer::EInstructionSet >( Set );
+        const double FrameTime = InstructionSet == VViconCGStreamBayer::EPortable ? PortableTime : Time( rPattern, InstructionSet, Width, Height, Bayer, BGR, Repeats );
+        const bool bExact = InstructionSet == VViconCGStreamBayer::EPortable || BGR == Reference;
+        bAllExact = bAllExact && bExact;
+
+        std::cout << std::setw( 14 ) << rResolution.m_pCamera
+                  << std::setw( 12 ) << ( std::to_string( Width ) + "x" + std::to_string( Height ) )
+                  << std::setw( 9 ) << rPattern.m_pName << std::setw( 10 ) << InstructionSetName( InstructionSet )
+                  << std::setw( 10 ) << FrameTime << std::setw( 12 ) << Width * Height / ( FrameTime * 1000.0 )
+                  << std::setw( 10 ) << PortableTime / FrameTime << std::setw( 8 ) << ( bExact ? "yes" : "NO" ) << std::endl;
+      }
+    }
+  }
+
+  return bAllExact ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <StreamCommon/Type.h>
+
+#include <boost/thread/mutex.hpp>
+
+#include <vector>
+
+// Recycles the large byte buffers used for video payloads, so that a steady stream of
+// frames does not allocate and fault in several megabytes of fresh memory per camera per frame.
+// Buffers are kept in buckets by the power of two below their capacity, so that finding one of the right size is cheap
+// and cameras of different resolutions do not keep taking each other's buffers.
+class VCGStreamBufferPool
+{
+public:
+  typedef std::vector< ViconCGStreamType::UInt8 > TBuffer;
+
+  explicit VCGStreamBufferPool( size_t i_MaxBuffersPerBucket = 16 )
+  : m_MaxBuffersPerBucket( i_MaxBuffersPerBucket )
+  {
+  }
+
+  // Replace o_rBuffer with an empty buffer from the pool, preferring the smallest one with at least i_MinCapacity bytes reserved.
+  // If the size needed is not known, pass zero to take the largest. o_rBuffer is left untouched if the pool is empty.
+  void Take( TBuffer & o_rBuffer, size_t i_MinCapacity = 0 )
+  {
+    boost::mutex::scoped_lock Lock( m_Mutex );
+
+    TBuffer* pBest = nullptr;
+    std::vector< TBuffer >* pBestBucket = nullptr;
+    if( i_MinCapacity != 0 )
+    {
+      // Buffers in the first bucket may be a little too small; any in a later bucket are large enough
+      for( size_t Bucket = BucketOf( i_MinCapacity ); !pBest && Bucket != BucketCount; ++Bucket )
+      {
+        for( TBuffer & rBuffer : m_Buckets[ Bucket ] )
+        {
+          if( rBuffer.capacity() >= i_MinCapacity && ( !pBest || rBuffer.capacity() < pBest->capacity() ) )
+          {
+            pBest = &rBuffer;
+            pBestBucket = &m_Buckets[ Bucket ];
+          }
+        }
+      }
+    }
+
+    // Nothing large enough; take the largest, so that it grows as little as possible
+    for( size_t Bucket = BucketCount; !pBest && Bucket != 0; --Bucket )
+    {
+      for( TBuffer & rBuffer : m_Buckets[ Bucket - 1 ] )
+      {
+        if( !pBest || rBuffer.capacity() > pBest->capacity() )
+        {
+          pBest = &rBuffer;
+          pBestBucket = &m_Buckets[ Bucket - 1 ];
+        }
+      }
+    }
+
+    if( !pBest )
+    {
+      return;
+    }
+
+    o_rBuffer.swap( *pBest );
+    o_rBuffer.clear();
+    pBest->swap( pBestBucket->back() );
+    pBestBucket->pop_back();
+  }
+
+  // Return a buffer to the pool. The contents are discarded; the allocation is kept unless its bucket is full.
+  void Give( TBuffer && i_rBuffer )
+  {
+    if( i_rBuffer.capacity() == 0 )
+    {
+      return;
+    }
+
+    TBuffer Buffer( std::move( i_rBuffer ) );
+    boost::mutex::scoped_lock Lock( m_Mutex );
+    std::vector< TBuffer > & rBucket = m_Buckets[ BucketOf( Buffer.capacity() ) ];
+    if( rBucket.size() < m_MaxBuffersPerBucket )
+    {
+      rBucket.push_back( std::move( Buffer ) );
+    }
+  }
+
+  void Clear()
+  {
+    boost::mutex::scoped_lock Lock( m_Mutex );
+    for( std::vector< TBuffer > & rBucket : m_Buckets )
+    {
+      rBucket.clear();
+    }
+  }
+
+private:
+  static const size_t BucketCount = sizeof( size_t ) * 8;
+
+  static size_t BucketOf( size_t i_Capacity )
+  {
+    size_t Bucket = 0;
+    while( i_Capacity >>= 1 )
+    {
+      ++Bucket;
+    }
+    return Bucket;
+  }
+
+  const size_t m_MaxBuffersPerBucket;
+  boost::mutex m_Mutex;
+  std::vector< TBuffer > m_Buckets[ BucketCount ];
+};
@@ -0,0 +1,114 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <boost/asio/io_service.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Pool of worker threads used to decode heavy stream objects off the socket thread.
+// Work is not guaranteed to complete in the order in which it was posted.
+class VCGStreamDecodePool
+{
+public:
+  VCGStreamDecodePool()
+  : m_ThreadCount( 0 )
+  {
+  }
+
+  ~VCGStreamDecodePool()
+  {
+    StopService();
+  }
+
+  void Post( const std::function< void() >& i_rFunction ) const
+  {
+    m_pService->post( i_rFunction );
+  }
+
+  bool StartService( unsigned int i_ThreadCount )
+  {
+    boost::mutex::scoped_lock Lock( m_Mutex );
+    if( m_pWork || i_ThreadCount == 0 )
+    {
+      return false;
+    }
+
+    if( !m_pService )
+    {
+      m_pService = std::make_shared< boost::asio::io_service >();
+    }
+
+    m_pWork = std::make_shared< boost::asio::io_service::work >( *m_pService );
+    for( unsigned int Thread = 0; Thread < i_ThreadCount; ++Thread )
+    {
+      m_Threads.push_back( std::make_shared< boost::thread >( std::bind( &VCGStreamDecodePool::ThreadFunction, this ) ) );
+    }
+    m_ThreadCount = i_ThreadCount;
+
+    return true;
+  }
+
+  // Outstanding work is completed before the threads exit.
+  bool StopService()
+  {
+    boost::mutex::scoped_lock Lock( m_Mutex );
+    if( m_pWork )
+    {
+      m_pWork.reset();
+      for( const auto& rpThread : m_Threads )
+      {
+        rpThread->join();
+      }
+      m_Threads.clear();
+      m_pService->reset();
+      m_ThreadCount = 0;
+      return true;
+    }
+    return false;
+  }
+
+  unsigned int ThreadCount() const
+  {
+    boost::mutex::scoped_lock Lock( m_Mutex );
+    return m_ThreadCount;
+  }
+
+  void ThreadFunction()
+  {
+    m_pService->run();
+  }
+
+private:
+  mutable boost::mutex m_Mutex;
+  std::shared_ptr< boost::asio::io_service > m_pService;
+  std::shared_ptr< boost::asio::io_service::work > m_pWork;
+  std::vector< std::shared_ptr< boost::thread > > m_Threads;
+  unsigned int m_ThreadCount;
+};
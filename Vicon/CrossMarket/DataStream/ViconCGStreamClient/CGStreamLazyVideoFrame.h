@@ -0,0 +1,83 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <ViconCGStream/VideoFrame.h>
+
+#include <boost/thread/mutex.hpp>
+
+#include <functional>
+#include <memory>
+
+// A video frame which keeps its data as it was received, and is only decoded the first time someone asks for it.
+// The decoded frame is kept and shared by every later caller; this frame itself is never modified, so it may still be
+// read from other threads while it is being decoded.
+class VCGStreamLazyVideoFrame : public ViconCGStream::VVideoFrame
+{
+public:
+  // Returns the decoded frame, or null if it cannot be decoded
+  typedef std::function< std::shared_ptr< const ViconCGStream::VVideoFrame >( const ViconCGStream::VVideoFrame& i_rFrame ) > TDecoder;
+
+  explicit VCGStreamLazyVideoFrame( const TDecoder& i_rDecoder )
+  : m_Decoder( i_rDecoder )
+  , m_bDecoded( false )
+  {
+  }
+
+  // The decoded frame, or null if this frame cannot be decoded
+  std::shared_ptr< const ViconCGStream::VVideoFrame > Decoded() const
+  {
+    boost::mutex::scoped_lock Lock( m_Mutex );
+    if( !m_bDecoded )
+    {
+      m_bDecoded = true;
+      if( m_Decoder )
+      {
+        m_pDecoded = m_Decoder( *this );
+      }
+    }
+    return m_pDecoded;
+  }
+
+  // A frame from the stream, decoded if it is a lazy one
+  static std::shared_ptr< const ViconCGStream::VVideoFrame > Resolve( const std::shared_ptr< const ViconCGStream::VVideoFrame >& i_pFrame )
+  {
+    const VCGStreamLazyVideoFrame* pLazyFrame = dynamic_cast< const VCGStreamLazyVideoFrame* >( i_pFrame.get() );
+    if( !pLazyFrame )
+    {
+      return i_pFrame;
+    }
+
+    std::shared_ptr< const ViconCGStream::VVideoFrame > pDecoded = pLazyFrame->Decoded();
+    return pDecoded ? pDecoded : i_pFrame;
+  }
+
+private:
+  TDecoder m_Decoder;
+
+  mutable boost::mutex m_Mutex;
+  mutable bool m_bDecoded;
+  mutable std::shared_ptr< const ViconCGStream::VVideoFrame > m_pDecoded;
+};
@@ -24,58 +24,293 @@
 //////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
-#include <boost/asio/io_service.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <thread>
+#include <utility>
 
-class VCGStreamPostalService
+// Snapshot of a post box's traffic
+struct VCGStreamPostalCounters
+{
+  uint64_t m_Posted;  // Items accepted
+  uint64_t m_Dropped; // Items discarded because the box was full or closed
+  uint64_t m_Waited;  // Items accepted only after waiting for space
+};
+
+// Bounded multi-producer ring of preallocated slots. Posting copies or moves an item into a free slot and never
+// allocates; what happens when the ring is full is decided by the box's policy. Items are taken out by a single
+// consumer at a time.
+template< typename TItem, size_t t_Capacity = 1024 >
+class VCGStreamPostBox
 {
+  static_assert( t_Capacity >= 2 && ( t_Capacity & ( t_Capacity - 1 ) ) == 0, "Post box capacity must be a power of two" );
+
 public:
-  void Post( const std::function< void() >& i_rFunction ) const
+
+  enum EFullPolicy
   {
-    m_pService->post( i_rFunction );
+    EDrop, // Discard the new item and count it
+    EWait  // Yield until the consumer makes space, unless the box is closed meanwhile
+  };
+
+  explicit VCGStreamPostBox( EFullPolicy i_Policy = EDrop )
+  : m_pSlots( new VSlot[ t_Capacity ] )
+  , m_EnqueuePosition( 0 )
+  , m_DequeuePosition( 0 )
+  , m_Policy( i_Policy )
+  , m_bOpen( false )
+  , m_Posted( 0 )
+  , m_Dropped( 0 )
+  , m_Waited( 0 )
+  {
+    for( size_t Index = 0; Index < t_Capacity; ++Index )
+    {
+      m_pSlots[ Index ].m_Sequence.store( Index, std::memory_order_relaxed );
+    }
   }
 
-  bool StartService()
+  // Posts are refused while the box is closed
+  void Open()
   {
-    boost::mutex::scoped_lock Lock( m_Mutex );
-    if( !m_pService )
+    m_bOpen = true;
+  }
+
+  void Close()
+  {
+    m_bOpen = false;
+  }
+
+  bool IsOpen() const
+  {
+    return m_bOpen.load( std::memory_order_relaxed );
+  }
+
+  void SetFullPolicy( EFullPolicy i_Policy )
+  {
+    m_Policy = i_Policy;
+  }
+
+  template< typename T >
+  bool Post( T && i_rItem )
+  {
+    return Post( std::forward< T >( i_rItem ), m_Policy.load() );
+  }
+
+  // Post with a policy of its own, for the occasional item which must not be dropped from a box that otherwise drops
+  template< typename T >
+  bool Post( T && i_rItem, EFullPolicy i_Policy )
+  {
+    if( !IsOpen() )
+    {
+      return false;
+    }
+
+    bool bWaited = false;
+    while( !TryPush( std::forward< T >( i_rItem ) ) )
+    {
+      if( i_Policy == EDrop || !IsOpen() )
+      {
+        m_Dropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+      }
+      bWaited = true;
+      std::this_thread::yield();
+    }
+
+    if( bWaited )
+    {
+      m_Waited.fetch_add( 1, std::memory_order_relaxed );
+    }
+    m_Posted.fetch_add( 1, std::memory_order_relaxed );
+    return true;
+  }
+
+  // Consumer only
+  bool TryPop( TItem & o_rItem )
+  {
+    const size_t Position = m_DequeuePosition.load( std::memory_order_relaxed );
+    VSlot & rSlot = m_pSlots[ Position & ( t_Capacity - 1 ) ];
+    if( rSlot.m_Sequence.load( std::memory_order_acquire ) != Position + 1 )
+    {
+      return false;
+    }
+
+    o_rItem = std::move( rSlot.m_Item );
+    m_DequeuePosition.store( Position + 1, std::memory_order_relaxed );
+    rSlot.m_Sequence.store( Position + t_Capacity, std::memory_order_release );
+    return true;
+  }
+
+  // Consumer only; hands each waiting item to i_rFunction and returns how many there were
+  template< typename TFunction >
+  size_t ConsumeAll( TFunction && i_rFunction )
+  {
+    size_t Count = 0;
+    TItem Item;
+    while( TryPop( Item ) )
     {
-      m_pService = std::make_shared< boost::asio::io_service >();
+      i_rFunction( Item );
+      ++Count;
     }
+    return Count;
+  }
+
+  VCGStreamPostalCounters Counters() const
+  {
+    VCGStreamPostalCounters Counters;
+    Counters.m_Posted = m_Posted.load( std::memory_order_relaxed );
+    Counters.m_Dropped = m_Dropped.load( std::memory_order_relaxed );
+    Counters.m_Waited = m_Waited.load( std::memory_order_relaxed );
+    return Counters;
+  }
+
+  void ResetCounters()
+  {
+    m_Posted = 0;
+    m_Dropped = 0;
+    m_Waited = 0;
+  }
+
+private:
 
-    if( !m_pWork )
+  // A slot is free for the producer claiming position P when its sequence is P, and holds an item for the
+  // consumer at position P when its sequence is P + 1
+  struct VSlot
+  {
+    std::atomic< size_t > m_Sequence;
+    TItem m_Item;
+  };
+
+  template< typename T >
+  bool TryPush( T && i_rItem )
+  {
+    size_t Position = m_EnqueuePosition.load( std::memory_order_relaxed );
+    for( ;; )
     {
-      m_pWork = std::make_shared< boost::asio::io_service::work >( *m_pService );
-      m_Thread = boost::thread( std::bind( &VCGStreamPostalService::ThreadFunction, this ) );
+      VSlot & rSlot = m_pSlots[ Position & ( t_Capacity - 1 ) ];
+      const size_t Sequence = rSlot.m_Sequence.load( std::memory_order_acquire );
+      const std::ptrdiff_t Difference = static_cast< std::ptrdiff_t >( Sequence - Position );
+      if( Difference == 0 )
+      {
+        if( m_EnqueuePosition.compare_exchange_weak( Position, Position + 1, std::memory_order_relaxed ) )
+        {
+          rSlot.m_Item = std::forward< T >( i_rItem );
+          rSlot.m_Sequence.store( Position + 1, std::memory_order_release );
+          return true;
+        }
+      }
+      else if( Difference < 0 )
+      {
+        // Full
+        return false;
+      }
+      else
+      {
+        Position = m_EnqueuePosition.load( std::memory_order_relaxed );
+      }
+    }
+  }
+
+  std::unique_ptr< VSlot[] > m_pSlots;
+
+  // Producers and the consumer each own a cache line
+  std::atomic< size_t > m_EnqueuePosition;
+  char m_EnqueuePadding[ 64 - sizeof( std::atomic< size_t > ) ];
+  std::atomic< size_t > m_DequeuePosition;
+  char m_DequeuePadding[ 64 - sizeof( std::atomic< size_t > ) ];
+
+  std::atomic< EFullPolicy > m_Policy;
+  std::atomic< bool > m_bOpen;
+  std::atomic< uint64_t > m_Posted;
+  std::atomic< uint64_t > m_Dropped;
+  std::atomic< uint64_t > m_Waited;
+};
+
+// A post box with a thread that delivers each item to a handler fixed when the service starts
+template< typename TItem, size_t t_Capacity = 1024 >
+class VCGStreamPostalService
+{
+public:
+
+  typedef VCGStreamPostBox< TItem, t_Capacity > TPostBox;
+  typedef std::function< void( TItem & ) > TDelivery;
+
+  VCGStreamPostalService()
+  : m_bStop( false )
+  {
+  }
+
+  ~VCGStreamPostalService()
+  {
+    StopService();
+  }
+
+  template< typename T >
+  bool Post( T && i_rItem )
+  {
+    return m_PostBox.Post( std::forward< T >( i_rItem ) );
+  }
+
+  bool StartService( const TDelivery & i_rDelivery, typename TPostBox::EFullPolicy i_Policy = TPostBox::EDrop )
+  {
+    boost::mutex::scoped_lock Lock( m_Mutex );
+    if( !m_Thread.joinable() )
+    {
+      m_Delivery = i_rDelivery;
+      m_PostBox.SetFullPolicy( i_Policy );
+      m_PostBox.ResetCounters();
+      m_bStop = false;
+      m_Thread = boost::thread( &VCGStreamPostalService::ThreadFunction, this );
+      m_PostBox.Open();
     }
 
     return true;
   }
 
+  // Delivers everything already posted before returning
   bool StopService()
   {
     boost::mutex::scoped_lock Lock( m_Mutex );
-    if( m_pWork )
+    if( m_Thread.joinable() )
     {
-      m_pWork.reset();
+      m_PostBox.Close();
+      m_bStop = true;
       m_Thread.join();
-      m_pService->reset();
+      m_PostBox.ConsumeAll( m_Delivery );
       return true;
     }
     return false;
   }
 
-  void ThreadFunction()
+  VCGStreamPostalCounters Counters() const
   {
-    m_pService->run();
+    return m_PostBox.Counters();
   }
 
 private:
-  mutable boost::mutex m_Mutex;
-  std::shared_ptr< boost::asio::io_service > m_pService;
-  std::shared_ptr< boost::asio::io_service::work > m_pWork;
+
+  void ThreadFunction()
+  {
+    while( !m_bStop )
+    {
+      if( m_PostBox.ConsumeAll( m_Delivery ) == 0 )
+      {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+      }
+    }
+  }
+
+  TPostBox m_PostBox;
+  TDelivery m_Delivery;
+  std::atomic< bool > m_bStop;
+
+  boost::mutex m_Mutex;
   boost::thread m_Thread;
 };
@@ -0,0 +1,66 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+// Shared by the video conversion kernels. Kernels for an instruction set are compiled with that target enabled and
+// only called once the processor has been found to support it, so the rest of the build needs no special flags.
+
+#if defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define VICON_CGSTREAM_X86
+#define VICON_CGSTREAM_TARGET( Target ) __attribute__(( target( Target ) ))
+#include <immintrin.h>
+#elif defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+#define VICON_CGSTREAM_X86
+#define VICON_CGSTREAM_TARGET( Target )
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+#ifdef VICON_CGSTREAM_X86
+
+namespace ViconCGStreamSIMD
+{
+  // Interleave 16 blue, green and red values into 48 bytes of BGR
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline void StoreBGR( __m128i i_Blue, __m128i i_Green, __m128i i_Red, unsigned char * o_pBGR )
+  {
+    const __m128i B0 = _mm_setr_epi8( 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5 );
+    const __m128i G0 = _mm_setr_epi8( -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1 );
+    const __m128i R0 = _mm_setr_epi8( -1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1 );
+    const __m128i B1 = _mm_setr_epi8( -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1 );
+    const __m128i G1 = _mm_setr_epi8( 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10 );
+    const __m128i R1 = _mm_setr_epi8( -1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1 );
+    const __m128i B2 = _mm_setr_epi8( -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1 );
+    const __m128i G2 = _mm_setr_epi8( -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1 );
+    const __m128i R2 = _mm_setr_epi8( 10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15 );
+
+    __m128i * pOut = reinterpret_cast< __m128i * >( o_pBGR );
+    _mm_storeu_si128( pOut, _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( i_Blue, B0 ), _mm_shuffle_epi8( i_Green, G0 ) ), _mm_shuffle_epi8( i_Red, R0 ) ) );
+    _mm_storeu_si128( pOut + 1, _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( i_Blue, B1 ), _mm_shuffle_epi8( i_Green, G1 ) ), _mm_shuffle_epi8( i_Red, R1 ) ) );
+    _mm_storeu_si128( pOut + 2, _mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( i_Blue, B2 ), _mm_shuffle_epi8( i_Green, G2 ) ), _mm_shuffle_epi8( i_Red, R2 ) ) );
+  }
+}
+
+#endif // VICON_CGSTREAM_X86
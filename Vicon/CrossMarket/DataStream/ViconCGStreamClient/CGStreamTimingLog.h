@@ -0,0 +1,283 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "CGStreamPostalService.h"
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Asynchronous log of fixed size records, cheap enough to use on the receive path.
+// Log() copies a record into a preallocated post box and never waits or allocates; a record that finds the box full
+// is dropped and counted. A writer thread drains the ring into a batch that goes to disk in large writes, either as raw
+// records behind a short header, or as text produced by the owner's formatter on the writer thread.
+template< typename TRecord, size_t t_Capacity = 4096 >
+class VCGStreamRecordLog
+{
+public:
+
+  // Appends one record as text, usually a line
+  typedef std::function< void( std::string & o_rText, const TRecord & i_rRecord ) > TFormatter;
+
+  VCGStreamRecordLog()
+  : m_bStop( false )
+  , m_bBinary( false )
+  {
+  }
+
+  ~VCGStreamRecordLog()
+  {
+    Close();
+  }
+
+  // i_rHeader is written at the start of a text log; a binary log starts with i_rMagic, a version and the record size
+  bool Open( const std::string & i_rFilename, bool i_bBinary, const char ( &i_rMagic )[ 4 ], const std::string & i_rHeader, const TFormatter & i_rFormatter )
+  {
+    boost::mutex::scoped_lock Lock( m_OpenMutex );
+
+    if( m_File.is_open() )
+    {
+      return false;
+    }
+
+    m_File.open( i_rFilename, std::ios::binary | std::ios::trunc );
+    if( !m_File.good() )
+    {
+      m_File.close();
+      return false;
+    }
+
+    m_bBinary = i_bBinary;
+    m_Formatter = i_rFormatter;
+    m_Batch.clear();
+    m_Batch.reserve( s_BatchSize + sizeof( TRecord ) * t_Capacity );
+
+    if( m_bBinary )
+    {
+      const uint32_t Version = s_Version;
+      const uint32_t RecordSize = sizeof( TRecord );
+      m_File.write( i_rMagic, sizeof( i_rMagic ) );
+      m_File.write( reinterpret_cast< const char * >( &Version ), sizeof( Version ) );
+      m_File.write( reinterpret_cast< const char * >( &RecordSize ), sizeof( RecordSize ) );
+    }
+    else
+    {
+      m_File << i_rHeader;
+    }
+
+    m_Records.ResetCounters();
+    m_bStop = false;
+    m_Thread = boost::thread( &VCGStreamRecordLog::WriterThread, this );
+    m_Records.Open();
+
+    return m_File.good();
+  }
+
+  void Close()
+  {
+    boost::mutex::scoped_lock Lock( m_OpenMutex );
+
+    m_Records.Close();
+
+    if( m_Thread.joinable() )
+    {
+      m_bStop = true;
+      m_Thread.join();
+    }
+
+    if( m_File.is_open() )
+    {
+      // Anything logged after the writer's last pass
+      Drain();
+      Write();
+      m_File.close();
+    }
+  }
+
+  bool IsEnabled() const
+  {
+    return m_Records.IsOpen();
+  }
+
+  void Log( const TRecord & i_rRecord )
+  {
+    m_Records.Post( i_rRecord );
+  }
+
+  // Waits for space rather than dropping the record, for records which later ones depend on
+  void LogWithoutDrop( const TRecord & i_rRecord )
+  {
+    m_Records.Post( i_rRecord, TPostBox::EWait );
+  }
+
+  // Number of records discarded because the ring was full
+  uint64_t DroppedCount() const
+  {
+    return m_Records.Counters().m_Dropped;
+  }
+
+  // Convert a binary log to text with the formatter used to write text logs
+  static bool WriteText( const std::string & i_rBinaryFile, const char ( &i_rMagic )[ 4 ], const std::string & i_rHeader,
+                         const TFormatter & i_rFormatter, std::ostream & o_rStream )
+  {
+    if( !IsBinaryLog( i_rBinaryFile, i_rMagic ) )
+    {
+      return false;
+    }
+
+    std::ifstream File( i_rBinaryFile, std::ios::binary );
+    File.seekg( s_HeaderSize );
+
+    o_rStream << i_rHeader;
+
+    std::string Text;
+    std::vector< TRecord > Records( 4096 );
+    while( File.read( reinterpret_cast< char * >( Records.data() ), Records.size() * sizeof( TRecord ) ) || File.gcount() > 0 )
+    {
+      const size_t Count = static_cast< size_t >( File.gcount() ) / sizeof( TRecord );
+      Text.clear();
+      for( size_t Index = 0; Index < Count; ++Index )
+      {
+        i_rFormatter( Text, Records[ Index ] );
+      }
+      o_rStream << Text;
+    }
+
+    return true;
+  }
+
+  // True if the file is a binary log of this record type with the given magic
+  static bool IsBinaryLog( const std::string & i_rFilename, const char ( &i_rMagic )[ 4 ] )
+  {
+    std::ifstream File( i_rFilename, std::ios::binary );
+
+    char Magic[ 4 ];
+    uint32_t Version = 0;
+    uint32_t RecordSize = 0;
+    File.read( Magic, sizeof( Magic ) );
+    File.read( reinterpret_cast< char * >( &Version ), sizeof( Version ) );
+    File.read( reinterpret_cast< char * >( &RecordSize ), sizeof( RecordSize ) );
+    return File.good() && std::memcmp( Magic, i_rMagic, sizeof( Magic ) ) == 0 && Version == s_Version && RecordSize == sizeof( TRecord );
+  }
+
+private:
+
+  void Drain()
+  {
+    m_Records.ConsumeAll( [this]( const TRecord & i_rRecord )
+    {
+      if( m_bBinary )
+      {
+        const char * pRecord = reinterpret_cast< const char * >( &i_rRecord );
+        m_Batch.insert( m_Batch.end(), pRecord, pRecord + sizeof( TRecord ) );
+      }
+      else
+      {
+        m_Formatter( m_Batch, i_rRecord );
+      }
+    } );
+  }
+
+  void Write()
+  {
+    if( !m_Batch.empty() )
+    {
+      m_File.write( m_Batch.data(), m_Batch.size() );
+      m_File.flush();
+      m_Batch.clear();
+    }
+  }
+
+  void WriterThread()
+  {
+    std::chrono::steady_clock::time_point LastWrite = std::chrono::steady_clock::now();
+    while( !m_bStop )
+    {
+      Drain();
+
+      // Go to disk in large writes, but not so rarely that a crash loses much
+      const std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+      if( m_Batch.size() >= s_BatchSize || Now - LastWrite >= std::chrono::seconds( 1 ) )
+      {
+        Write();
+        LastWrite = Now;
+      }
+
+      std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    }
+  }
+
+  static const uint32_t s_Version = 1;
+  static const size_t s_HeaderSize = 4 + sizeof( uint32_t ) + sizeof( uint32_t );
+  static const size_t s_BatchSize = 256 * 1024;
+
+  typedef VCGStreamPostBox< TRecord, t_Capacity > TPostBox;
+  TPostBox m_Records;
+  std::atomic< bool > m_bStop;
+
+  // Only touched by the writer thread while it is running
+  bool m_bBinary;
+  TFormatter m_Formatter;
+  std::string m_Batch;
+  std::ofstream m_File;
+
+  boost::thread m_Thread;
+  boost::mutex m_OpenMutex;
+};
+
+// Receipt time of each frame on the stream
+struct VCGStreamTimingRecord
+{
+  uint32_t m_FrameNumber;
+  uint32_t m_Reserved;
+  double   m_Timestamp;
+
+  static const char s_Magic[ 4 ];
+
+  static std::string TextHeader()
+  {
+    return "Frame Number, Timestamp\n";
+  }
+
+  static void WriteText( std::string & o_rText, const VCGStreamTimingRecord & i_rRecord )
+  {
+    char Line[ 64 ];
+    const int Length = std::snprintf( Line, sizeof( Line ), "%u, %f\n", i_rRecord.m_FrameNumber, i_rRecord.m_Timestamp );
+    o_rText.append( Line, Length > 0 ? std::min< size_t >( Length, sizeof( Line ) - 1 ) : 0 );
+  }
+};
@@ -23,228 +23,554 @@
 // SOFTWARE.
 //////////////////////////////////////////////////////////////////////////////////
 #include "ViconCGStreamBayer.h"
+#include "CGStreamSIMD.h"
 
 #include <cassert>
 #include <cstring>
 
-// Bayer pattern:
-// 
-// R G R G R G R G 
-// G B G B G B G B
-// R G R G R G R G 
-// G B G B G B G B
-// R G R G R G R G 
-// G B G B G B G B
-// R G R G R G R G 
-// G B G B G B G B
+// Every output pixel ( X, Y ) is built from the 2x2 window of raw pixels with rows Y - 1, Y and columns X, X + 1.
+// That window always holds one blue, one red and two greens on a diagonal; blue and red are taken as they are and
+// green is the average of the two greens, rounded down. Row 0 and the last column are left black.
+//
+// Each pattern differs only in where blue falls, which we describe by the parity of the raw rows and columns
+// holding blue. Within an output row, blue is in the same raw row for every pixel and alternates between
+// column X and X + 1.
 
-void VViconCGStreamBayer::BayerGBToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData )
+namespace
 {
-  assert( ( i_Width % 2 ) == 0 );
-  assert( ( i_Height % 2 ) == 0 );
+  struct VBayerLayout
+  {
+    unsigned int m_BlueRowParity;
+    unsigned int m_BlueColumnParity;
+  };
+
+  // Bayer pattern:
+  //
+  // R G R G R G R G
+  // G B G B G B G B
+  const VBayerLayout s_GBLayout = { 1, 1 };
+
+  // Bayer pattern:
+  //
+  // G R G R G R G
+  // B G B G B G B
+  const VBayerLayout s_BGLayout = { 1, 0 };
+
+  // Bayer pattern:
+  //
+  // G B G B G B G
+  // R G R G R G R
+  const VBayerLayout s_RGLayout = { 0, 1 };
+
+  // Bayer pattern:
+  //
+  // B G B G B G B
+  // G R G R G R G
+  const VBayerLayout s_GRLayout = { 0, 0 };
+
+  // At pixel X blue is at column X + S and red at X + 1 - S, where S alternates with X
+  template< unsigned int t_S >
+  inline void DemosaicPixel( const unsigned char * i_pBlue, const unsigned char * i_pRed, unsigned char * o_pBGR )
+  {
+    o_pBGR[ 0 ] = i_pBlue[ t_S ];
+    o_pBGR[ 1 ] = static_cast< unsigned char >( ( i_pBlue[ 1 - t_S ] + i_pRed[ t_S ] ) / 2 );
+    o_pBGR[ 2 ] = i_pRed[ 1 - t_S ];
+  }
+
+  // Pixels [ i_Begin, i_Width - 1 ) of one output row, where S is t_BlueOffset at even X
+  template< unsigned int t_BlueOffset >
+  void DemosaicRowPortable( const unsigned char * i_pBlueRow, const unsigned char * i_pRedRow, unsigned int i_Begin, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    unsigned int X = i_Begin;
+    const unsigned char * pBlue = i_pBlueRow + X;
+    const unsigned char * pRed = i_pRedRow + X;
+    unsigned char * pBGR = o_pBGRRow + X * 3;
 
-  std::memset( o_pBGRData, 0, i_Width * 3 );
+    if( ( X & 1 ) != 0 && X + 1 < i_Width )
+    {
+      DemosaicPixel< 1 - t_BlueOffset >( pBlue++, pRed++, pBGR );
+      pBGR += 3;
+      ++X;
+    }
+
+    for( ; X + 2 < i_Width; X += 2 )
+    {
+      DemosaicPixel< t_BlueOffset >( pBlue, pRed, pBGR );
+      DemosaicPixel< 1 - t_BlueOffset >( pBlue + 1, pRed + 1, pBGR + 3 );
+      pBlue += 2;
+      pRed += 2;
+      pBGR += 6;
+    }
 
-  const unsigned char * pLineAbove = i_pBayerData;
-  const unsigned char * pLine = i_pBayerData + i_Width;
-  unsigned char * pBGR = o_pBGRData + i_Width * 3;
+    if( X + 1 < i_Width )
+    {
+      DemosaicPixel< t_BlueOffset >( pBlue, pRed, pBGR );
+    }
+  }
 
-  for( unsigned int Y = 1; Y < i_Height; Y++ )
+  void DemosaicRowPortable( const unsigned char * i_pBlueRow, const unsigned char * i_pRedRow, unsigned int i_BlueOffset,
+                            unsigned int i_Begin, unsigned int i_Width, unsigned char * o_pBGRRow )
   {
-    if( ( Y & 1 ) == 0 )
+    if( i_BlueOffset )
     {
-      for( unsigned int X = 0; ( X + 1 ) < i_Width; X += 2 )
-      {
-        // Second line (odd lines): red, green
-        pBGR[ 0 ] = pLineAbove[ 1 ];
-        pBGR[ 1 ] = ( pLineAbove[ 0 ] + pLine[ 1 ] ) / 2;
-        pBGR[ 2 ] = pLine[ 0 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
-
-        pBGR[ 0 ] = pLineAbove[ 0 ];
-        pBGR[ 1 ] = ( pLineAbove[ 1 ] + pLine[ 0 ] ) / 2;
-        pBGR[ 2 ] = pLine[ 1 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
-      }
+      DemosaicRowPortable< 1 >( i_pBlueRow, i_pRedRow, i_Begin, i_Width, o_pBGRRow );
     }
     else
     {
-      for( unsigned int X = 0; ( X + 1 ) < i_Width; X += 2 )
+      DemosaicRowPortable< 0 >( i_pBlueRow, i_pRedRow, i_Begin, i_Width, o_pBGRRow );
+    }
+  }
+
+  // Pixels [ i_Begin, i_OutWidth ) of one binned output row, from the t_Binning raw rows starting at i_pBlocks. Each block is whole
+  // 2x2 cells of the pattern, so each colour is simply summed over it; blue and red are rounded to nearest, as is green.
+  template< unsigned int t_Binning >
+  void BinRowPortable( const VBayerLayout & i_rLayout, const unsigned char * i_pBlocks, unsigned int i_Stride, unsigned int i_Begin,
+                       unsigned int i_OutWidth, unsigned char * o_pBGRRow )
+  {
+    const unsigned int Cells = ( t_Binning / 2 ) * ( t_Binning / 2 );
+    const unsigned int BlueColumn = i_rLayout.m_BlueColumnParity;
+    const unsigned int RedColumn = 1 - BlueColumn;
+
+    const unsigned char * pBlock = i_pBlocks + i_Begin * t_Binning;
+    unsigned char * pBGR = o_pBGRRow + i_Begin * 3;
+    for( unsigned int X = i_Begin; X < i_OutWidth; ++X, pBlock += t_Binning, pBGR += 3 )
+    {
+      unsigned int Blue = 0;
+      unsigned int Green = 0;
+      unsigned int Red = 0;
+      for( unsigned int CellY = 0; CellY < t_Binning; CellY += 2 )
       {
-        // First line (even lines): green, blue
-        pBGR[ 0 ] = pLine[ 1 ];
-        pBGR[ 1 ] = ( pLine[ 0 ] + pLineAbove[ 1 ] ) / 2;
-        pBGR[ 2 ] = pLineAbove[ 0 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
-
-        pBGR[ 0 ] = pLine[ 0 ];
-        pBGR[ 1 ] = ( pLine[ 1 ] + pLineAbove[ 0 ] ) / 2;
-        pBGR[ 2 ] = pLineAbove[ 1 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
+        const unsigned char * pEven = pBlock + CellY * i_Stride;
+        const unsigned char * pBlueRow = i_rLayout.m_BlueRowParity ? pEven + i_Stride : pEven;
+        const unsigned char * pRedRow = i_rLayout.m_BlueRowParity ? pEven : pEven + i_Stride;
+        for( unsigned int CellX = 0; CellX < t_Binning; CellX += 2 )
+        {
+          Blue += pBlueRow[ CellX + BlueColumn ];
+          Green += pBlueRow[ CellX + RedColumn ] + pRedRow[ CellX + BlueColumn ];
+          Red += pRedRow[ CellX + RedColumn ];
+        }
       }
+
+      pBGR[ 0 ] = static_cast< unsigned char >( ( Blue + Cells / 2 ) / Cells );
+      pBGR[ 1 ] = static_cast< unsigned char >( ( Green + Cells ) / ( 2 * Cells ) );
+      pBGR[ 2 ] = static_cast< unsigned char >( ( Red + Cells / 2 ) / Cells );
     }
+  }
 
-    // Clear right-hand edge.
-    *( pBGR - 1 ) = 0;
-    *( pBGR - 2 ) = 0;
-    *( pBGR - 3 ) = 0;
+#ifdef VICON_CGSTREAM_X86
+
+  using ViconCGStreamSIMD::StoreBGR;
+
+  // i_Swap ? i_rA : i_rB per byte
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i Select( __m128i i_Swap, __m128i i_A, __m128i i_B )
+  {
+    return _mm_or_si128( _mm_and_si128( i_Swap, i_A ), _mm_andnot_si128( i_Swap, i_B ) );
+  }
+
+  // Average rounded down, as the integer division in the portable kernel
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i AverageDown( __m128i i_A, __m128i i_B )
+  {
+    return _mm_sub_epi8( _mm_avg_epu8( i_A, i_B ), _mm_and_si128( _mm_xor_si128( i_A, i_B ), _mm_set1_epi8( 1 ) ) );
   }
-}
 
-// Bayer pattern:
-// 
-// G R G R G R G 
-// B G B G B G B
-// G R G R G R G 
-// B G B G B G B
-// G R G R G R G 
-// B G B G B G B
-// G R G R G R G 
-// B G B G B G B
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  void DemosaicRowSSSE3( const unsigned char * i_pBlueRow, const unsigned char * i_pRedRow, unsigned int i_BlueOffset,
+                         unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    // Lanes where blue is at X + 1
+    const __m128i Swap = i_BlueOffset ? _mm_set1_epi16( 0x00FF ) : _mm_set1_epi16( static_cast< short >( 0xFF00 ) );
 
-void VViconCGStreamBayer::BayerBGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData )
-{
-  assert( ( i_Width % 2 ) == 0 );
-  assert( ( i_Height % 2 ) == 0 );
+    unsigned int X = 0;
+    for( ; X + 17 <= i_Width; X += 16 )
+    {
+      const __m128i Blue0 = _mm_loadu_si128( reinterpret_cast< const __m128i * >( i_pBlueRow + X ) );
+      const __m128i Blue1 = _mm_loadu_si128( reinterpret_cast< const __m128i * >( i_pBlueRow + X + 1 ) );
+      const __m128i Red0 = _mm_loadu_si128( reinterpret_cast< const __m128i * >( i_pRedRow + X ) );
+      const __m128i Red1 = _mm_loadu_si128( reinterpret_cast< const __m128i * >( i_pRedRow + X + 1 ) );
 
-  std::memset( o_pBGRData, 0, i_Width * 3 );
+      const __m128i Blue = Select( Swap, Blue1, Blue0 );
+      const __m128i Red = Select( Swap, Red0, Red1 );
+      const __m128i Green = AverageDown( Select( Swap, Blue0, Blue1 ), Select( Swap, Red1, Red0 ) );
 
-  const unsigned char * pLineAbove = i_pBayerData;
-  const unsigned char * pLine = i_pBayerData + i_Width;
-  unsigned char * pBGR = o_pBGRData + i_Width * 3;
+      StoreBGR( Blue, Green, Red, o_pBGRRow + X * 3 );
+    }
 
-  for( unsigned int Y = 1; Y < i_Height; Y++ )
+    DemosaicRowPortable( i_pBlueRow, i_pRedRow, i_BlueOffset, X, i_Width, o_pBGRRow );
+  }
+
+  VICON_CGSTREAM_TARGET( "avx2" )
+  void DemosaicRowAVX2( const unsigned char * i_pBlueRow, const unsigned char * i_pRedRow, unsigned int i_BlueOffset,
+                        unsigned int i_Width, unsigned char * o_pBGRRow )
   {
-    if( ( Y & 1 ) == 0 )
+    const __m256i Swap = i_BlueOffset ? _mm256_set1_epi16( 0x00FF ) : _mm256_set1_epi16( static_cast< short >( 0xFF00 ) );
+    const __m256i One = _mm256_set1_epi8( 1 );
+
+    unsigned int X = 0;
+    for( ; X + 33 <= i_Width; X += 32 )
     {
-      for( unsigned int X = 0; ( X + 1 ) < i_Width; X += 2 )
+      const __m256i Blue0 = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( i_pBlueRow + X ) );
+      const __m256i Blue1 = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( i_pBlueRow + X + 1 ) );
+      const __m256i Red0 = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( i_pRedRow + X ) );
+      const __m256i Red1 = _mm256_loadu_si256( reinterpret_cast< const __m256i * >( i_pRedRow + X + 1 ) );
+
+      const __m256i Blue = _mm256_blendv_epi8( Blue0, Blue1, Swap );
+      const __m256i Red = _mm256_blendv_epi8( Red1, Red0, Swap );
+      const __m256i GreenA = _mm256_blendv_epi8( Blue1, Blue0, Swap );
+      const __m256i GreenB = _mm256_blendv_epi8( Red0, Red1, Swap );
+      const __m256i Green = _mm256_sub_epi8( _mm256_avg_epu8( GreenA, GreenB ), _mm256_and_si256( _mm256_xor_si256( GreenA, GreenB ), One ) );
+
+      // Byte shuffles do not cross 128 bit lanes, so interleave each half on its own
+      StoreBGR( _mm256_castsi256_si128( Blue ), _mm256_castsi256_si128( Green ), _mm256_castsi256_si128( Red ), o_pBGRRow + X * 3 );
+      StoreBGR( _mm256_extracti128_si256( Blue, 1 ), _mm256_extracti128_si256( Green, 1 ), _mm256_extracti128_si256( Red, 1 ), o_pBGRRow + X * 3 + 48 );
+    }
+
+    DemosaicRowPortable( i_pBlueRow, i_pRedRow, i_BlueOffset, X, i_Width, o_pBGRRow );
+  }
+
+  // The samples of 8 pixels' blocks in one raw row which fall in columns of the given parity, summed per block as 16 bit lanes
+  template< unsigned int t_Binning >
+  __m128i BlockColumnSums( const unsigned char * i_pRow, unsigned int i_Parity );
+
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i ColumnSamples( __m128i i_Row, unsigned int i_Parity )
+  {
+    return i_Parity ? _mm_srli_epi16( i_Row, 8 ) : _mm_and_si128( i_Row, _mm_set1_epi16( 0x00FF ) );
+  }
+
+  template<>
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i BlockColumnSums< 2 >( const unsigned char * i_pRow, unsigned int i_Parity )
+  {
+    return ColumnSamples( _mm_loadu_si128( reinterpret_cast< const __m128i * >( i_pRow ) ), i_Parity );
+  }
+
+  template<>
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i BlockColumnSums< 4 >( const unsigned char * i_pRow, unsigned int i_Parity )
+  {
+    return _mm_hadd_epi16( ColumnSamples( _mm_loadu_si128( reinterpret_cast< const __m128i * >( i_pRow ) ), i_Parity ),
+                           ColumnSamples( _mm_loadu_si128( reinterpret_cast< const __m128i * >( i_pRow + 16 ) ), i_Parity ) );
+  }
+
+  // As BinRowPortable, 16 pixels at a time; returns the number of pixels done
+  template< unsigned int t_Binning >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  unsigned int BinRowSSSE3( const VBayerLayout & i_rLayout, const unsigned char * i_pBlocks, unsigned int i_Stride,
+                            unsigned int i_OutWidth, unsigned char * o_pBGRRow )
+  {
+    const int CellShift = t_Binning == 4 ? 2 : 0;
+    const __m128i HalfCells = _mm_set1_epi16( ( 1 << CellShift ) / 2 );
+    const __m128i Cells = _mm_set1_epi16( 1 << CellShift );
+    const unsigned int BlueColumn = i_rLayout.m_BlueColumnParity;
+    const unsigned int RedColumn = 1 - BlueColumn;
+
+    unsigned int X = 0;
+    for( ; X + 16 <= i_OutWidth; X += 16 )
+    {
+      __m128i Blue[ 2 ];
+      __m128i Green[ 2 ];
+      __m128i Red[ 2 ];
+      for( unsigned int Half = 0; Half < 2; ++Half )
       {
-        // Second line (odd lines): green, red
-        pBGR[ 0 ] = pLineAbove[ 0 ];
-        pBGR[ 1 ] = ( pLineAbove[ 1 ] + pLine[ 0 ] ) / 2;
-        pBGR[ 2 ] = pLine[ 1 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
-
-        pBGR[ 0 ] = pLineAbove[ 1 ];
-        pBGR[ 1 ] = ( pLineAbove[ 0 ] + pLine[ 1 ] ) / 2;
-        pBGR[ 2 ] = pLine[ 0 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
+        Blue[ Half ] = _mm_setzero_si128();
+        Green[ Half ] = _mm_setzero_si128();
+        Red[ Half ] = _mm_setzero_si128();
+        for( unsigned int CellY = 0; CellY < t_Binning; CellY += 2 )
+        {
+          const unsigned char * pEven = i_pBlocks + CellY * i_Stride + ( X + Half * 8 ) * t_Binning;
+          const unsigned char * pBlueRow = i_rLayout.m_BlueRowParity ? pEven + i_Stride : pEven;
+          const unsigned char * pRedRow = i_rLayout.m_BlueRowParity ? pEven : pEven + i_Stride;
+          Blue[ Half ] = _mm_add_epi16( Blue[ Half ], BlockColumnSums< t_Binning >( pBlueRow, BlueColumn ) );
+          Green[ Half ] = _mm_add_epi16( Green[ Half ], _mm_add_epi16( BlockColumnSums< t_Binning >( pBlueRow, RedColumn ),
+                                                                     BlockColumnSums< t_Binning >( pRedRow, BlueColumn ) ) );
+          Red[ Half ] = _mm_add_epi16( Red[ Half ], BlockColumnSums< t_Binning >( pRedRow, RedColumn ) );
+        }
+        Blue[ Half ] = _mm_srli_epi16( _mm_add_epi16( Blue[ Half ], HalfCells ), CellShift );
+        Green[ Half ] = _mm_srli_epi16( _mm_add_epi16( Green[ Half ], Cells ), CellShift + 1 );
+        Red[ Half ] = _mm_srli_epi16( _mm_add_epi16( Red[ Half ], HalfCells ), CellShift );
       }
+
+      StoreBGR( _mm_packus_epi16( Blue[ 0 ], Blue[ 1 ] ), _mm_packus_epi16( Green[ 0 ], Green[ 1 ] ), _mm_packus_epi16( Red[ 0 ], Red[ 1 ] ),
+                o_pBGRRow + X * 3 );
     }
-    else
+    return X;
+  }
+
+  VViconCGStreamBayer::EInstructionSet DetectInstructionSet()
+  {
+#if defined( __GNUC__ )
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx2" ) )
+    {
+      return VViconCGStreamBayer::EAVX2;
+    }
+    if( __builtin_cpu_supports( "ssse3" ) )
+    {
+      return VViconCGStreamBayer::ESSSE3;
+    }
+#else
+    int Info[ 4 ];
+    __cpuid( Info, 0 );
+    const int MaxLeaf = Info[ 0 ];
+
+    __cpuid( Info, 1 );
+    const bool bSSSE3 = ( Info[ 2 ] & ( 1 << 9 ) ) != 0;
+    const bool bOSXSave = ( Info[ 2 ] & ( 1 << 27 ) ) != 0;
+    const bool bAVX = ( Info[ 2 ] & ( 1 << 28 ) ) != 0;
+
+    if( MaxLeaf >= 7 && bOSXSave && bAVX && ( _xgetbv( 0 ) & 0x6 ) == 0x6 )
     {
-      for( unsigned int X = 0; ( X + 1 ) < i_Width; X += 2 )
+      __cpuidex( Info, 7, 0 );
+      if( ( Info[ 1 ] & ( 1 << 5 ) ) != 0 )
       {
-        // First line (odd lines): blue, green
-        pBGR[ 0 ] = pLine[ 0 ];
-        pBGR[ 1 ] = ( pLine[ 1 ] + pLineAbove[ 0 ] ) / 2;
-        pBGR[ 2 ] = pLineAbove[ 1 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
-
-        pBGR[ 0 ] = pLine[ 1 ];
-        pBGR[ 1 ] = ( pLine[ 0 ] + pLineAbove[ 1 ] ) / 2;
-        pBGR[ 2 ] = pLineAbove[ 0 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
+        return VViconCGStreamBayer::EAVX2;
       }
     }
+    if( bSSSE3 )
+    {
+      return VViconCGStreamBayer::ESSSE3;
+    }
+#endif
+    return VViconCGStreamBayer::EPortable;
+  }
+
+#else
+
+  VViconCGStreamBayer::EInstructionSet DetectInstructionSet()
+  {
+    return VViconCGStreamBayer::EPortable;
+  }
+
+#endif // VICON_CGSTREAM_X86
+
+  // Pixels [ 0, i_Width - 1 ) of one output row
+  void DemosaicPixels( const unsigned char * i_pBlueRow, const unsigned char * i_pRedRow, unsigned int i_BlueOffset,
+                       unsigned int i_Width, unsigned char * o_pBGRRow, VViconCGStreamBayer::EInstructionSet i_InstructionSet )
+  {
+    switch( i_InstructionSet )
+    {
+#ifdef VICON_CGSTREAM_X86
+    case VViconCGStreamBayer::EAVX2:
+      DemosaicRowAVX2( i_pBlueRow, i_pRedRow, i_BlueOffset, i_Width, o_pBGRRow );
+      break;
+    case VViconCGStreamBayer::ESSSE3:
+      DemosaicRowSSSE3( i_pBlueRow, i_pRedRow, i_BlueOffset, i_Width, o_pBGRRow );
+      break;
+#endif
+    default:
+      DemosaicRowPortable( i_pBlueRow, i_pRedRow, i_BlueOffset, 0, i_Width, o_pBGRRow );
+      break;
+    }
+  }
+
+  void DemosaicRow( const unsigned char * i_pBlueRow, const unsigned char * i_pRedRow, unsigned int i_BlueOffset,
+                    unsigned int i_Width, unsigned char * o_pBGRRow, VViconCGStreamBayer::EInstructionSet i_InstructionSet )
+  {
+    DemosaicPixels( i_pBlueRow, i_pRedRow, i_BlueOffset, i_Width, o_pBGRRow, i_InstructionSet );
 
     // Clear right-hand edge.
-    *( pBGR - 1 ) = 0;
-    *( pBGR - 2 ) = 0;
-    *( pBGR - 3 ) = 0;
+    std::memset( o_pBGRRow + ( i_Width - 1 ) * 3, 0, 3 );
   }
-}
 
-// Bayer pattern:
-// 
-// G B G B G B G  
-// R G R G R G R 
+  // Output rows [ i_BeginRow, i_EndRow ) of the frame
+  void Demosaic( const VBayerLayout & i_rLayout, unsigned int i_Width, unsigned int i_Height, unsigned int i_BeginRow, unsigned int i_EndRow,
+                 const unsigned char * i_pBayerData, unsigned char * o_pBGRData, VViconCGStreamBayer::EInstructionSet i_InstructionSet )
+  {
+    assert( ( i_Width % 2 ) == 0 );
+    assert( ( i_Height % 2 ) == 0 );
+
+    if( i_EndRow > i_Height )
+    {
+      i_EndRow = i_Height;
+    }
 
-void VViconCGStreamBayer::BayerRGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData )
-{
-  assert( ( i_Width  % 2 ) == 0 );
-  assert( ( i_Height % 2 ) == 0 );
+    if( i_Width == 0 || i_BeginRow >= i_EndRow )
+    {
+      return;
+    }
+
+    // Never use more than the processor has
+    const VViconCGStreamBayer::EInstructionSet Supported = VViconCGStreamBayer::SupportedInstructionSet();
+    const VViconCGStreamBayer::EInstructionSet InstructionSet = i_InstructionSet < Supported ? i_InstructionSet : Supported;
+
+    if( i_BeginRow == 0 )
+    {
+      std::memset( o_pBGRData, 0, i_Width * 3 );
+      ++i_BeginRow;
+    }
 
-  std::memset( o_pBGRData, 0, i_Width * 3 );
+    for( unsigned int Y = i_BeginRow; Y < i_EndRow; ++Y )
+    {
+      const unsigned char * pLineAbove = i_pBayerData + ( Y - 1 ) * i_Width;
+      const unsigned char * pLine = i_pBayerData + Y * i_Width;
+      const bool bBlueInLine = ( Y & 1 ) == i_rLayout.m_BlueRowParity;
 
-  const unsigned char * pLineAbove = i_pBayerData;
-  const unsigned char * pLine = i_pBayerData + i_Width;
-  unsigned char * pBGR = o_pBGRData + i_Width * 3;
+      DemosaicRow( bBlueInLine ? pLine : pLineAbove, bBlueInLine ? pLineAbove : pLine, i_rLayout.m_BlueColumnParity,
+                   i_Width, o_pBGRData + Y * i_Width * 3, InstructionSet );
+    }
+  }
 
-  for( unsigned int Y = 1; Y < i_Height; Y++ )
+  // Output rows [ i_BeginRow, i_EndRow ) of a window of the frame, each pixel as the whole frame would have it
+  void DemosaicWindow( const VBayerLayout & i_rLayout, unsigned int i_Width, unsigned int i_X, unsigned int i_Y, unsigned int i_OutWidth,
+                       unsigned int i_BeginRow, unsigned int i_EndRow, const unsigned char * i_pBayerData, unsigned char * o_pBGRData,
+                       VViconCGStreamBayer::EInstructionSet i_InstructionSet )
   {
-    if( ( Y & 1 ) == 0 )
+    const VViconCGStreamBayer::EInstructionSet Supported = VViconCGStreamBayer::SupportedInstructionSet();
+    const VViconCGStreamBayer::EInstructionSet InstructionSet = i_InstructionSet < Supported ? i_InstructionSet : Supported;
+
+    // Only the window which reaches the right of the frame has the black edge; any other reads the column past its end
+    const bool bRightEdge = i_X + i_OutWidth >= i_Width;
+    const unsigned int BlueOffset = i_rLayout.m_BlueColumnParity ^ ( i_X & 1 );
+
+    for( unsigned int Row = i_BeginRow; Row < i_EndRow; ++Row )
     {
-      for( unsigned int X = 0; ( X + 1 ) < i_Width; X += 2 )
+      unsigned char * pBGRRow = o_pBGRData + static_cast< size_t >( Row ) * i_OutWidth * 3;
+      const unsigned int Y = i_Y + Row;
+      if( Y == 0 )
+      {
+        std::memset( pBGRRow, 0, static_cast< size_t >( i_OutWidth ) * 3 );
+        continue;
+      }
+
+      const unsigned char * pLineAbove = i_pBayerData + static_cast< size_t >( Y - 1 ) * i_Width + i_X;
+      const unsigned char * pLine = i_pBayerData + static_cast< size_t >( Y ) * i_Width + i_X;
+      const bool bBlueInLine = ( Y & 1 ) == i_rLayout.m_BlueRowParity;
+      if( bRightEdge )
+      {
+        DemosaicRow( bBlueInLine ? pLine : pLineAbove, bBlueInLine ? pLineAbove : pLine, BlueOffset, i_OutWidth, pBGRRow, InstructionSet );
+      }
+      else
       {
-        // Second line (odd lines): green, blue
-        pBGR[ 0 ] = pLine[ 1 ];
-        pBGR[ 1 ] = ( pLineAbove[ 1 ] + pLine[ 0 ] ) / 2;
-        pBGR[ 2 ] = pLineAbove[ 0 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
-
-        pBGR[ 0 ] = pLine[ 0 ];
-        pBGR[ 1 ] = ( pLineAbove[ 0 ] + pLine[ 1 ] ) / 2;
-        pBGR[ 2 ] = pLineAbove[ 1 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
+        DemosaicPixels( bBlueInLine ? pLine : pLineAbove, bBlueInLine ? pLineAbove : pLine, BlueOffset, i_OutWidth + 1, pBGRRow, InstructionSet );
       }
     }
-    else
+  }
+
+  // Output rows [ i_BeginRow, i_EndRow ) of a window of the frame, each pixel the average of the t_Binning x t_Binning raw pixels
+  // it covers
+  template< unsigned int t_Binning >
+  void BinWindow( const VBayerLayout & i_rLayout, unsigned int i_Width, unsigned int i_X, unsigned int i_Y, unsigned int i_OutWidth,
+                  unsigned int i_BeginRow, unsigned int i_EndRow, const unsigned char * i_pBayerData, unsigned char * o_pBGRData,
+                  VViconCGStreamBayer::EInstructionSet i_InstructionSet )
+  {
+    for( unsigned int Row = i_BeginRow; Row < i_EndRow; ++Row )
     {
-      for( unsigned int X = 0; ( X + 1 ) < i_Width; X += 2 )
+      const unsigned char * pBlocks = i_pBayerData + static_cast< size_t >( i_Y + Row * t_Binning ) * i_Width + i_X;
+      unsigned char * pBGRRow = o_pBGRData + static_cast< size_t >( Row ) * i_OutWidth * 3;
+
+      unsigned int X = 0;
+#ifdef VICON_CGSTREAM_X86
+      if( i_InstructionSet >= VViconCGStreamBayer::ESSSE3 )
       {
-        // First line (odd lines): red, green
-        pBGR[ 0 ] = pLineAbove[ 1 ];
-        pBGR[ 1 ] = ( pLine[ 1 ] + pLineAbove[ 0 ] ) / 2;
-        pBGR[ 2 ] = pLine[ 0 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
-
-        pBGR[ 0 ] = pLineAbove[ 0 ];
-        pBGR[ 1 ] = ( pLine[ 0 ] + pLineAbove[ 1 ] ) / 2;
-        pBGR[ 2 ] = pLine[ 1 ];
-
-        pLine++;
-        pLineAbove++;
-        pBGR += 3;
+        X = BinRowSSSE3< t_Binning >( i_rLayout, pBlocks, i_Width, i_OutWidth, pBGRRow );
       }
+#else
+      ( void )i_InstructionSet;
+#endif
+      BinRowPortable< t_Binning >( i_rLayout, pBlocks, i_Width, X, i_OutWidth, pBGRRow );
     }
+  }
 
-    // Clear right-hand edge.
-    *( pBGR - 1 ) = 0;
-    *( pBGR - 2 ) = 0;
-    *( pBGR - 3 ) = 0;
+  const VBayerLayout & Layout( VViconCGStreamBayer::EPattern i_Pattern )
+  {
+    switch( i_Pattern )
+    {
+    case VViconCGStreamBayer::EBG:
+      return s_BGLayout;
+    case VViconCGStreamBayer::ERG:
+      return s_RGLayout;
+    case VViconCGStreamBayer::EGR:
+      return s_GRLayout;
+    default:
+      return s_GBLayout;
+    }
+  }
+}
+
+VViconCGStreamBayer::EInstructionSet VViconCGStreamBayer::SupportedInstructionSet()
+{
+  static const EInstructionSet s_Supported = DetectInstructionSet();
+  return s_Supported;
+}
+
+void VViconCGStreamBayer::BayerGBToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData )
+{
+  Demosaic( s_GBLayout, i_Width, i_Height, 0, i_Height, i_pBayerData, o_pBGRData, SupportedInstructionSet() );
+}
+
+void VViconCGStreamBayer::BayerBGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData )
+{
+  Demosaic( s_BGLayout, i_Width, i_Height, 0, i_Height, i_pBayerData, o_pBGRData, SupportedInstructionSet() );
+}
+
+void VViconCGStreamBayer::BayerRGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData )
+{
+  Demosaic( s_RGLayout, i_Width, i_Height, 0, i_Height, i_pBayerData, o_pBGRData, SupportedInstructionSet() );
+}
+
+void VViconCGStreamBayer::BayerGRToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData )
+{
+  Demosaic( s_GRLayout, i_Width, i_Height, 0, i_Height, i_pBayerData, o_pBGRData, SupportedInstructionSet() );
+}
+
+void VViconCGStreamBayer::BayerGBToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet )
+{
+  Demosaic( s_GBLayout, i_Width, i_Height, 0, i_Height, i_pBayerData, o_pBGRData, i_InstructionSet );
+}
+
+void VViconCGStreamBayer::BayerBGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet )
+{
+  Demosaic( s_BGLayout, i_Width, i_Height, 0, i_Height, i_pBayerData, o_pBGRData, i_InstructionSet );
+}
+
+void VViconCGStreamBayer::BayerRGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet )
+{
+  Demosaic( s_RGLayout, i_Width, i_Height, 0, i_Height, i_pBayerData, o_pBGRData, i_InstructionSet );
+}
+
+void VViconCGStreamBayer::BayerGRToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet )
+{
+  Demosaic( s_GRLayout, i_Width, i_Height, 0, i_Height, i_pBayerData, o_pBGRData, i_InstructionSet );
+}
+
+void VViconCGStreamBayer::BayerToBGR( EPattern i_Pattern, unsigned int i_Width, unsigned int i_Height, unsigned int i_BeginRow, unsigned int i_EndRow,
+                                      const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet )
+{
+  Demosaic( Layout( i_Pattern ), i_Width, i_Height, i_BeginRow, i_EndRow, i_pBayerData, o_pBGRData, i_InstructionSet );
+}
+
+void VViconCGStreamBayer::BayerWindowToBGR( EPattern i_Pattern, unsigned int i_Width, unsigned int i_Height, unsigned int i_X, unsigned int i_Y,
+                                            unsigned int i_Binning, unsigned int i_OutWidth, unsigned int i_BeginRow, unsigned int i_EndRow,
+                                            const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet )
+{
+  assert( i_Binning == 1 || ( ( i_Binning % 2 ) == 0 && ( i_X % 2 ) == 0 && ( i_Y % 2 ) == 0 ) );
+  assert( i_X + i_OutWidth * i_Binning <= i_Width );
+  assert( i_Y + i_EndRow * i_Binning <= i_Height );
+
+  if( i_OutWidth == 0 || i_BeginRow >= i_EndRow )
+  {
+    return;
+  }
+
+  const EInstructionSet Supported = SupportedInstructionSet();
+  const EInstructionSet InstructionSet = i_InstructionSet < Supported ? i_InstructionSet : Supported;
+
+  const VBayerLayout & rLayout = Layout( i_Pattern );
+  switch( i_Binning )
+  {
+  case 1:
+    DemosaicWindow( rLayout, i_Width, i_X, i_Y, i_OutWidth, i_BeginRow, i_EndRow, i_pBayerData, o_pBGRData, InstructionSet );
+    break;
+  case 2:
+    BinWindow< 2 >( rLayout, i_Width, i_X, i_Y, i_OutWidth, i_BeginRow, i_EndRow, i_pBayerData, o_pBGRData, InstructionSet );
+    break;
+  case 4:
+    BinWindow< 4 >( rLayout, i_Width, i_X, i_Y, i_OutWidth, i_BeginRow, i_EndRow, i_pBayerData, o_pBGRData, InstructionSet );
+    break;
+  default:
+    assert( false );
+    break;
   }
 }
@@ -27,7 +27,47 @@
 class VViconCGStreamBayer
 {
 public:
+  // Kernels in order of preference; every one gives the same output
+  enum EInstructionSet
+  {
+    EPortable,
+    ESSSE3,
+    EAVX2
+  };
+
+  // The best kernel this processor can run, which the conversions use unless told otherwise
+  static EInstructionSet SupportedInstructionSet();
+
+  // Patterns, named as the conversions below
+  enum EPattern
+  {
+    EGB,
+    EBG,
+    ERG,
+    EGR
+  };
+
+  // Convert output rows [ i_BeginRow, i_EndRow ) of a frame into the same rows of o_pBGRData.
+  // Each output row depends only on the input row above it, so a frame may be split between threads this way.
+  static void BayerToBGR( EPattern i_Pattern, unsigned int i_Width, unsigned int i_Height, unsigned int i_BeginRow, unsigned int i_EndRow,
+                          const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet = SupportedInstructionSet() );
+
+  // Convert output rows [ i_BeginRow, i_EndRow ) of a window of a frame, starting at raw pixel ( i_X, i_Y ), into the same rows
+  // of o_pBGRData, which holds i_OutWidth pixels per row. The window must lie within the frame.
+  // With i_Binning of 1 each output pixel is the one BayerToBGR gives at that point of the frame. Otherwise each is the average
+  // of the i_Binning x i_Binning raw pixels it covers, and i_Binning, i_X and i_Y must be even.
+  static void BayerWindowToBGR( EPattern i_Pattern, unsigned int i_Width, unsigned int i_Height, unsigned int i_X, unsigned int i_Y,
+                                unsigned int i_Binning, unsigned int i_OutWidth, unsigned int i_BeginRow, unsigned int i_EndRow,
+                                const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet = SupportedInstructionSet() );
+
   static void BayerGBToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData );
   static void BayerBGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData );
   static void BayerRGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData );
+  static void BayerGRToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData );
+
+  // As above with a given kernel, limited to what the processor supports
+  static void BayerGBToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet );
+  static void BayerBGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet );
+  static void BayerRGToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet );
+  static void BayerGRToBGR( unsigned int i_Width, unsigned int i_Height, const unsigned char * i_pBayerData, unsigned char * o_pBGRData, EInstructionSet i_InstructionSet );
 };
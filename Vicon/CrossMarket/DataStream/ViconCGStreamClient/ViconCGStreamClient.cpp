@@ -29,9 +29,11 @@
 #include "IViconCGStreamClientCallback.h"
 #include "ViconCGStreamClient.h"
 
-#include "CGStreamPostalService.h"
+#include "CGStreamDecodePool.h"
 #include "CGStreamReaderWriter.h"
-#include "ViconCGStreamBayer.h"
+#include "CGStreamTimingLog.h"
+#include "ViconCGStreamVideo.h"
+#include "CGStreamLazyVideoFrame.h"
 
 #include <ViconCGStream/ApexHaptics.h>
 #include <ViconCGStream/Contents.h>
@@ -45,6 +47,8 @@
 
 #include <boost/asio.hpp>
 #include <boost/chrono/include.hpp>
+#include <algorithm>
+#include <array>
 #include <functional>
 
 #include <iostream>
@@ -61,12 +65,81 @@ namespace
   // Number of pings to use to keep average
   const size_t s_MaxPings = 20;
 
+  // Number of frames which may be waiting on the decode pool before the socket thread blocks.
+  const size_t s_MaxPendingFrames = 8;
+
+  // Bytes received in one frame by object type. The enums are sparse, so rather than index by them we keep a short
+  // list of the types seen; a frame holds far fewer types than this, and nothing here allocates on the socket thread.
+  class VFrameBytes
+  {
+  public:
+    VFrameBytes()
+    : m_Count( 0 )
+    {
+    }
+
+    // Returns false if there is no room left for a new type
+    bool Add( ViconCGStreamType::Enum i_Enum, ViconCGStreamType::UInt64 i_Bytes )
+    {
+      for( size_t Index = 0; Index != m_Count; ++Index )
+      {
+        if( m_Bytes[ Index ].first == i_Enum )
+        {
+          m_Bytes[ Index ].second += i_Bytes;
+          return true;
+        }
+      }
+
+      if( m_Count == m_Bytes.size() )
+      {
+        return false;
+      }
+
+      m_Bytes[ m_Count++ ] = std::make_pair( i_Enum, i_Bytes );
+      return true;
+    }
+
+    typedef std::pair< ViconCGStreamType::Enum, ViconCGStreamType::UInt64 > TTypeBytes;
+    const TTypeBytes * begin() const { return m_Bytes.data(); }
+    const TTypeBytes * end() const { return m_Bytes.data() + m_Count; }
+
+  private:
+    std::array< TTypeBytes, 64 > m_Bytes;
+    size_t m_Count;
+  };
+
 } // namespace
 
 typedef std::chrono::high_resolution_clock hrc;
 
 //-------------------------------------------------------------------------------------------------
 
+// A frame which has some of its objects still being decoded on the decode pool.
+class VPendingFrame
+{
+public:
+  VPendingFrame()
+  : m_bContents( false )
+  , m_Outstanding( 0 )
+  , m_bFailed( false )
+  {
+  }
+
+  bool m_bContents;
+  ViconCGStream::VContents m_Contents;
+  std::shared_ptr< VStaticObjects > m_pStaticObjects;
+  std::shared_ptr< VDynamicObjects > m_pDynamicObjects;
+
+  // Applied in stream order once all blocks have been decoded.
+  std::vector< std::function< void( VDynamicObjects& ) > > m_Merges;
+
+  // Guarded by the client's decode mutex.
+  unsigned int m_Outstanding;
+  bool m_bFailed;
+};
+
+//-------------------------------------------------------------------------------------------------
+
 ViconCGStream::VCentroids& VDynamicObjects::AddCentroids()
 {
   m_Centroids.push_back( ViconCGStream::VCentroids() );
@@ -103,18 +176,6 @@ ViconCGStream::VLightweightSegments& VDynamicObjects::AddLightweightSegments()
   return m_LightweightSegments.back();
 }
 
-ViconCGStream::VGreyscaleBlobs& VDynamicObjects::AddGreyscaleBlobs()
-{
-  m_GreyscaleBlobs.push_back( ViconCGStream::VGreyscaleBlobs() );
-  return m_GreyscaleBlobs.back();
-}
-
-ViconCGStream::VGreyscaleSubsampledBlobs& VDynamicObjects::AddGreyscaleSubsampledBlobs()
-{
-  m_GreyscaleSubsampledBlobs.push_back(ViconCGStream::VGreyscaleSubsampledBlobs());
-  return m_GreyscaleSubsampledBlobs.back();
-}
-
 ViconCGStream::VEdgePairs& VDynamicObjects::AddEdgePairs()
 {
   m_EdgePairs.push_back( ViconCGStream::VEdgePairs() );
@@ -329,6 +390,10 @@ VViconCGStreamClient::VViconCGStreamClient( std::weak_ptr< IViconCGStreamClientC
 , m_bFilterChanged( false )
 , m_bPingChanged( false )
 , m_VideoHint( EPassThrough )
+, m_pVideoWindows( new TVideoWindows() )
+, m_DecodeThreadCount( 0 )
+, m_bStopAssembly( false )
+, m_pVideoBufferPool( new VCGStreamBufferPool() )
 {
   m_pSocket.reset( new boost::asio::ip::tcp::socket( m_Service ) );
 }
@@ -568,6 +633,18 @@ void VViconCGStreamClient::SetFilter( const ViconCGStream::VFilter& i_rFilter )
   boost::recursive_mutex::scoped_lock Lock( m_Mutex );
   m_Filter = i_rFilter;
   m_bFilterChanged = true;
+
+  // Send the filter now rather than with the next write after a frame is read, so that the server stops sending
+  // what has been filtered out straight away. If we are not connected yet, the client thread sends it once we are.
+  if( m_pSocket->is_open() )
+  {
+    VCGStreamReaderWriter ReaderWriter( m_pSocket );
+    {
+      ViconCGStreamIO::VScopedWriter Objects( ReaderWriter );
+      Objects.Write( m_Filter );
+    }
+    m_bFilterChanged = !ReaderWriter.Flush();
+  }
 }
 
 void VViconCGStreamClient::SetRequiredObjects( std::set< ViconCGStreamType::Enum >& i_rRequiredObjects )
@@ -639,6 +716,12 @@ bool VViconCGStreamClient::ObjectIsSupported(const ViconCGStreamType::Enum& i_rO
   return true;
 }
 
+void VViconCGStreamClient::GetBytesReceived( TBytesReceived & o_rBytesReceived ) const
+{
+  boost::mutex::scoped_lock Lock( m_BytesReceivedMutex );
+  o_rBytesReceived = m_BytesReceived;
+}
+
 void VViconCGStreamClient::SetServerToTransmitMulticast( std::string i_MulticastIPAddress, std::string i_ServerIPAddress, unsigned short i_Port )
 {
   boost::recursive_mutex::scoped_lock Lock( m_Mutex );
@@ -682,49 +765,32 @@ void VViconCGStreamClient::SetVideoHint( EVideoHint i_VideoHint )
   m_VideoHint = i_VideoHint;
 }
 
-bool VViconCGStreamClient::SetTimingLogFile(const std::string & i_rFilename)
+void VViconCGStreamClient::SetVideoWindow( unsigned int i_CameraID, const VViconCGStreamVideo::VWindow & i_rWindow )
 {
-  boost::mutex::scoped_lock Lock( m_LogMutex );
-
-  if( m_TimingLog.is_open() )
-  {
-    m_TimingLog.close();
-  }
-
-  if( !m_pPostalService )
-  {
-    m_pPostalService = std::make_shared< VCGStreamPostalService >();
-  }
-
-  if( !m_pPostalService->StartService() )
-  {
-    m_pPostalService.reset();
-    return false;
-  }
+  boost::recursive_mutex::scoped_lock Lock( m_Mutex );
+  std::shared_ptr< TVideoWindows > pWindows( new TVideoWindows( *m_pVideoWindows ) );
+  ( *pWindows )[ i_CameraID ] = i_rWindow;
+  m_pVideoWindows = pWindows;
+}
 
-  m_TimingLog.open( i_rFilename );
+void VViconCGStreamClient::SetDecodeThreadCount( unsigned int i_ThreadCount )
+{
+  boost::recursive_mutex::scoped_lock Lock( m_Mutex );
+  m_DecodeThreadCount = i_ThreadCount;
+}
 
-  // Write log header
-  if( m_TimingLog.good() )
-  {
-    m_TimingLog << std::fixed << "Frame Number, Timestamp" << std::endl;
-  }
+bool VViconCGStreamClient::SetTimingLogFile( const std::string & i_rFilename, bool i_bBinary )
+{
+  m_TimingLog.Close();
 
-  return m_TimingLog.good();
+  return m_TimingLog.Open( i_rFilename, i_bBinary, VCGStreamTimingRecord::s_Magic, VCGStreamTimingRecord::TextHeader(), &VCGStreamTimingRecord::WriteText );
 }
 
+const char VCGStreamTimingRecord::s_Magic[ 4 ] = { 'V', 'T', 'L', 'F' };
+
 void VViconCGStreamClient::CloseLog()
 {
-  boost::mutex::scoped_lock Lock(m_LogMutex);
-
-  if( m_pPostalService )
-  {
-    m_pPostalService->StopService();
-  }
-  if( m_TimingLog.is_open() )
-  {
-    m_TimingLog.close();
-  }
+  m_TimingLog.Close();
 }
 
 
@@ -768,6 +834,8 @@ void VViconCGStreamClient::ClientThread()
         break;
       }
     }
+
+    StopDecodePool();
   }
   else
   {
@@ -792,6 +860,7 @@ void VViconCGStreamClient::ClientThread()
       }
     }
 
+    StopDecodePool();
     OnDisconnect();
   }
 }
@@ -831,7 +900,7 @@ bool VViconCGStreamClient::ReadObjectEnums( VCGStreamReaderWriter& i_rReaderWrit
 bool VViconCGStreamClient::WriteObjects( VCGStreamReaderWriter& i_rReaderWriter )
 {
   boost::recursive_mutex::scoped_lock Lock( m_Mutex );
-  bool bWriteObjects = m_bEnumsChanged || m_bHapticChanged || m_bPingChanged;
+  bool bWriteObjects = m_bEnumsChanged || m_bHapticChanged || m_bFilterChanged || m_bPingChanged;
 
   if( bWriteObjects )
   {
@@ -1029,8 +1098,19 @@ bool VViconCGStreamClient::ReadObjects( VCGStreamReaderWriter& i_rReaderWriter )
     return false;
   }
 
+  // Monotonic receipt time for the frame; the wall clock version is kept for the timing log
+  const std::chrono::steady_clock::time_point ReceiptTime = std::chrono::steady_clock::now();
   const double PacketReceiptTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now().time_since_epoch() ).count();
 
+  UpdateDecodePool();
+
+  // Heavy objects are handed off to the decode pool if there is one
+  std::shared_ptr< VPendingFrame > pPendingFrame;
+  if( m_pDecodePool )
+  {
+    pPendingFrame = std::make_shared< VPendingFrame >();
+  }
+
   ViconCGStreamIO::VScopedReader Objects( i_rReaderWriter );
   if( Objects.Enum() != ViconCGStreamEnum::Objects )
   {
@@ -1043,9 +1123,16 @@ bool VViconCGStreamClient::ReadObjects( VCGStreamReaderWriter& i_rReaderWriter )
   bool bContents = false;
   ViconCGStream::VContents Contents;
 
+  VFrameBytes BytesReceived;
+
   while( Objects.Ok() )
   {
     ViconCGStreamIO::VScopedReader Object( i_rReaderWriter );
+    if( !BytesReceived.Add( Object.Enum(), Object.Length() ) )
+    {
+      boost::mutex::scoped_lock Lock( m_BytesReceivedMutex );
+      m_BytesReceived[ Object.Enum() ] += Object.Length();
+    }
 
     switch( Object.Enum() )
     {
@@ -1221,9 +1308,13 @@ bool VViconCGStreamClient::ReadObjects( VCGStreamReaderWriter& i_rReaderWriter )
         return false;
       }
 
-      if( m_pPostalService )
+      if( m_TimingLog.IsEnabled() )
       {
-        m_pPostalService->Post( std::bind( &VViconCGStreamClient::TimingLogFunction, this, pDynamicObjects->m_FrameInfo.m_FrameID, PacketReceiptTime ) );
+        VCGStreamTimingRecord Record;
+        Record.m_FrameNumber = pDynamicObjects->m_FrameInfo.m_FrameID;
+        Record.m_Reserved = 0;
+        Record.m_Timestamp = PacketReceiptTime;
+        m_TimingLog.Log( Record );
       }
       break;
     case ViconCGStreamEnum::HardwareFrameInfo:
@@ -1265,7 +1356,7 @@ bool VViconCGStreamClient::ReadObjects( VCGStreamReaderWriter& i_rReaderWriter )
     case ViconCGStreamEnum::Centroids:
       if( !pDynamicObjects )
         pDynamicObjects.reset( new VDynamicObjects() );
-      if( !Object.Read( pDynamicObjects->AddCentroids() ) )
+      if( pPendingFrame ? !DeferRead( Object, pPendingFrame, &VDynamicObjects::AddCentroids ) : !Object.Read( pDynamicObjects->AddCentroids() ) )
       {
         return false;
       }
@@ -1283,7 +1374,7 @@ bool VViconCGStreamClient::ReadObjects( VCGStreamReaderWriter& i_rReaderWriter )
     case ViconCGStreamEnum::CentroidWeights:
       if( !pDynamicObjects )
         pDynamicObjects.reset( new VDynamicObjects() );
-      if( !Object.Read( pDynamicObjects->AddCentroidWeights() ) )
+      if( pPendingFrame ? !DeferRead( Object, pPendingFrame, &VDynamicObjects::AddCentroidWeights ) : !Object.Read( pDynamicObjects->AddCentroidWeights() ) )
       {
         return false;
       }
@@ -1293,15 +1384,70 @@ bool VViconCGStreamClient::ReadObjects( VCGStreamReaderWriter& i_rReaderWriter )
     {
       if( !pDynamicObjects )
         pDynamicObjects.reset( new VDynamicObjects() );
-      ViconCGStream::VVideoFrame& rVideoFrame = pDynamicObjects->AddVideoFrame();
+
+      const bool bDecode = ( m_VideoHint == EDecode );
+      const bool bDecodeOnAccess = ( m_VideoHint == EDecodeOnAccess );
+      std::shared_ptr< const TVideoWindows > pWindows;
+      {
+        boost::recursive_mutex::scoped_lock Lock( m_Mutex );
+        pWindows = m_pVideoWindows;
+      }
+
+      if( pPendingFrame )
+      {
+        std::shared_ptr< ViconCGStream::VVideoFrame > pVideoFrame = NewVideoFrame( bDecodeOnAccess, pWindows );
+        // The decoded frame is only needed when decoding as the frame arrives
+        std::shared_ptr< ViconCGStream::VVideoFrame > pDecoded;
+        std::shared_ptr< std::atomic< bool > > pDecodeFailed;
+        if( bDecode )
+        {
+          pDecoded = PooledVideoFrame( new ViconCGStream::VVideoFrame(), m_pVideoBufferPool );
+          pDecodeFailed = std::make_shared< std::atomic< bool > >( false );
+        }
+
+        auto Read = [ this, pPendingFrame, pVideoFrame, pWindows, pDecoded, pDecodeFailed ]( const ViconCGStreamIO::VBuffer& i_rBlock )
+        {
+          m_pVideoBufferPool->Take( pVideoFrame->m_VideoData, i_rBlock.Length() );
+          if( !pVideoFrame->Read( i_rBlock ) )
+          {
+            return false;
+          }
+          if( pDecoded && !DecodeVideoStriped( pPendingFrame, pVideoFrame, *pWindows, pDecoded, pDecodeFailed ) )
+          {
+            *pDecodeFailed = true;
+          }
+          return true;
+        };
+        // Only runs once every stripe has been written. A failed decode leaves the output partly written, so the
+        // frame is passed on undecoded instead. The frame which is not kept gives its data back to the pool.
+        auto Merge = [ this, pVideoFrame, pDecoded, pDecodeFailed ]( VDynamicObjects& io_rDynamicObjects )
+        {
+          if( pDecoded && *pDecodeFailed )
+          {
+            m_pVideoBufferPool->Give( std::move( pDecoded->m_VideoData ) );
+            pDecoded->m_VideoData.clear();
+          }
+          io_rDynamicObjects.m_VideoFrames.push_back( pDecoded && !pDecoded->m_VideoData.empty() ? pDecoded : pVideoFrame );
+        };
+
+        if( !DeferRead( Object, pPendingFrame, Read, Merge ) )
+        {
+          return false;
+        }
+        break;
+      }
+
+      pDynamicObjects->m_VideoFrames.push_back( NewVideoFrame( bDecodeOnAccess, pWindows ) );
+      ViconCGStream::VVideoFrame& rVideoFrame = *pDynamicObjects->m_VideoFrames.back();
+      m_pVideoBufferPool->Take( rVideoFrame.m_VideoData, Object.Length() );
       if( !Object.Read( rVideoFrame ) )
       {
         return false;
       }
 
-      if( m_VideoHint == EDecode )
+      if( bDecode )
       {
-        DecodeVideo( rVideoFrame );
+        DecodeVideo( rVideoFrame, *pWindows );
       }
     }
     break;
@@ -1326,7 +1472,24 @@ bool VViconCGStreamClient::ReadObjects( VCGStreamReaderWriter& i_rReaderWriter )
     case ViconCGStreamEnum::LabeledReconRayAssignments:
       if( !pDynamicObjects )
         pDynamicObjects.reset( new VDynamicObjects() );
-      if( !Object.Read( pDynamicObjects->m_LabeledRayAssignments ) )
+      if( pPendingFrame )
+      {
+        std::shared_ptr< ViconCGStream::VLabeledReconRayAssignments > pAssignments( new ViconCGStream::VLabeledReconRayAssignments() );
+        auto Read = [ pAssignments ]( const ViconCGStreamIO::VBuffer& i_rBlock )
+        {
+          return pAssignments->Read( i_rBlock );
+        };
+        auto Merge = [ pAssignments ]( VDynamicObjects& io_rDynamicObjects )
+        {
+          io_rDynamicObjects.m_LabeledRayAssignments = std::move( *pAssignments );
+        };
+
+        if( !DeferRead( Object, pPendingFrame, Read, Merge ) )
+        {
+          return false;
+        }
+      }
+      else if( !Object.Read( pDynamicObjects->m_LabeledRayAssignments ) )
       {
         return false;
       }
@@ -1360,23 +1523,39 @@ bool VViconCGStreamClient::ReadObjects( VCGStreamReaderWriter& i_rReaderWriter )
 
       break;
     case ViconCGStreamEnum::GreyscaleBlobs:
+    case ViconCGStreamEnum::GreyscaleSubsampledBlobs:
+    {
       if( !pDynamicObjects )
         pDynamicObjects.reset( new VDynamicObjects() );
-      if( !Object.Read( pDynamicObjects->AddGreyscaleBlobs() ) )
+
+      // Both formats read into the packed form, which holds each camera's lines and pixels in flat arrays
+      const bool bSubsampled = ( Object.Enum() == ViconCGStreamEnum::GreyscaleSubsampledBlobs );
+      std::shared_ptr< ViconCGStream::VGreyscaleBlobsPacked > pBlobs( new ViconCGStream::VGreyscaleBlobsPacked( bSubsampled ) );
+      if( pPendingFrame )
       {
-        return false;
+        auto Read = [ pBlobs ]( const ViconCGStreamIO::VBuffer& i_rBlock )
+        {
+          return pBlobs->Read( i_rBlock );
+        };
+        auto Merge = [ pBlobs, bSubsampled ]( VDynamicObjects& io_rDynamicObjects )
+        {
+          ( bSubsampled ? io_rDynamicObjects.m_GreyscaleSubsampledBlobs : io_rDynamicObjects.m_GreyscaleBlobs ).push_back( pBlobs );
+        };
+
+        if( !DeferRead( Object, pPendingFrame, Read, Merge ) )
+        {
+          return false;
+        }
+        break;
       }
 
-      break;
-    case ViconCGStreamEnum::GreyscaleSubsampledBlobs:
-      if (!pDynamicObjects)
-        pDynamicObjects.reset(new VDynamicObjects());
-      if (!Object.Read(pDynamicObjects->AddGreyscaleSubsampledBlobs()))
+      if( !Object.Read( *pBlobs ) )
       {
         return false;
       }
-
-      break;
+      ( bSubsampled ? pDynamicObjects->m_GreyscaleSubsampledBlobs : pDynamicObjects->m_GreyscaleBlobs ).push_back( pBlobs );
+    }
+    break;
     case ViconCGStreamEnum::EdgePairs:
       if( !pDynamicObjects )
         pDynamicObjects.reset( new VDynamicObjects() );
@@ -1487,56 +1666,387 @@ bool VViconCGStreamClient::ReadObjects( VCGStreamReaderWriter& i_rReaderWriter )
     }
   }
 
-  if( bContents && m_pStaticObjects && pStaticObjects )
   {
-    CopyObjects( Contents, *m_pStaticObjects, *pStaticObjects );
+    boost::mutex::scoped_lock Lock( m_BytesReceivedMutex );
+    for( const auto & rBytes : BytesReceived )
+    {
+      m_BytesReceived[ rBytes.first ] += rBytes.second;
+    }
   }
 
-  if( bContents && m_pDynamicObjects && pDynamicObjects )
+  if( pDynamicObjects )
   {
-    CopyObjects( Contents, *m_pDynamicObjects, *pDynamicObjects );
+    pDynamicObjects->m_ReceiptTime = ReceiptTime;
   }
 
-  if( pStaticObjects )
+  if( pPendingFrame )
   {
-    m_pStaticObjects = pStaticObjects;
-    OnStaticObjects( pStaticObjects );
+    // Unchanged objects are copied from the previous frame once it has been assembled
+    pPendingFrame->m_bContents = bContents;
+    pPendingFrame->m_Contents = Contents;
+    pPendingFrame->m_pStaticObjects = pStaticObjects;
+    pPendingFrame->m_pDynamicObjects = pDynamicObjects;
+
+    boost::mutex::scoped_lock Lock( m_DecodeMutex );
+    while( m_PendingFrames.size() >= s_MaxPendingFrames )
+    {
+      m_DecodeCondition.wait( Lock );
+    }
+    m_PendingFrames.push_back( pPendingFrame );
+    m_DecodeCondition.notify_all();
+    return true;
   }
 
-  if( pDynamicObjects )
+  DispatchObjects( bContents, Contents, pStaticObjects, pDynamicObjects );
+  return true;
+}
+
+void VViconCGStreamClient::DispatchObjects( bool i_bContents, const ViconCGStream::VContents& i_rContents, std::shared_ptr< VStaticObjects > i_pStaticObjects, std::shared_ptr< VDynamicObjects > i_pDynamicObjects )
+{
+  if( i_bContents && m_pStaticObjects && i_pStaticObjects )
+  {
+    CopyObjects( i_rContents, *m_pStaticObjects, *i_pStaticObjects );
+  }
+
+  if( i_bContents && m_pDynamicObjects && i_pDynamicObjects )
+  {
+    CopyObjects( i_rContents, *m_pDynamicObjects, *i_pDynamicObjects );
+  }
+
+  if( i_pStaticObjects )
+  {
+    m_pStaticObjects = i_pStaticObjects;
+    OnStaticObjects( i_pStaticObjects );
+  }
+
+  if( i_pDynamicObjects )
+  {
+    m_pDynamicObjects = i_pDynamicObjects;
+    OnDynamicObjects( i_pDynamicObjects );
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool VViconCGStreamClient::DeferRead( const ViconCGStreamIO::VScopedReader& i_rObject, std::shared_ptr< VPendingFrame > i_pFrame,
+                                      const std::function< bool( const ViconCGStreamIO::VBuffer& ) >& i_rRead,
+                                      const std::function< void( VDynamicObjects& ) >& i_rMerge )
+{
+  // Take a copy of the encoded block, as the socket buffer will be refilled before it is decoded
+  std::shared_ptr< ViconCGStreamIO::VBuffer > pBlock( new ViconCGStreamIO::VBuffer() );
+  if( !i_rObject.Copy( *pBlock ) )
+  {
+    return false;
+  }
+
+  i_pFrame->m_Merges.push_back( i_rMerge );
   {
-    m_pDynamicObjects = pDynamicObjects;
-    OnDynamicObjects( pDynamicObjects );
+    boost::mutex::scoped_lock Lock( m_DecodeMutex );
+    ++i_pFrame->m_Outstanding;
   }
+
+  m_pDecodePool->Post( std::bind( &VViconCGStreamClient::DecodeBlock, this, i_pFrame, pBlock, i_rRead ) );
   return true;
 }
 
+template< typename T >
+bool VViconCGStreamClient::DeferRead( const ViconCGStreamIO::VScopedReader& i_rObject, std::shared_ptr< VPendingFrame > i_pFrame, T& ( VDynamicObjects::*i_pAdd )() )
+{
+  std::shared_ptr< T > pItem( new T() );
+  auto Read = [ pItem ]( const ViconCGStreamIO::VBuffer& i_rBlock )
+  {
+    return pItem->Read( i_rBlock );
+  };
+  auto Merge = [ pItem, i_pAdd ]( VDynamicObjects& io_rDynamicObjects )
+  {
+    ( io_rDynamicObjects.*i_pAdd )() = std::move( *pItem );
+  };
+
+  return DeferRead( i_rObject, i_pFrame, Read, Merge );
+}
+
+void VViconCGStreamClient::DecodeBlock( std::shared_ptr< VPendingFrame > i_pFrame, std::shared_ptr< const ViconCGStreamIO::VBuffer > i_pBlock,
+                                        const std::function< bool( const ViconCGStreamIO::VBuffer& ) >& i_rRead )
+{
+  CompleteWork( i_pFrame, i_rRead( *i_pBlock ) );
+}
+
+void VViconCGStreamClient::DeferWork( std::shared_ptr< VPendingFrame > i_pFrame, const std::function< bool() >& i_rWork )
+{
+  {
+    boost::mutex::scoped_lock Lock( m_DecodeMutex );
+    ++i_pFrame->m_Outstanding;
+  }
+
+  m_pDecodePool->Post( [ this, i_pFrame, i_rWork ]()
+  {
+    CompleteWork( i_pFrame, i_rWork() );
+  } );
+}
+
+void VViconCGStreamClient::CompleteWork( std::shared_ptr< VPendingFrame > i_pFrame, bool i_bOk )
+{
+  boost::mutex::scoped_lock Lock( m_DecodeMutex );
+  if( !i_bOk )
+  {
+    i_pFrame->m_bFailed = true;
+  }
+  --i_pFrame->m_Outstanding;
+  m_DecodeCondition.notify_all();
+}
+
+void VViconCGStreamClient::UpdateDecodePool()
+{
+  unsigned int ThreadCount = 0;
+  {
+    boost::recursive_mutex::scoped_lock Lock( m_Mutex );
+    ThreadCount = m_DecodeThreadCount;
+  }
+
+  const unsigned int CurrentThreadCount = m_pDecodePool ? m_pDecodePool->ThreadCount() : 0;
+  if( ThreadCount == CurrentThreadCount )
+  {
+    return;
+  }
+
+  // Frames already handed off are dispatched before any that follow
+  StopDecodePool();
+
+  if( ThreadCount > 0 )
+  {
+    m_pDecodePool = std::make_shared< VCGStreamDecodePool >();
+    m_pDecodePool->StartService( ThreadCount );
+
+    m_bStopAssembly = false;
+    m_pAssemblyThread.reset( new boost::thread( std::bind( &VViconCGStreamClient::AssemblyThread, this ) ) );
+  }
+}
+
+void VViconCGStreamClient::StopDecodePool()
+{
+  if( m_pAssemblyThread )
+  {
+    {
+      boost::mutex::scoped_lock Lock( m_DecodeMutex );
+      m_bStopAssembly = true;
+      m_DecodeCondition.notify_all();
+    }
+    m_pAssemblyThread->join();
+    m_pAssemblyThread.reset();
+  }
+
+  if( m_pDecodePool )
+  {
+    m_pDecodePool->StopService();
+    m_pDecodePool.reset();
+  }
+}
+
+void VViconCGStreamClient::AssemblyThread()
+{
+  for( ;; )
+  {
+    std::shared_ptr< VPendingFrame > pFrame;
+    {
+      boost::mutex::scoped_lock Lock( m_DecodeMutex );
+
+      // Frames are dispatched strictly in the order they were received
+      while( m_PendingFrames.empty() ? !m_bStopAssembly : m_PendingFrames.front()->m_Outstanding != 0 )
+      {
+        m_DecodeCondition.wait( Lock );
+      }
+
+      if( m_PendingFrames.empty() )
+      {
+        return;
+      }
+
+      pFrame = m_PendingFrames.front();
+      m_PendingFrames.pop_front();
+      m_DecodeCondition.notify_all();
+    }
+
+    // A block which failed to decode invalidates its frame, as it would have done on the socket thread
+    if( pFrame->m_bFailed )
+    {
+      continue;
+    }
+
+    if( pFrame->m_pDynamicObjects )
+    {
+      for( const auto& rMerge : pFrame->m_Merges )
+      {
+        rMerge( *pFrame->m_pDynamicObjects );
+      }
+    }
+
+    DispatchObjects( pFrame->m_bContents, pFrame->m_Contents, pFrame->m_pStaticObjects, pFrame->m_pDynamicObjects );
+  }
+}
+
 //-------------------------------------------------------------------------------------------------
 
-void VViconCGStreamClient::DecodeVideo( ViconCGStream::VVideoFrame& io_rVideoFrame )
+bool VViconCGStreamClient::PlanVideoDecode( const ViconCGStream::VVideoFrame& i_rVideoFrame, const TVideoWindows& i_rWindows, VVideoDecode& o_rDecode )
 {
-  if( io_rVideoFrame.m_Format == ViconCGStream::VVideoFrame::EBayerGB8 )
+  const size_t FrameSize = VViconCGStreamVideo::FrameSize( i_rVideoFrame.m_Format, i_rVideoFrame.m_Width, i_rVideoFrame.m_Height );
+  if( FrameSize == 0 || i_rVideoFrame.m_VideoData.size() < FrameSize )
   {
-    m_ScratchVideo.resize( io_rVideoFrame.m_Width * io_rVideoFrame.m_Height * 3 );
-    VViconCGStreamBayer::BayerGBToBGR( io_rVideoFrame.m_Width, io_rVideoFrame.m_Height, &io_rVideoFrame.m_VideoData[ 0 ], &m_ScratchVideo[ 0 ] );
+    return false;
   }
-  else if( io_rVideoFrame.m_Format == ViconCGStream::VVideoFrame::EBayerBG8 )
+
+  const TVideoWindows::const_iterator WindowIt = i_rWindows.find( i_rVideoFrame.m_CameraID );
+  o_rDecode.m_Window = WindowIt != i_rWindows.end() ? WindowIt->second : VViconCGStreamVideo::VWindow();
+  if( !VViconCGStreamVideo::FitWindow( i_rVideoFrame.m_Format, i_rVideoFrame.m_Width, i_rVideoFrame.m_Height, o_rDecode.m_Window ) )
   {
-    m_ScratchVideo.resize( io_rVideoFrame.m_Width * io_rVideoFrame.m_Height * 3 );
-    VViconCGStreamBayer::BayerBGToBGR( io_rVideoFrame.m_Width, io_rVideoFrame.m_Height, &io_rVideoFrame.m_VideoData[ 0 ], &m_ScratchVideo[ 0 ] );
+    return false;
   }
-  else if( io_rVideoFrame.m_Format == ViconCGStream::VVideoFrame::EBayerRG8 )
+
+  // Whole frames already in one of the decoded formats are left as they are
+  const bool bWholeFrame = o_rDecode.m_Window.m_Binning == 1 && o_rDecode.m_Window.m_Width == i_rVideoFrame.m_Width && o_rDecode.m_Window.m_Height == i_rVideoFrame.m_Height;
+  if( bWholeFrame && ( i_rVideoFrame.m_Format == ViconCGStream::VVideoFrame::EBGR888 || i_rVideoFrame.m_Format == ViconCGStream::VVideoFrame::EMono8 ) )
   {
-    m_ScratchVideo.resize( io_rVideoFrame.m_Width * io_rVideoFrame.m_Height * 3 );
-    VViconCGStreamBayer::BayerRGToBGR( io_rVideoFrame.m_Width, io_rVideoFrame.m_Height, &io_rVideoFrame.m_VideoData[ 0 ], &m_ScratchVideo[ 0 ] );
+    return false;
   }
-  else
+
+  const bool bGreyscale = VViconCGStreamVideo::IsGreyscale( i_rVideoFrame.m_Format );
+  o_rDecode.m_Format = bGreyscale ? ViconCGStream::VVideoFrame::EMono8 : ViconCGStream::VVideoFrame::EBGR888;
+  o_rDecode.m_Size = static_cast< size_t >( o_rDecode.m_Window.OutWidth() ) * o_rDecode.m_Window.OutHeight() * ( bGreyscale ? 1 : 3 );
+  return true;
+}
+
+void VViconCGStreamClient::SetDecodedHeader( const ViconCGStream::VVideoFrame& i_rVideoFrame, const VVideoDecode& i_rDecode, ViconCGStream::VVideoFrame& o_rDecoded )
+{
+  o_rDecoded.m_FrameID = i_rVideoFrame.m_FrameID;
+  o_rDecoded.m_CameraID = i_rVideoFrame.m_CameraID;
+  o_rDecoded.m_Position[ 0 ] = static_cast< ViconCGStreamType::Int16 >( i_rVideoFrame.m_Position[ 0 ] + i_rDecode.m_Window.m_X );
+  o_rDecoded.m_Position[ 1 ] = static_cast< ViconCGStreamType::Int16 >( i_rVideoFrame.m_Position[ 1 ] + i_rDecode.m_Window.m_Y );
+  o_rDecoded.m_Width = static_cast< ViconCGStreamType::UInt16 >( i_rDecode.m_Window.OutWidth() );
+  o_rDecoded.m_Height = static_cast< ViconCGStreamType::UInt16 >( i_rDecode.m_Window.OutHeight() );
+  o_rDecoded.m_Format = i_rDecode.m_Format;
+}
+
+bool VViconCGStreamClient::DecodeVideoRows( const ViconCGStream::VVideoFrame& i_rVideoFrame, const VVideoDecode& i_rDecode, unsigned int i_BeginRow, unsigned int i_EndRow,
+                                            ViconCGStreamType::UInt8* o_pDecoded )
+{
+  // Rows are decoded on the decode pool's threads, the receive thread, and for frames decoded on access, the caller's;
+  // each keeps its own working rows from one frame to the next
+  thread_local VViconCGStreamVideo::VScratch s_Scratch;
+
+  if( i_rDecode.m_Format == ViconCGStream::VVideoFrame::EMono8 )
+  {
+    return VViconCGStreamVideo::ToMono( i_rVideoFrame.m_Format, i_rVideoFrame.m_Width, i_rVideoFrame.m_Height, i_rDecode.m_Window, i_BeginRow, i_EndRow,
+                                        &i_rVideoFrame.m_VideoData[ 0 ], o_pDecoded, s_Scratch );
+  }
+  return VViconCGStreamVideo::ToBGR( i_rVideoFrame.m_Format, i_rVideoFrame.m_Width, i_rVideoFrame.m_Height, i_rDecode.m_Window, i_BeginRow, i_EndRow,
+                                     &i_rVideoFrame.m_VideoData[ 0 ], o_pDecoded, s_Scratch );
+}
+
+std::shared_ptr< const ViconCGStream::VVideoFrame > VViconCGStreamClient::DecodeVideoFrame( const ViconCGStream::VVideoFrame& i_rVideoFrame,
+                                                                                         std::shared_ptr< const TVideoWindows > i_pWindows,
+                                                                                         std::weak_ptr< VCGStreamBufferPool > i_pPool )
+{
+  VVideoDecode Decode;
+  if( !PlanVideoDecode( i_rVideoFrame, *i_pWindows, Decode ) )
+  {
+    return nullptr;
+  }
+
+  std::shared_ptr< ViconCGStream::VVideoFrame > pDecoded = PooledVideoFrame( new ViconCGStream::VVideoFrame(), i_pPool );
+  if( std::shared_ptr< VCGStreamBufferPool > pPool = i_pPool.lock() )
+  {
+    pPool->Take( pDecoded->m_VideoData, Decode.m_Size );
+  }
+
+  SetDecodedHeader( i_rVideoFrame, Decode, *pDecoded );
+  pDecoded->m_VideoData.resize( Decode.m_Size );
+  if( !DecodeVideoRows( i_rVideoFrame, Decode, 0, Decode.m_Window.OutHeight(), &pDecoded->m_VideoData[ 0 ] ) )
+  {
+    return nullptr;
+  }
+  return pDecoded;
+}
+
+std::shared_ptr< ViconCGStream::VVideoFrame > VViconCGStreamClient::PooledVideoFrame( ViconCGStream::VVideoFrame* i_pVideoFrame, std::weak_ptr< VCGStreamBufferPool > i_pPool )
+{
+  return std::shared_ptr< ViconCGStream::VVideoFrame >( i_pVideoFrame, [ i_pPool ]( ViconCGStream::VVideoFrame* i_pFrame )
+  {
+    if( std::shared_ptr< VCGStreamBufferPool > pPool = i_pPool.lock() )
+    {
+      pPool->Give( std::move( i_pFrame->m_VideoData ) );
+    }
+    delete i_pFrame;
+  } );
+}
+
+std::shared_ptr< ViconCGStream::VVideoFrame > VViconCGStreamClient::NewVideoFrame( bool i_bDecodeOnAccess, std::shared_ptr< const TVideoWindows > i_pWindows ) const
+{
+  std::weak_ptr< VCGStreamBufferPool > pPool = m_pVideoBufferPool;
+  if( i_bDecodeOnAccess )
+  {
+    return PooledVideoFrame( new VCGStreamLazyVideoFrame( std::bind( &VViconCGStreamClient::DecodeVideoFrame, std::placeholders::_1, i_pWindows, pPool ) ), pPool );
+  }
+  return PooledVideoFrame( new ViconCGStream::VVideoFrame(), pPool );
+}
+
+void VViconCGStreamClient::DecodeVideo( ViconCGStream::VVideoFrame& io_rVideoFrame, const TVideoWindows& i_rWindows )
+{
+  VVideoDecode Decode;
+  if( !PlanVideoDecode( io_rVideoFrame, i_rWindows, Decode ) )
   {
     return;
   }
 
-  io_rVideoFrame.m_Format = ViconCGStream::VVideoFrame::EBGR888;
-  io_rVideoFrame.m_VideoData = m_ScratchVideo;
+  VCGStreamBufferPool::TBuffer Decoded;
+  m_pVideoBufferPool->Take( Decoded, Decode.m_Size );
+  Decoded.resize( Decode.m_Size );
+  if( !DecodeVideoRows( io_rVideoFrame, Decode, 0, Decode.m_Window.OutHeight(), &Decoded[ 0 ] ) )
+  {
+    m_pVideoBufferPool->Give( std::move( Decoded ) );
+    return;
+  }
+
+  SetDecodedHeader( io_rVideoFrame, Decode, io_rVideoFrame );
+  io_rVideoFrame.m_VideoData.swap( Decoded );
+  m_pVideoBufferPool->Give( std::move( Decoded ) );
+}
+
+bool VViconCGStreamClient::DecodeVideoStriped( std::shared_ptr< VPendingFrame > i_pFrame, std::shared_ptr< const ViconCGStream::VVideoFrame > i_pVideoFrame,
+                                               const TVideoWindows& i_rWindows, std::shared_ptr< ViconCGStream::VVideoFrame > o_pDecoded,
+                                               std::shared_ptr< std::atomic< bool > > o_pFailed )
+{
+  VVideoDecode Decode;
+  if( !PlanVideoDecode( *i_pVideoFrame, i_rWindows, Decode ) )
+  {
+    return false;
+  }
+
+  SetDecodedHeader( *i_pVideoFrame, Decode, *o_pDecoded );
+  m_pVideoBufferPool->Take( o_pDecoded->m_VideoData, Decode.m_Size );
+  o_pDecoded->m_VideoData.resize( Decode.m_Size );
+  ViconCGStreamType::UInt8* pDecoded = &o_pDecoded->m_VideoData[ 0 ];
+
+  // Stripes of fewer than this many rows cost more to hand off than they save
+  const unsigned int MinStripeRows = 64;
+  const unsigned int Height = Decode.m_Window.OutHeight();
+  const unsigned int Stripes = std::max( 1u, std::min( m_pDecodePool->ThreadCount(), Height / MinStripeRows ) );
+
+  // Each stripe writes its own rows of the output directly; the first is decoded here
+  for( unsigned int Stripe = 1; Stripe < Stripes; ++Stripe )
+  {
+    const unsigned int BeginRow = static_cast< unsigned int >( static_cast< size_t >( Height ) * Stripe / Stripes );
+    const unsigned int EndRow = static_cast< unsigned int >( static_cast< size_t >( Height ) * ( Stripe + 1 ) / Stripes );
+    // The rest of the frame is still good, so a stripe that fails only loses the decode
+    DeferWork( i_pFrame, [ i_pVideoFrame, Decode, o_pDecoded, o_pFailed, pDecoded, BeginRow, EndRow ]()
+    {
+      if( !DecodeVideoRows( *i_pVideoFrame, Decode, BeginRow, EndRow, pDecoded ) )
+      {
+        *o_pFailed = true;
+      }
+      return true;
+    } );
+  }
+
+  return DecodeVideoRows( *i_pVideoFrame, Decode, 0, static_cast< unsigned int >( static_cast< size_t >( Height ) / Stripes ), pDecoded );
 }
 
 //-------------------------------------------------------------------------------------------------
@@ -1590,16 +2100,6 @@ bool VViconCGStreamClient::CalculateNetworkLatency( double& o_rValue )
   return false;
 }
 
-void VViconCGStreamClient::TimingLogFunction( const unsigned int i_FrameNumber, const double i_rTimestamp )
-{
-  boost::mutex::scoped_lock Lock( m_LogMutex );
-
-  if( m_TimingLog.good() )
-  {
-    m_TimingLog << i_FrameNumber << ", " << i_rTimestamp << std::endl;
-  }
-}
-
 boost::asio::ip::address_v4 VViconCGStreamClient::FirstV4AddressFromString( const std::string& i_rAddress )
 {
   boost::system::error_code Error;
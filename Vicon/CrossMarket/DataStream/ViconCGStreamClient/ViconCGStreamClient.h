@@ -25,6 +25,9 @@
 #pragma once
 
 #include "IViconCGStreamClientCallback.h"
+#include "CGStreamTimingLog.h"
+#include "CGStreamBufferPool.h"
+#include "ViconCGStreamVideo.h"
 
 #include <boost/asio.hpp>
 
@@ -62,8 +65,7 @@
 #include <ViconCGStream/FrameInfo.h>
 #include <ViconCGStream/FrameRateInfo.h>
 #include <ViconCGStream/GlobalSegments.h>
-#include <ViconCGStream/GreyscaleBlobs.h>
-#include <ViconCGStream/GreyscaleSubsampledBlobs.h>
+#include <ViconCGStream/GreyscaleBlobsPacked.h>
 #include <ViconCGStream/HardwareFrameInfo.h>
 #include <ViconCGStream/LabeledReconRayAssignments.h>
 #include <ViconCGStream/LabeledRecons.h>
@@ -77,9 +79,12 @@
 #include <ViconCGStream/VoltageFrame.h>
 
 #include <boost/optional.hpp>
+#include <boost/thread/condition.hpp>
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/thread.hpp>
+#include <atomic>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <string>
 #include <chrono>
@@ -87,7 +92,14 @@
 
 class VCGStreamReaderWriter;
 class VCGStreamPing;
-class VCGStreamPostalService;
+class VCGStreamDecodePool;
+class VPendingFrame;
+
+namespace ViconCGStreamIO
+{
+  class VBuffer;
+  class VScopedReader;
+}
 
 //-------------------------------------------------------------------------------------------------
 
@@ -167,6 +179,7 @@ public:
   ViconCGStream::VTimecode m_Timecode;
   ViconCGStream::VLatencyInfo m_LatencyInfo;
   ViconCGStream::VFrameRateInfo m_FrameRateInfo;
+  std::chrono::steady_clock::time_point m_ReceiptTime;
   ViconCGStream::VLabeledRecons m_LabeledRecons;
   ViconCGStream::VUnlabeledRecons m_UnlabeledRecons;
   ViconCGStream::VLabeledReconRayAssignments m_LabeledRayAssignments;
@@ -177,8 +190,8 @@ public:
   std::vector< ViconCGStream::VLocalSegments > m_LocalSegments;
   std::vector< ViconCGStream::VGlobalSegments > m_GlobalSegments;
   std::vector< ViconCGStream::VLightweightSegments > m_LightweightSegments;
-  std::vector< ViconCGStream::VGreyscaleBlobs > m_GreyscaleBlobs;
-  std::vector< ViconCGStream::VGreyscaleSubsampledBlobs > m_GreyscaleSubsampledBlobs;
+  std::vector< std::shared_ptr< const ViconCGStream::VGreyscaleBlobsPacked > > m_GreyscaleBlobs;
+  std::vector< std::shared_ptr< const ViconCGStream::VGreyscaleBlobsPacked > > m_GreyscaleSubsampledBlobs;
   std::vector< ViconCGStream::VEdgePairs > m_EdgePairs;
   std::vector< ViconCGStream::VForceFrame > m_ForceFrames;
   std::vector< ViconCGStream::VMomentFrame > m_MomentFrames;
@@ -195,8 +208,6 @@ public:
   ViconCGStream::VLocalSegments& AddLocalSegments();
   ViconCGStream::VGlobalSegments& AddGlobalSegments();
   ViconCGStream::VLightweightSegments& AddLightweightSegments();
-  ViconCGStream::VGreyscaleBlobs& AddGreyscaleBlobs();
-  ViconCGStream::VGreyscaleSubsampledBlobs& AddGreyscaleSubsampledBlobs();
   ViconCGStream::VEdgePairs& AddEdgePairs();
   ViconCGStream::VForceFrame& AddForceFrame();
   ViconCGStream::VMomentFrame& AddMomentFrame();
@@ -236,13 +247,29 @@ public:
   // Returns whether the object type is supported by the server
   bool ObjectIsSupported( const ViconCGStreamType::Enum & i_rObjectType );
 
+  // Bytes received by object type over the life of the client, counting block bodies but not their headers.
+  // Each frame is tallied without allocating and merged in once read; the map only grows when a new type first arrives.
+  typedef std::map< ViconCGStreamType::Enum, ViconCGStreamType::UInt64 > TBytesReceived;
+  void GetBytesReceived( TBytesReceived & o_rBytesReceived ) const;
+
   enum EVideoHint
   {
     EPassThrough,
-    EDecode
+    EDecode,
+    // Video frames keep their data as received and are decoded when first asked for; see VCGStreamLazyVideoFrame
+    EDecodeOnAccess
   };
   void SetVideoHint( EVideoHint i_VideoHint );
-  bool SetTimingLogFile( const std::string & i_rFilename );
+
+  // Decode only a window of one camera's video, binned as it asks; the default window restores whole frames.
+  // Decoded frames carry the size of the window after binning, and their position is that of the window in the frame.
+  void SetVideoWindow( unsigned int i_CameraID, const VViconCGStreamVideo::VWindow & i_rWindow );
+
+  // Set the number of threads used to decode heavy objects (centroids, greyscale, video and ray assignments).
+  // When zero, all objects are decoded on the socket thread.
+  void SetDecodeThreadCount( unsigned int i_ThreadCount );
+  // Log the receipt time of each frame; a binary log can be converted to text with ViconDataStreamSDKTimingLogToCSV
+  bool SetTimingLogFile( const std::string & i_rFilename, bool i_bBinary = false );
   std::string HostName() const;
 
 protected:
@@ -255,7 +282,58 @@ protected:
   void CopyObjects( const ViconCGStream::VContents& i_rContents, const VStaticObjects& i_rStaticObjects, VStaticObjects& o_rStaticObjects ) const;
   void CopyObjects( const ViconCGStream::VContents& i_rContents, const VDynamicObjects& i_rDynamicObjects, VDynamicObjects& o_rDynamicObjects ) const;
 
-  void DecodeVideo( ViconCGStream::VVideoFrame& io_rVideoFrame );
+  void DispatchObjects( bool i_bContents, const ViconCGStream::VContents& i_rContents, std::shared_ptr< VStaticObjects > i_pStaticObjects, std::shared_ptr< VDynamicObjects > i_pDynamicObjects );
+
+  // Hand the block off to the decode pool; i_rMerge is applied to the frame's dynamic objects, in stream order, once decoded.
+  bool DeferRead( const ViconCGStreamIO::VScopedReader& i_rObject, std::shared_ptr< VPendingFrame > i_pFrame,
+                  const std::function< bool( const ViconCGStreamIO::VBuffer& ) >& i_rRead,
+                  const std::function< void( VDynamicObjects& ) >& i_rMerge );
+  template< typename T >
+  bool DeferRead( const ViconCGStreamIO::VScopedReader& i_rObject, std::shared_ptr< VPendingFrame > i_pFrame, T& ( VDynamicObjects::*i_pAdd )() );
+  void DecodeBlock( std::shared_ptr< VPendingFrame > i_pFrame, std::shared_ptr< const ViconCGStreamIO::VBuffer > i_pBlock,
+                    const std::function< bool( const ViconCGStreamIO::VBuffer& ) >& i_rRead );
+  // Run further work for a frame on the decode pool; may be called from a decode thread while the frame is still outstanding.
+  void DeferWork( std::shared_ptr< VPendingFrame > i_pFrame, const std::function< bool() >& i_rWork );
+  void CompleteWork( std::shared_ptr< VPendingFrame > i_pFrame, bool i_bOk );
+  void UpdateDecodePool();
+  void StopDecodePool();
+  void AssemblyThread();
+
+  typedef std::map< unsigned int, VViconCGStreamVideo::VWindow > TVideoWindows;
+
+  // How a video frame is to be decoded
+  struct VVideoDecode
+  {
+    VViconCGStreamVideo::VWindow m_Window;
+    unsigned int m_Format;
+    size_t m_Size;
+  };
+
+  // Video is decoded to Mono8 if it only carries luminance and to BGR888 otherwise, within the window set for its camera;
+  // false if the frame is not to be decoded.
+  static bool PlanVideoDecode( const ViconCGStream::VVideoFrame& i_rVideoFrame, const TVideoWindows& i_rWindows, VVideoDecode& o_rDecode );
+  // The header of the decoded frame; o_rDecoded may be the frame itself.
+  static void SetDecodedHeader( const ViconCGStream::VVideoFrame& i_rVideoFrame, const VVideoDecode& i_rDecode, ViconCGStream::VVideoFrame& o_rDecoded );
+  // Decode output rows [ i_BeginRow, i_EndRow ) of a video frame.
+  static bool DecodeVideoRows( const ViconCGStream::VVideoFrame& i_rVideoFrame, const VVideoDecode& i_rDecode, unsigned int i_BeginRow, unsigned int i_EndRow,
+                               ViconCGStreamType::UInt8* o_pDecoded );
+  // Decode a copy of a video frame, for VCGStreamLazyVideoFrame; null if it cannot be decoded.
+  static std::shared_ptr< const ViconCGStream::VVideoFrame > DecodeVideoFrame( const ViconCGStream::VVideoFrame& i_rVideoFrame,
+                                                                               std::shared_ptr< const TVideoWindows > i_pWindows,
+                                                                               std::weak_ptr< VCGStreamBufferPool > i_pPool );
+  // Take ownership of a video frame whose data is given back to the pool when the last reference to it is released.
+  // The pool is only weakly held, as frames handed to the application may outlive the client.
+  static std::shared_ptr< ViconCGStream::VVideoFrame > PooledVideoFrame( ViconCGStream::VVideoFrame* i_pVideoFrame, std::weak_ptr< VCGStreamBufferPool > i_pPool );
+  std::shared_ptr< ViconCGStream::VVideoFrame > NewVideoFrame( bool i_bDecodeOnAccess, std::shared_ptr< const TVideoWindows > i_pWindows ) const;
+  // Decode a video frame in place.
+  void DecodeVideo( ViconCGStream::VVideoFrame& io_rVideoFrame, const TVideoWindows& i_rWindows );
+  // Decode a video frame into o_pDecoded in row stripes spread across the decode pool. The frame is left unchanged,
+  // as is o_pDecoded if the frame is not to be decoded. Returns false if the stripe decoded here fails; a deferred
+  // stripe that fails sets o_pFailed instead, so o_pDecoded is only complete once the frame's work is done and
+  // neither has failed.
+  bool DecodeVideoStriped( std::shared_ptr< VPendingFrame > i_pFrame, std::shared_ptr< const ViconCGStream::VVideoFrame > i_pVideoFrame,
+                           const TVideoWindows& i_rWindows, std::shared_ptr< ViconCGStream::VVideoFrame > o_pDecoded,
+                           std::shared_ptr< std::atomic< bool > > o_pFailed );
 
   void OnConnect() const;
   void OnStaticObjects( std::shared_ptr< const VStaticObjects > i_pStaticObjects ) const;
@@ -263,7 +341,6 @@ protected:
   void OnDisconnect() const;
 
   bool CalculateNetworkLatency( double& o_rValue );
-  void TimingLogFunction( const unsigned int i_FrameNumber, const double i_rTimestamp );
   void CloseLog();
 
   boost::asio::ip::address_v4 FirstV4AddressFromString( const std::string& i_rAddress );
@@ -297,11 +374,24 @@ protected:
   std::deque< double > m_PingRoundTrips;
 
   EVideoHint m_VideoHint;
-  std::vector< unsigned char > m_ScratchVideo;
+  // Replaced rather than changed, so that frames being decoded keep the windows they started with
+  std::shared_ptr< const TVideoWindows > m_pVideoWindows;
   std::set< unsigned int > m_OnDeviceList;
 
-  std::shared_ptr< VCGStreamPostalService > m_pPostalService;
-  std::ofstream m_TimingLog;
-  boost::mutex m_LogMutex;
+  mutable boost::mutex m_BytesReceivedMutex;
+  TBytesReceived m_BytesReceived;
+
+  // Decode pool and in-order assembly of frames handed off to it
+  unsigned int m_DecodeThreadCount;
+  std::shared_ptr< VCGStreamDecodePool > m_pDecodePool;
+  std::shared_ptr< boost::thread > m_pAssemblyThread;
+  boost::mutex m_DecodeMutex;
+  boost::condition m_DecodeCondition;
+  std::deque< std::shared_ptr< VPendingFrame > > m_PendingFrames;
+  bool m_bStopAssembly;
+
+  std::shared_ptr< VCGStreamBufferPool > m_pVideoBufferPool;
+
+  VCGStreamRecordLog< VCGStreamTimingRecord > m_TimingLog;
   std::string m_HostName;
 };
@@ -0,0 +1,978 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include "ViconCGStreamVideo.h"
+#include "ViconCGStreamBayer.h"
+#include "CGStreamSIMD.h"
+
+#include <ViconCGStream/VideoFrame.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// What we assume of the formats which are not simply bytes:
+//
+// - 6 and 7 bit formats carry one sample per byte, in the low bits, and are scaled up to 8 bits.
+// - R5G6B5 and the 10 bit samples of U10Y10V10Y10 are little endian 16 bit words.
+// - YUV is full range BT.601, with one U and one V for each pair of pixels along a row.
+//
+// As with the Bayer conversions, the SSSE3 kernels give exactly the same output as the portable ones; the portable
+// YUV arithmetic is written in the 16 bit steps which the SSSE3 kernel takes.
+
+namespace
+{
+  typedef ViconCGStream::VVideoFrame VVideoFrame;
+
+  // Each converts one row of i_Width pixels
+  typedef void ( *TRowFunction )( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pOutRow );
+
+  // Scale a sample of t_Bits up to 8 bits by repeating its top bits below it
+  template< unsigned int t_Bits >
+  inline unsigned char Expand( unsigned int i_Sample )
+  {
+    const unsigned int Sample = i_Sample & ( ( 1u << t_Bits ) - 1 );
+    return static_cast< unsigned char >( ( Sample << ( 8 - t_Bits ) ) | ( Sample >> ( 2 * t_Bits - 8 ) ) );
+  }
+
+  template<>
+  inline unsigned char Expand< 8 >( unsigned int i_Sample )
+  {
+    return static_cast< unsigned char >( i_Sample );
+  }
+
+  template< unsigned int t_Bits >
+  void ExpandSamples( unsigned char * io_pSamples, size_t i_Count )
+  {
+    for( size_t Index = 0; Index < i_Count; ++Index )
+    {
+      io_pSamples[ Index ] = Expand< t_Bits >( io_pSamples[ Index ] );
+    }
+  }
+
+  // BT.601 luminance, in 8 bit fixed point
+  inline unsigned char Luma( unsigned int i_Blue, unsigned int i_Green, unsigned int i_Red )
+  {
+    return static_cast< unsigned char >( ( 29 * i_Blue + 150 * i_Green + 77 * i_Red + 128 ) >> 8 );
+  }
+
+  inline unsigned char Clamp( int i_Value )
+  {
+    return static_cast< unsigned char >( std::min( std::max( i_Value, 0 ), 255 ) );
+  }
+
+  // Full range BT.601 coefficients, with 12 fractional bits
+  const int s_UToBlue = 7258;
+  const int s_UToGreen = -1410;
+  const int s_VToGreen = -2925;
+  const int s_VToRed = 5743;
+
+  // The contribution of a chroma sample of t_Bits, with 3 fractional bits. The centred sample is scaled to fill
+  // 16 bits and only the top 16 bits of the product are kept, which is what _mm_mulhi_epi16 gives.
+  template< unsigned int t_Bits >
+  inline int Chroma( int i_Sample, int i_Coefficient )
+  {
+    return ( ( i_Sample - ( 1 << ( t_Bits - 1 ) ) ) * ( 1 << ( 15 - t_Bits ) ) * i_Coefficient ) >> 16;
+  }
+
+  // A luminance sample of t_Bits, with 3 fractional bits and the rounding for the final shift
+  template< unsigned int t_Bits >
+  inline int Luminance( int i_Sample )
+  {
+    return ( i_Sample << ( 11 - t_Bits ) ) + 4;
+  }
+
+  // Sample i_Index of a row of t_Bits samples
+  template< unsigned int t_Bits >
+  inline int Sample( const unsigned char * i_pRow, unsigned int i_Index );
+
+  template<>
+  inline int Sample< 8 >( const unsigned char * i_pRow, unsigned int i_Index )
+  {
+    return i_pRow[ i_Index ];
+  }
+
+  template<>
+  inline int Sample< 10 >( const unsigned char * i_pRow, unsigned int i_Index )
+  {
+    return ( i_pRow[ 2 * i_Index ] | ( i_pRow[ 2 * i_Index + 1 ] << 8 ) ) & 0x3FF;
+  }
+
+  //-----------------------------------------------------------------------------------------------
+  // Portable rows to BGR
+
+  template< unsigned int t_Bits >
+  void MonoRowToBGR( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    for( unsigned int X = 0; X < i_Width; ++X, o_pBGRRow += 3 )
+    {
+      const unsigned char Value = Expand< t_Bits >( i_pRow[ X ] );
+      o_pBGRRow[ 0 ] = Value;
+      o_pBGRRow[ 1 ] = Value;
+      o_pBGRRow[ 2 ] = Value;
+    }
+  }
+
+  // 8 bit colour with t_Stride bytes per pixel, red at byte t_Red and blue at byte 2 - t_Red
+  template< unsigned int t_Stride, unsigned int t_Red >
+  void PackedRowToBGR( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    for( unsigned int X = 0; X < i_Width; ++X, i_pRow += t_Stride, o_pBGRRow += 3 )
+    {
+      o_pBGRRow[ 0 ] = i_pRow[ 2 - t_Red ];
+      o_pBGRRow[ 1 ] = i_pRow[ 1 ];
+      o_pBGRRow[ 2 ] = i_pRow[ t_Red ];
+    }
+  }
+
+  void R5G6B5RowToBGR( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    for( unsigned int X = 0; X < i_Width; ++X, i_pRow += 2, o_pBGRRow += 3 )
+    {
+      const unsigned int Pixel = i_pRow[ 0 ] | ( i_pRow[ 1 ] << 8 );
+      o_pBGRRow[ 0 ] = Expand< 5 >( Pixel );
+      o_pBGRRow[ 1 ] = Expand< 6 >( Pixel >> 5 );
+      o_pBGRRow[ 2 ] = Expand< 5 >( Pixel >> 11 );
+    }
+  }
+
+  // A pair of pixels sharing U and V, all of t_Bits
+  template< unsigned int t_Bits >
+  inline void YUVPairToBGR( int i_Y0, int i_Y1, int i_U, int i_V, unsigned char * o_pBGR )
+  {
+    const int Blue = Chroma< t_Bits >( i_U, s_UToBlue );
+    const int Green = Chroma< t_Bits >( i_U, s_UToGreen ) + Chroma< t_Bits >( i_V, s_VToGreen );
+    const int Red = Chroma< t_Bits >( i_V, s_VToRed );
+    const int Y0 = Luminance< t_Bits >( i_Y0 );
+    const int Y1 = Luminance< t_Bits >( i_Y1 );
+
+    o_pBGR[ 0 ] = Clamp( ( Y0 + Blue ) >> 3 );
+    o_pBGR[ 1 ] = Clamp( ( Y0 + Green ) >> 3 );
+    o_pBGR[ 2 ] = Clamp( ( Y0 + Red ) >> 3 );
+    o_pBGR[ 3 ] = Clamp( ( Y1 + Blue ) >> 3 );
+    o_pBGR[ 4 ] = Clamp( ( Y1 + Green ) >> 3 );
+    o_pBGR[ 5 ] = Clamp( ( Y1 + Red ) >> 3 );
+  }
+
+  // Groups of four samples, at offsets t_Y0, t_U, t_Y1 and t_V, each give two pixels
+  template< unsigned int t_Bits, unsigned int t_Y0, unsigned int t_U, unsigned int t_Y1, unsigned int t_V >
+  void YUVRowToBGR( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    unsigned int X = 0;
+    for( ; X + 1 < i_Width; X += 2, o_pBGRRow += 6 )
+    {
+      const unsigned int Group = X * 2;
+      YUVPairToBGR< t_Bits >( Sample< t_Bits >( i_pRow, Group + t_Y0 ), Sample< t_Bits >( i_pRow, Group + t_Y1 ),
+                              Sample< t_Bits >( i_pRow, Group + t_U ), Sample< t_Bits >( i_pRow, Group + t_V ), o_pBGRRow );
+    }
+
+    // An odd width leaves half a pair
+    if( X < i_Width )
+    {
+      unsigned char Pair[ 6 ];
+      const unsigned int Group = X * 2;
+      YUVPairToBGR< t_Bits >( Sample< t_Bits >( i_pRow, Group + t_Y0 ), 0,
+                              Sample< t_Bits >( i_pRow, Group + t_U ), Sample< t_Bits >( i_pRow, Group + t_V ), Pair );
+      std::memcpy( o_pBGRRow, Pair, 3 );
+    }
+  }
+
+  //-----------------------------------------------------------------------------------------------
+  // Portable rows to greyscale
+
+  template< unsigned int t_Bits >
+  void MonoRowToMono( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pMonoRow )
+  {
+    for( unsigned int X = 0; X < i_Width; ++X )
+    {
+      o_pMonoRow[ X ] = Expand< t_Bits >( i_pRow[ X ] );
+    }
+  }
+
+  template<>
+  void MonoRowToMono< 8 >( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pMonoRow )
+  {
+    std::memcpy( o_pMonoRow, i_pRow, i_Width );
+  }
+
+  // Luminance is the Y samples, at t_Y0 and t_Y1 of each group of four
+  template< unsigned int t_Bits, unsigned int t_Y0, unsigned int t_Y1 >
+  void YUVRowToMono( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pMonoRow )
+  {
+    for( unsigned int X = 0; X < i_Width; ++X )
+    {
+      const unsigned int Index = ( X & ~1u ) * 2 + ( ( X & 1 ) ? t_Y1 : t_Y0 );
+      o_pMonoRow[ X ] = static_cast< unsigned char >( Sample< t_Bits >( i_pRow, Index ) >> ( t_Bits - 8 ) );
+    }
+  }
+
+  void BGRRowToMono( const unsigned char * i_pBGRRow, unsigned int i_Width, unsigned char * o_pMonoRow )
+  {
+    for( unsigned int X = 0; X < i_Width; ++X, i_pBGRRow += 3 )
+    {
+      o_pMonoRow[ X ] = Luma( i_pBGRRow[ 0 ], i_pBGRRow[ 1 ], i_pBGRRow[ 2 ] );
+    }
+  }
+
+#ifdef VICON_CGSTREAM_X86
+
+  using ViconCGStreamSIMD::StoreBGR;
+
+  // Expand on 16 samples of t_Bits
+  template< unsigned int t_Bits >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i ExpandBytes( __m128i i_Samples )
+  {
+    const __m128i Samples = _mm_and_si128( i_Samples, _mm_set1_epi8( static_cast< char >( ( 1 << t_Bits ) - 1 ) ) );
+    const __m128i High = _mm_slli_epi16( Samples, 8 - t_Bits );
+    const __m128i Low = _mm_and_si128( _mm_srli_epi16( Samples, 2 * t_Bits - 8 ), _mm_set1_epi8( static_cast< char >( 0xFF >> ( 2 * t_Bits - 8 ) ) ) );
+    return _mm_or_si128( High, Low );
+  }
+
+  // Expand on 8 samples of t_Bits, in 16 bit lanes
+  template< unsigned int t_Bits >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i ExpandWords( __m128i i_Samples )
+  {
+    return _mm_or_si128( _mm_slli_epi16( i_Samples, 8 - t_Bits ), _mm_srli_epi16( i_Samples, 2 * t_Bits - 8 ) );
+  }
+
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i Load( const unsigned char * i_pData )
+  {
+    return _mm_loadu_si128( reinterpret_cast< const __m128i * >( i_pData ) );
+  }
+
+  template< unsigned int t_Bits >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  void ExpandSamplesSSSE3( unsigned char * io_pSamples, size_t i_Count )
+  {
+    size_t Index = 0;
+    for( ; Index + 16 <= i_Count; Index += 16 )
+    {
+      __m128i * pSamples = reinterpret_cast< __m128i * >( io_pSamples + Index );
+      _mm_storeu_si128( pSamples, ExpandBytes< t_Bits >( _mm_loadu_si128( pSamples ) ) );
+    }
+
+    ExpandSamples< t_Bits >( io_pSamples + Index, i_Count - Index );
+  }
+
+  template< unsigned int t_Bits >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  void MonoRowToBGRSSSE3( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    unsigned int X = 0;
+    for( ; X + 16 <= i_Width; X += 16 )
+    {
+      __m128i Value = Load( i_pRow + X );
+      if( t_Bits != 8 )
+      {
+        Value = ExpandBytes< t_Bits >( Value );
+      }
+      StoreBGR( Value, Value, Value, o_pBGRRow + X * 3 );
+    }
+
+    MonoRowToBGR< t_Bits >( i_pRow + X, i_Width - X, o_pBGRRow + X * 3 );
+  }
+
+  template< unsigned int t_Stride, unsigned int t_Red >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  void PackedRowToBGRSSSE3( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    // Four pixels from each 16 bytes read, packed into the low 12 bytes
+    const __m128i Mask = _mm_setr_epi8( 2 - t_Red, 1, t_Red,
+                                        t_Stride + 2 - t_Red, t_Stride + 1, t_Stride + t_Red,
+                                        2 * t_Stride + 2 - t_Red, 2 * t_Stride + 1, 2 * t_Stride + t_Red,
+                                        3 * t_Stride + 2 - t_Red, 3 * t_Stride + 1, 3 * t_Stride + t_Red,
+                                        -1, -1, -1, -1 );
+
+    // The last 16 bytes read must lie within the row
+    unsigned int X = 0;
+    for( ; ( X + 12 ) * t_Stride + 16 <= i_Width * t_Stride; X += 16 )
+    {
+      const unsigned char * pIn = i_pRow + X * t_Stride;
+      const __m128i Pixels0 = _mm_shuffle_epi8( Load( pIn ), Mask );
+      const __m128i Pixels1 = _mm_shuffle_epi8( Load( pIn + 4 * t_Stride ), Mask );
+      const __m128i Pixels2 = _mm_shuffle_epi8( Load( pIn + 8 * t_Stride ), Mask );
+      const __m128i Pixels3 = _mm_shuffle_epi8( Load( pIn + 12 * t_Stride ), Mask );
+
+      __m128i * pOut = reinterpret_cast< __m128i * >( o_pBGRRow + X * 3 );
+      _mm_storeu_si128( pOut, _mm_or_si128( Pixels0, _mm_slli_si128( Pixels1, 12 ) ) );
+      _mm_storeu_si128( pOut + 1, _mm_or_si128( _mm_srli_si128( Pixels1, 4 ), _mm_slli_si128( Pixels2, 8 ) ) );
+      _mm_storeu_si128( pOut + 2, _mm_or_si128( _mm_srli_si128( Pixels2, 8 ), _mm_slli_si128( Pixels3, 4 ) ) );
+    }
+
+    PackedRowToBGR< t_Stride, t_Red >( i_pRow + X * t_Stride, i_Width - X, o_pBGRRow + X * 3 );
+  }
+
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  void R5G6B5RowToBGRSSSE3( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    const __m128i FiveBits = _mm_set1_epi16( 0x1F );
+    const __m128i SixBits = _mm_set1_epi16( 0x3F );
+
+    unsigned int X = 0;
+    for( ; X + 16 <= i_Width; X += 16 )
+    {
+      __m128i Blue[ 2 ], Green[ 2 ], Red[ 2 ];
+      for( unsigned int Half = 0; Half < 2; ++Half )
+      {
+        const __m128i Pixels = Load( i_pRow + ( X + Half * 8 ) * 2 );
+        Blue[ Half ] = ExpandWords< 5 >( _mm_and_si128( Pixels, FiveBits ) );
+        Green[ Half ] = ExpandWords< 6 >( _mm_and_si128( _mm_srli_epi16( Pixels, 5 ), SixBits ) );
+        Red[ Half ] = ExpandWords< 5 >( _mm_srli_epi16( Pixels, 11 ) );
+      }
+
+      StoreBGR( _mm_packus_epi16( Blue[ 0 ], Blue[ 1 ] ), _mm_packus_epi16( Green[ 0 ], Green[ 1 ] ), _mm_packus_epi16( Red[ 0 ], Red[ 1 ] ),
+                o_pBGRRow + X * 3 );
+    }
+
+    R5G6B5RowToBGR( i_pRow + X * 2, i_Width - X, o_pBGRRow + X * 3 );
+  }
+
+  // For each of 8 pixels, the byte at i_Even or i_Odd within its group of four, as a 16 bit lane
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i PairMask( char i_Even, char i_Odd )
+  {
+    return _mm_setr_epi8( i_Even, -1, i_Odd, -1, 4 + i_Even, -1, 4 + i_Odd, -1, 8 + i_Even, -1, 8 + i_Odd, -1, 12 + i_Even, -1, 12 + i_Odd, -1 );
+  }
+
+  // For each of 4 pixels, the 16 bit word at i_Even or i_Odd within its group of four, in the low 8 bytes
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline __m128i WordPairMask( char i_Even, char i_Odd )
+  {
+    return _mm_setr_epi8( 2 * i_Even, 2 * i_Even + 1, 2 * i_Odd, 2 * i_Odd + 1, 8 + 2 * i_Even, 9 + 2 * i_Even, 8 + 2 * i_Odd, 9 + 2 * i_Odd,
+                          -1, -1, -1, -1, -1, -1, -1, -1 );
+  }
+
+  // Blue, green and red of 8 pixels, as 16 bit lanes, from their samples of t_Bits; the same arithmetic as YUVPairToBGR
+  template< unsigned int t_Bits >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  inline void YUVWordsToBGR( __m128i i_Y, __m128i i_U, __m128i i_V, __m128i & o_rBlue, __m128i & o_rGreen, __m128i & o_rRed )
+  {
+    const __m128i Centre = _mm_set1_epi16( 1 << ( t_Bits - 1 ) );
+    const __m128i Y = _mm_add_epi16( _mm_slli_epi16( i_Y, 11 - t_Bits ), _mm_set1_epi16( 4 ) );
+    const __m128i U = _mm_slli_epi16( _mm_sub_epi16( i_U, Centre ), 15 - t_Bits );
+    const __m128i V = _mm_slli_epi16( _mm_sub_epi16( i_V, Centre ), 15 - t_Bits );
+
+    o_rBlue = _mm_srai_epi16( _mm_add_epi16( Y, _mm_mulhi_epi16( U, _mm_set1_epi16( s_UToBlue ) ) ), 3 );
+    o_rGreen = _mm_srai_epi16( _mm_add_epi16( Y, _mm_add_epi16( _mm_mulhi_epi16( U, _mm_set1_epi16( s_UToGreen ) ),
+                                                                _mm_mulhi_epi16( V, _mm_set1_epi16( s_VToGreen ) ) ) ), 3 );
+    o_rRed = _mm_srai_epi16( _mm_add_epi16( Y, _mm_mulhi_epi16( V, _mm_set1_epi16( s_VToRed ) ) ), 3 );
+  }
+
+  template< unsigned int t_Y0, unsigned int t_U, unsigned int t_Y1, unsigned int t_V >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  void YUV8RowToBGRSSSE3( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    const __m128i YMask = PairMask( t_Y0, t_Y1 );
+    const __m128i UMask = PairMask( t_U, t_U );
+    const __m128i VMask = PairMask( t_V, t_V );
+
+    unsigned int X = 0;
+    for( ; X + 16 <= i_Width; X += 16 )
+    {
+      __m128i Blue[ 2 ], Green[ 2 ], Red[ 2 ];
+      for( unsigned int Half = 0; Half < 2; ++Half )
+      {
+        const __m128i Groups = Load( i_pRow + ( X + Half * 8 ) * 2 );
+        YUVWordsToBGR< 8 >( _mm_shuffle_epi8( Groups, YMask ), _mm_shuffle_epi8( Groups, UMask ), _mm_shuffle_epi8( Groups, VMask ),
+                            Blue[ Half ], Green[ Half ], Red[ Half ] );
+      }
+
+      StoreBGR( _mm_packus_epi16( Blue[ 0 ], Blue[ 1 ] ), _mm_packus_epi16( Green[ 0 ], Green[ 1 ] ), _mm_packus_epi16( Red[ 0 ], Red[ 1 ] ),
+                o_pBGRRow + X * 3 );
+    }
+
+    YUVRowToBGR< 8, t_Y0, t_U, t_Y1, t_V >( i_pRow + X * 2, i_Width - X, o_pBGRRow + X * 3 );
+  }
+
+  template< unsigned int t_Y0, unsigned int t_U, unsigned int t_Y1, unsigned int t_V >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  void YUV10RowToBGRSSSE3( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pBGRRow )
+  {
+    const __m128i YMask = WordPairMask( t_Y0, t_Y1 );
+    const __m128i UMask = WordPairMask( t_U, t_U );
+    const __m128i VMask = WordPairMask( t_V, t_V );
+    const __m128i TenBits = _mm_set1_epi16( 0x3FF );
+
+    unsigned int X = 0;
+    for( ; X + 16 <= i_Width; X += 16 )
+    {
+      __m128i Blue[ 2 ], Green[ 2 ], Red[ 2 ];
+      for( unsigned int Half = 0; Half < 2; ++Half )
+      {
+        // Four pixels from each 16 bytes read
+        const __m128i Groups0 = Load( i_pRow + ( X + Half * 8 ) * 4 );
+        const __m128i Groups1 = Load( i_pRow + ( X + Half * 8 ) * 4 + 16 );
+        const __m128i Y = _mm_and_si128( _mm_unpacklo_epi64( _mm_shuffle_epi8( Groups0, YMask ), _mm_shuffle_epi8( Groups1, YMask ) ), TenBits );
+        const __m128i U = _mm_and_si128( _mm_unpacklo_epi64( _mm_shuffle_epi8( Groups0, UMask ), _mm_shuffle_epi8( Groups1, UMask ) ), TenBits );
+        const __m128i V = _mm_and_si128( _mm_unpacklo_epi64( _mm_shuffle_epi8( Groups0, VMask ), _mm_shuffle_epi8( Groups1, VMask ) ), TenBits );
+        YUVWordsToBGR< 10 >( Y, U, V, Blue[ Half ], Green[ Half ], Red[ Half ] );
+      }
+
+      StoreBGR( _mm_packus_epi16( Blue[ 0 ], Blue[ 1 ] ), _mm_packus_epi16( Green[ 0 ], Green[ 1 ] ), _mm_packus_epi16( Red[ 0 ], Red[ 1 ] ),
+                o_pBGRRow + X * 3 );
+    }
+
+    YUVRowToBGR< 10, t_Y0, t_U, t_Y1, t_V >( i_pRow + X * 4, i_Width - X, o_pBGRRow + X * 3 );
+  }
+
+  template< unsigned int t_Bits >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  void MonoRowToMonoSSSE3( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pMonoRow )
+  {
+    unsigned int X = 0;
+    for( ; X + 16 <= i_Width; X += 16 )
+    {
+      _mm_storeu_si128( reinterpret_cast< __m128i * >( o_pMonoRow + X ), ExpandBytes< t_Bits >( Load( i_pRow + X ) ) );
+    }
+
+    MonoRowToMono< t_Bits >( i_pRow + X, i_Width - X, o_pMonoRow + X );
+  }
+
+  template< unsigned int t_Y0, unsigned int t_Y1 >
+  VICON_CGSTREAM_TARGET( "ssse3" )
+  void YUV8RowToMonoSSSE3( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pMonoRow )
+  {
+    // The 8 Y samples of each 16 bytes read, in the low 8 bytes
+    const __m128i Mask = _mm_setr_epi8( t_Y0, t_Y1, 4 + t_Y0, 4 + t_Y1, 8 + t_Y0, 8 + t_Y1, 12 + t_Y0, 12 + t_Y1, -1, -1, -1, -1, -1, -1, -1, -1 );
+
+    unsigned int X = 0;
+    for( ; X + 16 <= i_Width; X += 16 )
+    {
+      const __m128i Low = _mm_shuffle_epi8( Load( i_pRow + X * 2 ), Mask );
+      const __m128i High = _mm_shuffle_epi8( Load( i_pRow + X * 2 + 16 ), Mask );
+      _mm_storeu_si128( reinterpret_cast< __m128i * >( o_pMonoRow + X ), _mm_unpacklo_epi64( Low, High ) );
+    }
+
+    YUVRowToMono< 8, t_Y0, t_Y1 >( i_pRow + X * 2, i_Width - X, o_pMonoRow + X );
+  }
+
+#endif // VICON_CGSTREAM_X86
+
+  bool UseSSSE3()
+  {
+#ifdef VICON_CGSTREAM_X86
+    return VViconCGStreamBayer::SupportedInstructionSet() >= VViconCGStreamBayer::ESSSE3;
+#else
+    return false;
+#endif
+  }
+
+  //-----------------------------------------------------------------------------------------------
+
+  // Bytes in one row of a frame
+  size_t RowSize( unsigned int i_Format, unsigned int i_Width )
+  {
+    switch( i_Format )
+    {
+    case VVideoFrame::EMono8:
+    case VVideoFrame::EBayerRG8:
+    case VVideoFrame::EBayerGB8:
+    case VVideoFrame::EBayerGR8:
+    case VVideoFrame::EBayerBG8:
+    case VVideoFrame::EBayerGB7:
+    case VVideoFrame::EBayerGB6:
+    case VVideoFrame::ELuminance7:
+    case VVideoFrame::ELuminance6:
+      return i_Width;
+    case VVideoFrame::ER5G6B5:
+      return static_cast< size_t >( i_Width ) * 2;
+    case VVideoFrame::ERGB888:
+    case VVideoFrame::EBGR888:
+      return static_cast< size_t >( i_Width ) * 3;
+    case VVideoFrame::ER8G8B8u8:
+    case VVideoFrame::EB8G8R8u8:
+      return static_cast< size_t >( i_Width ) * 4;
+    case VVideoFrame::EU8Y8V8Y8:
+    case VVideoFrame::EY8U8Y8V8:
+      return ( static_cast< size_t >( i_Width ) + 1 ) / 2 * 4;
+    case VVideoFrame::EU10Y10V10Y10:
+      return ( static_cast< size_t >( i_Width ) + 1 ) / 2 * 8;
+    default:
+      return 0;
+    }
+  }
+
+  bool BayerPattern( unsigned int i_Format, VViconCGStreamBayer::EPattern & o_rPattern )
+  {
+    switch( i_Format )
+    {
+    case VVideoFrame::EBayerRG8:
+      o_rPattern = VViconCGStreamBayer::ERG;
+      return true;
+    case VVideoFrame::EBayerGB8:
+    case VVideoFrame::EBayerGB7:
+    case VVideoFrame::EBayerGB6:
+      o_rPattern = VViconCGStreamBayer::EGB;
+      return true;
+    case VVideoFrame::EBayerGR8:
+      o_rPattern = VViconCGStreamBayer::EGR;
+      return true;
+    case VVideoFrame::EBayerBG8:
+      o_rPattern = VViconCGStreamBayer::EBG;
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  // The pattern seen by a frame which starts one row further down
+  VViconCGStreamBayer::EPattern NextRowPattern( VViconCGStreamBayer::EPattern i_Pattern )
+  {
+    switch( i_Pattern )
+    {
+    case VViconCGStreamBayer::EGB:
+      return VViconCGStreamBayer::ERG;
+    case VViconCGStreamBayer::ERG:
+      return VViconCGStreamBayer::EGB;
+    case VViconCGStreamBayer::EBG:
+      return VViconCGStreamBayer::EGR;
+    default:
+      return VViconCGStreamBayer::EBG;
+    }
+  }
+
+  // Scale demosaiced samples of fewer than 8 bits
+  void ExpandBayerSamples( unsigned int i_Format, unsigned char * io_pSamples, size_t i_Count )
+  {
+    const bool bSSSE3 = UseSSSE3();
+    if( i_Format == VVideoFrame::EBayerGB7 )
+    {
+#ifdef VICON_CGSTREAM_X86
+      if( bSSSE3 )
+      {
+        ExpandSamplesSSSE3< 7 >( io_pSamples, i_Count );
+        return;
+      }
+#endif
+      ExpandSamples< 7 >( io_pSamples, i_Count );
+    }
+    else if( i_Format == VVideoFrame::EBayerGB6 )
+    {
+#ifdef VICON_CGSTREAM_X86
+      if( bSSSE3 )
+      {
+        ExpandSamplesSSSE3< 6 >( io_pSamples, i_Count );
+        return;
+      }
+#endif
+      ExpandSamples< 6 >( io_pSamples, i_Count );
+    }
+  }
+
+  // Row conversions for the formats which are not Bayer
+  TRowFunction BGRRowFunction( unsigned int i_Format )
+  {
+#ifdef VICON_CGSTREAM_X86
+    if( UseSSSE3() )
+    {
+      switch( i_Format )
+      {
+      case VVideoFrame::EMono8:
+        return &MonoRowToBGRSSSE3< 8 >;
+      case VVideoFrame::ELuminance7:
+        return &MonoRowToBGRSSSE3< 7 >;
+      case VVideoFrame::ELuminance6:
+        return &MonoRowToBGRSSSE3< 6 >;
+      case VVideoFrame::ERGB888:
+        return &PackedRowToBGRSSSE3< 3, 0 >;
+      case VVideoFrame::EBGR888:
+        return &PackedRowToBGRSSSE3< 3, 2 >;
+      case VVideoFrame::ER8G8B8u8:
+        return &PackedRowToBGRSSSE3< 4, 0 >;
+      case VVideoFrame::EB8G8R8u8:
+        return &PackedRowToBGRSSSE3< 4, 2 >;
+      case VVideoFrame::ER5G6B5:
+        return &R5G6B5RowToBGRSSSE3;
+      case VVideoFrame::EU8Y8V8Y8:
+        return &YUV8RowToBGRSSSE3< 1, 0, 3, 2 >;
+      case VVideoFrame::EY8U8Y8V8:
+        return &YUV8RowToBGRSSSE3< 0, 1, 2, 3 >;
+      case VVideoFrame::EU10Y10V10Y10:
+        return &YUV10RowToBGRSSSE3< 1, 0, 3, 2 >;
+      default:
+        break;
+      }
+    }
+#endif
+
+    switch( i_Format )
+    {
+    case VVideoFrame::EMono8:
+      return &MonoRowToBGR< 8 >;
+    case VVideoFrame::ELuminance7:
+      return &MonoRowToBGR< 7 >;
+    case VVideoFrame::ELuminance6:
+      return &MonoRowToBGR< 6 >;
+    case VVideoFrame::ERGB888:
+      return &PackedRowToBGR< 3, 0 >;
+    case VVideoFrame::EBGR888:
+      return &PackedRowToBGR< 3, 2 >;
+    case VVideoFrame::ER8G8B8u8:
+      return &PackedRowToBGR< 4, 0 >;
+    case VVideoFrame::EB8G8R8u8:
+      return &PackedRowToBGR< 4, 2 >;
+    case VVideoFrame::ER5G6B5:
+      return &R5G6B5RowToBGR;
+    case VVideoFrame::EU8Y8V8Y8:
+      return &YUVRowToBGR< 8, 1, 0, 3, 2 >;
+    case VVideoFrame::EY8U8Y8V8:
+      return &YUVRowToBGR< 8, 0, 1, 2, 3 >;
+    case VVideoFrame::EU10Y10V10Y10:
+      return &YUVRowToBGR< 10, 1, 0, 3, 2 >;
+    default:
+      return nullptr;
+    }
+  }
+
+  // Formats whose luminance can be read directly, without going through BGR
+  TRowFunction MonoRowFunction( unsigned int i_Format )
+  {
+#ifdef VICON_CGSTREAM_X86
+    if( UseSSSE3() )
+    {
+      switch( i_Format )
+      {
+      case VVideoFrame::ELuminance7:
+        return &MonoRowToMonoSSSE3< 7 >;
+      case VVideoFrame::ELuminance6:
+        return &MonoRowToMonoSSSE3< 6 >;
+      case VVideoFrame::EU8Y8V8Y8:
+        return &YUV8RowToMonoSSSE3< 1, 3 >;
+      case VVideoFrame::EY8U8Y8V8:
+        return &YUV8RowToMonoSSSE3< 0, 2 >;
+      default:
+        break;
+      }
+    }
+#endif
+
+    switch( i_Format )
+    {
+    case VVideoFrame::EMono8:
+      return &MonoRowToMono< 8 >;
+    case VVideoFrame::ELuminance7:
+      return &MonoRowToMono< 7 >;
+    case VVideoFrame::ELuminance6:
+      return &MonoRowToMono< 6 >;
+    case VVideoFrame::EU8Y8V8Y8:
+      return &YUVRowToMono< 8, 1, 3 >;
+    case VVideoFrame::EY8U8Y8V8:
+      return &YUVRowToMono< 8, 0, 2 >;
+    case VVideoFrame::EU10Y10V10Y10:
+      return &YUVRowToMono< 10, 1, 3 >;
+    default:
+      return nullptr;
+    }
+  }
+
+  // Produces one input row of a window, i_Width pixels wide, as 8 bit samples
+  typedef std::function< void( const unsigned char * i_pRow, unsigned int i_Width, unsigned char * o_pOutRow ) > TWindowRowFunction;
+
+  // Output rows [ i_BeginRow, i_EndRow ) of a binned window, with i_Channels samples per pixel, averaging each block of
+  // samples as the rows of the window are converted
+  void BinRows( const TWindowRowFunction & i_rRowFunction, unsigned int i_Channels, const unsigned char * i_pWindow, size_t i_InRowSize,
+                unsigned int i_Width, unsigned int i_Binning, unsigned int i_BeginRow, unsigned int i_EndRow, unsigned char * o_pData,
+                std::vector< unsigned char > & io_rRow, std::vector< unsigned int > & io_rSums )
+  {
+    const unsigned int OutWidth = i_Width / i_Binning;
+    const size_t OutRowSize = static_cast< size_t >( OutWidth ) * i_Channels;
+    const unsigned int Divisor = i_Binning * i_Binning;
+
+    std::vector< unsigned char > & Row = io_rRow;
+    std::vector< unsigned int > & Sums = io_rSums;
+    Row.resize( static_cast< size_t >( i_Width ) * i_Channels );
+    Sums.resize( OutRowSize );
+    for( unsigned int Y = i_BeginRow; Y < i_EndRow; ++Y )
+    {
+      std::fill( Sums.begin(), Sums.end(), 0u );
+      for( unsigned int BinY = 0; BinY < i_Binning; ++BinY )
+      {
+        i_rRowFunction( i_pWindow + ( static_cast< size_t >( Y ) * i_Binning + BinY ) * i_InRowSize, i_Width, &Row[ 0 ] );
+
+        const unsigned char * pSample = &Row[ 0 ];
+        for( unsigned int X = 0; X < OutWidth; ++X )
+        {
+          unsigned int * pSums = &Sums[ static_cast< size_t >( X ) * i_Channels ];
+          for( unsigned int BinX = 0; BinX < i_Binning; ++BinX )
+          {
+            for( unsigned int Channel = 0; Channel < i_Channels; ++Channel )
+            {
+              pSums[ Channel ] += *pSample++;
+            }
+          }
+        }
+      }
+
+      unsigned char * pOutRow = o_pData + Y * OutRowSize;
+      for( size_t Index = 0; Index < OutRowSize; ++Index )
+      {
+        pOutRow[ Index ] = static_cast< unsigned char >( ( Sums[ Index ] + Divisor / 2 ) / Divisor );
+      }
+    }
+  }
+}
+
+//-------------------------------------------------------------------------------------------------
+
+bool VViconCGStreamVideo::CanConvert( unsigned int i_Format )
+{
+  return RowSize( i_Format, 1 ) != 0;
+}
+
+bool VViconCGStreamVideo::IsGreyscale( unsigned int i_Format )
+{
+  return i_Format == VVideoFrame::EMono8 || i_Format == VVideoFrame::ELuminance7 || i_Format == VVideoFrame::ELuminance6;
+}
+
+size_t VViconCGStreamVideo::FrameSize( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height )
+{
+  return RowSize( i_Format, i_Width ) * i_Height;
+}
+
+bool VViconCGStreamVideo::ToBGR( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, unsigned int i_BeginRow, unsigned int i_EndRow,
+                                 const unsigned char * i_pData, unsigned char * o_pBGRData )
+{
+  if( !CanConvert( i_Format ) )
+  {
+    return false;
+  }
+
+  i_EndRow = std::min( i_EndRow, i_Height );
+  if( i_Width == 0 || i_BeginRow >= i_EndRow )
+  {
+    return true;
+  }
+
+  const size_t OutRowSize = static_cast< size_t >( i_Width ) * 3;
+
+  VViconCGStreamBayer::EPattern Pattern;
+  if( BayerPattern( i_Format, Pattern ) )
+  {
+    VViconCGStreamBayer::BayerToBGR( Pattern, i_Width, i_Height, i_BeginRow, i_EndRow, i_pData, o_pBGRData );
+    ExpandBayerSamples( i_Format, o_pBGRData + i_BeginRow * OutRowSize, ( i_EndRow - i_BeginRow ) * OutRowSize );
+    return true;
+  }
+
+  const TRowFunction pRowFunction = BGRRowFunction( i_Format );
+  const size_t InRowSize = RowSize( i_Format, i_Width );
+  for( unsigned int Y = i_BeginRow; Y < i_EndRow; ++Y )
+  {
+    pRowFunction( i_pData + Y * InRowSize, i_Width, o_pBGRData + Y * OutRowSize );
+  }
+  return true;
+}
+
+bool VViconCGStreamVideo::ToMono( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, unsigned int i_BeginRow, unsigned int i_EndRow,
+                                  const unsigned char * i_pData, unsigned char * o_pMonoData, VScratch & io_rScratch )
+{
+  if( !CanConvert( i_Format ) )
+  {
+    return false;
+  }
+
+  i_EndRow = std::min( i_EndRow, i_Height );
+  if( i_Width == 0 || i_BeginRow >= i_EndRow )
+  {
+    return true;
+  }
+
+  const size_t InRowSize = RowSize( i_Format, i_Width );
+
+  const TRowFunction pMonoRowFunction = MonoRowFunction( i_Format );
+  if( pMonoRowFunction )
+  {
+    for( unsigned int Y = i_BeginRow; Y < i_EndRow; ++Y )
+    {
+      pMonoRowFunction( i_pData + Y * InRowSize, i_Width, o_pMonoData + static_cast< size_t >( Y ) * i_Width );
+    }
+    return true;
+  }
+
+  // Everything else goes a row at a time through BGR
+  std::vector< unsigned char > & BGRRows = io_rScratch.m_BGRRow;
+  BGRRows.resize( static_cast< size_t >( i_Width ) * 6 );
+  unsigned char * pBGRRow = &BGRRows[ i_Width * 3 ];
+
+  VViconCGStreamBayer::EPattern Pattern;
+  if( BayerPattern( i_Format, Pattern ) )
+  {
+    if( i_BeginRow == 0 )
+    {
+      std::memset( o_pMonoData, 0, i_Width );
+      ++i_BeginRow;
+    }
+
+    // Each output row is the second row of a two row frame starting at the raw row above it
+    for( unsigned int Y = i_BeginRow; Y < i_EndRow; ++Y )
+    {
+      const VViconCGStreamBayer::EPattern RowPattern = ( ( Y - 1 ) & 1 ) ? NextRowPattern( Pattern ) : Pattern;
+      VViconCGStreamBayer::BayerToBGR( RowPattern, i_Width, 2, 1, 2, i_pData + ( Y - 1 ) * InRowSize, &BGRRows[ 0 ] );
+      ExpandBayerSamples( i_Format, pBGRRow, i_Width * 3 );
+      BGRRowToMono( pBGRRow, i_Width, o_pMonoData + static_cast< size_t >( Y ) * i_Width );
+    }
+    return true;
+  }
+
+  const TRowFunction pBGRRowFunction = BGRRowFunction( i_Format );
+  for( unsigned int Y = i_BeginRow; Y < i_EndRow; ++Y )
+  {
+    pBGRRowFunction( i_pData + Y * InRowSize, i_Width, pBGRRow );
+    BGRRowToMono( pBGRRow, i_Width, o_pMonoData + static_cast< size_t >( Y ) * i_Width );
+  }
+  return true;
+}
+
+bool VViconCGStreamVideo::FitWindow( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, VWindow & io_rWindow )
+{
+  if( !CanConvert( i_Format ) || ( io_rWindow.m_Binning != 1 && io_rWindow.m_Binning != 2 && io_rWindow.m_Binning != 4 ) )
+  {
+    return false;
+  }
+
+  io_rWindow.m_X &= ~1u;
+  io_rWindow.m_Y &= ~1u;
+  if( io_rWindow.m_X >= i_Width || io_rWindow.m_Y >= i_Height )
+  {
+    return false;
+  }
+
+  const unsigned int MaxWidth = i_Width - io_rWindow.m_X;
+  const unsigned int MaxHeight = i_Height - io_rWindow.m_Y;
+  io_rWindow.m_Width = io_rWindow.m_Width == 0 ? MaxWidth : std::min( io_rWindow.m_Width, MaxWidth );
+  io_rWindow.m_Height = io_rWindow.m_Height == 0 ? MaxHeight : std::min( io_rWindow.m_Height, MaxHeight );
+  io_rWindow.m_Width -= io_rWindow.m_Width % io_rWindow.m_Binning;
+  io_rWindow.m_Height -= io_rWindow.m_Height % io_rWindow.m_Binning;
+  return io_rWindow.m_Width != 0 && io_rWindow.m_Height != 0;
+}
+
+bool VViconCGStreamVideo::ToBGR( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, const VWindow & i_rWindow,
+                                 unsigned int i_BeginRow, unsigned int i_EndRow, const unsigned char * i_pData, unsigned char * o_pBGRData,
+                                 VScratch & io_rScratch )
+{
+  if( !CanConvert( i_Format ) )
+  {
+    return false;
+  }
+
+  const unsigned int OutWidth = i_rWindow.OutWidth();
+  i_EndRow = std::min( i_EndRow, i_rWindow.OutHeight() );
+  if( OutWidth == 0 || i_BeginRow >= i_EndRow )
+  {
+    return true;
+  }
+
+  const size_t OutRowSize = static_cast< size_t >( OutWidth ) * 3;
+
+  VViconCGStreamBayer::EPattern Pattern;
+  if( BayerPattern( i_Format, Pattern ) )
+  {
+    VViconCGStreamBayer::BayerWindowToBGR( Pattern, i_Width, i_Height, i_rWindow.m_X, i_rWindow.m_Y, i_rWindow.m_Binning, OutWidth,
+                                           i_BeginRow, i_EndRow, i_pData, o_pBGRData );
+    ExpandBayerSamples( i_Format, o_pBGRData + i_BeginRow * OutRowSize, ( i_EndRow - i_BeginRow ) * OutRowSize );
+    return true;
+  }
+
+  const TRowFunction pRowFunction = BGRRowFunction( i_Format );
+  const size_t InRowSize = RowSize( i_Format, i_Width );
+  const unsigned char * pWindow = i_pData + i_rWindow.m_Y * InRowSize + RowSize( i_Format, i_rWindow.m_X );
+  if( i_rWindow.m_Binning == 1 )
+  {
+    for( unsigned int Y = i_BeginRow; Y < i_EndRow; ++Y )
+    {
+      pRowFunction( pWindow + Y * InRowSize, OutWidth, o_pBGRData + Y * OutRowSize );
+    }
+    return true;
+  }
+
+  BinRows( pRowFunction, 3, pWindow, InRowSize, i_rWindow.m_Width, i_rWindow.m_Binning, i_BeginRow, i_EndRow, o_pBGRData,
+           io_rScratch.m_Row, io_rScratch.m_Sums );
+  return true;
+}
+
+bool VViconCGStreamVideo::ToMono( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, const VWindow & i_rWindow,
+                                  unsigned int i_BeginRow, unsigned int i_EndRow, const unsigned char * i_pData, unsigned char * o_pMonoData,
+                                  VScratch & io_rScratch )
+{
+  if( !CanConvert( i_Format ) )
+  {
+    return false;
+  }
+
+  const unsigned int OutWidth = i_rWindow.OutWidth();
+  i_EndRow = std::min( i_EndRow, i_rWindow.OutHeight() );
+  if( OutWidth == 0 || i_BeginRow >= i_EndRow )
+  {
+    return true;
+  }
+
+  VViconCGStreamBayer::EPattern Pattern;
+  if( BayerPattern( i_Format, Pattern ) )
+  {
+    // Each output row is the first row of a window starting at its own raw row
+    std::vector< unsigned char > & BGRRow = io_rScratch.m_BGRRow;
+    BGRRow.resize( static_cast< size_t >( OutWidth ) * 3 );
+    for( unsigned int Y = i_BeginRow; Y < i_EndRow; ++Y )
+    {
+      VViconCGStreamBayer::BayerWindowToBGR( Pattern, i_Width, i_Height, i_rWindow.m_X, i_rWindow.m_Y + Y * i_rWindow.m_Binning, i_rWindow.m_Binning,
+                                             OutWidth, 0, 1, i_pData, &BGRRow[ 0 ] );
+      ExpandBayerSamples( i_Format, &BGRRow[ 0 ], BGRRow.size() );
+      BGRRowToMono( &BGRRow[ 0 ], OutWidth, o_pMonoData + static_cast< size_t >( Y ) * OutWidth );
+    }
+    return true;
+  }
+
+  const size_t InRowSize = RowSize( i_Format, i_Width );
+  const unsigned char * pWindow = i_pData + i_rWindow.m_Y * InRowSize + RowSize( i_Format, i_rWindow.m_X );
+
+  // Luminance is read directly where the format allows, and through BGR otherwise
+  TWindowRowFunction RowFunction = MonoRowFunction( i_Format );
+  std::vector< unsigned char > & BGRRow = io_rScratch.m_BGRRow;
+  if( !RowFunction )
+  {
+    const TRowFunction pBGRRowFunction = BGRRowFunction( i_Format );
+    BGRRow.resize( static_cast< size_t >( i_rWindow.m_Width ) * 3 );
+    RowFunction = [ pBGRRowFunction, &BGRRow ]( const unsigned char * i_pRow, unsigned int i_RowWidth, unsigned char * o_pMonoRow )
+    {
+      pBGRRowFunction( i_pRow, i_RowWidth, &BGRRow[ 0 ] );
+      BGRRowToMono( &BGRRow[ 0 ], i_RowWidth, o_pMonoRow );
+    };
+  }
+
+  if( i_rWindow.m_Binning == 1 )
+  {
+    for( unsigned int Y = i_BeginRow; Y < i_EndRow; ++Y )
+    {
+      RowFunction( pWindow + Y * InRowSize, OutWidth, o_pMonoData + static_cast< size_t >( Y ) * OutWidth );
+    }
+    return true;
+  }
+
+  BinRows( RowFunction, 1, pWindow, InRowSize, i_rWindow.m_Width, i_rWindow.m_Binning, i_BeginRow, i_EndRow, o_pMonoData,
+           io_rScratch.m_Row, io_rScratch.m_Sums );
+  return true;
+}
@@ -0,0 +1,107 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Conversion of the video formats listed in ViconCGStream::VVideoFrame::EFormat to BGR888 or 8 bit greyscale.
+//
+// Conversions work on a range of output rows, [ i_BeginRow, i_EndRow ), so that a frame may be split between threads;
+// the whole input frame is always passed, and the output buffer is always the size of the whole frame.
+class VViconCGStreamVideo
+{
+public:
+  // A part of a frame to convert, in input pixels, and how many pixels each way are averaged into one output pixel.
+  // A zero width or height extends the window to the edge of the frame.
+  struct VWindow
+  {
+    VWindow( unsigned int i_X = 0, unsigned int i_Y = 0, unsigned int i_Width = 0, unsigned int i_Height = 0, unsigned int i_Binning = 1 )
+    : m_X( i_X )
+    , m_Y( i_Y )
+    , m_Width( i_Width )
+    , m_Height( i_Height )
+    , m_Binning( i_Binning )
+    {
+    }
+
+    unsigned int OutWidth() const
+    {
+      return m_Binning ? m_Width / m_Binning : 0;
+    }
+
+    unsigned int OutHeight() const
+    {
+      return m_Binning ? m_Height / m_Binning : 0;
+    }
+
+    unsigned int m_X;
+    unsigned int m_Y;
+    unsigned int m_Width;
+    unsigned int m_Height;
+    unsigned int m_Binning;
+  };
+
+  // Working rows for the conversions which need them, held by the caller so that converting does not allocate once
+  // they have grown to the widest frame. One may be used by only one conversion at a time.
+  struct VScratch
+  {
+    std::vector< unsigned char > m_Row;
+    std::vector< unsigned char > m_BGRRow;
+    std::vector< unsigned int > m_Sums;
+  };
+
+  // Whether a frame in this format can be converted
+  static bool CanConvert( unsigned int i_Format );
+
+  // Whether this format only carries luminance, in which case converting to greyscale loses nothing
+  static bool IsGreyscale( unsigned int i_Format );
+
+  // The number of bytes of video data in a frame of this format, or zero if the format is unknown
+  static size_t FrameSize( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height );
+
+  // Convert to packed 8 bit blue, green, red. o_pBGRData must hold i_Width * i_Height * 3 bytes.
+  static bool ToBGR( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, unsigned int i_BeginRow, unsigned int i_EndRow,
+                     const unsigned char * i_pData, unsigned char * o_pBGRData );
+
+  // Convert to 8 bit luminance. o_pMonoData must hold i_Width * i_Height bytes.
+  static bool ToMono( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, unsigned int i_BeginRow, unsigned int i_EndRow,
+                      const unsigned char * i_pData, unsigned char * o_pMonoData, VScratch & io_rScratch );
+
+  // Clip a window to a frame and align it as the conversions below need: the origin is rounded down to even pixels, so that
+  // YUV pairs and Bayer cells are kept whole, and the size down to whole bins. Binning may be 1, 2 or 4.
+  // False if the frame cannot be converted or nothing of the window is left.
+  static bool FitWindow( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, VWindow & io_rWindow );
+
+  // As above, for output rows [ i_BeginRow, i_EndRow ) of a window fitted by FitWindow. The output buffer holds the window
+  // alone, i_rWindow.OutWidth() by i_rWindow.OutHeight() pixels. Without binning the output is exactly that part of what the
+  // whole frame converts to; Bayer formats are binned in the demosaic itself.
+  static bool ToBGR( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, const VWindow & i_rWindow,
+                     unsigned int i_BeginRow, unsigned int i_EndRow, const unsigned char * i_pData, unsigned char * o_pBGRData,
+                     VScratch & io_rScratch );
+  static bool ToMono( unsigned int i_Format, unsigned int i_Width, unsigned int i_Height, const VWindow & i_rWindow,
+                      unsigned int i_BeginRow, unsigned int i_EndRow, const unsigned char * i_pData, unsigned char * o_pMonoData,
+                      VScratch & io_rScratch );
+};
@@ -85,6 +85,9 @@ VCGClient::VCGClient()
 : m_bMulticastReceiving( false )
 , m_bMulticastController( false )
 , m_MaxBufferSize( 1 )
+, m_DecodeThreadCount( 0 )
+, m_VideoHint( VViconCGStreamClient::EPassThrough )
+, m_WaitGeneration( 0 )
 {
 }
 
@@ -175,6 +178,7 @@ void VCGClient::ReadFramePair( const TFramePair& i_rPair, ICGFrameState& o_rFram
     o_rFrameState.m_Timecode = rpDynamicState->m_Timecode;
     o_rFrameState.m_Latency = rpDynamicState->m_LatencyInfo;
     o_rFrameState.m_FrameRateInfo = rpDynamicState->m_FrameRateInfo;
+    o_rFrameState.m_ReceiptTime = rpDynamicState->m_ReceiptTime;
     o_rFrameState.m_EdgePairs = rpDynamicState->m_EdgePairs;
     o_rFrameState.m_GreyscaleBlobs = rpDynamicState->m_GreyscaleBlobs;
     o_rFrameState.m_GreyscaleSubsampledBlobs = rpDynamicState->m_GreyscaleSubsampledBlobs;
@@ -203,10 +207,8 @@ void VCGClient::ReadFramePair( const TFramePair& i_rPair, ICGFrameState& o_rFram
   }
 }
 
-bool VCGClient::WaitFrames( std::vector< ICGFrameState > & o_rFrames, unsigned int i_TimeoutMs )
+bool VCGClient::WaitForFrameQueue( boost::recursive_mutex::scoped_lock & io_rLock, unsigned int i_TimeoutMs )
 {
-  boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
-
   boost::xtime WaitDeadline;
 
   // boost::TIME_UTC has been renamed to boost::TIME_UTC_ in Boost 1.50:
@@ -222,12 +224,31 @@ bool VCGClient::WaitFrames( std::vector< ICGFrameState > & o_rFrames, unsigned i
   WaitDeadline.sec += AdditionalSeconds;
   WaitDeadline.nsec += AdditionalNanoSeconds;
 
+  // OnDynamicObjects, OnDisconnect and CancelWait all notify, so there is no need to wake before the deadline otherwise
+  const unsigned int Generation = m_WaitGeneration;
   while( m_FrameDeque.empty() )
   {
-    if( !m_NewFramesCondition.timed_wait( Lock, WaitDeadline ) )
+    if( Generation != m_WaitGeneration || !( IsConnected() || m_bMulticastReceiving ) )
     {
       return false;
     }
+
+    if( !m_NewFramesCondition.timed_wait( io_rLock, WaitDeadline ) )
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool VCGClient::WaitFrames( std::vector< ICGFrameState > & o_rFrames, unsigned int i_TimeoutMs )
+{
+  boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
+
+  if( !WaitForFrameQueue( Lock, i_TimeoutMs ) )
+  {
+    return false;
   }
   
   return PollFrames( o_rFrames );
@@ -237,32 +258,22 @@ bool VCGClient::WaitFrame( ICGFrameState& o_rFrame, unsigned int i_TimeoutMs )
 {
   boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
 
-  boost::xtime WaitDeadline;
-
-  // boost::TIME_UTC has been renamed to boost::TIME_UTC_ in Boost 1.50:
-  // https://svn.boost.org/trac/boost/ticket/6940
-#if BOOST_VERSION >= 105000
-  boost::xtime_get( &WaitDeadline, boost::TIME_UTC_ );
-#else
-  boost::xtime_get( &WaitDeadline, boost::TIME_UTC );
-#endif
-  boost::xtime::xtime_sec_t  AdditionalSeconds     = static_cast< boost::xtime::xtime_sec_t  >( static_cast< double >( i_TimeoutMs ) / 1000.0 );
-  boost::xtime::xtime_nsec_t AdditionalNanoSeconds = static_cast< boost::xtime::xtime_nsec_t >( ( i_TimeoutMs - ( 1000 * AdditionalSeconds ) ) * 1000000 );
- 
-  WaitDeadline.sec += AdditionalSeconds;
-  WaitDeadline.nsec += AdditionalNanoSeconds;
-
-  while( m_FrameDeque.empty() )
+  if( !WaitForFrameQueue( Lock, i_TimeoutMs ) )
   {
-    if( !m_NewFramesCondition.timed_wait( Lock, WaitDeadline ) )
-    {
-      return false;
-    }
+    return false;
   }
   
   return PollFrame( o_rFrame );
 }
 
+void VCGClient::CancelWait()
+{
+  boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
+
+  ++m_WaitGeneration;
+  m_NewFramesCondition.notify_all();
+}
+
 void VCGClient::Connect( std::string i_IPAddress, unsigned short i_Port )
 {
   Connect({{i_IPAddress, i_Port}});
@@ -276,6 +287,13 @@ void VCGClient::Connect( const std::vector< std::pair< std::string, unsigned sho
   {
     std::shared_ptr< VCGClientCallback > pCallback(new VCGClientCallback(*this, m_pCallbacks.size()) );
     std::shared_ptr< VViconCGStreamClient > pClient( new VViconCGStreamClient( pCallback ) );
+    pClient->SetDecodeThreadCount( m_DecodeThreadCount );
+    pClient->SetVideoHint( m_VideoHint );
+    for( const auto & rWindow : m_VideoWindows )
+    {
+      pClient->SetVideoWindow( rWindow.first, rWindow.second );
+    }
+    pClient->SetFilter( m_Filter );
 
     pClient->Connect( rHost.first, rHost.second );
 
@@ -355,13 +373,38 @@ void VCGClient::SetBufferSize( unsigned int i_MaxFrames )
   }
 }
 
-void VCGClient::SetDecodeVideo( bool i_bDecode )
+void VCGClient::SetDecodeVideo( bool i_bDecode, bool i_bOnAccess )
+{
+  boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
+
+  m_VideoHint = !i_bDecode ? VViconCGStreamClient::EPassThrough : ( i_bOnAccess ? VViconCGStreamClient::EDecodeOnAccess : VViconCGStreamClient::EDecode );
+  for (auto pClient : m_pClients)
+  {
+    pClient->SetVideoHint( m_VideoHint );
+  }
+}
+
+void VCGClient::SetVideoDecodeWindow( unsigned int i_CameraID, unsigned int i_Binning,
+                                      unsigned int i_X, unsigned int i_Y, unsigned int i_Width, unsigned int i_Height )
 {
   boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
 
+  const VViconCGStreamVideo::VWindow Window( i_X, i_Y, i_Width, i_Height, i_Binning );
+  m_VideoWindows[ i_CameraID ] = Window;
   for (auto pClient : m_pClients)
   {
-    pClient->SetVideoHint(i_bDecode ? VViconCGStreamClient::EDecode : VViconCGStreamClient::EPassThrough);
+    pClient->SetVideoWindow( i_CameraID, Window );
+  }
+}
+
+void VCGClient::SetDecodeThreadCount( unsigned int i_ThreadCount )
+{
+  boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
+
+  m_DecodeThreadCount = i_ThreadCount;
+  for (auto pClient : m_pClients)
+  {
+    pClient->SetDecodeThreadCount( i_ThreadCount );
   }
 }
 
@@ -379,12 +422,29 @@ void VCGClient::SetFilter( const ViconCGStream::VFilter & i_rFilter )
 {
   boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
 
+  m_Filter = i_rFilter;
   for (auto pClient : m_pClients)
   {
     pClient->SetFilter(i_rFilter);
   }
 }
 
+void VCGClient::GetBytesReceived( std::map< ViconCGStreamType::Enum, ViconCGStreamType::UInt64 > & o_rBytesReceived ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
+
+  o_rBytesReceived.clear();
+  for( const auto & pClient : m_pClients )
+  {
+    VViconCGStreamClient::TBytesReceived BytesReceived;
+    pClient->GetBytesReceived( BytesReceived );
+    for( const auto & rBytes : BytesReceived )
+    {
+      o_rBytesReceived[ rBytes.first ] += rBytes.second;
+    }
+  }
+}
+
 void VCGClient::SendPing()
 {
   boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
@@ -422,7 +482,7 @@ void VCGClient::ClearBuffer()
   std::swap( m_FrameDeque, FrameDeque );
 }
 
-bool VCGClient::SetLogFile(const std::string& i_rLog)
+bool VCGClient::SetLogFile(const std::string& i_rLog, bool i_bBinary)
 {
   boost::recursive_mutex::scoped_lock Lock( m_ClientMutex );
 
@@ -433,7 +493,7 @@ bool VCGClient::SetLogFile(const std::string& i_rLog)
 
   if (m_pClients.size() == 1)
   {
-    return m_pClients.front()->SetTimingLogFile(i_rLog);
+    return m_pClients.front()->SetTimingLogFile(i_rLog, i_bBinary);
   }
   else
   {
@@ -448,7 +508,7 @@ bool VCGClient::SetLogFile(const std::string& i_rLog)
     {
       std::string Log = i_rLog;
       Log.insert(Pos, pClient->HostName());
-      bOk = bOk && pClient->SetTimingLogFile( Log );
+      bOk = bOk && pClient->SetTimingLogFile( Log, i_bBinary );
     }
     return bOk;
   }
@@ -57,7 +57,10 @@ public:
 
   virtual bool SetRequestTypes( ViconCGStreamType::Enum i_RequestedType, bool i_bEnable = true) override;
   virtual void SetBufferSize( unsigned int i_MaxFrames ) override;
-  virtual void SetDecodeVideo( bool i_bDecode ) override;
+  virtual void SetDecodeVideo( bool i_bDecode, bool i_bOnAccess ) override;
+  virtual void SetVideoDecodeWindow( unsigned int i_CameraID, unsigned int i_Binning,
+                                     unsigned int i_X, unsigned int i_Y, unsigned int i_Width, unsigned int i_Height ) override;
+  virtual void SetDecodeThreadCount( unsigned int i_ThreadCount ) override;
   virtual void SetStreamMode( bool i_bStream ) override;
   virtual void SetServerToTransmitMulticast( std::string i_MulticastIPAddress, std::string i_ServerIPAddress, unsigned short i_Port ) override;
   virtual void StopMulticastTransmission() override;
@@ -68,6 +71,7 @@ public:
 
   virtual bool WaitFrames( std::vector< ICGFrameState > & o_rFrames, unsigned int i_TimeoutMs ) override;
   virtual bool WaitFrame( ICGFrameState& o_rFrame, unsigned int i_TimeoutMs ) override;
+  virtual void CancelWait() override;
 
   // maintains a list of devices with haptic feedback on. 
   // if on add to the list,
@@ -77,8 +81,10 @@ public:
   /// Allows filtering of items in a group, e.g. only get centroids for a given camera id, etc.
   virtual void SetFilter( const ViconCGStream::VFilter & i_rFilter ) override;
 
+  virtual void GetBytesReceived( std::map< ViconCGStreamType::Enum, ViconCGStreamType::UInt64 > & o_rBytesReceived ) const override;
+
   virtual void SendPing() override;
-  virtual bool SetLogFile( const std::string& i_rLog ) override;
+  virtual bool SetLogFile( const std::string& i_rLog, bool i_bBinary ) override;
 
   virtual void RequestFrame() override;
   virtual void RequestNextFrame() override;
@@ -115,8 +121,15 @@ protected:
   std::shared_ptr< const VStaticObjects >   m_pLastStaticObjects;
   TFrameDeque                               m_FrameDeque;
   unsigned int                              m_MaxBufferSize;
+  unsigned int                              m_DecodeThreadCount;
+  VViconCGStreamClient::EVideoHint          m_VideoHint;
+  std::map< unsigned int, VViconCGStreamVideo::VWindow > m_VideoWindows;
+  ViconCGStream::VFilter                    m_Filter;
 
   boost::condition                          m_NewFramesCondition; 
+  unsigned int                              m_WaitGeneration;
+
+  bool WaitForFrameQueue( boost::recursive_mutex::scoped_lock & io_rLock, unsigned int i_TimeoutMs );
 };
 
 } // End of namespace ViconCGStreamClientSDK
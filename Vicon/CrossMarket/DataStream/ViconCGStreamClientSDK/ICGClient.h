@@ -25,6 +25,7 @@
 #pragma once
 
 #include <StreamCommon/Type.h>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -78,8 +79,21 @@ public:
   /// Set the maximum number of frames you want cached
   virtual void SetBufferSize( unsigned int i_MaxFrames ) = 0;
 
-  /// Request that video data be transcoded into BGR888
-  virtual void SetDecodeVideo( bool i_bDecode ) = 0;
+  /// Request that video data be transcoded into BGR888 ( Mono8 for luminance-only formats ).
+  /// With i_bOnAccess, frames are delivered as received and decoded the first time they are asked for, so frames
+  /// which are dropped or never read cost nothing; use VCGStreamLazyVideoFrame::Resolve to get the decoded frame.
+  virtual void SetDecodeVideo( bool i_bDecode, bool i_bOnAccess = false ) = 0;
+
+  /// Decode only part of one camera's video, for previews and the like. The window is i_Width x i_Height pixels from ( i_X, i_Y ),
+  /// with a zero width or height reaching to the edge of the frame, and each i_Binning x i_Binning block of it (1, 2 or 4)
+  /// is averaged into one pixel. Decoded frames have the size of the window after binning and the position of its top left.
+  /// A binning of 1 with an empty window restores whole frames; with any other binning the camera's video is not decoded.
+  virtual void SetVideoDecodeWindow( unsigned int i_CameraID, unsigned int i_Binning,
+                                     unsigned int i_X = 0, unsigned int i_Y = 0, unsigned int i_Width = 0, unsigned int i_Height = 0 ) = 0;
+
+  /// Set the number of worker threads used to decode heavy objects (centroids, greyscale, video, ray assignments)
+  /// off the socket thread. Frames are still delivered in order. Zero decodes everything on the socket thread.
+  virtual void SetDecodeThreadCount( unsigned int i_ThreadCount ) = 0;
 
   /// Request that data is constantly streamed from the server, rather than sent on request.
   virtual void SetStreamMode( bool i_bStream ) = 0;
@@ -90,6 +104,9 @@ public:
   /// Allows filtering of items in a group, e.g. only get centroids for a given camera id, etc.
   virtual void SetFilter( const ViconCGStream::VFilter & i_rFilter ) = 0;
 
+  /// Bytes received from the server by object type, summed over every connection.
+  virtual void GetBytesReceived( std::map< ViconCGStreamType::Enum, ViconCGStreamType::UInt64 > & o_rBytesReceived ) const = 0;
+
   /// Send a ping to the server to measure network latency
   virtual void SendPing() = 0;
 
@@ -124,12 +141,17 @@ public:
   virtual bool PollFrame( ICGFrameState& o_rFrame ) = 0;
   virtual bool PollFrames( std::vector< ICGFrameState > & o_rFrames ) = 0;
 
-  /// Wait for frames. Returns when a frame arrives or i_TimeoutMs expires
+  /// Wait for frames. Returns when a frame arrives or i_TimeoutMs expires.
+  /// Returns false early if the connection is lost or CancelWait is called.
   virtual bool WaitFrame( ICGFrameState& o_rFrame, unsigned int i_TimeoutMs ) = 0;
   virtual bool WaitFrames( std::vector< ICGFrameState > & o_rFrames, unsigned int i_TimeoutMs ) = 0;
 
+  /// Wake any threads blocked in WaitFrame or WaitFrames
+  virtual void CancelWait() = 0;
+
   /// Sets a log filename through which this cgstream client can log data
-  virtual bool SetLogFile( const std::string & i_rLog ) = 0;
+  /// A binary log is smaller and cheaper to write; ViconDataStreamSDKTimingLogToCSV converts it to text
+  virtual bool SetLogFile( const std::string & i_rLog, bool i_bBinary = false ) = 0;
 
 protected:
   /// Private desctructor. To delete, call the Destroy() method
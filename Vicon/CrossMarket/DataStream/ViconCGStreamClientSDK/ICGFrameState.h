@@ -57,9 +57,7 @@
 #include <ViconCGStream/UnlabeledRecons.h>
 #include <ViconCGStream/LabeledReconRayAssignments.h>
 #include <ViconCGStream/VideoFrame.h>
-#include <ViconCGStream/GreyscaleBlobs.h>
-#include <ViconCGStream/GreyscaleSubsampledBlobs.h>
-#include <ViconCGStream/GreyscaleBlobsDetail.h>
+#include <ViconCGStream/GreyscaleBlobsPacked.h>
 #include <ViconCGStream/EdgePairs.h>
 #include <ViconCGStream/Timecode.h>
 #include <ViconCGStream/ForcePlateInfo.h>
@@ -71,6 +69,7 @@
 #include <ViconCGStream/FrameRateInfo.h>
 
 #include <boost/optional.hpp>
+#include <chrono>
 #include <memory>
 #include <vector>
 
@@ -80,6 +79,7 @@ namespace ViconCGStreamClientSDK
 {
 
 typedef std::shared_ptr< const ViconCGStream::VVideoFrame > VVideoFramePtr;
+typedef std::shared_ptr< const ViconCGStream::VGreyscaleBlobsPacked > VGreyscaleBlobsPtr;
 
 class ICGFrameState
 {
@@ -92,6 +92,7 @@ public:
   ViconCGStream::VLatencyInfo                          m_Latency;
   boost::optional<ViconCGStream::VApplicationInfo>     m_ApplicationInfo;
   ViconCGStream::VFrameRateInfo                        m_FrameRateInfo;
+  std::chrono::steady_clock::time_point                m_ReceiptTime;
 
   // Cameras
   ViconCGStream::VCameraCalibrationHealth              m_CameraCalibrationHealth;
@@ -99,8 +100,8 @@ public:
   std::vector< ViconCGStream::VCameraInfo >            m_Cameras;
   std::vector< ViconCGStream::VCameraSensorInfo >      m_CamerasSensorInfo;
   std::vector< ViconCGStream::VEdgePairs >             m_EdgePairs;
-  std::vector< ViconCGStream::VGreyscaleBlobs >        m_GreyscaleBlobs;
-  std::vector< ViconCGStream::VGreyscaleSubsampledBlobs > m_GreyscaleSubsampledBlobs;
+  std::vector< VGreyscaleBlobsPtr >                    m_GreyscaleBlobs;
+  std::vector< VGreyscaleBlobsPtr >                    m_GreyscaleSubsampledBlobs;
   std::vector< ViconCGStream::VCentroids >             m_Centroids;
   std::vector< ViconCGStream::VCentroidTracks >        m_CentroidTracks;
   std::vector< ViconCGStream::VCentroidWeights >       m_CentroidWeights;
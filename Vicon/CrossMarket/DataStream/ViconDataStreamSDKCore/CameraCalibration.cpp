@@ -0,0 +1,337 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include "CameraCalibration.h"
+
+#include <ViconCGStreamClient/CGStreamSIMD.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// Each kernel handles two points at a time with SSE2 where the build targets it ( every x64 build does ), and the rest one
+// at a time. Both forms make the same operations in the same order, so a point gives the same result either way.
+#if defined( VICON_CGSTREAM_X86 ) && ( defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 ) )
+#define VICON_CALIBRATION_SSE2
+#endif
+
+namespace
+{
+  // Newton steps taken to invert the distortion; enough for full double precision at any distortion a lens will show
+  const unsigned int s_DistortIterations = 6;
+
+  // Points undistorted at a time on the way to rays
+  const std::size_t s_RayBlock = 256;
+
+#ifdef VICON_CALIBRATION_SSE2
+  // Two interleaved x, y points to and from a register of x values and a register of y values
+  inline void LoadXY( const double * i_pPoints, __m128d & o_rX, __m128d & o_rY )
+  {
+    const __m128d A = _mm_loadu_pd( i_pPoints );
+    const __m128d B = _mm_loadu_pd( i_pPoints + 2 );
+    o_rX = _mm_unpacklo_pd( A, B );
+    o_rY = _mm_unpackhi_pd( A, B );
+  }
+
+  inline void StoreXY( __m128d i_X, __m128d i_Y, double * o_pPoints )
+  {
+    _mm_storeu_pd( o_pPoints, _mm_unpacklo_pd( i_X, i_Y ) );
+    _mm_storeu_pd( o_pPoints + 2, _mm_unpackhi_pd( i_X, i_Y ) );
+  }
+
+  // Two interleaved x, y, z points to and from registers of x, y and z values
+  inline void LoadXYZ( const double * i_pPoints, __m128d & o_rX, __m128d & o_rY, __m128d & o_rZ )
+  {
+    const __m128d A = _mm_loadu_pd( i_pPoints );
+    const __m128d B = _mm_loadu_pd( i_pPoints + 2 );
+    const __m128d C = _mm_loadu_pd( i_pPoints + 4 );
+    o_rX = _mm_shuffle_pd( A, B, 2 );
+    o_rY = _mm_shuffle_pd( A, C, 1 );
+    o_rZ = _mm_shuffle_pd( B, C, 2 );
+  }
+
+  inline void StoreXYZ( __m128d i_X, __m128d i_Y, __m128d i_Z, double * o_pPoints )
+  {
+    _mm_storeu_pd( o_pPoints, _mm_unpacklo_pd( i_X, i_Y ) );
+    _mm_storeu_pd( o_pPoints + 2, _mm_shuffle_pd( i_Z, i_X, 2 ) );
+    _mm_storeu_pd( o_pPoints + 4, _mm_unpackhi_pd( i_Y, i_Z ) );
+  }
+#endif
+}
+
+namespace ViconDataStreamSDK
+{
+namespace Core
+{
+
+VCameraCalibration::VCameraCalibration( const ViconCGStream::VCameraCalibrationInfo & i_rInfo )
+: m_CameraID( i_rInfo.m_CameraID )
+, m_FocalLength( i_rInfo.m_FocalLength )
+, m_Skew( i_rInfo.m_Skew )
+{
+  std::copy( i_rInfo.m_PoseRotation, i_rInfo.m_PoseRotation + 9, m_Rotation );
+  std::copy( i_rInfo.m_PoseTranslation, i_rInfo.m_PoseTranslation + 3, m_Position );
+  std::copy( i_rInfo.m_PrincipalPoint, i_rInfo.m_PrincipalPoint + 2, m_PrincipalPoint );
+  std::copy( i_rInfo.m_RadialDistortion, i_rInfo.m_RadialDistortion + 2, m_RadialDistortion );
+}
+
+void VCameraCalibration::RotateWorld( const double ( & i_Rotation )[ 9 ] )
+{
+  // With world points X' = M X, the camera sees R ( X - T ) = R M^T ( X' - M T )
+  double Rotation[ 9 ];
+  double Position[ 3 ];
+  for( unsigned int Row = 0; Row < 3; ++Row )
+  {
+    for( unsigned int Column = 0; Column < 3; ++Column )
+    {
+      Rotation[ Row * 3 + Column ] = m_Rotation[ Row * 3 ] * i_Rotation[ Column * 3 ] +
+                                     m_Rotation[ Row * 3 + 1 ] * i_Rotation[ Column * 3 + 1 ] +
+                                     m_Rotation[ Row * 3 + 2 ] * i_Rotation[ Column * 3 + 2 ];
+    }
+    Position[ Row ] = i_Rotation[ Row * 3 ] * m_Position[ 0 ] + i_Rotation[ Row * 3 + 1 ] * m_Position[ 1 ] + i_Rotation[ Row * 3 + 2 ] * m_Position[ 2 ];
+  }
+
+  std::copy( Rotation, Rotation + 9, m_Rotation );
+  std::copy( Position, Position + 3, m_Position );
+}
+
+void VCameraCalibration::GetPosition( double ( & o_rPosition )[ 3 ] ) const
+{
+  std::copy( m_Position, m_Position + 3, o_rPosition );
+}
+
+void VCameraCalibration::Undistort( const double * i_pPoints, std::size_t i_Count, double * o_pPoints ) const
+{
+  const double Px = m_PrincipalPoint[ 0 ];
+  const double Py = m_PrincipalPoint[ 1 ];
+  const double K1 = m_RadialDistortion[ 0 ];
+  const double K2 = m_RadialDistortion[ 1 ];
+
+  std::size_t Point = 0;
+#ifdef VICON_CALIBRATION_SSE2
+  const __m128d PX = _mm_set1_pd( Px );
+  const __m128d PY = _mm_set1_pd( Py );
+  const __m128d K1s = _mm_set1_pd( K1 );
+  const __m128d K2s = _mm_set1_pd( K2 );
+  const __m128d One = _mm_set1_pd( 1.0 );
+  for( ; Point + 2 <= i_Count; Point += 2 )
+  {
+    __m128d X, Y;
+    LoadXY( i_pPoints + Point * 2, X, Y );
+    const __m128d Dx = _mm_sub_pd( X, PX );
+    const __m128d Dy = _mm_sub_pd( Y, PY );
+    const __m128d R2 = _mm_add_pd( _mm_mul_pd( Dx, Dx ), _mm_mul_pd( Dy, Dy ) );
+    const __m128d Scale = _mm_add_pd( One, _mm_mul_pd( R2, _mm_add_pd( K1s, _mm_mul_pd( K2s, R2 ) ) ) );
+    StoreXY( _mm_add_pd( PX, _mm_mul_pd( Dx, Scale ) ), _mm_add_pd( PY, _mm_mul_pd( Dy, Scale ) ), o_pPoints + Point * 2 );
+  }
+#endif
+  for( ; Point < i_Count; ++Point )
+  {
+    const double Dx = i_pPoints[ Point * 2 ] - Px;
+    const double Dy = i_pPoints[ Point * 2 + 1 ] - Py;
+    const double R2 = Dx * Dx + Dy * Dy;
+    const double Scale = 1.0 + R2 * ( K1 + K2 * R2 );
+    o_pPoints[ Point * 2 ] = Px + Dx * Scale;
+    o_pPoints[ Point * 2 + 1 ] = Py + Dy * Scale;
+  }
+}
+
+void VCameraCalibration::Distort( const double * i_pPoints, std::size_t i_Count, double * o_pPoints ) const
+{
+  // The distorted point is p + S ( u - p ) for the S that Undistort takes back to u: S ( 1 + A S^2 + B S^4 ) = 1, with
+  // A = k1 r^2 and B = k2 r^4 at the undistorted radius r. Newton's method from S = 1 needs no branches.
+  const double Px = m_PrincipalPoint[ 0 ];
+  const double Py = m_PrincipalPoint[ 1 ];
+  const double K1 = m_RadialDistortion[ 0 ];
+  const double K2 = m_RadialDistortion[ 1 ];
+
+  std::size_t Point = 0;
+#ifdef VICON_CALIBRATION_SSE2
+  const __m128d PX = _mm_set1_pd( Px );
+  const __m128d PY = _mm_set1_pd( Py );
+  const __m128d K1s = _mm_set1_pd( K1 );
+  const __m128d K2s = _mm_set1_pd( K2 );
+  const __m128d One = _mm_set1_pd( 1.0 );
+  const __m128d Three = _mm_set1_pd( 3.0 );
+  const __m128d Five = _mm_set1_pd( 5.0 );
+  for( ; Point + 2 <= i_Count; Point += 2 )
+  {
+    __m128d X, Y;
+    LoadXY( i_pPoints + Point * 2, X, Y );
+    const __m128d Dx = _mm_sub_pd( X, PX );
+    const __m128d Dy = _mm_sub_pd( Y, PY );
+    const __m128d R2 = _mm_add_pd( _mm_mul_pd( Dx, Dx ), _mm_mul_pd( Dy, Dy ) );
+    const __m128d A = _mm_mul_pd( K1s, R2 );
+    const __m128d B = _mm_mul_pd( _mm_mul_pd( K2s, R2 ), R2 );
+    __m128d S = One;
+    for( unsigned int Iteration = 0; Iteration < s_DistortIterations; ++Iteration )
+    {
+      const __m128d S2 = _mm_mul_pd( S, S );
+      const __m128d H = _mm_sub_pd( _mm_mul_pd( S, _mm_add_pd( One, _mm_mul_pd( S2, _mm_add_pd( A, _mm_mul_pd( B, S2 ) ) ) ) ), One );
+      const __m128d Slope = _mm_add_pd( One, _mm_mul_pd( S2, _mm_add_pd( _mm_mul_pd( Three, A ), _mm_mul_pd( _mm_mul_pd( Five, B ), S2 ) ) ) );
+      S = _mm_sub_pd( S, _mm_div_pd( H, Slope ) );
+    }
+    StoreXY( _mm_add_pd( PX, _mm_mul_pd( Dx, S ) ), _mm_add_pd( PY, _mm_mul_pd( Dy, S ) ), o_pPoints + Point * 2 );
+  }
+#endif
+  for( ; Point < i_Count; ++Point )
+  {
+    const double Dx = i_pPoints[ Point * 2 ] - Px;
+    const double Dy = i_pPoints[ Point * 2 + 1 ] - Py;
+    const double R2 = Dx * Dx + Dy * Dy;
+    const double A = K1 * R2;
+    const double B = K2 * R2 * R2;
+    double S = 1.0;
+    for( unsigned int Iteration = 0; Iteration < s_DistortIterations; ++Iteration )
+    {
+      const double S2 = S * S;
+      const double H = S * ( 1.0 + S2 * ( A + B * S2 ) ) - 1.0;
+      const double Slope = 1.0 + S2 * ( 3.0 * A + 5.0 * B * S2 );
+      S = S - H / Slope;
+    }
+    o_pPoints[ Point * 2 ] = Px + Dx * S;
+    o_pPoints[ Point * 2 + 1 ] = Py + Dy * S;
+  }
+}
+
+void VCameraCalibration::Project( const double * i_pPoints, std::size_t i_Count, double * o_pPoints, bool i_bDistort ) const
+{
+  const double * R = m_Rotation;
+  const double * T = m_Position;
+  const double F = m_FocalLength;
+  const double Skew = m_Skew;
+  const double Px = m_PrincipalPoint[ 0 ];
+  const double Py = m_PrincipalPoint[ 1 ];
+  const double NaN = std::numeric_limits< double >::quiet_NaN();
+
+  std::size_t Point = 0;
+#ifdef VICON_CALIBRATION_SSE2
+  const __m128d R0 = _mm_set1_pd( R[ 0 ] ), R1 = _mm_set1_pd( R[ 1 ] ), R2 = _mm_set1_pd( R[ 2 ] );
+  const __m128d R3 = _mm_set1_pd( R[ 3 ] ), R4 = _mm_set1_pd( R[ 4 ] ), R5 = _mm_set1_pd( R[ 5 ] );
+  const __m128d R6 = _mm_set1_pd( R[ 6 ] ), R7 = _mm_set1_pd( R[ 7 ] ), R8 = _mm_set1_pd( R[ 8 ] );
+  const __m128d TX = _mm_set1_pd( T[ 0 ] ), TY = _mm_set1_pd( T[ 1 ] ), TZ = _mm_set1_pd( T[ 2 ] );
+  const __m128d Fs = _mm_set1_pd( F );
+  const __m128d Skews = _mm_set1_pd( Skew );
+  const __m128d PX = _mm_set1_pd( Px );
+  const __m128d PY = _mm_set1_pd( Py );
+  const __m128d One = _mm_set1_pd( 1.0 );
+  const __m128d Zero = _mm_setzero_pd();
+  const __m128d NaNs = _mm_set1_pd( NaN );
+  for( ; Point + 2 <= i_Count; Point += 2 )
+  {
+    __m128d X, Y, Z;
+    LoadXYZ( i_pPoints + Point * 3, X, Y, Z );
+    X = _mm_sub_pd( X, TX );
+    Y = _mm_sub_pd( Y, TY );
+    Z = _mm_sub_pd( Z, TZ );
+    const __m128d Cx = _mm_add_pd( _mm_add_pd( _mm_mul_pd( R0, X ), _mm_mul_pd( R1, Y ) ), _mm_mul_pd( R2, Z ) );
+    const __m128d Cy = _mm_add_pd( _mm_add_pd( _mm_mul_pd( R3, X ), _mm_mul_pd( R4, Y ) ), _mm_mul_pd( R5, Z ) );
+    const __m128d Cz = _mm_add_pd( _mm_add_pd( _mm_mul_pd( R6, X ), _mm_mul_pd( R7, Y ) ), _mm_mul_pd( R8, Z ) );
+    const __m128d InvZ = _mm_div_pd( One, Cz );
+    const __m128d Nx = _mm_mul_pd( Cx, InvZ );
+    const __m128d Ny = _mm_mul_pd( Cy, InvZ );
+    const __m128d U = _mm_add_pd( _mm_add_pd( _mm_mul_pd( Fs, Nx ), _mm_mul_pd( Skews, Ny ) ), PX );
+    const __m128d V = _mm_add_pd( _mm_mul_pd( Fs, Ny ), PY );
+    const __m128d InFront = _mm_cmpgt_pd( Cz, Zero );
+    StoreXY( _mm_or_pd( _mm_and_pd( InFront, U ), _mm_andnot_pd( InFront, NaNs ) ),
+             _mm_or_pd( _mm_and_pd( InFront, V ), _mm_andnot_pd( InFront, NaNs ) ), o_pPoints + Point * 2 );
+  }
+#endif
+  for( ; Point < i_Count; ++Point )
+  {
+    const double X = i_pPoints[ Point * 3 ] - T[ 0 ];
+    const double Y = i_pPoints[ Point * 3 + 1 ] - T[ 1 ];
+    const double Z = i_pPoints[ Point * 3 + 2 ] - T[ 2 ];
+    const double Cx = R[ 0 ] * X + R[ 1 ] * Y + R[ 2 ] * Z;
+    const double Cy = R[ 3 ] * X + R[ 4 ] * Y + R[ 5 ] * Z;
+    const double Cz = R[ 6 ] * X + R[ 7 ] * Y + R[ 8 ] * Z;
+    const double InvZ = 1.0 / Cz;
+    const double Nx = Cx * InvZ;
+    const double Ny = Cy * InvZ;
+    const bool bInFront = Cz > 0.0;
+    o_pPoints[ Point * 2 ] = bInFront ? F * Nx + Skew * Ny + Px : NaN;
+    o_pPoints[ Point * 2 + 1 ] = bInFront ? F * Ny + Py : NaN;
+  }
+
+  if( i_bDistort )
+  {
+    Distort( o_pPoints, i_Count, o_pPoints );
+  }
+}
+
+void VCameraCalibration::Rays( const double * i_pPoints, std::size_t i_Count, double * o_pDirections ) const
+{
+  // Undistort a block at a time, then invert the pinhole and rotate back to the world: d = R^T ( x, y, 1 )
+  const double * R = m_Rotation;
+  const double InvF = 1.0 / m_FocalLength;
+  const double Skew = m_Skew;
+  const double Px = m_PrincipalPoint[ 0 ];
+  const double Py = m_PrincipalPoint[ 1 ];
+
+  double Undistorted[ s_RayBlock * 2 ];
+  for( std::size_t Begin = 0; Begin < i_Count; Begin += s_RayBlock )
+  {
+    const std::size_t Count = ( std::min )( s_RayBlock, i_Count - Begin );
+    Undistort( i_pPoints + Begin * 2, Count, Undistorted );
+    double * pDirections = o_pDirections + Begin * 3;
+
+    std::size_t Point = 0;
+#ifdef VICON_CALIBRATION_SSE2
+    const __m128d R0 = _mm_set1_pd( R[ 0 ] ), R1 = _mm_set1_pd( R[ 1 ] ), R2 = _mm_set1_pd( R[ 2 ] );
+    const __m128d R3 = _mm_set1_pd( R[ 3 ] ), R4 = _mm_set1_pd( R[ 4 ] ), R5 = _mm_set1_pd( R[ 5 ] );
+    const __m128d R6 = _mm_set1_pd( R[ 6 ] ), R7 = _mm_set1_pd( R[ 7 ] ), R8 = _mm_set1_pd( R[ 8 ] );
+    const __m128d InvFs = _mm_set1_pd( InvF );
+    const __m128d Skews = _mm_set1_pd( Skew );
+    const __m128d PX = _mm_set1_pd( Px );
+    const __m128d PY = _mm_set1_pd( Py );
+    for( ; Point + 2 <= Count; Point += 2 )
+    {
+      __m128d U, V;
+      LoadXY( Undistorted + Point * 2, U, V );
+      const __m128d Ny = _mm_mul_pd( _mm_sub_pd( V, PY ), InvFs );
+      const __m128d Nx = _mm_mul_pd( _mm_sub_pd( _mm_sub_pd( U, PX ), _mm_mul_pd( Skews, Ny ) ), InvFs );
+      const __m128d Dx = _mm_add_pd( _mm_add_pd( _mm_mul_pd( R0, Nx ), _mm_mul_pd( R3, Ny ) ), R6 );
+      const __m128d Dy = _mm_add_pd( _mm_add_pd( _mm_mul_pd( R1, Nx ), _mm_mul_pd( R4, Ny ) ), R7 );
+      const __m128d Dz = _mm_add_pd( _mm_add_pd( _mm_mul_pd( R2, Nx ), _mm_mul_pd( R5, Ny ) ), R8 );
+      const __m128d Length = _mm_sqrt_pd( _mm_add_pd( _mm_add_pd( _mm_mul_pd( Dx, Dx ), _mm_mul_pd( Dy, Dy ) ), _mm_mul_pd( Dz, Dz ) ) );
+      StoreXYZ( _mm_div_pd( Dx, Length ), _mm_div_pd( Dy, Length ), _mm_div_pd( Dz, Length ), pDirections + Point * 3 );
+    }
+#endif
+    for( ; Point < Count; ++Point )
+    {
+      const double Ny = ( Undistorted[ Point * 2 + 1 ] - Py ) * InvF;
+      const double Nx = ( ( Undistorted[ Point * 2 ] - Px ) - Skew * Ny ) * InvF;
+      const double Dx = R[ 0 ] * Nx + R[ 3 ] * Ny + R[ 6 ];
+      const double Dy = R[ 1 ] * Nx + R[ 4 ] * Ny + R[ 7 ];
+      const double Dz = R[ 2 ] * Nx + R[ 5 ] * Ny + R[ 8 ];
+      const double Length = std::sqrt( Dx * Dx + Dy * Dy + Dz * Dz );
+      pDirections[ Point * 3 ] = Dx / Length;
+      pDirections[ Point * 3 + 1 ] = Dy / Length;
+      pDirections[ Point * 3 + 2 ] = Dz / Length;
+    }
+  }
+}
+
+} // End of namespace Core
+} // End of namespace ViconDataStreamSDK
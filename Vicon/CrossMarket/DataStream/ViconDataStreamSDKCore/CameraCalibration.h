@@ -0,0 +1,86 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <ViconCGStream/CameraCalibrationInfo.h>
+
+#include <cstddef>
+
+namespace ViconDataStreamSDK
+{
+namespace Core
+{
+
+// The geometry of one calibrated camera, with kernels that apply it to many points at once.
+//
+// The camera sits at m_PoseTranslation and m_PoseRotation (row-major) takes world directions into the camera frame, so
+// a world point X is at R ( X - T ) in the camera, looking down +z. Image points are in pixels:
+//   u = f x / z + s y / z + px,  v = f y / z + py
+// with focal length f, skew s and principal point ( px, py ). Lens distortion is radial about the principal point: a
+// distorted point d is undistorted to p + ( d - p )( 1 + k1 r^2 + k2 r^4 ), where r is the distance of d from the
+// principal point p in pixels.
+//
+// Points are passed as contiguous x, y ( image ) or x, y, z ( world ) values. Output may overwrite input of the same shape.
+class VCameraCalibration
+{
+public:
+  explicit VCameraCalibration( const ViconCGStream::VCameraCalibrationInfo & i_rInfo );
+
+  unsigned int CameraID() const { return m_CameraID; }
+
+  // Express the world in axes rotated by i_Rotation ( row-major ), as the client's axis mapping does to its output
+  void RotateWorld( const double ( & i_Rotation )[ 9 ] );
+
+  // Camera centre in world coordinates
+  void GetPosition( double ( & o_rPosition )[ 3 ] ) const;
+
+  // Remove lens distortion from measured image points
+  void Undistort( const double * i_pPoints, std::size_t i_Count, double * o_pPoints ) const;
+
+  // Apply lens distortion to ideal image points. Inverts Undistort by Newton's method.
+  void Distort( const double * i_pPoints, std::size_t i_Count, double * o_pPoints ) const;
+
+  // Project world points into the image, with lens distortion when i_bDistort is set. Points on or behind the camera
+  // plane give NaN.
+  void Project( const double * i_pPoints, std::size_t i_Count, double * o_pPoints, bool i_bDistort = true ) const;
+
+  // Unit world direction of the ray through each measured image point; every ray starts at the camera centre
+  void Rays( const double * i_pPoints, std::size_t i_Count, double * o_pDirections ) const;
+
+private:
+  unsigned int m_CameraID;
+
+  // World to camera rotation, row-major, and camera centre
+  double m_Rotation[ 9 ];
+  double m_Position[ 3 ];
+
+  double m_PrincipalPoint[ 2 ];
+  double m_RadialDistortion[ 2 ];
+  double m_FocalLength;
+  double m_Skew;
+};
+
+} // End of namespace Core
+} // End of namespace ViconDataStreamSDK
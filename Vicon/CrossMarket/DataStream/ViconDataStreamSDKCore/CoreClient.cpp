@@ -24,6 +24,7 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "CoreClient.h"
 #include "WirelessConfiguration.h"
+#include "CameraCalibration.h"
 
 #include <ViconDataStreamSDKCoreUtils/ClientUtils.h>
 
@@ -34,7 +35,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include <ViconCGStreamClient/ViconCGStreamClient.h>
-#include <ViconCGStreamClient/CGStreamPostalService.h>
+#include <ViconCGStreamClient/CGStreamLazyVideoFrame.h>
 
 #include "ViconDataStreamSDKCoreVersion.h"
 
@@ -147,6 +148,10 @@ VClient::VClient()
 , m_bVideoDataEnabled( false )
 , m_bSubjectScaleEnabled ( false )
 , m_BufferSize( 1 )
+, m_DecodeThreadCount( 0 )
+, m_bDecodeVideo( false )
+, m_bDecodeVideoOnAccess( false )
+, m_bBinaryTimingLog( false )
 {
   SetAxisMapping( Direction::Forward, Direction::Left, Direction::Up );
 
@@ -207,7 +212,10 @@ Result::Enum VClient::Connect(       std::shared_ptr< ViconCGStreamClientSDK::IC
   }
 
   // Kill any old client
-  m_pClient.reset();
+  {
+    boost::mutex::scoped_lock ClientLock( m_ClientMutex );
+    m_pClient.reset();
+  }
 
   std::vector< std::pair< std::string, unsigned short > > Hosts;
 
@@ -253,8 +261,14 @@ Result::Enum VClient::Connect(       std::shared_ptr< ViconCGStreamClientSDK::IC
   }
 
   // copy the pointer if all is well
-  m_pClient = i_pClient;
+  {
+    boost::mutex::scoped_lock ClientLock( m_ClientMutex );
+    m_pClient = i_pClient;
+  }
   m_pClient->SetBufferSize(m_BufferSize);
+  m_pClient->SetDecodeThreadCount( m_DecodeThreadCount );
+  m_pClient->SetDecodeVideo( m_bDecodeVideo, m_bDecodeVideoOnAccess );
+  ApplyVideoDecodeWindows();
 
   // set some default request types
   m_pClient->SetRequestTypes( ViconCGStreamEnum::Contents );
@@ -274,6 +288,7 @@ Result::Enum VClient::Connect(       std::shared_ptr< ViconCGStreamClientSDK::IC
   m_pClient->SetRequestTypes( ViconCGStreamEnum::CameraInfo, false );
   m_pClient->SetRequestTypes( ViconCGStreamEnum::Centroids, false );
   m_pClient->SetRequestTypes( ViconCGStreamEnum::CentroidWeights, false );
+  m_pClient->SetRequestTypes( ViconCGStreamEnum::CentroidTracks, false );
   m_pClient->SetRequestTypes( ViconCGStreamEnum::VideoFrame, false );
   m_pClient->SetRequestTypes( ViconCGStreamEnum::LabeledRecons, false );
   m_pClient->SetRequestTypes( ViconCGStreamEnum::UnlabeledRecons, false );
@@ -296,7 +311,7 @@ Result::Enum VClient::Connect(       std::shared_ptr< ViconCGStreamClientSDK::IC
 
   if (!m_ClientLogFile.empty())
   {
-    m_pClient->SetLogFile(m_ClientLogFile);
+    m_pClient->SetLogFile(m_ClientLogFile, m_bBinaryTimingLog);
   }
 
   return Result::Success;
@@ -347,7 +362,10 @@ Result::Enum VClient::ConnectToMulticast( std::shared_ptr< ViconCGStreamClientSD
   }
 
   // Kill any old client
-  m_pClient.reset();
+  {
+    boost::mutex::scoped_lock ClientLock( m_ClientMutex );
+    m_pClient.reset();
+  }
 
   // Parse the supplied host name to strip any port (the port cannot be specified)
   std::string    LocalIP = i_rLocalIP;
@@ -368,8 +386,14 @@ Result::Enum VClient::ConnectToMulticast( std::shared_ptr< ViconCGStreamClientSD
   }
 
   // copy the pointer if all is well
-  m_pClient = i_pClient;
+  {
+    boost::mutex::scoped_lock ClientLock( m_ClientMutex );
+    m_pClient = i_pClient;
+  }
   m_pClient->SetBufferSize( m_BufferSize );
+  m_pClient->SetDecodeThreadCount( m_DecodeThreadCount );
+  m_pClient->SetDecodeVideo( m_bDecodeVideo, m_bDecodeVideoOnAccess );
+  ApplyVideoDecodeWindows();
 
   return Result::Success;
 }
@@ -387,7 +411,10 @@ Result::Enum VClient::Disconnect()
     return Result::NotConnected;
   }  
 
-  m_pClient.reset(); 
+  {
+    boost::mutex::scoped_lock ClientLock( m_ClientMutex );
+    m_pClient.reset();
+  }
 
   return Result::Success;
 }
@@ -491,6 +518,43 @@ void VClient::SetBufferSize( unsigned int i_MaxFrames )
   }
 }
 
+void VClient::SetDecodeThreadCount( unsigned int i_ThreadCount )
+{
+  m_DecodeThreadCount = i_ThreadCount;
+  if( m_pClient )
+  {
+    m_pClient->SetDecodeThreadCount( m_DecodeThreadCount );
+  }
+}
+
+void VClient::SetDecodeVideo( bool i_bDecode, bool i_bOnAccess )
+{
+  m_bDecodeVideo = i_bDecode;
+  m_bDecodeVideoOnAccess = i_bOnAccess;
+  if( m_pClient )
+  {
+    m_pClient->SetDecodeVideo( m_bDecodeVideo, m_bDecodeVideoOnAccess );
+  }
+}
+
+void VClient::SetVideoDecodeWindow( unsigned int i_CameraID, unsigned int i_Binning, unsigned int i_X, unsigned int i_Y, unsigned int i_Width, unsigned int i_Height )
+{
+  m_VideoDecodeWindows[ i_CameraID ] = VViconCGStreamVideo::VWindow( i_X, i_Y, i_Width, i_Height, i_Binning );
+  if( m_pClient )
+  {
+    m_pClient->SetVideoDecodeWindow( i_CameraID, i_Binning, i_X, i_Y, i_Width, i_Height );
+  }
+}
+
+void VClient::ApplyVideoDecodeWindows()
+{
+  for( const auto & rWindow : m_VideoDecodeWindows )
+  {
+    const VViconCGStreamVideo::VWindow & rVideoWindow = rWindow.second;
+    m_pClient->SetVideoDecodeWindow( rWindow.first, rVideoWindow.m_Binning, rVideoWindow.m_X, rVideoWindow.m_Y, rVideoWindow.m_Width, rVideoWindow.m_Height );
+  }
+}
+
 Result::Enum VClient::GetFrame()
 {
   if( !IsConnected() )
@@ -547,6 +611,21 @@ Result::Enum VClient::GetFrame()
   }
 }
 
+void VClient::CancelGetFrame()
+{
+  // Called from another thread than the one in GetFrame, so copy the client under the lock in case of a concurrent
+  // disconnect; the copy keeps it alive while it is woken
+  std::shared_ptr< ViconCGStreamClientSDK::ICGClient > pClient;
+  {
+    boost::mutex::scoped_lock ClientLock( m_ClientMutex );
+    pClient = m_pClient;
+  }
+  if( pClient )
+  {
+    pClient->CancelWait();
+  }
+}
+
 bool VClient::InitGet( Result::Enum & o_rResult ) const
 {
   o_rResult = Result::Success;
@@ -668,6 +747,19 @@ Result::Enum VClient::GetLatencyTotal( double & o_rLatency ) const
   return Result::Success;
 }
 
+Result::Enum VClient::GetFrameReceiptTime( double & o_rReceiptTime ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  Result::Enum GetResult = Result::Success;
+  if( InitGet( GetResult, o_rReceiptTime ) )
+  {
+    o_rReceiptTime = std::chrono::duration< double >( m_LatestFrame.m_ReceiptTime.time_since_epoch() ).count();
+  }
+
+  return GetResult;
+}
+
 Result::Enum VClient::GetLatencySampleCount( unsigned int & o_rSampleCount ) const
 {
   boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
@@ -942,6 +1034,8 @@ Result::Enum VClient::SetCentroidDataEnabled( const bool i_bEnabled )
   m_pClient->SetRequestTypes( ViconCGStreamEnum::CameraSensorInfo, i_bEnabled);
   m_pClient->SetRequestTypes( ViconCGStreamEnum::Centroids, i_bEnabled );
   m_pClient->SetRequestTypes( ViconCGStreamEnum::CentroidWeights, i_bEnabled );
+  m_pClient->SetRequestTypes( ViconCGStreamEnum::CentroidTracks, i_bEnabled );
+  m_pClient->SetRequestTypes( ViconCGStreamEnum::CameraCalibrationInfo, i_bEnabled );
 
   m_bCentroidDataEnabled = i_bEnabled;
   return Result::Success;
@@ -2730,7 +2824,113 @@ const ViconCGStream::VCentroidWeights * VClient::GetCentroidWeightSet( const uns
   return nullptr;
 }
 
-const ViconCGStream::VGreyscaleBlobs  * VClient::GetGreyscaleBlobs( const unsigned int i_CameraID, Result::Enum & o_rResult ) const
+const ViconCGStream::VCentroidTracks * VClient::GetCentroidTrackSet( const unsigned int i_CameraID, Result::Enum & o_rResult ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  const auto rCentroidTrackSetIt = std::find_if( m_LatestFrame.m_CentroidTracks.begin(), m_LatestFrame.m_CentroidTracks.end(),
+    [&i_CameraID]( const ViconCGStream::VCentroidTracks & rSet )
+  {
+    return rSet.m_CameraID == i_CameraID;
+  } );
+
+  if( rCentroidTrackSetIt != m_LatestFrame.m_CentroidTracks.end() )
+  {
+    o_rResult = Result::Success;
+    return &( *rCentroidTrackSetIt );
+  }
+
+  o_rResult = Result::InvalidIndex;
+  return nullptr;
+}
+
+const ViconCGStream::VCameraCalibrationInfo * VClient::GetCameraCalibrationInfo( const unsigned int i_CameraID, Result::Enum & o_rResult ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  const auto rCalibrationIt = std::find_if( m_LatestFrame.m_CameraCalibrations.begin(), m_LatestFrame.m_CameraCalibrations.end(),
+    [&i_CameraID]( const ViconCGStream::VCameraCalibrationInfo & rCalibration )
+  {
+    return rCalibration.m_CameraID == i_CameraID;
+  } );
+
+  if( rCalibrationIt != m_LatestFrame.m_CameraCalibrations.end() )
+  {
+    o_rResult = Result::Success;
+    return &( *rCalibrationIt );
+  }
+
+  o_rResult = Result::InvalidIndex;
+  return nullptr;
+}
+
+VCameraCalibration VClient::ClientCameraCalibration( const ViconCGStream::VCameraCalibrationInfo & i_rInfo ) const
+{
+  // Calibrations are in the server's axes. The axis mapping is a rotation, so its matrix has the mapped unit axes as columns.
+  double Rotation[ 9 ];
+  for( unsigned int Column = 0; Column < 3; ++Column )
+  {
+    double Axis[ 3 ] = { 0.0, 0.0, 0.0 };
+    Axis[ Column ] = 1.0;
+    double MappedAxis[ 3 ];
+    CopyAndTransformT( Axis, MappedAxis );
+    for( unsigned int Row = 0; Row < 3; ++Row )
+    {
+      Rotation[ Row * 3 + Column ] = MappedAxis[ Row ];
+    }
+  }
+
+  VCameraCalibration Calibration( i_rInfo );
+  Calibration.RotateWorld( Rotation );
+  return Calibration;
+}
+
+void VClient::AppendCentroids( const ViconCGStream::VCentroids & i_rCentroidSet,
+                               std::vector< unsigned int > & io_rCameraIDs,
+                               std::vector< unsigned int > & io_rCameraOffsets,
+                               std::vector< double > & io_rPositions,
+                               std::vector< double > & io_rRadii,
+                               std::vector< double > & io_rWeights,
+                               std::vector< unsigned long long > & io_rTrackIDs ) const
+{
+  const size_t Offset = io_rRadii.size();
+  const size_t Count = i_rCentroidSet.m_Centroids.size();
+
+  io_rCameraIDs.push_back( i_rCentroidSet.m_CameraID );
+  io_rCameraOffsets.push_back( static_cast< unsigned int >( Offset ) );
+
+  for( const ViconCGStreamDetail::VCentroids_Centroid & rCentroid : i_rCentroidSet.m_Centroids )
+  {
+    io_rPositions.push_back( rCentroid.m_Position[ 0 ] );
+    io_rPositions.push_back( rCentroid.m_Position[ 1 ] );
+    io_rRadii.push_back( rCentroid.m_Radius );
+  }
+
+  // Weights and tracks arrive in their own items, and either may be missing for this camera
+  Result::Enum Ignored;
+  io_rWeights.resize( Offset + Count, 0.0 );
+  const ViconCGStream::VCentroidWeights * pCentroidWeightSet = GetCentroidWeightSet( i_rCentroidSet.m_CameraID, Ignored );
+  if( pCentroidWeightSet )
+  {
+    const size_t NumWeights = ( std::min )( Count, pCentroidWeightSet->m_Weights.size() );
+    std::copy( pCentroidWeightSet->m_Weights.begin(), pCentroidWeightSet->m_Weights.begin() + NumWeights, io_rWeights.begin() + Offset );
+  }
+
+  io_rTrackIDs.resize( Offset + Count, ~0ull );
+  const ViconCGStream::VCentroidTracks * pCentroidTrackSet = GetCentroidTrackSet( i_rCentroidSet.m_CameraID, Ignored );
+  if( pCentroidTrackSet )
+  {
+    for( const ViconCGStreamDetail::VCentroidTracks_CentroidTrack & rTrack : pCentroidTrackSet->m_CentroidTracks )
+    {
+      if( rTrack.m_CentroidIndex < Count )
+      {
+        io_rTrackIDs[ Offset + rTrack.m_CentroidIndex ] = rTrack.m_TrackId;
+      }
+    }
+  }
+}
+
+ViconCGStreamClientSDK::VGreyscaleBlobsPtr VClient::GetGreyscaleBlobs( const unsigned int i_CameraID, Result::Enum & o_rResult ) const
 {
   boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
 
@@ -2738,33 +2938,33 @@ const ViconCGStream::VGreyscaleBlobs  * VClient::GetGreyscaleBlobs( const unsign
   // When the camera information contains the subsampling mode, we will be able to tell where the data should be and give an appropriate error
   // if it isn't, but for now, look in both places
   const auto rGreyscaleSubsampledBlobIt = std::find_if( m_LatestFrame.m_GreyscaleSubsampledBlobs.begin(), m_LatestFrame.m_GreyscaleSubsampledBlobs.end(),
-                                              [&i_CameraID](const ViconCGStream::VGreyscaleSubsampledBlobs & rSet )
+                                              [&i_CameraID](const ViconCGStreamClientSDK::VGreyscaleBlobsPtr & rpSet )
                                               {
-                                                return rSet.m_CameraID == i_CameraID;
+                                                return rpSet->m_CameraID == i_CameraID;
                                               });
   if (rGreyscaleSubsampledBlobIt != m_LatestFrame.m_GreyscaleSubsampledBlobs.end())
   {
     o_rResult = Result::Success;
-    return &(*rGreyscaleSubsampledBlobIt);
+    return *rGreyscaleSubsampledBlobIt;
   }
   else
   {
     const auto rGreyscaleBlobIt = std::find_if(m_LatestFrame.m_GreyscaleBlobs.begin(), m_LatestFrame.m_GreyscaleBlobs.end(),
-      [&i_CameraID](const ViconCGStream::VGreyscaleBlobs & rSet)
+      [&i_CameraID](const ViconCGStreamClientSDK::VGreyscaleBlobsPtr & rpSet)
     {
-      return rSet.m_CameraID == i_CameraID;
+      return rpSet->m_CameraID == i_CameraID;
     });
 
 
     if (rGreyscaleBlobIt != m_LatestFrame.m_GreyscaleBlobs.end())
     {
       o_rResult = Result::Success;
-      return &(*rGreyscaleBlobIt);
+      return *rGreyscaleBlobIt;
     }
   }
 
   o_rResult = Result::InvalidIndex;
-  return nullptr;
+  return ViconCGStreamClientSDK::VGreyscaleBlobsPtr();
 }
 
 void VClient::GetVideoFrame( const unsigned int i_CameraID, Result::Enum & o_rResult, ViconCGStreamClientSDK::VVideoFramePtr & o_rVideoFramePtr ) const
@@ -2780,7 +2980,8 @@ void VClient::GetVideoFrame( const unsigned int i_CameraID, Result::Enum & o_rRe
   if( rVideoFramePtrIt != m_LatestFrame.m_VideoFrames.end() )
   {
     o_rResult = Result::Success;
-    o_rVideoFramePtr = *rVideoFramePtrIt;
+    // Frames received for decode on access are decoded here, the first time they are asked for
+    o_rVideoFramePtr = VCGStreamLazyVideoFrame::Resolve( *rVideoFramePtrIt );
   }
   else
   {
@@ -4716,6 +4917,164 @@ Result::Enum VClient::GetCentroidWeight( const std::string & i_rCameraName,
   return GetResult;
 }
 
+Result::Enum VClient::GetCentroids( const std::string & i_rCameraName,
+                                    std::vector< unsigned int > & o_rCameraIDs,
+                                    std::vector< unsigned int > & o_rCameraOffsets,
+                                    std::vector< double > & o_rPositions,
+                                    std::vector< double > & o_rRadii,
+                                    std::vector< double > & o_rWeights,
+                                    std::vector< unsigned long long > & o_rTrackIDs ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  ClientUtils::Clear( o_rCameraIDs );
+  ClientUtils::Clear( o_rCameraOffsets );
+  ClientUtils::Clear( o_rPositions );
+  ClientUtils::Clear( o_rRadii );
+  ClientUtils::Clear( o_rWeights );
+  ClientUtils::Clear( o_rTrackIDs );
+
+  Result::Enum GetResult = Result::Success;
+  if( InitGet( GetResult ) )
+  {
+    if( i_rCameraName.empty() )
+    {
+      size_t NumCentroids = 0;
+      for( const ViconCGStream::VCentroids & rCentroidSet : m_LatestFrame.m_Centroids )
+      {
+        NumCentroids += rCentroidSet.m_Centroids.size();
+      }
+
+      o_rCameraIDs.reserve( m_LatestFrame.m_Centroids.size() );
+      o_rCameraOffsets.reserve( m_LatestFrame.m_Centroids.size() );
+      o_rPositions.reserve( 2 * NumCentroids );
+      o_rRadii.reserve( NumCentroids );
+      o_rWeights.reserve( NumCentroids );
+      o_rTrackIDs.reserve( NumCentroids );
+
+      for( const ViconCGStream::VCentroids & rCentroidSet : m_LatestFrame.m_Centroids )
+      {
+        AppendCentroids( rCentroidSet, o_rCameraIDs, o_rCameraOffsets, o_rPositions, o_rRadii, o_rWeights, o_rTrackIDs );
+      }
+      return GetResult;
+    }
+
+    const ViconCGStream::VCameraInfo* pCamera = GetCamera( i_rCameraName, GetResult );
+    if( !pCamera )
+    {
+      return GetResult;
+    }
+
+    const ViconCGStream::VCentroids* pCentroidSet = GetCentroidSet( pCamera->m_CameraID, GetResult );
+    if( pCentroidSet )
+    {
+      AppendCentroids( *pCentroidSet, o_rCameraIDs, o_rCameraOffsets, o_rPositions, o_rRadii, o_rWeights, o_rTrackIDs );
+    }
+  }
+  return GetResult;
+}
+
+Result::Enum VClient::GetUndistortedCentroids( const std::string & i_rCameraName, std::vector< double > & o_rPositions ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  Result::Enum GetResult = Result::Success;
+  if( InitGet( GetResult, o_rPositions ) )
+  {
+    const ViconCGStream::VCameraInfo* pCamera = GetCamera( i_rCameraName, GetResult );
+    if( !pCamera )
+    {
+      return GetResult;
+    }
+
+    const ViconCGStream::VCameraCalibrationInfo* pCalibration = GetCameraCalibrationInfo( pCamera->m_CameraID, GetResult );
+    if( !pCalibration )
+    {
+      return GetResult;
+    }
+
+    const ViconCGStream::VCentroids* pCentroidSet = GetCentroidSet( pCamera->m_CameraID, GetResult );
+    if( pCentroidSet )
+    {
+      const size_t NumCentroids = pCentroidSet->m_Centroids.size();
+      o_rPositions.resize( 2 * NumCentroids );
+      for( size_t Centroid = 0; Centroid != NumCentroids; ++Centroid )
+      {
+        o_rPositions[ 2 * Centroid ] = pCentroidSet->m_Centroids[ Centroid ].m_Position[ 0 ];
+        o_rPositions[ 2 * Centroid + 1 ] = pCentroidSet->m_Centroids[ Centroid ].m_Position[ 1 ];
+      }
+      VCameraCalibration( *pCalibration ).Undistort( o_rPositions.data(), NumCentroids, o_rPositions.data() );
+    }
+  }
+  return GetResult;
+}
+
+Result::Enum VClient::GetCentroidRays( const std::string & i_rCameraName, double ( & o_rOrigin )[ 3 ], std::vector< double > & o_rDirections ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  Result::Enum GetResult = Result::Success;
+  if( InitGet( GetResult, o_rOrigin, o_rDirections ) )
+  {
+    const ViconCGStream::VCameraInfo* pCamera = GetCamera( i_rCameraName, GetResult );
+    if( !pCamera )
+    {
+      return GetResult;
+    }
+
+    const ViconCGStream::VCameraCalibrationInfo* pCalibration = GetCameraCalibrationInfo( pCamera->m_CameraID, GetResult );
+    if( !pCalibration )
+    {
+      return GetResult;
+    }
+
+    const ViconCGStream::VCentroids* pCentroidSet = GetCentroidSet( pCamera->m_CameraID, GetResult );
+    if( pCentroidSet )
+    {
+      const size_t NumCentroids = pCentroidSet->m_Centroids.size();
+      std::vector< double > Positions( 2 * NumCentroids );
+      for( size_t Centroid = 0; Centroid != NumCentroids; ++Centroid )
+      {
+        Positions[ 2 * Centroid ] = pCentroidSet->m_Centroids[ Centroid ].m_Position[ 0 ];
+        Positions[ 2 * Centroid + 1 ] = pCentroidSet->m_Centroids[ Centroid ].m_Position[ 1 ];
+      }
+
+      const VCameraCalibration Calibration = ClientCameraCalibration( *pCalibration );
+      Calibration.GetPosition( o_rOrigin );
+      o_rDirections.resize( 3 * NumCentroids );
+      Calibration.Rays( Positions.data(), NumCentroids, o_rDirections.data() );
+    }
+  }
+  return GetResult;
+}
+
+Result::Enum VClient::ProjectPoints( const std::vector< double > & i_rPoints,
+                                     std::vector< unsigned int > & o_rCameraIDs,
+                                     std::vector< double > & o_rPositions ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  Result::Enum GetResult = Result::Success;
+  if( InitGet( GetResult, o_rCameraIDs, o_rPositions ) )
+  {
+    if( i_rPoints.size() % 3 != 0 )
+    {
+      return Result::InvalidIndex;
+    }
+
+    const size_t NumPoints = i_rPoints.size() / 3;
+    o_rCameraIDs.reserve( m_LatestFrame.m_CameraCalibrations.size() );
+    o_rPositions.resize( 2 * NumPoints * m_LatestFrame.m_CameraCalibrations.size() );
+    for( const ViconCGStream::VCameraCalibrationInfo & rCalibration : m_LatestFrame.m_CameraCalibrations )
+    {
+      double * pPositions = o_rPositions.data() + 2 * NumPoints * o_rCameraIDs.size();
+      o_rCameraIDs.push_back( rCalibration.m_CameraID );
+      ClientCameraCalibration( rCalibration ).Project( i_rPoints.data(), NumPoints, pPositions );
+    }
+  }
+  return GetResult;
+}
+
 Result::Enum VClient::GetGreyscaleBlobCount( const std::string & i_rCameraName, unsigned int & o_rCount ) const
 {
   boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
@@ -4729,10 +5088,10 @@ Result::Enum VClient::GetGreyscaleBlobCount( const std::string & i_rCameraName,
       return GetResult;
     }
 
-    const ViconCGStream::VGreyscaleBlobs * pBlobSet = GetGreyscaleBlobs( pCamera->m_CameraID, GetResult );
+    const ViconCGStreamClientSDK::VGreyscaleBlobsPtr pBlobSet = GetGreyscaleBlobs( pCamera->m_CameraID, GetResult );
     if( pBlobSet )
     {
-      o_rCount = static_cast< unsigned int >( pBlobSet->m_GreyscaleBlobs.size() );
+      o_rCount = static_cast< unsigned int >( pBlobSet->BlobCount() );
     }
   }
   return GetResult;
@@ -4755,7 +5114,7 @@ Result::Enum VClient::GetGreyscaleBlobSubsampleInfo(const std::string & i_rCamer
       return GetResult;
     }
 
-    const ViconCGStream::VGreyscaleBlobs * pBlobSet = GetGreyscaleBlobs(pCamera->m_CameraID, GetResult);
+    const ViconCGStreamClientSDK::VGreyscaleBlobsPtr pBlobSet = GetGreyscaleBlobs(pCamera->m_CameraID, GetResult);
     if (pBlobSet)
     {
       o_rTwiceOffsetX = pBlobSet->m_TwiceOffsetX;
@@ -4784,22 +5143,23 @@ Result::Enum VClient::GetGreyscaleBlob( const std::string & i_rCameraName,
       return GetResult;
     }
 
-    const ViconCGStream::VGreyscaleBlobs* pBlobSet = GetGreyscaleBlobs( pCamera->m_CameraID, GetResult );
+    const ViconCGStreamClientSDK::VGreyscaleBlobsPtr pBlobSet = GetGreyscaleBlobs( pCamera->m_CameraID, GetResult );
     if( pBlobSet )
     {
-      if( i_BlobIndex < pBlobSet->m_GreyscaleBlobs.size() )
+      if( i_BlobIndex < pBlobSet->BlobCount() )
       {
-        const ViconCGStreamDetail::VGreyscaleBlobs_GreyscaleBlob & rBlob = pBlobSet->m_GreyscaleBlobs[ i_BlobIndex ];
+        const auto Lines = pBlobSet->BlobLines( i_BlobIndex );
 
-        o_rLineXPositions.reserve( rBlob.m_GreyscaleLines.size() );
-        o_rLineYPositions.reserve( rBlob.m_GreyscaleLines.size() );
-        o_rLinePixelValues.reserve( rBlob.m_GreyscaleLines.size() );
+        o_rLineXPositions.reserve( Lines.size() );
+        o_rLineYPositions.reserve( Lines.size() );
+        o_rLinePixelValues.reserve( Lines.size() );
 
-        for ( auto line : rBlob.m_GreyscaleLines )
+        for ( const auto & rLine : Lines )
         {
-          o_rLineXPositions.push_back( line.m_Position[0] );
-          o_rLineYPositions.push_back( line.m_Position[1] );
-          o_rLinePixelValues.push_back( line.m_Greyscale);
+          const auto Pixels = pBlobSet->LinePixels( rLine );
+          o_rLineXPositions.push_back( rLine.m_Position[0] );
+          o_rLineYPositions.push_back( rLine.m_Position[1] );
+          o_rLinePixelValues.emplace_back( Pixels.begin(), Pixels.end() );
         }
 
       }
@@ -4813,6 +5173,27 @@ Result::Enum VClient::GetGreyscaleBlob( const std::string & i_rCameraName,
   return GetResult;
 }
 
+Result::Enum VClient::GetGreyscaleBlobs( const std::string & i_rCameraName, ViconCGStreamClientSDK::VGreyscaleBlobsPtr & o_rBlobsPtr ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  o_rBlobsPtr.reset();
+
+  Result::Enum GetResult = Result::Success;
+  if ( InitGet( GetResult ) )
+  {
+    const ViconCGStream::VCameraInfo* pCamera = GetCamera( i_rCameraName, GetResult );
+    if( !pCamera )
+    {
+      return GetResult;
+    }
+
+    o_rBlobsPtr = GetGreyscaleBlobs( pCamera->m_CameraID, GetResult );
+  }
+
+  return GetResult;
+}
+
 Result::Enum VClient::GetVideoFrame( const std::string & i_rCameraName, ViconCGStreamClientSDK::VVideoFramePtr & o_rVideoFramePtr ) const
 {
   boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
@@ -4884,6 +5265,7 @@ Result::Enum VClient::ClearSubjectFilter()
   m_Filter.Clear( ViconCGStreamEnum::LightweightSegments );
   m_Filter.Clear( ViconCGStreamEnum::SubjectScale );
   m_Filter.Clear( ViconCGStreamEnum::SubjectTopology );
+  m_Filter.Clear( ViconCGStreamEnum::ObjectQuality );
 
   m_pClient->SetFilter(m_Filter);
 
@@ -4909,6 +5291,267 @@ Result::Enum VClient::AddToSubjectFilter(const std::string & i_rSubjectName)
   return Result;
 }
 
+Result::Enum VClient::AddToCameraFilter( const unsigned int i_CameraId, const bool i_bCentroids, const bool i_bBlobs, const bool i_bVideo )
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  if( !IsConnected() )
+  {
+    return Result::NotConnected;
+  }
+
+  // The dummy id keeps the filter active once the last real camera has been removed again
+  if( i_bCentroids )
+  {
+    m_Filter.Add( ViconCGStreamEnum::Centroids, i_CameraId );
+    m_Filter.Add( ViconCGStreamEnum::Centroids, -1 );
+  }
+
+  if( i_bBlobs )
+  {
+    m_Filter.Add( ViconCGStreamEnum::GreyscaleBlobs, i_CameraId );
+    m_Filter.Add( ViconCGStreamEnum::GreyscaleBlobs, -1 );
+  }
+
+  if( i_bVideo )
+  {
+    m_Filter.Add( ViconCGStreamEnum::VideoFrame, i_CameraId );
+    m_Filter.Add( ViconCGStreamEnum::VideoFrame, -1 );
+  }
+
+  m_pClient->SetFilter( m_Filter );
+
+  return Result::Success;
+}
+
+Result::Enum VClient::RemoveFromCameraFilter( const unsigned int i_CameraId, const bool i_bCentroids, const bool i_bBlobs, const bool i_bVideo )
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  if( !IsConnected() )
+  {
+    return Result::NotConnected;
+  }
+
+  std::vector< unsigned int > CameraIds;
+  CameraIds.reserve( m_LatestFrame.m_Cameras.size() );
+  for( const auto & rCamera : m_LatestFrame.m_Cameras )
+  {
+    CameraIds.push_back( rCamera.m_CameraID );
+  }
+
+  if( i_bCentroids )
+  {
+    RemoveFromFilter( ViconCGStreamEnum::Centroids, i_CameraId, CameraIds );
+  }
+
+  if( i_bBlobs )
+  {
+    RemoveFromFilter( ViconCGStreamEnum::GreyscaleBlobs, i_CameraId, CameraIds );
+  }
+
+  if( i_bVideo )
+  {
+    RemoveFromFilter( ViconCGStreamEnum::VideoFrame, i_CameraId, CameraIds );
+  }
+
+  m_pClient->SetFilter( m_Filter );
+
+  return Result::Success;
+}
+
+Result::Enum VClient::RemoveFromSubjectFilter( const std::string & i_rSubjectName )
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  Result::Enum GetResult;
+  if( InitGet( GetResult ) )
+  {
+    const ViconCGStream::VSubjectInfo * pSubjectInfo = GetSubjectInfo( i_rSubjectName, GetResult );
+    if( pSubjectInfo )
+    {
+      std::vector< unsigned int > SubjectIds;
+      SubjectIds.reserve( m_LatestFrame.m_Subjects.size() );
+      for( const auto & rSubject : m_LatestFrame.m_Subjects )
+      {
+        SubjectIds.push_back( rSubject.m_SubjectID );
+      }
+
+      RemoveFromFilter( ViconCGStreamEnum::GlobalSegments, pSubjectInfo->m_SubjectID, SubjectIds );
+      RemoveFromFilter( ViconCGStreamEnum::LocalSegments, pSubjectInfo->m_SubjectID, SubjectIds );
+      RemoveFromFilter( ViconCGStreamEnum::LightweightSegments, pSubjectInfo->m_SubjectID, SubjectIds );
+      RemoveFromFilter( ViconCGStreamEnum::ObjectQuality, pSubjectInfo->m_SubjectID, SubjectIds );
+
+      m_pClient->SetFilter( m_Filter );
+    }
+  }
+  return GetResult;
+}
+
+Result::Enum VClient::ClearDeviceFilter()
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  if( !IsConnected() )
+  {
+    return Result::NotConnected;
+  }
+
+  m_Filter.Clear( ViconCGStreamEnum::VoltageFrame );
+  m_Filter.Clear( ViconCGStreamEnum::ForceFrame );
+  m_Filter.Clear( ViconCGStreamEnum::MomentFrame );
+  m_Filter.Clear( ViconCGStreamEnum::CentreOfPressureFrame );
+  m_Filter.Clear( ViconCGStreamEnum::EyeTrackerFrame );
+
+  m_pClient->SetFilter( m_Filter );
+
+  return Result::Success;
+}
+
+Result::Enum VClient::AddToDeviceFilter( const std::string & i_rDeviceName )
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  Result::Enum GetResult;
+  if( InitGet( GetResult ) )
+  {
+    const ViconCGStream::VDeviceInfo * pDevice = GetDevice( i_rDeviceName, GetResult );
+    if( pDevice )
+    {
+      m_Filter.Add( ViconCGStreamEnum::VoltageFrame, pDevice->m_DeviceID );
+      m_Filter.Add( ViconCGStreamEnum::ForceFrame, pDevice->m_DeviceID );
+      m_Filter.Add( ViconCGStreamEnum::MomentFrame, pDevice->m_DeviceID );
+      m_Filter.Add( ViconCGStreamEnum::CentreOfPressureFrame, pDevice->m_DeviceID );
+      m_Filter.Add( ViconCGStreamEnum::EyeTrackerFrame, pDevice->m_DeviceID );
+
+      // The dummy id keeps the filter active once the last real device has been removed again
+      m_Filter.Add( ViconCGStreamEnum::VoltageFrame, -1 );
+      m_Filter.Add( ViconCGStreamEnum::ForceFrame, -1 );
+      m_Filter.Add( ViconCGStreamEnum::MomentFrame, -1 );
+      m_Filter.Add( ViconCGStreamEnum::CentreOfPressureFrame, -1 );
+      m_Filter.Add( ViconCGStreamEnum::EyeTrackerFrame, -1 );
+
+      m_pClient->SetFilter( m_Filter );
+    }
+  }
+  return GetResult;
+}
+
+Result::Enum VClient::RemoveFromDeviceFilter( const std::string & i_rDeviceName )
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  Result::Enum GetResult;
+  if( InitGet( GetResult ) )
+  {
+    const ViconCGStream::VDeviceInfo * pDevice = GetDevice( i_rDeviceName, GetResult );
+    if( pDevice )
+    {
+      std::vector< unsigned int > DeviceIds;
+      DeviceIds.reserve( m_LatestFrame.m_Devices.size() );
+      for( const auto & rDevice : m_LatestFrame.m_Devices )
+      {
+        DeviceIds.push_back( rDevice.m_DeviceID );
+      }
+
+      RemoveFromFilter( ViconCGStreamEnum::VoltageFrame, pDevice->m_DeviceID, DeviceIds );
+      RemoveFromFilter( ViconCGStreamEnum::ForceFrame, pDevice->m_DeviceID, DeviceIds );
+      RemoveFromFilter( ViconCGStreamEnum::MomentFrame, pDevice->m_DeviceID, DeviceIds );
+      RemoveFromFilter( ViconCGStreamEnum::CentreOfPressureFrame, pDevice->m_DeviceID, DeviceIds );
+      RemoveFromFilter( ViconCGStreamEnum::EyeTrackerFrame, pDevice->m_DeviceID, DeviceIds );
+
+      m_pClient->SetFilter( m_Filter );
+    }
+  }
+  return GetResult;
+}
+
+void VClient::RemoveFromFilter( const ViconCGStreamType::Enum i_Type, const unsigned int i_ID, const std::vector< unsigned int > & i_rPresentIDs )
+{
+  // The filter only lists what is let through, so an unfiltered type has to start from everything we know of
+  if( !m_Filter.IsFiltered( i_Type ) )
+  {
+    for( const unsigned int ID : i_rPresentIDs )
+    {
+      m_Filter.Add( i_Type, ID );
+    }
+  }
+
+  // The CGServer lets a type through when its filter is empty, so the dummy id keeps it filtered once the last id goes
+  m_Filter.Add( i_Type, -1 );
+  m_Filter.Remove( i_Type, i_ID );
+}
+
+Result::Enum VClient::GetBytesReceived( unsigned long long & o_rCameraBytes,
+                                        unsigned long long & o_rSubjectBytes,
+                                        unsigned long long & o_rDeviceBytes,
+                                        unsigned long long & o_rOtherBytes ) const
+{
+  boost::recursive_mutex::scoped_lock Lock( m_FrameMutex );
+
+  o_rCameraBytes = 0;
+  o_rSubjectBytes = 0;
+  o_rDeviceBytes = 0;
+  o_rOtherBytes = 0;
+
+  if( !IsConnected() )
+  {
+    return Result::NotConnected;
+  }
+
+  std::map< ViconCGStreamType::Enum, ViconCGStreamType::UInt64 > BytesReceived;
+  m_pClient->GetBytesReceived( BytesReceived );
+
+  for( const auto & rBytes : BytesReceived )
+  {
+    switch( rBytes.first )
+    {
+    case ViconCGStreamEnum::CameraInfo:
+    case ViconCGStreamEnum::CameraSensorInfo:
+    case ViconCGStreamEnum::CameraCalibrationInfo:
+    case ViconCGStreamEnum::CameraTimingInfo:
+    case ViconCGStreamEnum::CameraWand2d:
+    case ViconCGStreamEnum::Centroids:
+    case ViconCGStreamEnum::CentroidWeights:
+    case ViconCGStreamEnum::CentroidTracks:
+    case ViconCGStreamEnum::EdgePairs:
+    case ViconCGStreamEnum::GreyscaleBlobs:
+    case ViconCGStreamEnum::GreyscaleSubsampledBlobs:
+    case ViconCGStreamEnum::VideoFrame:
+      o_rCameraBytes += rBytes.second;
+      break;
+    case ViconCGStreamEnum::SubjectInfo:
+    case ViconCGStreamEnum::SubjectTopology:
+    case ViconCGStreamEnum::SubjectScale:
+    case ViconCGStreamEnum::SubjectHealth:
+    case ViconCGStreamEnum::ObjectQuality:
+    case ViconCGStreamEnum::GlobalSegments:
+    case ViconCGStreamEnum::LocalSegments:
+    case ViconCGStreamEnum::LightweightSegments:
+      o_rSubjectBytes += rBytes.second;
+      break;
+    case ViconCGStreamEnum::DeviceInfo:
+    case ViconCGStreamEnum::DeviceInfoExtra:
+    case ViconCGStreamEnum::ChannelInfo:
+    case ViconCGStreamEnum::ChannelInfoExtra:
+    case ViconCGStreamEnum::ForcePlateInfo:
+    case ViconCGStreamEnum::EyeTrackerInfo:
+    case ViconCGStreamEnum::VoltageFrame:
+    case ViconCGStreamEnum::ForceFrame:
+    case ViconCGStreamEnum::MomentFrame:
+    case ViconCGStreamEnum::CentreOfPressureFrame:
+    case ViconCGStreamEnum::EyeTrackerFrame:
+      o_rDeviceBytes += rBytes.second;
+      break;
+    default:
+      o_rOtherBytes += rBytes.second;
+      break;
+    }
+  }
+
+  return Result::Success;
+}
+
 ViconCGStreamClientSDK::ICGFrameState& VClient::LatestFrame()
 { 
   return m_LatestFrame; 
@@ -4919,22 +5562,23 @@ ViconCGStreamClientSDK::ICGFrameState& VClient::CachedFrame()
   return m_CachedFrame; 
 }
 
-Result::Enum VClient::SetTimingLog(const std::string & i_rClientLog, const std::string & i_rCGStreamLog )
+Result::Enum VClient::SetTimingLog(const std::string & i_rClientLog, const std::string & i_rCGStreamLog, bool i_bBinary )
 {
   if (!m_pTimingLog)
   {
     m_pTimingLog = std::make_shared< VClientTimingLog >();
   }
 
-  bool bClientLogOk = m_pTimingLog->CreateLog(i_rClientLog);
+  bool bClientLogOk = m_pTimingLog->CreateLog(i_rClientLog, i_bBinary);
   bool bCGStreamLogOK = true;
   if( m_pClient )
   {
-    bCGStreamLogOK = m_pClient->SetLogFile(i_rCGStreamLog);
+    bCGStreamLogOK = m_pClient->SetLogFile(i_rCGStreamLog, i_bBinary);
   }
   else
   {
     m_ClientLogFile = i_rCGStreamLog;
+    m_bBinaryTimingLog = i_bBinary;
   }
 
   Result::Enum Output = ( bClientLogOk && bCGStreamLogOK ) ? Result::Success : Result::InvalidOperation;
@@ -39,7 +39,6 @@
 #include <ViconCGStreamClientSDK/CGClient.h>
 #include <ViconCGStreamClientSDK/ICGFrameState.h>
 
-class VCGStreamPostalService;
 class VWirelessConfiguration;
 
 namespace ViconDataStreamSDK
@@ -48,6 +47,7 @@ namespace Core
 {
 
 class VAxisMapping;
+class VCameraCalibration;
 
 class VClient
 {
@@ -86,7 +86,22 @@ public:
   // Control how many frames are buffered by the client (default is one)
   void SetBufferSize( unsigned int i_MaxFrames );
 
+  // Number of threads used to decode heavy objects off the socket thread (default is zero; decode on the socket thread)
+  void SetDecodeThreadCount( unsigned int i_ThreadCount );
+
+  // Decode video to BGR888 ( Mono8 for luminance-only formats ). With i_bOnAccess a frame is only decoded when it is
+  // first fetched with GetVideoFrame, rather than as every frame arrives.
+  void SetDecodeVideo( bool i_bDecode, bool i_bOnAccess = false );
+
+  // Decode only a window of one camera's video, binning each i_Binning x i_Binning block (1, 2 or 4) into one pixel;
+  // a zero width or height reaches to the edge of the frame. A binning of 1 with an empty window restores whole frames.
+  void SetVideoDecodeWindow( unsigned int i_CameraID, unsigned int i_Binning,
+                             unsigned int i_X = 0, unsigned int i_Y = 0, unsigned int i_Width = 0, unsigned int i_Height = 0 );
+
   Result::Enum GetFrame();
+
+  // Wake a thread blocked in GetFrame, which then returns without a new frame
+  void CancelGetFrame();
   Result::Enum GetFrameNumber( unsigned int & o_rFrameNumber ) const;
   Result::Enum GetFrameRate( double & o_rFrameRateInHz ) const;
 
@@ -103,6 +118,9 @@ public:
 
   // Latency reporting
   Result::Enum GetLatencyTotal( double & o_rLatency ) const;
+
+  // Time at which the current frame was received, in seconds on the steady (monotonic) clock
+  Result::Enum GetFrameReceiptTime( double & o_rReceiptTime ) const;
   Result::Enum GetLatencySampleCount( unsigned int & o_rSampleCount ) const;
   Result::Enum GetLatencySampleName( const unsigned int i_SampleIndex, std::string & o_rSampleName ) const;
   Result::Enum GetLatencySampleValue( const std::string & i_rSampleName, double & o_rSampleValue ) const;
@@ -344,6 +362,31 @@ public:
                                   const unsigned int i_CentroidIndex,
                                   double & o_rWeight ) const;
 
+  // Every centroid of a camera, or of every camera when i_rCameraName is empty, under one lock. The centroid arrays are
+  // parallel, with two positions (x, y) per centroid; the centroids of camera o_rCameraIDs[ i ] start at o_rCameraOffsets[ i ].
+  // Weights are zero where none were sent, and track IDs are all ones where the centroid is not on a track.
+  Result::Enum GetCentroids( const std::string & i_rCameraName,
+                             std::vector< unsigned int > & o_rCameraIDs,
+                             std::vector< unsigned int > & o_rCameraOffsets,
+                             std::vector< double > & o_rPositions,
+                             std::vector< double > & o_rRadii,
+                             std::vector< double > & o_rWeights,
+                             std::vector< unsigned long long > & o_rTrackIDs ) const;
+
+  // Every centroid of a camera with lens distortion removed, as x, y pairs in centroid index order.
+  // These and the other calibrated functions need the camera calibrations, which are sent with centroid data.
+  Result::Enum GetUndistortedCentroids( const std::string & i_rCameraName, std::vector< double > & o_rPositions ) const;
+
+  // The ray through every centroid of a camera, in the client's axes: each starts at the camera centre and has a unit
+  // direction ( x, y, z ) per centroid.
+  Result::Enum GetCentroidRays( const std::string & i_rCameraName, double ( & o_rOrigin )[ 3 ], std::vector< double > & o_rDirections ) const;
+
+  // Project points ( x, y, z in the client's axes ) into every calibrated camera, with lens distortion. The image positions
+  // in camera o_rCameraIDs[ c ] are x, y pairs, starting at 2 c times the number of points. Points behind a camera give NaN.
+  Result::Enum ProjectPoints( const std::vector< double > & i_rPoints,
+                              std::vector< unsigned int > & o_rCameraIDs,
+                              std::vector< double > & o_rPositions ) const;
+
   Result::Enum GetGreyscaleBlobCount( const std::string & i_rCameraName, unsigned int & o_rCount ) const;
   Result::Enum GetGreyscaleBlobSubsampleInfo( const std::string & i_rCameraName,
                                               unsigned short & o_rTwiceOffsetX,
@@ -356,6 +399,10 @@ public:
                                  std::vector< unsigned int > & o_rLineYPositions,
                                  std::vector< std::vector< unsigned char > > & o_rLinePixelValues ) const;
 
+  // All of a camera's blobs for the current frame, packed into flat line and pixel arrays. The lines of a blob and the
+  // pixels of a line are read in place as spans, and stay valid for as long as the pointer is held.
+  Result::Enum GetGreyscaleBlobs( const std::string & i_rCameraName, ViconCGStreamClientSDK::VGreyscaleBlobsPtr & o_rBlobsPtr ) const;
+
   Result::Enum GetVideoFrame( const std::string & i_rCameraName, ViconCGStreamClientSDK::VVideoFramePtr & o_rVideoFramePtr ) const;
 
   // Only stream camera data for the given cameras
@@ -365,11 +412,26 @@ public:
 
   Result::Enum ClearSubjectFilter();
   Result::Enum AddToSubjectFilter(const std::string & i_rSubjectName);
+
+  // Add or remove single cameras, subjects or devices, so that a viewer can subscribe to just what it shows. Changes are
+  // sent to the server at once. Removing from a type that is not yet filtered keeps everything else in the latest frame.
+  Result::Enum AddToCameraFilter( const unsigned int i_CameraId, const bool i_bCentroids, const bool i_bBlobs, const bool i_bVideo );
+  Result::Enum RemoveFromCameraFilter( const unsigned int i_CameraId, const bool i_bCentroids, const bool i_bBlobs, const bool i_bVideo );
+  Result::Enum RemoveFromSubjectFilter( const std::string & i_rSubjectName );
+  Result::Enum ClearDeviceFilter();
+  Result::Enum AddToDeviceFilter( const std::string & i_rDeviceName );
+  Result::Enum RemoveFromDeviceFilter( const std::string & i_rDeviceName );
+
+  // Bytes received from the server since connecting, split into camera, subject and device data and everything else
+  Result::Enum GetBytesReceived( unsigned long long & o_rCameraBytes,
+                                 unsigned long long & o_rSubjectBytes,
+                                 unsigned long long & o_rDeviceBytes,
+                                 unsigned long long & o_rOtherBytes ) const;
   
   ViconCGStreamClientSDK::ICGFrameState& LatestFrame();
   ViconCGStreamClientSDK::ICGFrameState& CachedFrame();
 
-  Result::Enum SetTimingLog(const std::string & i_rClientLog, const std::string & i_rCGStreamLog );
+  Result::Enum SetTimingLog(const std::string & i_rClientLog, const std::string & i_rCGStreamLog, bool i_bBinary = false );
 
   Result::Enum ConfigureWireless( std::string& o_rError );
 
@@ -392,8 +454,19 @@ private:
   const ViconCGStream::VCameraSensorInfo * GetCameraSensorInfo( const unsigned int i_CameraID, Result::Enum & o_rResult ) const;
   const ViconCGStream::VCentroids       * GetCentroidSet( const unsigned int i_CameraID, Result::Enum & o_rResult ) const;
   const ViconCGStream::VCentroidWeights * GetCentroidWeightSet( const unsigned int i_CameraID, Result::Enum & o_rResult ) const;
-  const ViconCGStream::VGreyscaleBlobs  * GetGreyscaleBlobs( const unsigned int i_CameraID, Result::Enum & o_rResult ) const;
+  const ViconCGStream::VCentroidTracks  * GetCentroidTrackSet( const unsigned int i_CameraID, Result::Enum & o_rResult ) const;
+  const ViconCGStream::VCameraCalibrationInfo * GetCameraCalibrationInfo( const unsigned int i_CameraID, Result::Enum & o_rResult ) const;
+  VCameraCalibration ClientCameraCalibration( const ViconCGStream::VCameraCalibrationInfo & i_rInfo ) const;
+  void AppendCentroids( const ViconCGStream::VCentroids & i_rCentroidSet,
+                        std::vector< unsigned int > & io_rCameraIDs,
+                        std::vector< unsigned int > & io_rCameraOffsets,
+                        std::vector< double > & io_rPositions,
+                        std::vector< double > & io_rRadii,
+                        std::vector< double > & io_rWeights,
+                        std::vector< unsigned long long > & io_rTrackIDs ) const;
+  ViconCGStreamClientSDK::VGreyscaleBlobsPtr GetGreyscaleBlobs( const unsigned int i_CameraID, Result::Enum & o_rResult ) const;
   void  GetVideoFrame( const unsigned int i_CameraID, Result::Enum & o_rResult, ViconCGStreamClientSDK::VVideoFramePtr & o_rVideoFramePtr ) const;
+  void RemoveFromFilter( const ViconCGStreamType::Enum i_Type, const unsigned int i_ID, const std::vector< unsigned int > & i_rPresentIDs );
 
   Result::Enum GetMarkerID( const ViconCGStream::VSubjectInfo & i_rSubjectInfo, const std::string& i_rMarkerName, unsigned int& o_rMarkerID ) const;
   Result::Enum GetSegmentID( const ViconCGStream::VSubjectInfo & i_rSubjectInfo, const std::string& i_rSegmentName, unsigned int& o_rSegmentID ) const;
@@ -436,6 +509,8 @@ private:
 
   void FetchNextFrame();
 
+  void ApplyVideoDecodeWindows();
+
   void CopyAndTransformT( const float i_Translation[3], double( &io_Translation )[3] ) const;
   void CopyAndTransformT( const double i_Translation[ 3 ], double ( & io_Translation )[ 3 ] ) const;
   void CopyAndTransformR( const double i_Rotation[ 9 ], double ( & io_Rotation )[ 9 ] ) const;
@@ -443,8 +518,10 @@ private:
   ViconCGStreamType::UInt64 GetDevicePeriod( const unsigned int i_DeviceID ) const;
   ViconCGStreamType::UInt64 GetDeviceStartTick( const unsigned int i_DeviceID ) const;
 
-  // reference the client
+  // reference the client; changes to the pointer are made under m_ClientMutex so that CancelGetFrame may copy it
+  // from another thread
   std::shared_ptr< ViconCGStreamClientSDK::ICGClient > m_pClient;
+  boost::mutex                                         m_ClientMutex;
   std::string                                          m_ServerName;
 
   bool m_bPreFetch;
@@ -481,12 +558,17 @@ private:
   ViconCGStream::VFilter m_Filter;
 
   unsigned int m_BufferSize;
+  unsigned int m_DecodeThreadCount;
+  bool m_bDecodeVideo;
+  bool m_bDecodeVideoOnAccess;
+  std::map< unsigned int, VViconCGStreamVideo::VWindow > m_VideoDecodeWindows;
 
   // Timing log for this client
   std::shared_ptr< VClientTimingLog > m_pTimingLog;
 
   // Filename for stream client timing log; to allow it to be set before the client is instantiated.
   std::string m_ClientLogFile;
+  bool m_bBinaryTimingLog;
 };
 
 /* Needs VC12 :(
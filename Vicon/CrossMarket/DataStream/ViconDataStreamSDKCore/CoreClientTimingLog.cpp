@@ -24,19 +24,75 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "CoreClientTimingLog.h"
 
-#include <functional>
-
-#include <boost/lexical_cast.hpp>
-#include <boost/filesystem.hpp>
-#include <boost/algorithm/string.hpp>
-
-#include <ViconCGStreamClient/CGStreamPostalService.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 
 namespace
 {
-  // Number of frames to wait for before starting to log, in the hope of getting all of the
-  // columns in.
-  static const size_t s_LogPreamble = 200;
+  // Text formatter for client timing records. Writes a heading line before the first frame and again whenever
+  // a new latency column appears, so a text log stays readable however the set of latencies changes.
+  class VClientTimingTextFormatter
+  {
+  public:
+    VClientTimingTextFormatter()
+    : m_bHeadingsChanged( true )
+    {
+    }
+
+    void operator()( std::string& o_rText, const ViconDataStreamSDK::Core::VClientTimingRecord& i_rRecord )
+    {
+      using ViconDataStreamSDK::Core::VClientTimingRecord;
+
+      if( i_rRecord.m_Type == VClientTimingRecord::EColumn )
+      {
+        if( i_rRecord.m_FrameNumber < VClientTimingRecord::s_MaxColumns )
+        {
+          if( m_Headings.size() <= i_rRecord.m_FrameNumber )
+          {
+            m_Headings.resize( i_rRecord.m_FrameNumber + 1 );
+          }
+          m_Headings[ i_rRecord.m_FrameNumber ].assign( i_rRecord.m_ColumnName, strnlen( i_rRecord.m_ColumnName, VClientTimingRecord::s_MaxNameLength ) );
+          m_bHeadingsChanged = true;
+        }
+        return;
+      }
+
+      if( m_bHeadingsChanged )
+      {
+        o_rText += "Frame Number, Receipt Time";
+        for( const auto& rHeading : m_Headings )
+        {
+          o_rText += ", ";
+          o_rText += rHeading;
+        }
+        o_rText += "\n";
+        m_bHeadingsChanged = false;
+      }
+
+      char Value[ 64 ];
+      int Length = std::snprintf( Value, sizeof( Value ), "%u, %f", i_rRecord.m_FrameNumber, i_rRecord.m_ReceiptTime );
+      o_rText.append( Value, Length > 0 ? std::min< size_t >( Length, sizeof( Value ) - 1 ) : 0 );
+
+      for( size_t Column = 0; Column < m_Headings.size(); ++Column )
+      {
+        o_rText += ", ";
+        if( !std::isnan( i_rRecord.m_Latencies[ Column ] ) )
+        {
+          Length = std::snprintf( Value, sizeof( Value ), "%f", i_rRecord.m_Latencies[ Column ] );
+          o_rText.append( Value, Length > 0 ? std::min< size_t >( Length, sizeof( Value ) - 1 ) : 0 );
+        }
+      }
+      o_rText += "\n";
+    }
+
+  private:
+    std::vector< std::string > m_Headings;
+    bool m_bHeadingsChanged;
+  };
 }
 
 namespace ViconDataStreamSDK
@@ -44,6 +100,7 @@ namespace ViconDataStreamSDK
 namespace Core
 {
 
+const char VClientTimingRecord::s_Magic[ 4 ] = { 'V', 'C', 'T', 'L' };
 
 VClientTimingLog::VClientTimingLog()
 {
@@ -54,195 +111,86 @@ VClientTimingLog::~VClientTimingLog()
   CloseLog();
 }
 
-
-std::vector< std::string > VClientTimingLog::LogHeadings(const std::vector< ViconCGStreamDetail::VLatencyInfo_Sample > & i_rSamples ) const
+unsigned int VClientTimingLog::ColumnIndex( const std::string& i_rName )
 {
-  std::vector< std::string > Headings;
-  for (const auto& rLatency : i_rSamples)
+  for( unsigned int Index = 0; Index < m_Columns.size(); ++Index )
   {
-    Headings.push_back( rLatency.m_Name );
+    if( m_Columns[ Index ] == i_rName )
+    {
+      return Index;
+    }
   }
-  return Headings;
-}
 
-VClientTimingLog::EHeadingComparison VClientTimingLog::CompareHeadings( const std::vector< std::string >& i_rHeadings1, const std::vector< std::string >& i_rHeadings2, const VClientTimingLog::EHeadingComparison i_SubsetType ) const
- {
-  if (i_rHeadings1 == i_rHeadings2)
+  if( m_Columns.size() >= VClientTimingRecord::s_MaxColumns )
   {
-    return ESame;
+    return VClientTimingRecord::s_MaxColumns;
   }
 
-  size_t Found = 0;
-  for( size_t Index = 0; Index < i_rHeadings1.size(); ++Index )
-  {
-    if (Found < i_rHeadings2.size())
-    {
-      if (i_rHeadings1[Index] == i_rHeadings2[Found])
-      {
-        ++Found;
-      }
-    }
-  }
-
-  return ( Found == i_rHeadings2.size() ) ? i_SubsetType : EDifferent;
+  // First sighting of this latency; announce the column ahead of the frame that uses it. The announcement is made only
+  // once, so it waits for space rather than being dropped with the frames when the writer falls behind.
+  VClientTimingRecord Record;
+  Record.m_Type = VClientTimingRecord::EColumn;
+  Record.m_FrameNumber = static_cast< uint32_t >( m_Columns.size() );
+  Record.m_ReceiptTime = 0.0;
+  std::memset( Record.m_ColumnName, 0, sizeof( Record.m_ColumnName ) );
+  std::strncpy( Record.m_ColumnName, i_rName.c_str(), sizeof( Record.m_ColumnName ) - 1 );
+  m_Log.LogWithoutDrop( Record );
+
+  m_Columns.push_back( i_rName );
+  return Record.m_FrameNumber;
 }
 
-VClientTimingLog::EHeadingComparison VClientTimingLog::CompareHeadings( const std::vector< std::string >& i_rHeadings1, const std::vector< std::string >& i_rHeadings2 ) const
+void VClientTimingLog::WriteToLog( const unsigned int i_FrameNumber, const std::vector< ViconCGStreamDetail::VLatencyInfo_Sample >& i_rLatencies )
 {
-
-  if( i_rHeadings1.size() >= i_rHeadings2.size() )
+  if( !m_Log.IsEnabled() )
   {
-    return CompareHeadings( i_rHeadings1, i_rHeadings2, ESubset );
+    return;
   }
-  else
-  {
-    return CompareHeadings( i_rHeadings2, i_rHeadings1, ESuperset );
-  }
-}
 
-void VClientTimingLog::LogLatencies(std::ostream & i_rStream, const std::vector< std::string > & i_rHeadings, const std::vector< ViconCGStreamDetail::VLatencyInfo_Sample >& i_rLatencies) const
-{
-  EHeadingComparison Result = CompareHeadings( i_rHeadings, LogHeadings( i_rLatencies ) );
-  if( Result <= ESubset )
-  { 
-    unsigned int LatencyIndex = 0;
-    for( const auto& Heading : i_rHeadings)
-    {
-      if(LatencyIndex < i_rLatencies.size() )
-      {
-        if( Heading == i_rLatencies[ LatencyIndex ].m_Name )
-        { 
-          i_rStream << ", " << i_rLatencies[ LatencyIndex ].m_Latency;
-          ++LatencyIndex;
-        }
-        else
-        {
-          i_rStream << ", ";
-        }
-      }
-      else
-      {
-        i_rStream << ", ";
-      }
-    }
-  }
-  // We need a DSSDK error log
-  //else
-  //{
-  //  i_rStream << ", Headings are " << ( Result == ESuperset ) ? "Superset, " : "Different, ";
-  //  for (const auto& rHeading : LogHeadings(i_rLatencies))
-  //  {
-  //    i_rStream << rHeading << ", ";
-  //  }
-  //}
-}
+  VClientTimingRecord Record;
+  Record.m_Type = VClientTimingRecord::EFrame;
+  Record.m_FrameNumber = i_FrameNumber;
+  Record.m_ReceiptTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now().time_since_epoch() ).count();
+  std::fill( Record.m_Latencies, Record.m_Latencies + VClientTimingRecord::s_MaxColumns, std::numeric_limits< float >::quiet_NaN() );
 
-void VClientTimingLog::LogTimingFunction( const unsigned int i_FrameNumber, const double i_ReceiptTime, const std::vector< ViconCGStreamDetail::VLatencyInfo_Sample >& i_rLatencies )
-{
-  boost::mutex::scoped_lock LogLock( m_LogMutex );
-  if( m_Log.good() )
   {
-    // We haven't written a header yet
-    if( m_LogHeadings.empty() )
+    boost::mutex::scoped_lock Lock( m_ColumnMutex );
+    for( const auto& rLatency : i_rLatencies )
     {
-      // Store up a buffer of items before we start to log, in order to
-      // get an idea of all of the column items.
-      if( m_PreLoggedItems.size() < s_LogPreamble )
-      {
-        LogCacheItem Item;
-        Item.m_FrameNumber = i_FrameNumber;
-        Item.m_ReceiptTime = i_ReceiptTime;
-        Item.m_Latencies = i_rLatencies;
-        m_PreLoggedItems.push_back( Item );
-      }
-      else
+      const unsigned int Column = ColumnIndex( rLatency.m_Name );
+      if( Column < VClientTimingRecord::s_MaxColumns )
       {
-        // We have filled our buffer; now work out what the set of headings is
-        for (const auto& rLatency : m_PreLoggedItems)
-        {
-          const auto Headings = LogHeadings( rLatency.m_Latencies );
-          const auto Result = CompareHeadings( Headings, m_LogHeadings );
-        
-          if (Result == ESubset)
-          {
-            m_LogHeadings = Headings;
-          }
-        }
-
-        m_Log << "Frame Number, Receipt Time";
-        for( const auto& Heading : m_LogHeadings)
-        {
-          m_Log << ", " << Heading;
-        }
-        m_Log << std::endl;
-
-        // Now write out the rest of our buffer
-        for (const auto& rLatency : m_PreLoggedItems)
-        {
-          m_Log << std::fixed << rLatency.m_FrameNumber << ", " << rLatency.m_ReceiptTime;
-          LogLatencies( m_Log, m_LogHeadings, rLatency.m_Latencies );
-          m_Log << std::endl;
-        }
-
-        m_PreLoggedItems.clear();
+        Record.m_Latencies[ Column ] = static_cast< float >( rLatency.m_Latency );
       }
     }
-    else
-    { 
-      m_Log << std::fixed << i_FrameNumber << ", " << i_ReceiptTime;
-      LogLatencies( m_Log, m_LogHeadings, i_rLatencies );
-      m_Log << std::endl;
-    }
   }
-}
 
-void VClientTimingLog::WriteToLog( const unsigned int i_FrameNumber, const std::vector< ViconCGStreamDetail::VLatencyInfo_Sample >& i_rLatencies )
-{
-  if( m_pPostalService )
-  {
-    const double ReceiptTime = std::chrono::duration< double, std::milli >( std::chrono::high_resolution_clock::now().time_since_epoch() ).count();
-    m_pPostalService->Post( std::bind( &VClientTimingLog::LogTimingFunction, this, i_FrameNumber, ReceiptTime, i_rLatencies ) );
-  }
+  m_Log.Log( Record );
 }
 
-bool VClientTimingLog::CreateLog( const std::string& i_rFilename )
+bool VClientTimingLog::CreateLog( const std::string& i_rFilename, bool i_bBinary )
 {
-  boost::mutex::scoped_lock LogLock( m_LogMutex );
+  boost::mutex::scoped_lock Lock( m_ColumnMutex );
 
-  bool bSuccess = false;
+  m_Log.Close();
+  m_Columns.clear();
 
-  if( !m_Log.is_open() )
-  {
-    m_Log.open( i_rFilename );
-    bSuccess = m_Log.good();
-  }
-
-  if( bSuccess )
-  {
-    if( !m_pPostalService )
-    {
-      m_pPostalService = std::make_shared< VCGStreamPostalService >();
-    }
-
-    bSuccess = m_pPostalService->StartService();
-  }
-
-  return bSuccess;
+  return m_Log.Open( i_rFilename, i_bBinary, VClientTimingRecord::s_Magic, std::string(), VClientTimingTextFormatter() );
 }
 
 void VClientTimingLog::CloseLog()
 {
-  boost::mutex::scoped_lock LogLock( m_LogMutex );
+  m_Log.Close();
+}
 
-  if( m_pPostalService )
-  {
-    m_pPostalService->StopService();
-  }
+bool VClientTimingLog::WriteText( const std::string& i_rBinaryFile, std::ostream& o_rStream )
+{
+  return VCGStreamRecordLog< VClientTimingRecord >::WriteText( i_rBinaryFile, VClientTimingRecord::s_Magic, std::string(), VClientTimingTextFormatter(), o_rStream );
+}
 
-  if( m_Log.is_open() )
-  {
-    m_Log.close();
-  }
+bool VClientTimingLog::IsBinaryLog( const std::string& i_rFilename )
+{
+  return VCGStreamRecordLog< VClientTimingRecord >::IsBinaryLog( i_rFilename, VClientTimingRecord::s_Magic );
 }
 
 } // End of namespace Core
@@ -24,79 +24,71 @@
 //////////////////////////////////////////////////////////////////////////////////
 #pragma once
 
-#include "RetimingClient.h"
+#include <ViconCGStream/LatencyInfo.h>
+#include <ViconCGStreamClient/CGStreamTimingLog.h>
 
-#include <ViconDataStreamSDKCoreUtils/Constants.h>
-#include <ViconDataStreamSDKCoreUtils/AxisMapping.h>
-#include <ViconDataStreamSDKCoreUtils/ClientUtils.h>
-
-
-#include <memory>
-#include <array>
-#include <boost/thread/thread.hpp>
-#include <boost/thread/recursive_mutex.hpp>
-#include <ViconCGStreamClientSDK/ICGClient.h>
-#include <ViconCGStreamClientSDK/CGClient.h>
-#include <ViconCGStreamClientSDK/ICGFrameState.h>
-
-class VCGStreamPostalService;
+#include <boost/thread/mutex.hpp>
 
+#include <cstdint>
+#include <string>
+#include <vector>
 
 namespace ViconDataStreamSDK
 {
 namespace Core
 {
 
-
-
-class VClientTimingLog
+// One record of the client timing log. A column record names a latency column the first time it is seen;
+// frame records then carry a value for each column defined so far, NaN where the frame had no such latency.
+struct VClientTimingRecord
 {
+  enum EType
+  {
+    EFrame,
+    EColumn
+  };
 
-public:
-  enum EHeadingComparison
+  // Sized so that a record fills a cache line
+  static const size_t s_MaxColumns = 12;
+  static const size_t s_MaxNameLength = s_MaxColumns * sizeof( float );
+
+  uint32_t m_Type;
+  uint32_t m_FrameNumber; // Column index for a column record
+  double m_ReceiptTime;
+  union
   {
-    ESame,     /// The heading items are the same
-    ESubset,   /// Headings2 is completely contained within headings1
-    ESuperset, /// Headings1 is completely contained within headings2
-    EDifferent /// The items in the 2 heading vectors are different, or in a different order
+    float m_Latencies[ s_MaxColumns ];
+    char m_ColumnName[ s_MaxNameLength ];
   };
 
+  static const char s_Magic[ 4 ];
+};
+
+class VClientTimingLog
+{
 public:
 
   VClientTimingLog();
   virtual ~VClientTimingLog();
 
-  bool CreateLog( const std::string& i_rFilename );
+  bool CreateLog( const std::string& i_rFilename, bool i_bBinary = false );
   void WriteToLog( const unsigned int i_FrameNumber, const std::vector< ViconCGStreamDetail::VLatencyInfo_Sample >& i_rLatencies );
   void CloseLog();
 
-  EHeadingComparison CompareHeadings( const std::vector< std::string >& i_rHeadings1, const std::vector< std::string >& i_rHeadings2 ) const;
-  std::vector< std::string > LogHeadings( const std::vector< ViconCGStreamDetail::VLatencyInfo_Sample >& i_rSamples ) const;
-  void LogLatencies( std::ostream& i_rStream, const std::vector< std::string >& i_rHeadings, const std::vector< ViconCGStreamDetail::VLatencyInfo_Sample >& i_rLatencies ) const;
-
-protected:
-
-  void LogTimingFunction( const unsigned int i_FrameNumber, const double i_ReceiptTime, const std::vector< ViconCGStreamDetail::VLatencyInfo_Sample >& i_rLatencies );
-  EHeadingComparison CompareHeadings( const std::vector< std::string >& i_rHeadings1, const std::vector< std::string >& i_rHeadings2, const EHeadingComparison i_SubsetType ) const;
+  // Convert a binary client timing log to the same text as a text log
+  static bool WriteText( const std::string& i_rBinaryFile, std::ostream& o_rStream );
+  static bool IsBinaryLog( const std::string& i_rFilename );
 
 private:
 
-  std::shared_ptr< VCGStreamPostalService > m_pPostalService;
-  boost::mutex m_LogMutex;
-  std::ofstream m_Log;
-  
-  struct LogCacheItem
-  {
-    unsigned int m_FrameNumber;
-    double m_ReceiptTime;
-    std::vector< ViconCGStreamDetail::VLatencyInfo_Sample > m_Latencies;
-  };
-
-  std::deque< LogCacheItem > m_PreLoggedItems;
-  std::vector< std::string > m_LogHeadings;
-};
+  unsigned int ColumnIndex( const std::string& i_rName );
 
+  VCGStreamRecordLog< VClientTimingRecord > m_Log;
 
+  // Latency names in column order, as announced to the log
+  boost::mutex m_ColumnMutex;
+  std::vector< std::string > m_Columns;
+};
 
 } // End of namespace Core
 } // End of namespace ViconDataStreamSDK
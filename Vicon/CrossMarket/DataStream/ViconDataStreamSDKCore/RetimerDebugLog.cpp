@@ -0,0 +1,197 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include "RetimerDebugLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <thread>
+
+namespace ViconDataStreamSDK
+{
+  namespace Core
+  {
+    static const char s_Magic[ 4 ] = { 'V', 'R', 'D', 'L' };
+    static const uint32_t s_Version = 1;
+
+    VRetimerDebugLog::VRetimerDebugLog()
+    : m_bStop( false )
+    , m_Session( 0 )
+    {
+    }
+
+    VRetimerDebugLog::~VRetimerDebugLog()
+    {
+      Close();
+    }
+
+    bool VRetimerDebugLog::Open( const std::string & i_rFilename )
+    {
+      boost::mutex::scoped_lock Lock( m_OpenMutex );
+
+      if( m_File.is_open() )
+      {
+        return false;
+      }
+
+      m_File.open( i_rFilename, std::ios::binary );
+      if( !m_File.good() )
+      {
+        m_File.close();
+        return false;
+      }
+
+      const uint32_t RecordSize = sizeof( VRecord );
+      m_File.write( s_Magic, sizeof( s_Magic ) );
+      m_File.write( reinterpret_cast< const char * >( &s_Version ), sizeof( s_Version ) );
+      m_File.write( reinterpret_cast< const char * >( &RecordSize ), sizeof( RecordSize ) );
+
+      ++m_Session;
+      m_Records.ResetCounters();
+      m_bStop = false;
+      m_Thread = boost::thread( &VRetimerDebugLog::WriterThread, this );
+      m_Records.Open();
+
+      return true;
+    }
+
+    void VRetimerDebugLog::Close()
+    {
+      boost::mutex::scoped_lock Lock( m_OpenMutex );
+
+      m_Records.Close();
+
+      if( m_Thread.joinable() )
+      {
+        m_bStop = true;
+        m_Thread.join();
+      }
+
+      if( m_File.is_open() )
+      {
+        // Anything pushed after the writer's last pass
+        Drain();
+        m_File.close();
+      }
+    }
+
+    uint64_t VRetimerDebugLog::DroppedCount() const
+    {
+      return m_Records.Counters().m_Dropped;
+    }
+
+    void VRetimerDebugLog::Push( ERecordType i_Type, const std::string & i_rSubject, double i_PredictionTime, double i_Sample1Time, double i_Sample2Time, double i_MaximumPrediction )
+    {
+      VQueuedRecord Queued;
+      Queued.m_Session = m_Session.load();
+
+      VRecord & Record = Queued.m_Record;
+      Record.m_Type = static_cast< uint32_t >( i_Type );
+      Record.m_Reserved = 0;
+      Record.m_PredictionTime = i_PredictionTime;
+      Record.m_Sample1Time = i_Sample1Time;
+      Record.m_Sample2Time = i_Sample2Time;
+      Record.m_MaximumPrediction = i_MaximumPrediction;
+
+      const size_t Length = std::min< size_t >( i_rSubject.size(), SubjectNameLength - 1 );
+      std::memcpy( Record.m_Subject, i_rSubject.data(), Length );
+      std::memset( Record.m_Subject + Length, 0, SubjectNameLength - Length );
+
+      m_Records.Post( Queued );
+    }
+
+    void VRetimerDebugLog::Drain()
+    {
+      const uint32_t Session = m_Session.load();
+      m_Records.ConsumeAll( [this, Session]( const VQueuedRecord & i_rQueued )
+      {
+        if( i_rQueued.m_Session == Session )
+        {
+          m_File.write( reinterpret_cast< const char * >( &i_rQueued.m_Record ), sizeof( VRecord ) );
+        }
+      } );
+    }
+
+    void VRetimerDebugLog::WriterThread()
+    {
+      while( !m_bStop )
+      {
+        Drain();
+        m_File.flush();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+      }
+    }
+
+    std::string VRetimerDebugLog::RecordTypeString( uint32_t i_Type )
+    {
+      switch( i_Type )
+      {
+      case EPrediction:
+        return "Prediction to time from samples";
+      case EEarly:
+        return "Early data requested";
+      case ELate:
+        return "Late data requested";
+      case EInvalidReceiptTime:
+        return "Invalid Receipt Time";
+      case EMismatchedTopology:
+        return "Mismatched topology";
+      default:
+        return "Unknown";
+      }
+    }
+
+    bool VRetimerDebugLog::WriteText( const std::string & i_rBinaryFile, std::ostream & o_rStream )
+    {
+      std::ifstream File( i_rBinaryFile, std::ios::binary );
+
+      char Magic[ 4 ];
+      uint32_t Version = 0;
+      uint32_t RecordSize = 0;
+      File.read( Magic, sizeof( Magic ) );
+      File.read( reinterpret_cast< char * >( &Version ), sizeof( Version ) );
+      File.read( reinterpret_cast< char * >( &RecordSize ), sizeof( RecordSize ) );
+      if( !File.good() || std::memcmp( Magic, s_Magic, sizeof( Magic ) ) != 0 || Version != s_Version || RecordSize != sizeof( VRecord ) )
+      {
+        return false;
+      }
+
+      VRecord Record;
+      while( File.read( reinterpret_cast< char * >( &Record ), sizeof( VRecord ) ) )
+      {
+        Record.m_Subject[ SubjectNameLength - 1 ] = 0;
+        o_rStream << RecordTypeString( Record.m_Type ) << ", "
+                  << Record.m_Subject << ", "
+                  << std::fixed << Record.m_PredictionTime << ", "
+                  << Record.m_Sample1Time << ", "
+                  << Record.m_Sample2Time << ", "
+                  << Record.m_MaximumPrediction << std::endl;
+      }
+
+      return true;
+    }
+  }
+}
@@ -0,0 +1,125 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <ViconCGStreamClient/CGStreamPostalService.h>
+
+#include <boost/thread.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+namespace ViconDataStreamSDK
+{
+  namespace Core
+  {
+    // Asynchronous binary log of retimer prediction events.
+    // Log() may be called from any thread; when the log is not open it returns before touching its arguments,
+    // otherwise it copies a fixed size record into a post box which a writer thread drains to file.
+    class VRetimerDebugLog
+    {
+    public:
+
+      enum ERecordType
+      {
+        EPrediction,
+        EEarly,
+        ELate,
+        EInvalidReceiptTime,
+        EMismatchedTopology
+      };
+
+      static const unsigned int SubjectNameLength = 48;
+
+      // Record layout written to file
+      struct VRecord
+      {
+        uint32_t m_Type;
+        uint32_t m_Reserved;
+        double   m_PredictionTime;
+        double   m_Sample1Time;
+        double   m_Sample2Time;
+        double   m_MaximumPrediction;
+        char     m_Subject[ SubjectNameLength ];
+      };
+
+      VRetimerDebugLog();
+      ~VRetimerDebugLog();
+
+      bool Open( const std::string & i_rFilename );
+      void Close();
+
+      bool IsEnabled() const
+      {
+        return m_Records.IsOpen();
+      }
+
+      void Log( ERecordType i_Type, const std::string & i_rSubject, double i_PredictionTime, double i_Sample1Time, double i_Sample2Time, double i_MaximumPrediction = 0.0 )
+      {
+        if( IsEnabled() )
+        {
+          Push( i_Type, i_rSubject, i_PredictionTime, i_Sample1Time, i_Sample2Time, i_MaximumPrediction );
+        }
+      }
+
+      // Number of records discarded because the queue was full
+      uint64_t DroppedCount() const;
+
+      // Convert a binary log to one line of comma separated text per record
+      static bool WriteText( const std::string & i_rBinaryFile, std::ostream & o_rStream );
+
+      static std::string RecordTypeString( uint32_t i_Type );
+
+    private:
+
+      void Push( ERecordType i_Type, const std::string & i_rSubject, double i_PredictionTime, double i_Sample1Time, double i_Sample2Time, double i_MaximumPrediction );
+
+      void WriterThread();
+      void Drain();
+
+      // A producer which found the log open may still be posting when it is closed, so each record carries the
+      // session it was made in and records left over from an earlier session are discarded rather than written
+      struct VQueuedRecord
+      {
+        uint32_t m_Session;
+        VRecord  m_Record;
+      };
+
+      static const unsigned int s_QueueCapacity = 4096;
+      VCGStreamPostBox< VQueuedRecord, s_QueueCapacity > m_Records;
+
+      std::atomic< uint32_t > m_Session;
+
+      std::atomic< bool > m_bStop;
+
+      // Only touched by the writer thread while it is running
+      std::ofstream m_File;
+      boost::thread m_Thread;
+      boost::mutex m_OpenMutex;
+    };
+  }
+}
@@ -0,0 +1,176 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ViconDataStreamSDK
+{
+  namespace Core
+  {
+    // Recycled instances of one type, handed out as shared pointers. An item only returns to the pool once the last
+    // reference to it has gone: the reference's control block is kept in the item's entry, and freeing it marks the
+    // entry free with release semantics, which Acquire claims with acquire semantics. So readers have finished with an
+    // item before the writer that acquires it next starts to overwrite it, and handing an item out allocates nothing.
+    // Entries outlive the pool while references to them are held. Acquire must not be called concurrently.
+    template< typename T >
+    class VRetimerItemPool
+    {
+    public:
+      VRetimerItemPool()
+      {
+      }
+
+      ~VRetimerItemPool()
+      {
+        for( VEntry * pEntry : m_Entries )
+        {
+          Unreference( pEntry );
+        }
+      }
+
+      VRetimerItemPool( const VRetimerItemPool & ) = delete;
+      VRetimerItemPool & operator=( const VRetimerItemPool & ) = delete;
+
+      // A free item from the pool, or a new one, which is kept for reuse while there are fewer than i_Capacity
+      std::shared_ptr< T > Acquire( size_t i_Capacity )
+      {
+        for( VEntry * pEntry : m_Entries )
+        {
+          bool bInUse = false;
+          if( pEntry->m_bInUse.compare_exchange_strong( bInUse, true, std::memory_order_acquire, std::memory_order_relaxed ) )
+          {
+            return Lease( pEntry );
+          }
+        }
+
+        VEntry * pEntry = new VEntry();
+        if( m_Entries.size() < i_Capacity )
+        {
+          pEntry->m_References.store( 1, std::memory_order_relaxed );
+          m_Entries.push_back( pEntry );
+        }
+        return Lease( pEntry );
+      }
+
+    private:
+
+      // Room for the control block of a shared pointer with an empty deleter and a one pointer allocator
+      static const size_t s_ControlBlockSize = 64;
+
+      class VEntry
+      {
+      public:
+        VEntry()
+        : m_bInUse( true )
+        , m_References( 0 )
+        {
+        }
+
+        T m_Item;
+        std::atomic< bool > m_bInUse;
+
+        // Held once by the pool and once by an outstanding lease; the last to let go deletes the entry
+        std::atomic< unsigned int > m_References;
+
+        alignas( std::max_align_t ) unsigned char m_ControlBlock[ s_ControlBlockSize ];
+      };
+
+      // The item is part of its entry, so there is nothing to delete
+      class VNoDelete
+      {
+      public:
+        void operator()( T * ) const
+        {
+        }
+      };
+
+      template< typename U >
+      class VAllocator
+      {
+      public:
+        typedef U value_type;
+
+        explicit VAllocator( VEntry * i_pEntry )
+        : m_pEntry( i_pEntry )
+        {
+        }
+
+        template< typename V >
+        VAllocator( const VAllocator< V > & i_rOther )
+        : m_pEntry( i_rOther.m_pEntry )
+        {
+        }
+
+        U * allocate( std::size_t )
+        {
+          static_assert( sizeof( U ) <= s_ControlBlockSize, "Control block does not fit in a pool entry" );
+          static_assert( alignof( U ) <= alignof( std::max_align_t ), "Control block is over-aligned for a pool entry" );
+          return reinterpret_cast< U * >( m_pEntry->m_ControlBlock );
+        }
+
+        // Called once the control block has been destroyed, which is the last use of the lease
+        void deallocate( U *, std::size_t )
+        {
+          m_pEntry->m_bInUse.store( false, std::memory_order_release );
+          Unreference( m_pEntry );
+        }
+
+        template< typename V >
+        bool operator==( const VAllocator< V > & i_rOther ) const
+        {
+          return m_pEntry == i_rOther.m_pEntry;
+        }
+
+        template< typename V >
+        bool operator!=( const VAllocator< V > & i_rOther ) const
+        {
+          return m_pEntry != i_rOther.m_pEntry;
+        }
+
+        VEntry * m_pEntry;
+      };
+
+      static std::shared_ptr< T > Lease( VEntry * i_pEntry )
+      {
+        i_pEntry->m_References.fetch_add( 1, std::memory_order_relaxed );
+        return std::shared_ptr< T >( &i_pEntry->m_Item, VNoDelete(), VAllocator< T >( i_pEntry ) );
+      }
+
+      static void Unreference( VEntry * i_pEntry )
+      {
+        if( i_pEntry->m_References.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+        {
+          delete i_pEntry;
+        }
+      }
+
+      std::vector< VEntry * > m_Entries;
+    };
+  }
+}
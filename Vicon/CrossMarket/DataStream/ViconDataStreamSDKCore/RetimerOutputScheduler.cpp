@@ -0,0 +1,140 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include "RetimerOutputScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace ViconDataStreamSDK
+{
+  namespace Core
+  {
+    VRetimerOutputScheduler::VRetimerOutputScheduler()
+    : m_Period( 0 )
+    , m_Tick( 0 )
+    , m_SpinTime( 0 )
+    , m_JitterSumSquares( 0 )
+    {
+    }
+
+    bool VRetimerOutputScheduler::Start( double i_FrameRate )
+    {
+      if( !( i_FrameRate > 0 ) )
+      {
+        return false;
+      }
+
+      m_Period = 1.0e9 / i_FrameRate;
+      m_Tick = 0;
+      m_Start = TClock::now();
+
+      ResetStatistics();
+
+      return true;
+    }
+
+    void VRetimerOutputScheduler::SetSpinTime( double i_SpinTime )
+    {
+      m_SpinTime = static_cast< int64_t >( std::max( i_SpinTime, 0.0 ) * 1.0e6 );
+    }
+
+    double VRetimerOutputScheduler::SpinTime() const
+    {
+      return static_cast< double >( m_SpinTime.load() ) / 1.0e6;
+    }
+
+    void VRetimerOutputScheduler::WaitForNextTick()
+    {
+      ++m_Tick;
+      TClock::time_point Deadline = m_Start + std::chrono::nanoseconds( std::llround( static_cast< double >( m_Tick ) * m_Period ) );
+
+      // Skip any ticks we have already overrun completely
+      uint64_t Missed = 0;
+      const double Late = static_cast< double >( std::chrono::duration_cast< std::chrono::nanoseconds >( TClock::now() - Deadline ).count() );
+      if( Late >= m_Period )
+      {
+        Missed = static_cast< uint64_t >( Late / m_Period );
+        m_Tick += Missed;
+        Deadline = m_Start + std::chrono::nanoseconds( std::llround( static_cast< double >( m_Tick ) * m_Period ) );
+      }
+
+      const std::chrono::nanoseconds Spin( m_SpinTime.load() );
+      if( Spin.count() > 0 )
+      {
+        std::this_thread::sleep_until( Deadline - Spin );
+        while( TClock::now() < Deadline )
+        {
+        }
+      }
+      else
+      {
+        std::this_thread::sleep_until( Deadline );
+      }
+
+      const double Jitter = std::chrono::duration< double, std::milli >( TClock::now() - Deadline ).count();
+      UpdateStatistics( Jitter, Missed );
+    }
+
+    void VRetimerOutputScheduler::UpdateStatistics( double i_Jitter, uint64_t i_Missed )
+    {
+      boost::mutex::scoped_lock Lock( m_StatisticsMutex );
+
+      VOutputTimingStatistics & rStats = m_Statistics;
+      if( rStats.TickCount == 0 )
+      {
+        rStats.MinimumJitter = i_Jitter;
+        rStats.MaximumJitter = i_Jitter;
+      }
+      else
+      {
+        rStats.MinimumJitter = std::min( rStats.MinimumJitter, i_Jitter );
+        rStats.MaximumJitter = std::max( rStats.MaximumJitter, i_Jitter );
+      }
+
+      // Running mean and variance (Welford)
+      ++rStats.TickCount;
+      const double Delta = i_Jitter - rStats.MeanJitter;
+      rStats.MeanJitter += Delta / static_cast< double >( rStats.TickCount );
+      m_JitterSumSquares += Delta * ( i_Jitter - rStats.MeanJitter );
+      rStats.JitterStandardDeviation = std::sqrt( m_JitterSumSquares / static_cast< double >( rStats.TickCount ) );
+
+      rStats.MissedTickCount += i_Missed;
+    }
+
+    VOutputTimingStatistics VRetimerOutputScheduler::Statistics() const
+    {
+      boost::mutex::scoped_lock Lock( m_StatisticsMutex );
+      return m_Statistics;
+    }
+
+    void VRetimerOutputScheduler::ResetStatistics()
+    {
+      boost::mutex::scoped_lock Lock( m_StatisticsMutex );
+      m_Statistics = VOutputTimingStatistics();
+      m_JitterSumSquares = 0;
+    }
+  }
+}
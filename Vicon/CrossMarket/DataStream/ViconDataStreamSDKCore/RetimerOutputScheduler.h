@@ -0,0 +1,100 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <boost/thread/mutex.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace ViconDataStreamSDK
+{
+  namespace Core
+  {
+    // Achieved output tick timing. Jitter is how late each tick woke relative to its deadline, in milliseconds.
+    class VOutputTimingStatistics
+    {
+    public:
+      VOutputTimingStatistics()
+      : TickCount( 0 )
+      , MissedTickCount( 0 )
+      , MeanJitter( 0 )
+      , MinimumJitter( 0 )
+      , MaximumJitter( 0 )
+      , JitterStandardDeviation( 0 )
+      {}
+
+      uint64_t TickCount;
+      uint64_t MissedTickCount;
+      double   MeanJitter;
+      double   MinimumJitter;
+      double   MaximumJitter;
+      double   JitterStandardDeviation;
+    };
+
+    // Fixed rate tick source on the steady clock.
+    // Deadlines are computed from the start time and the tick index in nanoseconds, so a period which is not a
+    // whole number of milliseconds does not drift. The final part of each wait may optionally be spent spinning,
+    // trading CPU for a tighter wake up than the OS sleep provides.
+    class VRetimerOutputScheduler
+    {
+    public:
+
+      typedef std::chrono::steady_clock TClock;
+
+      VRetimerOutputScheduler();
+
+      // Start scheduling ticks at the given rate; the first tick is due one period from now.
+      // Returns false if the rate is not positive.
+      bool Start( double i_FrameRate );
+
+      // Time to busy-wait before each deadline, in milliseconds. Zero sleeps for the whole interval.
+      void SetSpinTime( double i_SpinTime );
+      double SpinTime() const;
+
+      // Block until the next tick is due. If one or more whole periods have already passed, those ticks are
+      // counted as missed and the schedule moves on rather than firing a burst of catch-up ticks.
+      void WaitForNextTick();
+
+      VOutputTimingStatistics Statistics() const;
+      void ResetStatistics();
+
+    private:
+
+      void UpdateStatistics( double i_Jitter, uint64_t i_Missed );
+
+      TClock::time_point m_Start;
+      double   m_Period;
+      uint64_t m_Tick;
+
+      std::atomic< int64_t > m_SpinTime;
+
+      mutable boost::mutex m_StatisticsMutex;
+      VOutputTimingStatistics m_Statistics;
+      double m_JitterSumSquares;
+    };
+  }
+}
@@ -0,0 +1,580 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include "RetimerPredictor.h"
+#include "RetimingCore.h"
+#include "RetimerUtils.h"
+
+#include <ViconDataStreamSDKCoreUtils/ClientUtils.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ClientUtils;
+
+namespace ViconDataStreamSDK
+{
+  namespace Core
+  {
+    namespace
+    {
+      typedef std::array< double, 3 > VSegmentPose::* TTranslationMember;
+      typedef std::array< double, 4 > VSegmentPose::* TRotationMember;
+
+      // Every predictor treats the global and local poses of a segment identically
+      const unsigned int s_ChannelCount = 2;
+      const TTranslationMember s_Translations[ s_ChannelCount ] = { &VSegmentPose::T, &VSegmentPose::T_Rel };
+      const TRotationMember s_Rotations[ s_ChannelCount ] = { &VSegmentPose::R, &VSegmentPose::R_Rel };
+
+      const Displacement s_Zero = { 0.0, 0.0, 0.0 };
+
+      // Index of the sample that starts the interval used for a prediction at i_Time: the interval containing
+      // i_Time if it lies within the history, otherwise the newest interval
+      unsigned int IntervalIndex( const VPoseHistory & i_rHistory, double i_Time )
+      {
+        unsigned int Index = i_rHistory.Size() - 2;
+        while( Index > 0 && i_rHistory[ Index ]->ReceiptTime > i_Time )
+        {
+          --Index;
+        }
+        return Index;
+      }
+
+      void PredictLinear( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput )
+      {
+        const unsigned int Index = IntervalIndex( i_rHistory, i_Time );
+        VConstantVelocityPredictor::PredictSegments( *i_rHistory[ Index ], *i_rHistory[ Index + 1 ], i_Time, o_rOutput );
+      }
+
+      // Lagrange basis weights for a quadratic through three sample times, and their time derivatives.
+      // Returns false if two of the times coincide.
+      bool QuadraticWeights( const std::array< double, 3 > & i_rTimes, double i_Time, std::array< double, 3 > & o_rWeights, std::array< double, 3 > & o_rSlopes )
+      {
+        for( unsigned int i = 0; i < 3; ++i )
+        {
+          const double Ta = i_rTimes[ ( i + 1 ) % 3 ];
+          const double Tb = i_rTimes[ ( i + 2 ) % 3 ];
+          const double Denominator = ( i_rTimes[ i ] - Ta ) * ( i_rTimes[ i ] - Tb );
+          if( Denominator == 0.0 )
+          {
+            return false;
+          }
+
+          o_rWeights[ i ] = ( i_Time - Ta ) * ( i_Time - Tb ) / Denominator;
+          o_rSlopes[ i ] = ( 2.0 * i_Time - Ta - Tb ) / Denominator;
+        }
+        return true;
+      }
+
+      // Rotation vector taking i_rFrom to i_rTo, in the left-multiplied convention used by PredictRotation
+      Axis Difference( const Quaternion & i_rTo, const Quaternion & i_rFrom )
+      {
+        return ToRotationVector( i_rTo * Inverse( i_rFrom ) );
+      }
+
+      void Normalize( Quaternion & io_rInput )
+      {
+        double Magnitude = 0.0;
+        for( double Value : io_rInput )
+        {
+          Magnitude += Value * Value;
+        }
+
+        Magnitude = std::sqrt( Magnitude );
+        if( Magnitude > 0.0 )
+        {
+          for( double & rValue : io_rInput )
+          {
+            rValue /= Magnitude;
+          }
+        }
+      }
+
+      // Slopes of a local quadratic fit at a sample, using that sample and its neighbours in the history
+      class VSampleSlope
+      {
+      public:
+
+        bool Fit( const VPoseHistory & i_rHistory, unsigned int i_Sample )
+        {
+          m_pHistory = &i_rHistory;
+          m_Sample = i_Sample;
+          m_First = std::min( i_Sample > 0 ? i_Sample - 1 : 0, i_rHistory.Size() - 3 );
+
+          std::array< double, 3 > Times;
+          for( unsigned int i = 0; i < 3; ++i )
+          {
+            Times[ i ] = i_rHistory[ m_First + i ]->ReceiptTime;
+          }
+
+          std::array< double, 3 > Weights;
+          return QuadraticWeights( Times, i_rHistory[ i_Sample ]->ReceiptTime, Weights, m_Slopes );
+        }
+
+        Displacement Velocity( size_t i_Segment, TTranslationMember i_Member ) const
+        {
+          Displacement Output = s_Zero;
+          for( unsigned int i = 0; i < 3; ++i )
+          {
+            Output += ( ( *m_pHistory )[ m_First + i ]->m_Segments[ i_Segment ].*i_Member ) * m_Slopes[ i ];
+          }
+          return Output;
+        }
+
+        // Fitted in the tangent space at the sample itself, where its own rotation vector is zero
+        Axis AngularVelocity( size_t i_Segment, TRotationMember i_Member ) const
+        {
+          const Quaternion & rReference = ( *m_pHistory )[ m_Sample ]->m_Segments[ i_Segment ].*i_Member;
+
+          Axis Output = s_Zero;
+          for( unsigned int i = 0; i < 3; ++i )
+          {
+            if( m_First + i != m_Sample )
+            {
+              Output += Difference( ( *m_pHistory )[ m_First + i ]->m_Segments[ i_Segment ].*i_Member, rReference ) * m_Slopes[ i ];
+            }
+          }
+          return Output;
+        }
+
+      private:
+
+        const VPoseHistory * m_pHistory;
+        unsigned int m_Sample;
+        unsigned int m_First;
+        std::array< double, 3 > m_Slopes;
+      };
+    }
+
+    VPoseHistory::VPoseHistory( unsigned int i_Capacity )
+    : m_Samples( std::max( i_Capacity, 1u ) )
+    , m_Head( 0 )
+    , m_Size( 0 )
+    {
+    }
+
+    void VPoseHistory::SetCapacity( unsigned int i_Capacity )
+    {
+      i_Capacity = std::max( i_Capacity, 1u );
+      if( i_Capacity == Capacity() )
+      {
+        return;
+      }
+
+      const unsigned int Kept = std::min( m_Size, i_Capacity );
+      std::vector< TSample > Samples( i_Capacity );
+      for( unsigned int i = 0; i < Kept; ++i )
+      {
+        Samples[ i ] = ( *this )[ m_Size - Kept + i ];
+      }
+
+      m_Samples.swap( Samples );
+      m_Head = 0;
+      m_Size = Kept;
+    }
+
+    void VPoseHistory::Clear()
+    {
+      for( auto & rpSample : m_Samples )
+      {
+        rpSample.reset();
+      }
+      m_Head = 0;
+      m_Size = 0;
+    }
+
+    void VPoseHistory::Push( const TSample & i_rpSample )
+    {
+      const unsigned int Capacity = this->Capacity();
+      if( m_Size < Capacity )
+      {
+        m_Samples[ ( m_Head + m_Size ) % Capacity ] = i_rpSample;
+        ++m_Size;
+      }
+      else
+      {
+        m_Samples[ m_Head ] = i_rpSample;
+        m_Head = ( m_Head + 1 ) % Capacity;
+      }
+    }
+
+    void VPoseHistory::PopFront()
+    {
+      if( m_Size > 0 )
+      {
+        m_Samples[ m_Head ].reset();
+        m_Head = ( m_Head + 1 ) % Capacity();
+        --m_Size;
+      }
+    }
+
+    void VPoseHistory::PopBack()
+    {
+      if( m_Size > 0 )
+      {
+        m_Samples[ ( m_Head + m_Size - 1 ) % Capacity() ].reset();
+        --m_Size;
+      }
+    }
+
+    std::unique_ptr< VPosePredictor > VPosePredictor::Create( PredictionModel::Enum i_Model )
+    {
+      switch( i_Model )
+      {
+      case PredictionModel::ConstantAcceleration:
+        return std::unique_ptr< VPosePredictor >( new VConstantAccelerationPredictor() );
+      case PredictionModel::Spline:
+        return std::unique_ptr< VPosePredictor >( new VSplinePredictor() );
+      case PredictionModel::AlphaBeta:
+        return std::unique_ptr< VPosePredictor >( new VAlphaBetaPredictor() );
+      case PredictionModel::ConstantVelocity:
+      default:
+        return std::unique_ptr< VPosePredictor >( new VConstantVelocityPredictor() );
+      }
+    }
+
+    void VConstantVelocityPredictor::Predict( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput ) const
+    {
+      PredictLinear( i_rHistory, i_Time, o_rOutput );
+    }
+
+    void VConstantVelocityPredictor::PredictSegments( const VSubjectPose & i_rP1, const VSubjectPose & i_rP2, double i_Time, VSubjectPose & o_rOutput )
+    {
+      const double Time1 = i_rP1.ReceiptTime;
+      const double Time2 = i_rP2.ReceiptTime;
+
+      const size_t SegmentCount = o_rOutput.m_Segments.size();
+      for( size_t SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex )
+      {
+        const VSegmentPose & rSegment1 = i_rP1.m_Segments[ SegmentIndex ];
+        const VSegmentPose & rSegment2 = i_rP2.m_Segments[ SegmentIndex ];
+        VSegmentPose & rOutputSegment = o_rOutput.m_Segments[ SegmentIndex ];
+
+        for( unsigned int Channel = 0; Channel < s_ChannelCount; ++Channel )
+        {
+          const TTranslationMember T = s_Translations[ Channel ];
+          const TRotationMember R = s_Rotations[ Channel ];
+
+          rOutputSegment.*T = PredictDisplacement( rSegment1.*T, Time1, rSegment2.*T, Time2, i_Time );
+          rOutputSegment.*R = PredictRotation( rSegment1.*R, Time1, rSegment2.*R, Time2, i_Time );
+        }
+      }
+    }
+
+    void VConstantAccelerationPredictor::Predict( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput ) const
+    {
+      if( i_rHistory.Size() < 3 )
+      {
+        PredictLinear( i_rHistory, i_Time, o_rOutput );
+        return;
+      }
+
+      // Fit the three samples ending with the end of the interval used for this time
+      const unsigned int Index = IntervalIndex( i_rHistory, i_Time );
+      const unsigned int First = Index > 0 ? Index - 1 : 0;
+
+      std::array< const VSubjectPose *, 3 > Samples;
+      std::array< double, 3 > Times;
+      for( unsigned int i = 0; i < 3; ++i )
+      {
+        Samples[ i ] = i_rHistory[ First + i ].get();
+        Times[ i ] = Samples[ i ]->ReceiptTime;
+      }
+
+      std::array< double, 3 > Weights;
+      std::array< double, 3 > Slopes;
+      if( !QuadraticWeights( Times, i_Time, Weights, Slopes ) )
+      {
+        PredictLinear( i_rHistory, i_Time, o_rOutput );
+        return;
+      }
+
+      const size_t SegmentCount = o_rOutput.m_Segments.size();
+      for( size_t SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex )
+      {
+        VSegmentPose & rOutputSegment = o_rOutput.m_Segments[ SegmentIndex ];
+
+        for( unsigned int Channel = 0; Channel < s_ChannelCount; ++Channel )
+        {
+          const TTranslationMember T = s_Translations[ Channel ];
+          const TRotationMember R = s_Rotations[ Channel ];
+
+          Displacement Translation = s_Zero;
+          for( unsigned int i = 0; i < 3; ++i )
+          {
+            Translation += ( Samples[ i ]->m_Segments[ SegmentIndex ].*T ) * Weights[ i ];
+          }
+          rOutputSegment.*T = Translation;
+
+          // Fit rotation vectors relative to the newest sample, whose own vector is zero
+          const Quaternion & rReference = Samples[ 2 ]->m_Segments[ SegmentIndex ].*R;
+          Axis Rotation = s_Zero;
+          for( unsigned int i = 0; i < 2; ++i )
+          {
+            Rotation += Difference( Samples[ i ]->m_Segments[ SegmentIndex ].*R, rReference ) * Weights[ i ];
+          }
+          rOutputSegment.*R = FromRotationVector( Rotation ) * rReference;
+        }
+      }
+    }
+
+    void VSplinePredictor::Predict( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput ) const
+    {
+      const unsigned int Size = i_rHistory.Size();
+      if( Size < 3 )
+      {
+        PredictLinear( i_rHistory, i_Time, o_rOutput );
+        return;
+      }
+
+      const size_t SegmentCount = o_rOutput.m_Segments.size();
+      const VSubjectPose & rNewest = *i_rHistory.Back();
+
+      if( i_Time >= rNewest.ReceiptTime )
+      {
+        // Continue along the tangent at the end of the spline
+        VSampleSlope EndSlope;
+        if( !EndSlope.Fit( i_rHistory, Size - 1 ) )
+        {
+          PredictLinear( i_rHistory, i_Time, o_rOutput );
+          return;
+        }
+
+        const double Elapsed = i_Time - rNewest.ReceiptTime;
+        for( size_t SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex )
+        {
+          const VSegmentPose & rSegment = rNewest.m_Segments[ SegmentIndex ];
+          VSegmentPose & rOutputSegment = o_rOutput.m_Segments[ SegmentIndex ];
+
+          for( unsigned int Channel = 0; Channel < s_ChannelCount; ++Channel )
+          {
+            const TTranslationMember T = s_Translations[ Channel ];
+            const TRotationMember R = s_Rotations[ Channel ];
+
+            rOutputSegment.*T = rSegment.*T + EndSlope.Velocity( SegmentIndex, T ) * Elapsed;
+            rOutputSegment.*R = FromRotationVector( EndSlope.AngularVelocity( SegmentIndex, R ) * Elapsed ) * ( rSegment.*R );
+          }
+        }
+        return;
+      }
+
+      const unsigned int Index = IntervalIndex( i_rHistory, i_Time );
+      const VSubjectPose & rStart = *i_rHistory[ Index ];
+      const VSubjectPose & rEnd = *i_rHistory[ Index + 1 ];
+
+      VSampleSlope StartSlope;
+      VSampleSlope EndSlope;
+      const double Interval = rEnd.ReceiptTime - rStart.ReceiptTime;
+      if( !( Interval > 0.0 ) || !StartSlope.Fit( i_rHistory, Index ) || !EndSlope.Fit( i_rHistory, Index + 1 ) )
+      {
+        PredictLinear( i_rHistory, i_Time, o_rOutput );
+        return;
+      }
+
+      // Cubic Hermite basis
+      const double S = ( i_Time - rStart.ReceiptTime ) / Interval;
+      const double S2 = S * S;
+      const double S3 = S2 * S;
+      const double H00 = 2.0 * S3 - 3.0 * S2 + 1.0;
+      const double H10 = ( S3 - 2.0 * S2 + S ) * Interval;
+      const double H01 = -2.0 * S3 + 3.0 * S2;
+      const double H11 = ( S3 - S2 ) * Interval;
+
+      for( size_t SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex )
+      {
+        const VSegmentPose & rSegment1 = rStart.m_Segments[ SegmentIndex ];
+        const VSegmentPose & rSegment2 = rEnd.m_Segments[ SegmentIndex ];
+        VSegmentPose & rOutputSegment = o_rOutput.m_Segments[ SegmentIndex ];
+
+        for( unsigned int Channel = 0; Channel < s_ChannelCount; ++Channel )
+        {
+          const TTranslationMember T = s_Translations[ Channel ];
+          const TRotationMember R = s_Rotations[ Channel ];
+
+          Displacement Translation = ( rSegment1.*T ) * H00;
+          Translation += StartSlope.Velocity( SegmentIndex, T ) * H10;
+          Translation += ( rSegment2.*T ) * H01;
+          Translation += EndSlope.Velocity( SegmentIndex, T ) * H11;
+          rOutputSegment.*T = Translation;
+
+          // The SLERP arc from the start rotation, bent by the angular velocity at either end
+          Axis Rotation = Difference( rSegment2.*R, rSegment1.*R ) * H01;
+          Rotation += StartSlope.AngularVelocity( SegmentIndex, R ) * H10;
+          Rotation += EndSlope.AngularVelocity( SegmentIndex, R ) * H11;
+          rOutputSegment.*R = FromRotationVector( Rotation ) * ( rSegment1.*R );
+        }
+      }
+    }
+
+    VAlphaBetaPredictor::VAlphaBetaPredictor( double i_Alpha )
+    : m_Alpha( std::min( std::max( i_Alpha, 0.0 ), 1.0 ) )
+    , m_Beta( m_Alpha * m_Alpha / ( 2.0 - m_Alpha ) )
+    , m_Time( 0 )
+    , m_SampleCount( 0 )
+    , m_PreviousTime( 0 )
+    {
+    }
+
+    void VAlphaBetaPredictor::Reset()
+    {
+      m_SampleCount = 0;
+      m_State.clear();
+    }
+
+    void VAlphaBetaPredictor::CopyState( const VPosePredictor & i_rOther )
+    {
+      const VAlphaBetaPredictor & rOther = static_cast< const VAlphaBetaPredictor & >( i_rOther );
+      m_Alpha = rOther.m_Alpha;
+      m_Beta = rOther.m_Beta;
+      m_Time = rOther.m_Time;
+      m_SampleCount = rOther.m_SampleCount;
+      m_State = rOther.m_State;
+      m_PreviousTime = rOther.m_PreviousTime;
+      m_PreviousState = rOther.m_PreviousState;
+    }
+
+    void VAlphaBetaPredictor::Start( const VSubjectPose & i_rSample )
+    {
+      const size_t SegmentCount = i_rSample.m_Segments.size();
+      m_State.resize( SegmentCount );
+      for( size_t SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex )
+      {
+        const VSegmentPose & rSegment = i_rSample.m_Segments[ SegmentIndex ];
+        VSegmentState & rState = m_State[ SegmentIndex ];
+
+        for( unsigned int Channel = 0; Channel < s_ChannelCount; ++Channel )
+        {
+          rState.Position[ Channel ] = rSegment.*s_Translations[ Channel ];
+          rState.Velocity[ Channel ] = s_Zero;
+          rState.Rotation[ Channel ] = rSegment.*s_Rotations[ Channel ];
+          rState.AngularVelocity[ Channel ] = s_Zero;
+        }
+      }
+
+      m_Time = i_rSample.ReceiptTime;
+      m_SampleCount = 1;
+    }
+
+    void VAlphaBetaPredictor::AddSample( const VSubjectPose & i_rSample )
+    {
+      const size_t SegmentCount = i_rSample.m_Segments.size();
+      const double Time = i_rSample.ReceiptTime;
+
+      if( m_SampleCount == 0 || m_State.size() != SegmentCount )
+      {
+        Start( i_rSample );
+        return;
+      }
+
+      // A sample from the past, or with no valid time, has nothing to add
+      if( !( Time >= m_Time ) )
+      {
+        return;
+      }
+
+      if( Time == m_Time )
+      {
+        // The sample replaces the latest one, as the retiming core does in its history, so undo that one's update
+        // rather than filtering over no elapsed time
+        if( m_SampleCount == 1 )
+        {
+          Start( i_rSample );
+          return;
+        }
+
+        m_State = m_PreviousState;
+        m_Time = m_PreviousTime;
+        --m_SampleCount;
+      }
+
+      m_PreviousState = m_State;
+      m_PreviousTime = m_Time;
+
+      const double Elapsed = Time - m_Time;
+      for( size_t SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex )
+      {
+        const VSegmentPose & rSegment = i_rSample.m_Segments[ SegmentIndex ];
+        VSegmentState & rState = m_State[ SegmentIndex ];
+
+        for( unsigned int Channel = 0; Channel < s_ChannelCount; ++Channel )
+        {
+          const Displacement & rMeasuredPosition = rSegment.*s_Translations[ Channel ];
+          const Quaternion & rMeasuredRotation = rSegment.*s_Rotations[ Channel ];
+
+          Displacement & rPosition = rState.Position[ Channel ];
+          Displacement & rVelocity = rState.Velocity[ Channel ];
+          Quaternion & rRotation = rState.Rotation[ Channel ];
+          Axis & rAngularVelocity = rState.AngularVelocity[ Channel ];
+
+          if( m_SampleCount == 1 )
+          {
+            // There is no velocity estimate to filter yet, so take it from the first two samples
+            rVelocity = ( rMeasuredPosition - rPosition ) * ( 1.0 / Elapsed );
+            rPosition = rMeasuredPosition;
+            rAngularVelocity = Difference( rMeasuredRotation, rRotation ) * ( 1.0 / Elapsed );
+            rRotation = rMeasuredRotation;
+            continue;
+          }
+
+          const Displacement PredictedPosition = rPosition + rVelocity * Elapsed;
+          const Displacement PositionResidual = rMeasuredPosition - PredictedPosition;
+          rPosition = PredictedPosition + PositionResidual * m_Alpha;
+          rVelocity += PositionResidual * ( m_Beta / Elapsed );
+
+          const Quaternion PredictedRotation = FromRotationVector( rAngularVelocity * Elapsed ) * rRotation;
+          const Axis RotationResidual = Difference( rMeasuredRotation, PredictedRotation );
+          rRotation = FromRotationVector( RotationResidual * m_Alpha ) * PredictedRotation;
+          Normalize( rRotation );
+          rAngularVelocity += RotationResidual * ( m_Beta / Elapsed );
+        }
+      }
+
+      m_Time = Time;
+      ++m_SampleCount;
+    }
+
+    void VAlphaBetaPredictor::Predict( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput ) const
+    {
+      const size_t SegmentCount = o_rOutput.m_Segments.size();
+      if( m_SampleCount == 0 || m_State.size() != SegmentCount )
+      {
+        PredictLinear( i_rHistory, i_Time, o_rOutput );
+        return;
+      }
+
+      const double Elapsed = i_Time - m_Time;
+      for( size_t SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex )
+      {
+        const VSegmentState & rState = m_State[ SegmentIndex ];
+        VSegmentPose & rOutputSegment = o_rOutput.m_Segments[ SegmentIndex ];
+
+        for( unsigned int Channel = 0; Channel < s_ChannelCount; ++Channel )
+        {
+          rOutputSegment.*s_Translations[ Channel ] = rState.Position[ Channel ] + rState.Velocity[ Channel ] * Elapsed;
+          rOutputSegment.*s_Rotations[ Channel ] = FromRotationVector( rState.AngularVelocity[ Channel ] * Elapsed ) * rState.Rotation[ Channel ];
+        }
+      }
+    }
+  }
+}
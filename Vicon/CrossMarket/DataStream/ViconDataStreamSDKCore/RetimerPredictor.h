@@ -0,0 +1,220 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <ViconDataStreamSDKCoreUtils/Constants.h>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace ViconDataStreamSDK
+{
+  namespace Core
+  {
+    class VSubjectPose;
+
+    // The most recent input samples for a subject, oldest first.
+    // Storage is allocated once for the capacity; adding to a full history overwrites the oldest sample.
+    class VPoseHistory
+    {
+    public:
+
+      typedef std::shared_ptr< const VSubjectPose > TSample;
+
+      explicit VPoseHistory( unsigned int i_Capacity = 2 );
+
+      // Change the capacity, keeping the newest samples
+      void SetCapacity( unsigned int i_Capacity );
+
+      unsigned int Capacity() const
+      {
+        return static_cast< unsigned int >( m_Samples.size() );
+      }
+
+      unsigned int Size() const
+      {
+        return m_Size;
+      }
+
+      bool Empty() const
+      {
+        return m_Size == 0;
+      }
+
+      void Clear();
+
+      void Push( const TSample & i_rpSample );
+
+      // Remove the oldest sample
+      void PopFront();
+
+      // Remove the newest sample
+      void PopBack();
+
+      // Index 0 is the oldest sample and Size() - 1 the newest
+      const TSample & operator[]( unsigned int i_Index ) const
+      {
+        return m_Samples[ ( m_Head + i_Index ) % m_Samples.size() ];
+      }
+
+      const TSample & Front() const
+      {
+        return ( *this )[ 0 ];
+      }
+
+      const TSample & Back() const
+      {
+        return ( *this )[ m_Size - 1 ];
+      }
+
+    private:
+
+      std::vector< TSample > m_Samples;
+      unsigned int m_Head;
+      unsigned int m_Size;
+    };
+
+    // Estimates the segment poses of a subject at an arbitrary time from its sample history.
+    // The retimer holds one predictor per subject, so implementations may keep filter state between samples.
+    class VPosePredictor
+    {
+    public:
+
+      virtual ~VPosePredictor() {}
+
+      // Called with each sample after it has been added to the history
+      virtual void AddSample( const VSubjectPose & /*i_rSample*/ ) {}
+
+      // Discard any state; called when the history is cleared
+      virtual void Reset() {}
+
+      virtual PredictionModel::Enum Model() const = 0;
+
+      // Take the state of another predictor of the same model
+      virtual void CopyState( const VPosePredictor & /*i_rOther*/ ) {}
+
+      // Fill T, R, T_Rel and R_Rel of each output segment at i_Time.
+      // The history holds at least two samples with a common topology, and o_rOutput.m_Segments is sized to match.
+      virtual void Predict( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput ) const = 0;
+
+      static std::unique_ptr< VPosePredictor > Create( PredictionModel::Enum i_Model );
+    };
+
+    // Linear interpolation between the two samples either side of the requested time, or linear extrapolation
+    // from the newest two. With two samples of history this is the retimer's original behaviour.
+    class VConstantVelocityPredictor : public VPosePredictor
+    {
+    public:
+
+      virtual PredictionModel::Enum Model() const override
+      {
+        return PredictionModel::ConstantVelocity;
+      }
+
+      virtual void Predict( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput ) const override;
+
+      // Interpolate or extrapolate segment poses from a pair of samples
+      static void PredictSegments( const VSubjectPose & i_rP1, const VSubjectPose & i_rP2, double i_Time, VSubjectPose & o_rOutput );
+    };
+
+    // Quadratic fit through three samples. Rotations are fitted as rotation vectors relative to the newest of
+    // the three, so a constant angular acceleration about a fixed axis is reproduced exactly.
+    class VConstantAccelerationPredictor : public VPosePredictor
+    {
+    public:
+
+      virtual PredictionModel::Enum Model() const override
+      {
+        return PredictionModel::ConstantAcceleration;
+      }
+
+      virtual void Predict( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput ) const override;
+    };
+
+    // Cubic Hermite spline through the history, with velocities at each sample taken from a local quadratic fit.
+    // Rotations follow the SLERP arc between samples, corrected by the angular velocity at each end. Beyond the
+    // newest sample the pose continues along the spline's end tangent.
+    class VSplinePredictor : public VPosePredictor
+    {
+    public:
+
+      virtual PredictionModel::Enum Model() const override
+      {
+        return PredictionModel::Spline;
+      }
+
+      virtual void Predict( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput ) const override;
+    };
+
+    // Alpha-beta filter on position and velocity, which is the steady state form of a constant velocity Kalman
+    // filter. Beta is derived from alpha using the Benedict-Bordner relation. Lower alpha smooths more noise
+    // at the cost of lagging manoeuvres.
+    class VAlphaBetaPredictor : public VPosePredictor
+    {
+    public:
+
+      explicit VAlphaBetaPredictor( double i_Alpha = 0.8 );
+
+      virtual void AddSample( const VSubjectPose & i_rSample ) override;
+
+      virtual void Reset() override;
+
+      virtual PredictionModel::Enum Model() const override
+      {
+        return PredictionModel::AlphaBeta;
+      }
+
+      virtual void CopyState( const VPosePredictor & i_rOther ) override;
+
+      virtual void Predict( const VPoseHistory & i_rHistory, double i_Time, VSubjectPose & o_rOutput ) const override;
+
+    private:
+
+      class VSegmentState
+      {
+      public:
+        std::array< std::array< double, 3 >, 2 > Position;
+        std::array< std::array< double, 3 >, 2 > Velocity;
+        std::array< std::array< double, 4 >, 2 > Rotation;
+        std::array< std::array< double, 3 >, 2 > AngularVelocity;
+      };
+
+      // Start again from this sample, at rest
+      void Start( const VSubjectPose & i_rSample );
+
+      double m_Alpha;
+      double m_Beta;
+
+      double m_Time;
+      unsigned int m_SampleCount;
+      std::vector< VSegmentState > m_State;
+
+      // The state before the latest sample was applied, so that a sample with the same time can replace it
+      double m_PreviousTime;
+      std::vector< VSegmentState > m_PreviousState;
+    };
+  }
+}
@@ -183,6 +183,41 @@ namespace ClientUtils
     return output;
   }
 
+  Axis ToRotationVector( const Quaternion & i_rInput )
+  {
+    // q and -q are the same rotation; pick the one with a non-negative real part so the angle is at most pi
+    const double Sign = i_rInput[3] < 0.0 ? -1.0 : 1.0;
+    Axis Imag = Imaginary( i_rInput ) * Sign;
+    const double SinHalfAngle = Magnitude( Imag );
+    if( SinHalfAngle < 1e-12 )
+    {
+      // Small angle limit of 2 * asin( s ) / s
+      return Imag * 2.0;
+    }
+
+    const double Angle = 2.0 * std::atan2( SinHalfAngle, i_rInput[3] * Sign );
+    return Imag * ( Angle / SinHalfAngle );
+  }
+
+  Quaternion FromRotationVector( const Axis & i_rRotationVector )
+  {
+    const double Angle = Magnitude( i_rRotationVector );
+    const double HalfAngle = Angle * 0.5;
+
+    // sin( a / 2 ) / a, using the series expansion where a is tiny
+    const double Scale = Angle < 1e-6 ? 0.5 - ( Angle * Angle ) / 48.0 : std::sin( HalfAngle ) / Angle;
+
+    Quaternion Output = { i_rRotationVector[0] * Scale, i_rRotationVector[1] * Scale, i_rRotationVector[2] * Scale, std::cos( HalfAngle ) };
+    return Output;
+  }
+
+  Quaternion Slerp( const Quaternion & r1, const Quaternion & r2, double u )
+  {
+    // exp( u * log( r2 * r1^-1 ) ) * r1, in the same left-multiplied form as PredictRotation
+    Axis Delta = ToRotationVector( r2 * Inverse( r1 ) );
+    return FromRotationVector( Delta * u ) * r1;
+  }
+
   // Simple interpolation using linear interpolation and prediction
   /// Returns a rotation prediction at time t3 from 2 rotation r1 at time t1 and r2 and time t2
   /// where t3 > t2 > t1
@@ -252,6 +287,15 @@ namespace ClientUtils
     return d3;
 
   }
+
+  void InterpolateChannels( const double * i_pFrom, const double * i_pTo, double u, size_t i_Count, double * o_pOutput )
+  {
+    // Each channel is independent, so this loop vectorises
+    for( size_t Channel = 0; Channel < i_Count; ++Channel )
+    {
+      o_pOutput[ Channel ] = i_pFrom[ Channel ] + u * ( i_pTo[ Channel ] - i_pFrom[ Channel ] );
+    }
+  }
 }
 
 
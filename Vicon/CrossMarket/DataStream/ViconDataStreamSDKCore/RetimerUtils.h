@@ -25,6 +25,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
 namespace ClientUtils
 {
@@ -49,6 +50,16 @@ namespace ClientUtils
   Axis operator+=( Axis & i_rLeft, const Axis & i_rRight );
   Quaternion operator*( const Quaternion & i_rLeft, const Quaternion & i_rRight );
 
+  /// Returns the rotation vector (unit axis scaled by angle) of a unit quaternion, taking the shortest path
+  Axis ToRotationVector( const Quaternion & i_rInput );
+
+  /// Returns the unit quaternion for a rotation vector
+  Quaternion FromRotationVector( const Axis & i_rRotationVector );
+
+  /// Spherical linear interpolation from r1 at u = 0 to r2 at u = 1, along the shortest arc.
+  /// Values of u outside [0,1] extrapolate along the same arc
+  Quaternion Slerp( const Quaternion & r1, const Quaternion & r2, double u );
+
   /// Returns a rotation prediction at time t3 from 2 rotation r1 at time t1 and r2 and time t2
   /// where t3 > t2 > t1
   Quaternion PredictRotation( Quaternion r1, double t1, Quaternion r2, double t2, double t3 );
@@ -59,6 +70,10 @@ namespace ClientUtils
 
   /// Linear interpolation between doubles
   double PredictVal( const double d1, double t1, const double d2, double t2, double t3 );
+
+  /// Linear interpolation of i_Count contiguous values, from i_pFrom at u = 0 to i_pTo at u = 1.
+  /// Used to interpolate every channel of a device sample, or the components of a translation, at once
+  void InterpolateChannels( const double * i_pFrom, const double * i_pTo, double u, size_t i_Count, double * o_pOutput );
 }
 
 
@@ -163,6 +163,11 @@ namespace ViconDataStreamSDK
       boost::recursive_mutex::scoped_lock Lock(m_FrameRateMutex);
       m_FrameRate = FrameRate;
 
+      if( !m_OutputScheduler.Start( m_FrameRate ) )
+      {
+        return Result::InvalidOperation;
+      }
+
       // start thread
       m_pOutputThread.reset(new boost::thread(std::bind(&VRetimingClient::OutputThread, this)));
 
@@ -189,6 +194,9 @@ namespace ViconDataStreamSDK
     {
       m_bInputStopped = true;
 
+      // Wake the input thread if it is waiting for a frame
+      m_pClient->CancelGetFrame();
+
       // Wait for it to stop
       if( m_pInputThread )
       {
@@ -242,7 +250,7 @@ namespace ViconDataStreamSDK
 
       if( Result == Result::Success )
       {
-        o_rSegmentName = pSubject->RootSegment;
+        o_rSegmentName = pSubject->RootSegment();
       }
 
       return Result;
@@ -258,7 +266,7 @@ namespace ViconDataStreamSDK
 
       if( Result == Result::Success )
       {
-        o_rSegmentCount = static_cast< unsigned int >( pSubject->m_SegmentNames.size() );
+        o_rSegmentCount = pSubject->m_pTopology->SegmentCount();
       }
 
       return Result;
@@ -274,9 +282,9 @@ namespace ViconDataStreamSDK
 
       if( Result == Result::Success )
       {
-        if( i_SegmentIndex < pSubject->m_SegmentNames.size() )
+        if( i_SegmentIndex < pSubject->m_pTopology->SegmentCount() )
         {
-          o_rSegmentName = pSubject->m_SegmentNames[ i_SegmentIndex ];
+          o_rSegmentName = pSubject->m_pTopology->m_SegmentNames[ i_SegmentIndex ];
         }
         else
         {
@@ -297,10 +305,10 @@ namespace ViconDataStreamSDK
 
       if( Result == Result::Success )
       {
-        const auto pSegment = pSubject->m_Segments.find(i_rSegmentName);
-        if( pSegment != pSubject->m_Segments.end() && pSegment->second )
+        unsigned int SegmentIndex = 0;
+        if( pSubject->m_pTopology->SegmentIndex( i_rSegmentName, SegmentIndex ) )
         {
-          o_rSegmentCount = static_cast< unsigned int >( pSegment->second->m_Children.size() );
+          o_rSegmentCount = static_cast< unsigned int >( pSubject->m_pTopology->m_Children[ SegmentIndex ].size() );
         }
         else
         {
@@ -321,12 +329,13 @@ namespace ViconDataStreamSDK
 
       if( Result == Result::Success )
       {
-        const auto pSegment = pSubject->m_Segments.find(i_rSegmentName);
-        if( pSegment != pSubject->m_Segments.end() && pSegment->second )
+        unsigned int SegmentIndex = 0;
+        if( pSubject->m_pTopology->SegmentIndex( i_rSegmentName, SegmentIndex ) )
         {
-          if( i_SegmentIndex < pSegment->second->m_Children.size() )
+          const auto & rChildren = pSubject->m_pTopology->m_Children[ SegmentIndex ];
+          if( i_SegmentIndex < rChildren.size() )
           {
-            o_rSegmentName = pSegment->second->m_Children[i_SegmentIndex];
+            o_rSegmentName = rChildren[i_SegmentIndex];
           }
           else
           {
@@ -352,10 +361,10 @@ namespace ViconDataStreamSDK
 
       if( Result == Result::Success )
       {
-        const auto pSegment = pSubject->m_Segments.find(i_rSegmentName);
-        if( pSegment != pSubject->m_Segments.end() && pSegment->second )
+        unsigned int SegmentIndex = 0;
+        if( pSubject->m_pTopology->SegmentIndex( i_rSegmentName, SegmentIndex ) )
         {
-          o_rSegmentName = pSegment->second->Parent;
+          o_rSegmentName = pSubject->m_pTopology->m_Parents[ SegmentIndex ];
         }
         else
         {
@@ -382,10 +391,10 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          std::copy(SegIt->second->T_Stat.begin(), SegIt->second->T_Stat.end(), o_rThreeVector);
+          std::copy(pSegment->T_Stat.begin(), pSegment->T_Stat.end(), o_rThreeVector);
         }
       }
       return GetResult;
@@ -426,10 +435,10 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          std::array< double, 9 > StaticRotation = ClientUtils::ToRotationMatrix(SegIt->second->R_Stat);
+          std::array< double, 9 > StaticRotation = ClientUtils::ToRotationMatrix(pSegment->R_Stat);
           std::copy(StaticRotation.begin(), StaticRotation.end(), o_rRotation);
         }
       }
@@ -452,10 +461,10 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          std::copy(SegIt->second->R_Stat.begin(), SegIt->second->R_Stat.end(), o_rFourVector);
+          std::copy(pSegment->R_Stat.begin(), pSegment->R_Stat.end(), o_rFourVector);
         }
       }
 
@@ -497,12 +506,12 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          if( SegIt->second->bHasScale )
+          if( pSegment->bHasScale )
           { 
-            std::array< double, 3 > StaticScale = SegIt->second->Scale;
+            std::array< double, 3 > StaticScale = pSegment->Scale;
             std::copy(StaticScale.begin(), StaticScale .end(), o_rThreeVector);
           }
           else
@@ -530,11 +539,11 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          std::copy(SegIt->second->T.begin(), SegIt->second->T.end(), o_rThreeVector);
-          o_rbOccluded = SegIt->second->bOccluded;
+          std::copy(pSegment->T.begin(), pSegment->T.end(), o_rThreeVector);
+          o_rbOccluded = pSegment->bOccluded;
         }
       }
       return GetResult;
@@ -576,12 +585,12 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          std::array< double, 9 > GlobalRotation = ClientUtils::ToRotationMatrix(SegIt->second->R);
+          std::array< double, 9 > GlobalRotation = ClientUtils::ToRotationMatrix(pSegment->R);
           std::copy(GlobalRotation.begin(), GlobalRotation.end(), o_rRotation);
-          o_rbOccluded = SegIt->second->bOccluded;
+          o_rbOccluded = pSegment->bOccluded;
         }
       }
       return GetResult;
@@ -603,11 +612,11 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          std::copy(SegIt->second->R.begin(), SegIt->second->R.end(), o_rFourVector);
-          o_rbOccluded = SegIt->second->bOccluded;
+          std::copy(pSegment->R.begin(), pSegment->R.end(), o_rFourVector);
+          o_rbOccluded = pSegment->bOccluded;
         }
       }
       return GetResult;
@@ -647,11 +656,11 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          std::copy(SegIt->second->T_Rel.begin(), SegIt->second->T_Rel.end(), o_rThreeVector);
-          o_rbOccluded = SegIt->second->bOccluded;
+          std::copy(pSegment->T_Rel.begin(), pSegment->T_Rel.end(), o_rThreeVector);
+          o_rbOccluded = pSegment->bOccluded;
         }
       }
       return GetResult;
@@ -690,12 +699,12 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          std::array< double, 9 > LocalRotation = ClientUtils::ToRotationMatrix(SegIt->second->R_Rel);
+          std::array< double, 9 > LocalRotation = ClientUtils::ToRotationMatrix(pSegment->R_Rel);
           std::copy(LocalRotation.begin(), LocalRotation.end(), o_rRotation);
-          o_rbOccluded = SegIt->second->bOccluded;
+          o_rbOccluded = pSegment->bOccluded;
         }
       }
       return GetResult;
@@ -715,11 +724,11 @@ namespace ViconDataStreamSDK
       if( GetResult == Result::Success )
       {
         // Get the segment
-        auto SegIt = pSubject->m_Segments.find(i_rSegmentName);
-        if( SegIt != pSubject->m_Segments.end() )
+        const VSegmentPose * pSegment = pSubject->Segment( i_rSegmentName );
+        if( pSegment )
         {
-          std::copy(SegIt->second->R_Rel.begin(), SegIt->second->R_Rel.end(), o_rFourVector);
-          o_rbOccluded = SegIt->second->bOccluded;
+          std::copy(pSegment->R_Rel.begin(), pSegment->R_Rel.end(), o_rFourVector);
+          o_rbOccluded = pSegment->bOccluded;
         }
       }
       return GetResult;
@@ -746,6 +755,226 @@ namespace ViconDataStreamSDK
 
 
 
+    Result::Enum VRetimingClient::GetMarkerSet( bool i_bLabeled, const VMarkerSet * & o_rpMarkerSet, std::shared_ptr< const VRetimedMarkers > & o_rpMarkers ) const
+    {
+      if( !m_pClient->IsConnected() )
+      {
+        return Result::NotConnected;
+      }
+
+      Result::Enum GetResult = Adapt( m_Retimer.GetMarkers( o_rpMarkers ) );
+      if( GetResult == Result::Success )
+      {
+        o_rpMarkerSet = i_bLabeled ? &o_rpMarkers->m_Labeled : &o_rpMarkers->m_Unlabeled;
+      }
+      return GetResult;
+    }
+
+    Result::Enum VRetimingClient::GetLabeledMarkerCount( unsigned int & o_rMarkerCount ) const
+    {
+      Clear( o_rMarkerCount );
+
+      std::shared_ptr< const VRetimedMarkers > pMarkers;
+      const VMarkerSet * pMarkerSet = nullptr;
+      Result::Enum GetResult = GetMarkerSet( true, pMarkerSet, pMarkers );
+      if( GetResult == Result::Success )
+      {
+        o_rMarkerCount = pMarkerSet->Size();
+      }
+      return GetResult;
+    }
+
+    Result::Enum VRetimingClient::GetLabeledMarkerGlobalTranslation( const unsigned int i_MarkerIndex, double( &o_rTranslation )[3], unsigned int & o_rTrajID ) const
+    {
+      Clear( o_rTranslation );
+      Clear( o_rTrajID );
+
+      std::shared_ptr< const VRetimedMarkers > pMarkers;
+      const VMarkerSet * pMarkerSet = nullptr;
+      Result::Enum GetResult = GetMarkerSet( true, pMarkerSet, pMarkers );
+      if( GetResult == Result::Success )
+      {
+        if( i_MarkerIndex >= pMarkerSet->Size() )
+        {
+          return Result::InvalidIndex;
+        }
+
+        std::copy( pMarkerSet->m_Translations[ i_MarkerIndex ].begin(), pMarkerSet->m_Translations[ i_MarkerIndex ].end(), o_rTranslation );
+        o_rTrajID = pMarkerSet->m_TrajectoryIDs[ i_MarkerIndex ];
+      }
+      return GetResult;
+    }
+
+    Result::Enum VRetimingClient::GetUnlabeledMarkerCount( unsigned int & o_rMarkerCount ) const
+    {
+      Clear( o_rMarkerCount );
+
+      std::shared_ptr< const VRetimedMarkers > pMarkers;
+      const VMarkerSet * pMarkerSet = nullptr;
+      Result::Enum GetResult = GetMarkerSet( false, pMarkerSet, pMarkers );
+      if( GetResult == Result::Success )
+      {
+        o_rMarkerCount = pMarkerSet->Size();
+      }
+      return GetResult;
+    }
+
+    Result::Enum VRetimingClient::GetUnlabeledMarkerGlobalTranslation( const unsigned int i_MarkerIndex, double( &o_rTranslation )[3], unsigned int & o_rTrajID ) const
+    {
+      Clear( o_rTranslation );
+      Clear( o_rTrajID );
+
+      std::shared_ptr< const VRetimedMarkers > pMarkers;
+      const VMarkerSet * pMarkerSet = nullptr;
+      Result::Enum GetResult = GetMarkerSet( false, pMarkerSet, pMarkers );
+      if( GetResult == Result::Success )
+      {
+        if( i_MarkerIndex >= pMarkerSet->Size() )
+        {
+          return Result::InvalidIndex;
+        }
+
+        std::copy( pMarkerSet->m_Translations[ i_MarkerIndex ].begin(), pMarkerSet->m_Translations[ i_MarkerIndex ].end(), o_rTranslation );
+        o_rTrajID = pMarkerSet->m_TrajectoryIDs[ i_MarkerIndex ];
+      }
+      return GetResult;
+    }
+
+    Result::Enum VRetimingClient::GetRetimedDevice( const std::string & i_rDeviceName, std::shared_ptr< const VRetimedDevice > & o_rpDevice ) const
+    {
+      if( !m_pClient->IsConnected() )
+      {
+        return Result::NotConnected;
+      }
+
+      const VSubjectPose::EResult DeviceResult = m_Retimer.GetDevice( i_rDeviceName, o_rpDevice );
+      return DeviceResult == VSubjectPose::EUnknownSubject ? Result::InvalidDeviceName : Adapt( DeviceResult );
+    }
+
+    Result::Enum VRetimingClient::GetDeviceCount( unsigned int & o_rDeviceCount ) const
+    {
+      Clear( o_rDeviceCount );
+
+      if( !m_pClient->IsConnected() )
+      {
+        return Result::NotConnected;
+      }
+
+      return Adapt( m_Retimer.GetDeviceCount( o_rDeviceCount ) );
+    }
+
+    Result::Enum VRetimingClient::GetDeviceName( const unsigned int i_DeviceIndex, std::string & o_rDeviceName, DeviceType::Enum & o_rDeviceType ) const
+    {
+      Clear( o_rDeviceName );
+      Clear( o_rDeviceType );
+
+      if( !m_pClient->IsConnected() )
+      {
+        return Result::NotConnected;
+      }
+
+      if( m_Retimer.GetDeviceName( i_DeviceIndex, o_rDeviceName ) != VSubjectPose::ESuccess )
+      {
+        return Result::InvalidIndex;
+      }
+
+      std::shared_ptr< const VRetimedDevice > pDevice;
+      GetRetimedDevice( o_rDeviceName, pDevice );
+      if( pDevice )
+      {
+        o_rDeviceType = pDevice->m_Samples.m_pChannels->Type;
+      }
+      return Result::Success;
+    }
+
+    Result::Enum VRetimingClient::GetDeviceOutputCount( const std::string & i_rDeviceName, unsigned int & o_rDeviceOutputCount ) const
+    {
+      Clear( o_rDeviceOutputCount );
+
+      std::shared_ptr< const VRetimedDevice > pDevice;
+      Result::Enum GetResult = GetRetimedDevice( i_rDeviceName, pDevice );
+      if( pDevice )
+      {
+        o_rDeviceOutputCount = pDevice->m_Samples.m_pChannels->ChannelCount();
+        GetResult = Result::Success;
+      }
+      return GetResult;
+    }
+
+    Result::Enum VRetimingClient::GetDeviceOutputNameComponent( const std::string & i_rDeviceName, const unsigned int i_DeviceOutputIndex,
+                                                                std::string & o_rDeviceOutputName, std::string & o_rDeviceOutputComponentName, Unit::Enum & o_rDeviceOutputUnit ) const
+    {
+      Clear( o_rDeviceOutputName );
+      Clear( o_rDeviceOutputComponentName );
+      Clear( o_rDeviceOutputUnit );
+
+      std::shared_ptr< const VRetimedDevice > pDevice;
+      Result::Enum GetResult = GetRetimedDevice( i_rDeviceName, pDevice );
+      if( pDevice )
+      {
+        const VDeviceChannels & rChannels = *pDevice->m_Samples.m_pChannels;
+        if( i_DeviceOutputIndex >= rChannels.ChannelCount() )
+        {
+          return Result::InvalidIndex;
+        }
+
+        o_rDeviceOutputName = rChannels.m_OutputNames[ i_DeviceOutputIndex ];
+        o_rDeviceOutputComponentName = rChannels.m_ComponentNames[ i_DeviceOutputIndex ];
+        o_rDeviceOutputUnit = rChannels.m_Units[ i_DeviceOutputIndex ];
+        GetResult = Result::Success;
+      }
+      return GetResult;
+    }
+
+    Result::Enum VRetimingClient::GetDeviceOutputSubsamples( const std::string & i_rDeviceName, const std::string & i_rDeviceOutputName, const std::string & i_rDeviceOutputComponentName,
+                                                             unsigned int & o_rDeviceOutputSubsamples, bool & o_rbOccluded ) const
+    {
+      Clear( o_rDeviceOutputSubsamples );
+      Clear( o_rbOccluded );
+
+      std::shared_ptr< const VRetimedDevice > pDevice;
+      Result::Enum GetResult = GetRetimedDevice( i_rDeviceName, pDevice );
+      if( GetResult == Result::Success )
+      {
+        unsigned int Channel = 0;
+        if( !pDevice->m_Samples.m_pChannels->ChannelIndex( i_rDeviceOutputName, i_rDeviceOutputComponentName, Channel ) )
+        {
+          return Result::InvalidDeviceOutputName;
+        }
+
+        o_rDeviceOutputSubsamples = pDevice->m_Samples.SubsampleCount;
+        o_rbOccluded = pDevice->m_Samples.m_Occluded[ Channel ];
+      }
+      return GetResult;
+    }
+
+    Result::Enum VRetimingClient::GetDeviceOutputValue( const std::string & i_rDeviceName, const std::string & i_rDeviceOutputName, const std::string & i_rDeviceOutputComponentName,
+                                                        unsigned int i_Subsample, double & o_rValue, bool & o_rbOccluded ) const
+    {
+      Clear( o_rValue );
+      Clear( o_rbOccluded );
+
+      std::shared_ptr< const VRetimedDevice > pDevice;
+      Result::Enum GetResult = GetRetimedDevice( i_rDeviceName, pDevice );
+      if( GetResult == Result::Success )
+      {
+        unsigned int Channel = 0;
+        if( !pDevice->m_Samples.m_pChannels->ChannelIndex( i_rDeviceOutputName, i_rDeviceOutputComponentName, Channel ) )
+        {
+          return Result::InvalidDeviceOutputName;
+        }
+
+        if( i_Subsample >= pDevice->m_Samples.SubsampleCount )
+        {
+          return Result::InvalidIndex;
+        }
+
+        o_rValue = pDevice->m_Samples.Subsample( i_Subsample )[ Channel ];
+        o_rbOccluded = pDevice->m_Samples.m_Occluded[ Channel ];
+      }
+      return GetResult;
+    }
+
     Result::Enum VRetimingClient::WaitForFrame() const
     {
       boost::mutex::scoped_lock Lock(m_OutputMutex);
@@ -765,6 +994,22 @@ namespace ViconDataStreamSDK
       m_OutputLatency = i_OutputLatency;
     }
 
+    void VRetimingClient::SetOutputSpinTime( double i_SpinTime )
+    {
+      m_OutputScheduler.SetSpinTime( i_SpinTime );
+    }
+
+    double VRetimingClient::OutputSpinTime() const
+    {
+      return m_OutputScheduler.SpinTime();
+    }
+
+    Result::Enum VRetimingClient::GetOutputTimingStatistics( VOutputTimingStatistics & o_rStatistics ) const
+    {
+      o_rStatistics = m_OutputScheduler.Statistics();
+      return IsRunning() ? Result::Success : Result::InvalidOperation;
+    }
+
     double VRetimingClient::OutputLatency() const
     {
       boost::recursive_mutex::scoped_lock Lock(m_DataMutex);
@@ -781,14 +1026,44 @@ namespace ViconDataStreamSDK
       return m_Retimer.MaximumPrediction();
     }
 
+    void VRetimingClient::SetHistoryDepth( unsigned int i_Depth )
+    {
+      m_Retimer.SetHistoryDepth( i_Depth );
+    }
+
+    unsigned int VRetimingClient::HistoryDepth() const
+    {
+      return m_Retimer.HistoryDepth();
+    }
+
+    void VRetimingClient::SetPredictionModel( PredictionModel::Enum i_Model )
+    {
+      m_Retimer.SetPredictionModel( i_Model );
+    }
+
+    PredictionModel::Enum VRetimingClient::GetPredictionModel() const
+    {
+      return m_Retimer.GetPredictionModel();
+    }
+
+    void VRetimingClient::SetPredictionThreadCount( unsigned int i_ThreadCount )
+    {
+      m_Retimer.SetPredictionThreadCount( i_ThreadCount );
+    }
+
+    unsigned int VRetimingClient::PredictionThreadCount() const
+    {
+      return m_Retimer.PredictionThreadCount();
+    }
+
     bool VRetimingClient::SetDebugLogFile(const std::string & i_rLogFile)
     {
       return m_Retimer.SetDebugLogFile(i_rLogFile);
     }
 
-    bool VRetimingClient::SetOutputFile(const std::string & i_rLogFile)
+    bool VRetimingClient::SetOutputFile(const std::string & i_rLogFile, OutputLogFormat::Enum i_Format )
     {
-      return m_Retimer.SetOutputFile(i_rLogFile);
+      return m_Retimer.SetOutputFile(i_rLogFile, i_Format);
     }
 
     Result::Enum VRetimingClient::UpdateFrame(double i_rOffset)
@@ -803,26 +1078,24 @@ namespace ViconDataStreamSDK
       return Adapt(m_Retimer.UpdateFrameAtTime( PTime ));
     }
 
+    Result::Enum VRetimingClient::SampleFrame( double i_Offset, std::shared_ptr< const VRetimedFrame > & o_rpFrame ) const
+    {
+      const double Now = std::chrono::duration< double, std::milli >( hrc::now() - m_Epoch ).count();
+      return Adapt( m_Retimer.SampleAt( Now + i_Offset, o_rpFrame ) );
+    }
+
     void VRetimingClient::InputThread()
     {
-      while( !m_bInputStopped )
+      while( !m_bInputStopped && m_pClient->IsConnected() )
       {
-        if( m_pClient->IsConnected() )
+        // Block until the next frame has been assembled. GetFrame returns early without a frame if the
+        // connection drops or StopInput cancels the wait, and the loop condition then decides whether to carry on.
+        if( m_pClient->GetFrame() == Result::Success )
         {
 
-          // Get a frame
-          while( m_pClient->GetFrame() != Result::Success && m_pClient->IsConnected() )
-          {
-            // Sleep a little so that we don't lumber the CPU with a busy poll
-#ifdef WIN32
-            Sleep(200);
-#else
-            sleep(1);
-#endif
-          }
-
           // Get the system latencies as individual components for debugging
-          std::map< std::string, double > Latencies;
+          std::shared_ptr< VSubjectPose::TLatencies > pLatencies = std::make_shared< VSubjectPose::TLatencies >();
+          VSubjectPose::TLatencies & Latencies = *pLatencies;
           unsigned int LatencySampleCount;
           if( m_pClient->GetLatencySampleCount(LatencySampleCount) == Result::Success )
           {
@@ -867,7 +1140,7 @@ namespace ViconDataStreamSDK
               pPoseData->FrameNumber = FrameNumber;
               pPoseData->FrameTime = FrameReceiptTime;
               pPoseData->ReceiptTime = WallReceiptTime;
-              pPoseData->Latencies = Latencies;
+              pPoseData->m_pLatencies = pLatencies;
               pPoseData->Result = VSubjectPose::ESuccess;
               pPoseData->FrameRate = FrameRateHz;
 
@@ -879,30 +1152,26 @@ namespace ViconDataStreamSDK
               std::string RootSegment;
               m_pClient->GetSubjectRootSegmentName(SubjectName, RootSegment);
 
-              pPoseData->Name = SubjectName;
-              pPoseData->RootSegment = RootSegment;
+              // The retimer replaces this with its shared copy if the topology is unchanged
+              std::shared_ptr< VSubjectTopology > pTopology = std::make_shared< VSubjectTopology >();
+              pTopology->Name = SubjectName;
+              pTopology->RootSegment = RootSegment;
 
               // Count the number of segments
               unsigned int SegmentCount;
               m_pClient->GetSegmentCount(SubjectName, SegmentCount);
+              pPoseData->m_Segments.reserve( SegmentCount );
               for( unsigned int SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex )
               {
                 std::string SegmentName;
                 m_pClient->GetSegmentName(SubjectName, SegmentIndex, SegmentName);
 
-                pPoseData->m_SegmentNames.push_back( SegmentName );
-
-                std::shared_ptr< VSegmentPose > pSegmentPoseData(new VSegmentPose());
-                pSegmentPoseData->Name = SegmentName;
-
                 // Get our parent name (if we have one)
                 std::string ParentName;
-                if( m_pClient->GetSegmentParentName(SubjectName, SegmentName, ParentName) == Result::Success )
-                {
-                  pSegmentPoseData->Parent = ParentName;
-                }
+                m_pClient->GetSegmentParentName(SubjectName, SegmentName, ParentName);
 
                 // Add some information about the children of this segment
+                std::vector< std::string > Children;
                 unsigned int ChildSegmentCount;
                 if( m_pClient->GetSegmentChildCount(SubjectName, SegmentName, ChildSegmentCount) == Result::Success )
                 {
@@ -911,64 +1180,72 @@ namespace ViconDataStreamSDK
                     std::string ChildSegmentName;
                     if( m_pClient->GetSegmentChildName(SubjectName, SegmentName, ChildSegmentIndex, ChildSegmentName) == Result::Success )
                     {
-                      pSegmentPoseData->m_Children.push_back(ChildSegmentName);
+                      Children.push_back(ChildSegmentName);
                     }
                   }
                 }
 
+                pTopology->AddSegment( SegmentName, ParentName, Children );
+
+                VSegmentPose SegmentPoseData;
+
                 // Get the global segment translation
                 bool bOccluded = false;
                 double Translation[3];
                 m_pClient->GetSegmentGlobalTranslation(SubjectName, SegmentName, Translation, bOccluded);
-                std::copy(Translation, Translation + 3, pSegmentPoseData->T.begin());
+                std::copy(Translation, Translation + 3, SegmentPoseData.T.begin());
 
                 // Get the global segment rotation in quaternion co-ordinates
                 double Rotation[4];
                 m_pClient->GetSegmentGlobalRotationQuaternion(SubjectName, SegmentName, Rotation, bOccluded);
-                std::copy(Rotation, Rotation + 4, pSegmentPoseData->R.begin());
+                std::copy(Rotation, Rotation + 4, SegmentPoseData.R.begin());
 
                 // Get local translation
                 double LocalTranslation[3];
                 m_pClient->GetSegmentLocalTranslation(SubjectName, SegmentName, LocalTranslation, bOccluded);
-                std::copy(LocalTranslation, LocalTranslation + 3, pSegmentPoseData->T_Rel.begin());
+                std::copy(LocalTranslation, LocalTranslation + 3, SegmentPoseData.T_Rel.begin());
 
                 // And local rotation
                 double LocalRotation[4];
                 m_pClient->GetSegmentLocalRotationQuaternion(SubjectName, SegmentName, LocalRotation, bOccluded);
-                std::copy(LocalRotation, LocalRotation + 4, pSegmentPoseData->R_Rel.begin());
+                std::copy(LocalRotation, LocalRotation + 4, SegmentPoseData.R_Rel.begin());
 
                 // Get static translation
                 double StaticTranslation[3];
                 m_pClient->GetSegmentStaticTranslation(SubjectName, SegmentName, StaticTranslation);
-                std::copy(StaticTranslation, StaticTranslation + 3, pSegmentPoseData->T_Stat.begin());
+                std::copy(StaticTranslation, StaticTranslation + 3, SegmentPoseData.T_Stat.begin());
 
                 // And static rotation
                 double StaticRotation[4];
                 m_pClient->GetSegmentStaticRotationQuaternion(SubjectName, SegmentName, StaticRotation);
-                std::copy(StaticRotation, StaticRotation + 4, pSegmentPoseData->R_Stat.begin());
+                std::copy(StaticRotation, StaticRotation + 4, SegmentPoseData.R_Stat.begin());
 
                 // and scale
                 double Scale[3];
                 if( m_pClient->GetSegmentStaticScale(SubjectName, SegmentName, Scale) == Result::Success )
                 {
-                  std::copy(Scale, Scale + 3, pSegmentPoseData->Scale.begin());
-                  pSegmentPoseData->bHasScale = true;
+                  std::copy(Scale, Scale + 3, SegmentPoseData.Scale.begin());
+                  SegmentPoseData.bHasScale = true;
                 }
                 else
                 {
-                  pSegmentPoseData->bHasScale = false;
+                  SegmentPoseData.bHasScale = false;
                 }
 
-                pSegmentPoseData->bOccluded = bOccluded;
+                SegmentPoseData.bOccluded = bOccluded;
 
-                pPoseData->m_Segments[SegmentName] = pSegmentPoseData;
+                pPoseData->m_Segments.push_back( SegmentPoseData );
               }
 
+              pPoseData->m_pTopology = pTopology;
+
               PoseDataItems.emplace_back( pPoseData );
             }
 
             m_Retimer.AddData( PoseDataItems );
 
+            AddMarkerData( FrameNumber, FrameRateHz, WallReceiptTime );
+            AddDeviceData( FrameNumber, FrameRateHz, WallReceiptTime );
           }
         }
       }
@@ -977,14 +1254,125 @@ namespace ViconDataStreamSDK
 
     }
 
+    void VRetimingClient::AddMarkerData( unsigned int i_FrameNumber, double i_FrameRate, double i_ReceiptTime )
+    {
+      if( !m_pClient->IsMarkerDataEnabled() && !m_pClient->IsUnlabeledMarkerDataEnabled() )
+      {
+        return;
+      }
+
+      std::shared_ptr< VMarkerFrame > pFrame = std::make_shared< VMarkerFrame >();
+      pFrame->FrameNumber = i_FrameNumber;
+      pFrame->ReceiptTime = i_ReceiptTime;
+      pFrame->FrameRate = i_FrameRate;
+
+      unsigned int MarkerCount = 0;
+      if( m_pClient->GetLabeledMarkerCount( MarkerCount ) == Result::Success )
+      {
+        for( unsigned int MarkerIndex = 0; MarkerIndex < MarkerCount; ++MarkerIndex )
+        {
+          double Translation[ 3 ];
+          unsigned int TrajectoryID = 0;
+          if( m_pClient->GetLabeledMarkerGlobalTranslation( MarkerIndex, Translation, TrajectoryID ) == Result::Success )
+          {
+            pFrame->m_Labeled.Add( TrajectoryID, { { Translation[ 0 ], Translation[ 1 ], Translation[ 2 ] } } );
+          }
+        }
+        pFrame->m_Labeled.Sort();
+      }
+
+      if( m_pClient->GetUnlabeledMarkerCount( MarkerCount ) == Result::Success )
+      {
+        for( unsigned int MarkerIndex = 0; MarkerIndex < MarkerCount; ++MarkerIndex )
+        {
+          double Translation[ 3 ];
+          unsigned int TrajectoryID = 0;
+          if( m_pClient->GetUnlabeledMarkerGlobalTranslation( MarkerIndex, Translation, TrajectoryID ) == Result::Success )
+          {
+            pFrame->m_Unlabeled.Add( TrajectoryID, { { Translation[ 0 ], Translation[ 1 ], Translation[ 2 ] } } );
+          }
+        }
+        pFrame->m_Unlabeled.Sort();
+      }
+
+      m_Retimer.AddMarkers( pFrame );
+    }
+
+    void VRetimingClient::AddDeviceData( unsigned int i_FrameNumber, double i_FrameRate, double i_ReceiptTime )
+    {
+      unsigned int DeviceCount = 0;
+      if( !m_pClient->IsDeviceDataEnabled() || m_pClient->GetDeviceCount( DeviceCount ) != Result::Success )
+      {
+        return;
+      }
+
+      std::vector< std::shared_ptr< VDeviceFrame > > DeviceFrames;
+      for( unsigned int DeviceIndex = 0; DeviceIndex < DeviceCount; ++DeviceIndex )
+      {
+        // The retimer replaces this with its shared copy if the channels are unchanged
+        std::shared_ptr< VDeviceChannels > pChannels = std::make_shared< VDeviceChannels >();
+        if( m_pClient->GetDeviceName( DeviceIndex, pChannels->Name, pChannels->Type ) != Result::Success )
+        {
+          continue;
+        }
+
+        std::shared_ptr< VDeviceFrame > pFrame = std::make_shared< VDeviceFrame >();
+        pFrame->FrameNumber = i_FrameNumber;
+        pFrame->ReceiptTime = i_ReceiptTime;
+        pFrame->FrameRate = i_FrameRate;
+
+        // Every output of a device is sampled at the same rate; should they ever differ, the common subsamples are kept
+        bool bFirstOutput = true;
+        unsigned int OutputCount = 0;
+        m_pClient->GetDeviceOutputCount( pChannels->Name, OutputCount );
+        for( unsigned int OutputIndex = 0; OutputIndex < OutputCount; ++OutputIndex )
+        {
+          std::string OutputName;
+          std::string ComponentName;
+          Unit::Enum OutputUnit;
+          if( m_pClient->GetDeviceOutputNameComponent( pChannels->Name, OutputIndex, OutputName, ComponentName, OutputUnit ) != Result::Success )
+          {
+            continue;
+          }
+
+          unsigned int SubsampleCount = 0;
+          bool bOccluded = false;
+          m_pClient->GetDeviceOutputSubsamples( pChannels->Name, OutputName, ComponentName, SubsampleCount, bOccluded );
+
+          pChannels->m_OutputNames.push_back( OutputName );
+          pChannels->m_ComponentNames.push_back( ComponentName );
+          pChannels->m_Units.push_back( OutputUnit );
+          pFrame->m_Occluded.push_back( bOccluded );
+
+          pFrame->SubsampleCount = bFirstOutput ? SubsampleCount : std::min( pFrame->SubsampleCount, SubsampleCount );
+          bFirstOutput = false;
+        }
+
+        // Store subsample-major, so that the retimer interpolates all channels of a subsample together
+        const unsigned int ChannelCount = pChannels->ChannelCount();
+        pFrame->m_Values.resize( static_cast< size_t >( pFrame->SubsampleCount ) * ChannelCount );
+        for( unsigned int Channel = 0; Channel < ChannelCount; ++Channel )
+        {
+          for( unsigned int Subsample = 0; Subsample < pFrame->SubsampleCount; ++Subsample )
+          {
+            bool bOccluded = false;
+            m_pClient->GetDeviceOutputValue( pChannels->Name, pChannels->m_OutputNames[ Channel ], pChannels->m_ComponentNames[ Channel ], Subsample,
+                                             pFrame->m_Values[ Subsample * ChannelCount + Channel ], bOccluded );
+          }
+        }
+
+        pFrame->m_pChannels = pChannels;
+        DeviceFrames.push_back( pFrame );
+      }
+
+      m_Retimer.AddDevices( DeviceFrames );
+    }
+
     void VRetimingClient::OutputThread()
     {
       // Keep track of retimed output frame number
       uint64_t CurrentOutputFrame = 0;
 
-      std::chrono::system_clock::time_point WakeTime
-        = std::chrono::system_clock::now() + std::chrono::milliseconds(static_cast< unsigned int >( ( 1.0 / m_FrameRate ) * 1000 ));;
-
       while( !m_bOutputStopped )
       {
         {
@@ -1003,8 +1391,7 @@ namespace ViconDataStreamSDK
         ++CurrentOutputFrame;
 
         // Yield until next frame is required.
-        std::this_thread::sleep_until( WakeTime );
-        WakeTime += std::chrono::milliseconds(static_cast< unsigned int >( ( 1.0 / m_FrameRate ) * 1000 ));
+        m_OutputScheduler.WaitForNextTick();
 
       }
 
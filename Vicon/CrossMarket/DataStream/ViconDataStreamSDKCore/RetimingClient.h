@@ -36,6 +36,7 @@
 #include <chrono>
 
 #include "RetimingCore.h"
+#include "RetimerOutputScheduler.h"
 
 #include <ViconDataStreamSDKCoreUtils/Constants.h>
 #include <ViconDataStreamSDKCoreUtils/ClientUtils.h>
@@ -75,6 +76,10 @@ namespace ViconDataStreamSDK
       // Store a predicted pose for all subjects currently in the stream at the current time.
       Result::Enum UpdateFrame(double i_Offset);
 
+      // Predict all subjects at the current time plus i_Offset (in milliseconds) into a frame owned by the caller.
+      // Unlike UpdateFrame this leaves the stored frame alone, so may be called from any thread while output is running.
+      Result::Enum SampleFrame( double i_Offset, std::shared_ptr< const VRetimedFrame > & o_rpFrame ) const;
+
       Result::Enum GetSubjectCount(unsigned int & o_rSubjectCount) const;
       Result::Enum GetSubjectName(const unsigned int i_SubjectIndex, std::string& o_rSubjectName) const;
       Result::Enum GetSubjectRootSegmentName(const std::string & i_rSubjectName, std::string & o_rSegmentName) const;
@@ -104,6 +109,23 @@ namespace ViconDataStreamSDK
       Result::Enum GetSegmentLocalRotationQuaternion(const std::string& i_rSubjectName, const std::string& i_rSegmentName, double(&o_rFourVector)[4], bool& o_rbOccluded) const;
       Result::Enum GetSegmentLocalRotationEulerXYZ(const std::string& i_rSubjectName, const std::string& i_rSegmentName, double(&o_rThreeVector)[3], bool& o_rbOccluded) const;
 
+      // Markers and devices are retimed when their data is enabled on the client. Marker trajectory IDs are returned
+      // as for the non-retimed client; device subsamples are resampled to the output rate.
+      Result::Enum GetLabeledMarkerCount( unsigned int & o_rMarkerCount ) const;
+      Result::Enum GetLabeledMarkerGlobalTranslation( const unsigned int i_MarkerIndex, double( &o_rTranslation )[3], unsigned int & o_rTrajID ) const;
+      Result::Enum GetUnlabeledMarkerCount( unsigned int & o_rMarkerCount ) const;
+      Result::Enum GetUnlabeledMarkerGlobalTranslation( const unsigned int i_MarkerIndex, double( &o_rTranslation )[3], unsigned int & o_rTrajID ) const;
+
+      Result::Enum GetDeviceCount( unsigned int & o_rDeviceCount ) const;
+      Result::Enum GetDeviceName( const unsigned int i_DeviceIndex, std::string & o_rDeviceName, DeviceType::Enum & o_rDeviceType ) const;
+      Result::Enum GetDeviceOutputCount( const std::string & i_rDeviceName, unsigned int & o_rDeviceOutputCount ) const;
+      Result::Enum GetDeviceOutputNameComponent( const std::string & i_rDeviceName, const unsigned int i_DeviceOutputIndex,
+                                                 std::string & o_rDeviceOutputName, std::string & o_rDeviceOutputComponentName, Unit::Enum & o_rDeviceOutputUnit ) const;
+      Result::Enum GetDeviceOutputSubsamples( const std::string & i_rDeviceName, const std::string & i_rDeviceOutputName, const std::string & i_rDeviceOutputComponentName,
+                                              unsigned int & o_rDeviceOutputSubsamples, bool & o_rbOccluded ) const;
+      Result::Enum GetDeviceOutputValue( const std::string & i_rDeviceName, const std::string & i_rDeviceOutputName, const std::string & i_rDeviceOutputComponentName,
+                                         unsigned int i_Subsample, double & o_rValue, bool & o_rbOccluded ) const;
+
       // Wait for a frame, populates pose of all objects in o_rSubjects mapped to name
       Result::Enum WaitForFrame() const;
 
@@ -114,24 +136,58 @@ namespace ViconDataStreamSDK
       // Return the output latency specified
       double OutputLatency() const;
 
+      // Set the time (in milliseconds) the output thread busy-waits before each tick, for a tighter output rate
+      void SetOutputSpinTime( double i_SpinTime );
+
+      // Return the output spin time
+      double OutputSpinTime() const;
+
+      // Achieved output tick timing since output was started
+      Result::Enum GetOutputTimingStatistics( VOutputTimingStatistics & o_rStatistics ) const;
+
       // Set the maximum amount by which the interpolation engine will predict forward
       void SetMaximumPrediction( double i_MaxPrediction );
 
       // Return the maximum prediction used by the system
       double MaximumPrediction() const;
 
+      // Set the number of input samples kept per subject for prediction
+      void SetHistoryDepth( unsigned int i_Depth );
+
+      unsigned int HistoryDepth() const;
+
+      // Select the model used to predict poses from the sample history
+      void SetPredictionModel( PredictionModel::Enum i_Model );
+
+      PredictionModel::Enum GetPredictionModel() const;
+
+      // Set the number of worker threads that share subject prediction with the output thread
+      void SetPredictionThreadCount( unsigned int i_ThreadCount );
+
+      unsigned int PredictionThreadCount() const;
+
       // Set a log file to write debug output about performance to
       bool SetDebugLogFile(const std::string & i_rLogFile);
 
       // Set a file to write input data to, allowing offline processing of the subequent file
-      bool SetOutputFile(const std::string & i_rLogFile);
+      bool SetOutputFile(const std::string & i_rLogFile, OutputLogFormat::Enum i_Format = OutputLogFormat::Text );
 
     private:
 
       void InputThread();
       void StopInput();
 
-      typedef std::chrono::high_resolution_clock hrc;
+      // Pass the markers and devices of the latest frame to the retimer, if their data is enabled
+      void AddMarkerData( unsigned int i_FrameNumber, double i_FrameRate, double i_ReceiptTime );
+      void AddDeviceData( unsigned int i_FrameNumber, double i_FrameRate, double i_ReceiptTime );
+
+      Result::Enum GetMarkerSet( bool i_bLabeled, const VMarkerSet * & o_rpMarkerSet, std::shared_ptr< const VRetimedMarkers > & o_rpMarkers ) const;
+
+      // The device is returned whenever it exists, so that its channels may be read even if it could not be resampled
+      Result::Enum GetRetimedDevice( const std::string & i_rDeviceName, std::shared_ptr< const VRetimedDevice > & o_rpDevice ) const;
+
+      // Timestamps are relative to the steady clock, so are unaffected by wall clock adjustments
+      typedef std::chrono::steady_clock hrc;
       hrc::time_point m_Epoch;
 
       bool InitGet(Result::Enum & o_rResult) const;
@@ -163,6 +219,8 @@ namespace ViconDataStreamSDK
       std::unique_ptr< boost::thread > m_pOutputThread;
       bool m_bOutputStopped;
 
+      VRetimerOutputScheduler m_OutputScheduler;
+
       // Required output latency (in milliseconds)
       double m_OutputLatency;
 
@@ -24,8 +24,10 @@
 //////////////////////////////////////////////////////////////////////////////////
 #include "RetimingCore.h"
 #include "RetimerUtils.h"
+#include "SubjectPoseLog.h"
 
 #include <ViconCGStreamClient/CGStreamPostalService.h>
+#include <ViconCGStreamClient/CGStreamDecodePool.h>
 
 #pragma warning( push )
 #pragma warning( disable : 4265 )
@@ -40,7 +42,6 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/range/combine.hpp>
-#include <boost/format.hpp>
 
 using namespace ClientUtils;
 
@@ -48,33 +49,119 @@ namespace ViconDataStreamSDK
 {
   namespace Core
   {
-    static unsigned int s_BufSize = 2;
+    static unsigned int s_MinHistoryDepth = 2;
+    static unsigned int s_MaxHistoryDepth = 64;
+
+    // Samples older than this relative to the newest sample of a subject are not used for prediction (in milliseconds)
     static double s_PurgeLimit = 500.0;
+    static size_t s_OutputPoolSize = 4;
+    static size_t s_InputPoolSize = 4;
+
+    // Fewest subjects worth handing to another thread; below this the hand off costs more than the prediction
+    static size_t s_MinSubjectsPerTask = 8;
 
     VRetimingCore::VRetimingCore()    
-    : m_MaxPredictionTime( 100 )
+    : m_OutputSubjectCount( 0 )
+    , m_OutputDeviceCount( 0 )
+    , m_LastUpdateTime( 0 )
+    , m_bHasLastUpdateTime( false )
+    , m_MaxPredictionTime( 100 )
+    , m_HistoryDepth( s_MinHistoryDepth )
+    , m_PredictionModel( PredictionModel::ConstantVelocity )
     , m_bOutputLogHeaderWritten( true )
     {
     }
 
     VRetimingCore::~VRetimingCore()
     {
-      CloseDebugLog();
+      m_DebugLog.Close();
       CloseOutputLog();
     }
 
     void VRetimingCore::SetMaximumPrediction( double i_MaxPrediction )
     {
-      boost::recursive_mutex::scoped_lock Lock( m_DataMutex );
+      TWriteLock Lock( m_DataMutex );
       m_MaxPredictionTime = i_MaxPrediction;
     }
 
     double VRetimingCore::MaximumPrediction() const
     {
-      boost::recursive_mutex::scoped_lock Lock( m_DataMutex );
+      TReadLock Lock( m_DataMutex );
       return m_MaxPredictionTime;
     }
 
+    void VRetimingCore::SetHistoryDepth( unsigned int i_Depth )
+    {
+      TWriteLock Lock( m_DataMutex );
+      m_HistoryDepth = std::min( std::max( i_Depth, s_MinHistoryDepth ), s_MaxHistoryDepth );
+
+      for( auto & rpSlot : m_Slots )
+      {
+        std::shared_ptr< const VSubjectInput > pInput = std::atomic_load( &rpSlot->m_pInput );
+        if( pInput )
+        {
+          std::shared_ptr< VSubjectInput > pNext = rpSlot->AcquireInput();
+          pNext->CopyFrom( *pInput );
+          pNext->m_Samples.SetCapacity( m_HistoryDepth );
+          std::atomic_store( &rpSlot->m_pInput, std::shared_ptr< const VSubjectInput >( pNext ) );
+        }
+      }
+    }
+
+    unsigned int VRetimingCore::HistoryDepth() const
+    {
+      TReadLock Lock( m_DataMutex );
+      return m_HistoryDepth;
+    }
+
+    void VRetimingCore::SetPredictionModel( PredictionModel::Enum i_Model )
+    {
+      TWriteLock Lock( m_DataMutex );
+      m_PredictionModel = i_Model;
+
+      // Replace each subject's predictor, bringing any filter state up to date with the samples already held
+      for( auto & rpSlot : m_Slots )
+      {
+        std::shared_ptr< const VSubjectInput > pInput = std::atomic_load( &rpSlot->m_pInput );
+        if( pInput )
+        {
+          std::shared_ptr< VSubjectInput > pNext = rpSlot->AcquireInput();
+          pNext->m_pTopology = pInput->m_pTopology;
+          pNext->m_Samples = pInput->m_Samples;
+          pNext->m_pPredictor = VPosePredictor::Create( m_PredictionModel );
+          for( unsigned int SampleIndex = 0; SampleIndex < pNext->m_Samples.Size(); ++SampleIndex )
+          {
+            pNext->m_pPredictor->AddSample( *pNext->m_Samples[ SampleIndex ] );
+          }
+          std::atomic_store( &rpSlot->m_pInput, std::shared_ptr< const VSubjectInput >( pNext ) );
+        }
+      }
+    }
+
+    PredictionModel::Enum VRetimingCore::GetPredictionModel() const
+    {
+      TReadLock Lock( m_DataMutex );
+      return m_PredictionModel;
+    }
+
+    void VRetimingCore::SetPredictionThreadCount( unsigned int i_ThreadCount )
+    {
+      boost::mutex::scoped_lock UpdateLock( m_UpdateMutex );
+
+      m_pPredictionPool.reset();
+      if( i_ThreadCount > 0 )
+      {
+        m_pPredictionPool.reset( new VCGStreamDecodePool() );
+        m_pPredictionPool->StartService( i_ThreadCount );
+      }
+    }
+
+    unsigned int VRetimingCore::PredictionThreadCount() const
+    {
+      boost::mutex::scoped_lock UpdateLock( m_UpdateMutex );
+      return m_pPredictionPool ? m_pPredictionPool->ThreadCount() : 0;
+    }
+
     // utility to insert the current date and time into a string
     static std::string TimestampFilename( const std::string& i_rFilename )
     {
@@ -93,297 +180,1061 @@ namespace ViconDataStreamSDK
     bool VRetimingCore::SetDebugLogFile( const std::string& i_rLogFile )
     {
 
-      return CreateDebugLog( TimestampFilename( i_rLogFile ) );
+      return m_DebugLog.Open( TimestampFilename( i_rLogFile ) );
     }
 
-    bool VRetimingCore::SetOutputFile( const std::string& i_rLogFile )
+    bool VRetimingCore::SetOutputFile( const std::string& i_rLogFile, OutputLogFormat::Enum i_Format )
     {
-      return CreateOutputLog( TimestampFilename( i_rLogFile ) );
+      return CreateOutputLog( TimestampFilename( i_rLogFile ), i_Format );
     }
 
     void VRetimingCore::AddData( std::vector< std::shared_ptr< VSubjectPose > > i_pData )
     {
-      boost::recursive_mutex::scoped_lock Lock( m_DataMutex );
+      // Slots for new subjects are created up front, as that is the only part of adding data which needs the
+      // lock exclusively
+      bool bNewSubjects = false;
+      {
+        TReadLock Lock( m_DataMutex );
+        for( const auto& rpData : i_pData )
+        {
+          if( rpData && rpData->m_pTopology && m_SlotIndex.find( rpData->Name() ) == m_SlotIndex.end() )
+          {
+            bNewSubjects = true;
+            break;
+          }
+        }
+      }
+
+      if( bNewSubjects )
+      {
+        TWriteLock Lock( m_DataMutex );
+        for( const auto& rpData : i_pData )
+        {
+          if( rpData && rpData->m_pTopology && m_SlotIndex.find( rpData->Name() ) == m_SlotIndex.end() )
+          {
+            m_SlotIndex[ rpData->Name() ] = static_cast< unsigned int >( m_Slots.size() );
+            m_Slots.emplace_back( new VSubjectSlot() );
+            m_Slots.back()->m_Name = rpData->Name();
+          }
+        }
+      }
+
+      TReadLock Lock( m_DataMutex );
+
+      for( const auto& rpData : i_pData )
+      {
+
+        if( !rpData || !rpData->m_pTopology )
+        {
+          continue;
+        }
+
+        auto SlotIt = m_SlotIndex.find( rpData->Name() );
+        if( SlotIt != m_SlotIndex.end() )
+        {
+          AddSample( *m_Slots[ SlotIt->second ], rpData );
+        }
+      }
+    }
+
+    void VRetimingCore::AddSample( VSubjectSlot & io_rSlot, const std::shared_ptr< VSubjectPose > & i_rpData )
+    {
+      boost::mutex::scoped_lock InputLock( io_rSlot.m_InputMutex );
+
+      std::shared_ptr< const VSubjectInput > pInput = std::atomic_load( &io_rSlot.m_pInput );
+
+      // Build the next state alongside the published one; readers keep using the old state until it is swapped in
+      std::shared_ptr< VSubjectInput > pNext = io_rSlot.AcquireInput();
+      if( pInput )
+      {
+        pNext->CopyFrom( *pInput );
+      }
+      else
+      {
+        pNext->m_Samples.SetCapacity( m_HistoryDepth );
+        pNext->m_pPredictor = VPosePredictor::Create( m_PredictionModel );
+      }
+
+      bool bChanged = false;
+
+      // Share one topology between all poses of the subject, so that Predict can match segments by slot.
+      // If the topology has changed, samples held against the old one can no longer be matched.
+      if( i_rpData->m_pTopology != pNext->m_pTopology )
+      {
+        if( pNext->m_pTopology && *i_rpData->m_pTopology == *pNext->m_pTopology )
+        {
+          i_rpData->m_pTopology = pNext->m_pTopology;
+        }
+        else
+        {
+          pNext->m_pTopology = i_rpData->m_pTopology;
+          pNext->m_Samples.Clear();
+          pNext->m_pPredictor->Reset();
+          bChanged = true;
+        }
+      }
+
+      // Print all input data to the output log, even if it's occluded and we're not going to add it to
+      // the retimer.
+      OutputLog( i_rpData );
+
+      // DSSDK-210. Don't add occluded data, as we will be able to interpolate from good data
+      // as long as gaps are not too long. If an object becomes occluded for a significant time,
+      // Predict will return ELate when the data becomes too stale.
+      bool bOccluded = false;
+      // For multi-segment subjects, don't add if any segments are occluded.
+      for( const auto& rSegment : i_rpData->m_Segments )
+      {
+        if( rSegment.bOccluded )
+        {
+          bOccluded = true;
+          break;
+        }
+      }
+
+      if( !bOccluded )
+      {
+        // Frames delivered together can share a receipt time, which leaves no interval to predict over.
+        // Keep only the newest of them.
+        if( !pNext->m_Samples.Empty() && i_rpData->ReceiptTime <= pNext->m_Samples.Back()->ReceiptTime )
+        {
+          pNext->m_Samples.PopBack();
+        }
+
+        pNext->m_Samples.Push( i_rpData );
+
+        // A full history drops its oldest sample on Push; also drop any that are too old to describe current motion
+        while( pNext->m_Samples.Size() > 1 && i_rpData->ReceiptTime - pNext->m_Samples.Front()->ReceiptTime > s_PurgeLimit )
+        {
+          pNext->m_Samples.PopFront();
+        }
+
+        pNext->m_pPredictor->AddSample( *i_rpData );
+        bChanged = true;
+      }
+
+      if( bChanged || !pInput )
+      {
+        std::atomic_store( &io_rSlot.m_pInput, std::shared_ptr< const VSubjectInput >( pNext ) );
+      }
+    }
+
+    std::shared_ptr< const VSubjectPose > VRetimingCore::Predict( std::shared_ptr< const VSubjectPose > p1, std::shared_ptr< const VSubjectPose > p2, double t ) const
+    {
+      std::shared_ptr< VSubjectPose > pOutput( new VSubjectPose() );
+
+      if( p1 && p2 )
+      {
+        Predict( *p1, *p2, t, *pOutput );
+      }
+
+      return pOutput;
+    }
+
+    VSubjectPose::EResult VRetimingCore::Predict( const VSubjectPose & i_rP1, const VSubjectPose & i_rP2, double i_Time, VSubjectPose & o_rOutput ) const
+    {
+      if( PreparePrediction( i_rP1, i_rP2, i_Time, o_rOutput ) == VSubjectPose::ESuccess )
+      {
+        VConstantVelocityPredictor::PredictSegments( i_rP1, i_rP2, i_Time, o_rOutput );
+      }
+
+      return o_rOutput.Result;
+    }
+
+    VSubjectPose::EResult VRetimingCore::Predict( const VSubjectInput & i_rInput, double i_Time, VSubjectPose & o_rOutput ) const
+    {
+      const VPoseHistory & rHistory = i_rInput.m_Samples;
+      if( PreparePrediction( *rHistory.Front(), *rHistory.Back(), i_Time, o_rOutput ) == VSubjectPose::ESuccess )
+      {
+        // Frame numbers advance linearly, so follow the newest pair whatever the model
+        o_rOutput.FrameNumber = ClientUtils::PredictVal( rHistory[ rHistory.Size() - 2 ]->FrameNumber, rHistory[ rHistory.Size() - 2 ]->ReceiptTime,
+                                                         rHistory.Back()->FrameNumber, rHistory.Back()->ReceiptTime, i_Time );
+
+        i_rInput.m_pPredictor->Predict( rHistory, i_Time, o_rOutput );
+      }
+
+      return o_rOutput.Result;
+    }
+
+    VSubjectPose::EResult VRetimingCore::PreparePrediction( const VSubjectPose & i_rP1, const VSubjectPose & i_rP2, double i_Time, VSubjectPose & o_rOutput ) const
+    {
+      // Calculate the input frame number that corresponds to this requested time
+      double Sample1Index = i_rP1.ReceiptTime;
+      double Sample2Index = i_rP2.ReceiptTime;
+      double PredictionIndex = i_Time;
+      double MaximumPredictionValue = m_MaxPredictionTime;
+
+      if( i_rP1.m_pTopology != i_rP2.m_pTopology || i_rP1.m_Segments.size() != i_rP2.m_Segments.size() )
+      {
+        o_rOutput.Result = VSubjectPose::EInvalid;
+        m_DebugLog.Log( VRetimerDebugLog::EMismatchedTopology, i_rP1.Name(), PredictionIndex, Sample1Index, Sample2Index );
+        return o_rOutput.Result;
+      }
+
+      if( Sample2Index < Sample1Index )
+      {
+        o_rOutput.Result = VSubjectPose::EInvalid;
+        m_DebugLog.Log( VRetimerDebugLog::EInvalidReceiptTime, i_rP1.Name(), PredictionIndex, Sample1Index, Sample2Index );
+        return o_rOutput.Result;
+      }
+
+      if( PredictionIndex < Sample1Index )
+      {
+        o_rOutput.Result = VSubjectPose::EEarly;
+        m_DebugLog.Log( VRetimerDebugLog::EEarly, i_rP1.Name(), PredictionIndex, Sample1Index, Sample2Index );
+        return o_rOutput.Result;
+      }
+
+      if( PredictionIndex > Sample2Index )
+      {
+        if( PredictionIndex - Sample2Index > MaximumPredictionValue )
+        {
+          o_rOutput.Result = VSubjectPose::ELate;
+          m_DebugLog.Log( VRetimerDebugLog::ELate, i_rP1.Name(), PredictionIndex, Sample1Index, Sample2Index, MaximumPredictionValue );
+          return o_rOutput.Result;
+        }
+      }
+
+      m_DebugLog.Log( VRetimerDebugLog::EPrediction, i_rP1.Name(), PredictionIndex, Sample1Index, Sample2Index );
+
+      o_rOutput.FrameTime = i_Time;
+      o_rOutput.ReceiptTime = i_Time;
+      o_rOutput.Result = VSubjectPose::ESuccess;
+
+      // Copy over input data; topology and latencies are shared rather than copied
+      o_rOutput.m_pTopology = i_rP1.m_pTopology;
+      o_rOutput.m_pLatencies = i_rP1.m_pLatencies;
+      o_rOutput.FrameRate = i_rP1.FrameRate;
+
+      double PredictedFrameNumber = ClientUtils::PredictVal( i_rP1.FrameNumber, i_rP1.ReceiptTime, i_rP2.FrameNumber, i_rP2.ReceiptTime, i_Time );
+      o_rOutput.FrameNumber = PredictedFrameNumber;
+
+      // Both samples share a topology, so segments correspond slot for slot
+      const size_t SegmentCount = i_rP1.m_Segments.size();
+      o_rOutput.m_Segments.resize( SegmentCount );
+      for( size_t SegmentIndex = 0; SegmentIndex < SegmentCount; ++SegmentIndex )
+      {
+        const VSegmentPose & rSegment = i_rP1.m_Segments[ SegmentIndex ];
+        const VSegmentPose & rSegment2 = i_rP2.m_Segments[ SegmentIndex ];
+        VSegmentPose & rOutputSegment = o_rOutput.m_Segments[ SegmentIndex ];
+
+        rOutputSegment.T_Stat = rSegment.T_Stat;
+        rOutputSegment.R_Stat = rSegment.R_Stat;
+        rOutputSegment.bHasScale = rSegment.bHasScale;
+        rOutputSegment.Scale = rSegment.Scale;
+
+        rOutputSegment.bOccluded = rSegment.bOccluded || rSegment2.bOccluded;
+      }
+
+      return o_rOutput.Result;
+    }
+
+    void VRetimingCore::VSubjectInput::CopyFrom( const VSubjectInput & i_rOther )
+    {
+      m_pTopology = i_rOther.m_pTopology;
+
+      // Same capacity, so the ring's storage is reused
+      m_Samples = i_rOther.m_Samples;
+
+      if( !m_pPredictor || m_pPredictor->Model() != i_rOther.m_pPredictor->Model() )
+      {
+        m_pPredictor = VPosePredictor::Create( i_rOther.m_pPredictor->Model() );
+      }
+      m_pPredictor->CopyState( *i_rOther.m_pPredictor );
+    }
+
+    std::shared_ptr< VRetimingCore::VSubjectInput > VRetimingCore::VSubjectSlot::AcquireInput()
+    {
+      return m_InputPool.Acquire( s_InputPoolSize );
+    }
+
+    std::shared_ptr< VSubjectPose > VRetimingCore::VSubjectSlot::AcquireOutputPose()
+    {
+      return m_OutputPool.Acquire( s_OutputPoolSize );
+    }
+
+    void VRetimingCore::AddMarkers( const std::shared_ptr< const VMarkerFrame > & i_pFrame )
+    {
+      if( !i_pFrame )
+      {
+        return;
+      }
+
+      boost::mutex::scoped_lock InputLock( m_MarkerInputMutex );
+
+      std::shared_ptr< const VMarkerInput > pInput = std::atomic_load( &m_pMarkerInput );
+      std::shared_ptr< VMarkerInput > pNext = std::make_shared< VMarkerInput >();
+
+      // A frame which is not newer than the latest means the stream has restarted, so the history starts again
+      if( pInput && pInput->m_pLatest && pInput->m_pLatest->FrameNumber < i_pFrame->FrameNumber )
+      {
+        pNext->m_pPrevious = pInput->m_pLatest;
+      }
+      pNext->m_pLatest = i_pFrame;
+
+      std::atomic_store( &m_pMarkerInput, std::shared_ptr< const VMarkerInput >( pNext ) );
+    }
+
+    void VRetimingCore::AddDevices( std::vector< std::shared_ptr< VDeviceFrame > > i_Frames )
+    {
+      // As for subjects, only creating a slot needs the lock exclusively
+      bool bNewDevices = false;
+      {
+        TReadLock Lock( m_DataMutex );
+        for( const auto & rpFrame : i_Frames )
+        {
+          if( rpFrame && rpFrame->m_pChannels && m_DeviceSlotIndex.find( rpFrame->m_pChannels->Name ) == m_DeviceSlotIndex.end() )
+          {
+            bNewDevices = true;
+            break;
+          }
+        }
+      }
+
+      if( bNewDevices )
+      {
+        TWriteLock Lock( m_DataMutex );
+        for( const auto & rpFrame : i_Frames )
+        {
+          if( rpFrame && rpFrame->m_pChannels && m_DeviceSlotIndex.find( rpFrame->m_pChannels->Name ) == m_DeviceSlotIndex.end() )
+          {
+            m_DeviceSlotIndex[ rpFrame->m_pChannels->Name ] = static_cast< unsigned int >( m_DeviceSlots.size() );
+            m_DeviceSlots.emplace_back( new VDeviceSlot() );
+            m_DeviceSlots.back()->m_Name = rpFrame->m_pChannels->Name;
+          }
+        }
+      }
+
+      TReadLock Lock( m_DataMutex );
+
+      for( const auto & rpFrame : i_Frames )
+      {
+        if( !rpFrame || !rpFrame->m_pChannels )
+        {
+          continue;
+        }
+
+        auto SlotIt = m_DeviceSlotIndex.find( rpFrame->m_pChannels->Name );
+        if( SlotIt != m_DeviceSlotIndex.end() )
+        {
+          AddDeviceFrame( *m_DeviceSlots[ SlotIt->second ], rpFrame );
+        }
+      }
+    }
+
+    void VRetimingCore::AddDeviceFrame( VDeviceSlot & io_rSlot, const std::shared_ptr< VDeviceFrame > & i_rpFrame )
+    {
+      VDeviceFrame & rFrame = *i_rpFrame;
+      if( rFrame.FrameRate <= 0.0 || rFrame.SubsampleCount == 0 ||
+          rFrame.m_Values.size() != static_cast< size_t >( rFrame.SubsampleCount ) * rFrame.m_pChannels->ChannelCount() )
+      {
+        return;
+      }
+
+      boost::mutex::scoped_lock InputLock( io_rSlot.m_InputMutex );
+
+      std::shared_ptr< const VDeviceInput > pInput = std::atomic_load( &io_rSlot.m_pInput );
+      std::shared_ptr< VDeviceInput > pNext = io_rSlot.m_InputPool.Acquire( s_InputPoolSize );
+      pNext->m_Frames.clear();
+
+      if( pInput && !pInput->m_Frames.empty() )
+      {
+        const VDeviceFrame & rLatest = *pInput->m_Frames.back();
+
+        // Share one set of channels between all frames of the device. Frames held against other channels, at another
+        // frame rate or from before a restart of the stream can not be resampled together with this one.
+        if( rFrame.m_pChannels != rLatest.m_pChannels && *rFrame.m_pChannels == *rLatest.m_pChannels )
+        {
+          rFrame.m_pChannels = rLatest.m_pChannels;
+        }
+
+        if( rFrame.m_pChannels == rLatest.m_pChannels && rFrame.FrameRate == rLatest.FrameRate && rFrame.FrameNumber > rLatest.FrameNumber )
+        {
+          pNext->m_Frames = pInput->m_Frames;
+        }
+      }
+
+      pNext->m_Frames.push_back( i_rpFrame );
+
+      const double FramePeriod = 1000.0 / rFrame.FrameRate;
+      while( pNext->m_Frames.size() > 1 && ( rFrame.FrameNumber - pNext->m_Frames.front()->FrameNumber ) * FramePeriod > s_PurgeLimit )
+      {
+        pNext->m_Frames.pop_front();
+      }
+
+      std::atomic_store( &io_rSlot.m_pInput, std::shared_ptr< const VDeviceInput >( pNext ) );
+    }
+
+    // Interpolate the markers of i_rTo back towards those with the same trajectory ID in i_rFrom. Markers which are
+    // only in i_rTo are held where they are.
+    static void InterpolateMarkers( const VMarkerSet & i_rFrom, const VMarkerSet & i_rTo, double u, VMarkerSet & o_rOutput )
+    {
+      o_rOutput.m_TrajectoryIDs = i_rTo.m_TrajectoryIDs;
+      o_rOutput.m_Translations.resize( i_rTo.m_Translations.size() );
+
+      size_t From = 0;
+      for( size_t To = 0; To < i_rTo.m_TrajectoryIDs.size(); ++To )
+      {
+        const unsigned int TrajectoryID = i_rTo.m_TrajectoryIDs[ To ];
+        while( From < i_rFrom.m_TrajectoryIDs.size() && i_rFrom.m_TrajectoryIDs[ From ] < TrajectoryID )
+        {
+          ++From;
+        }
+
+        if( From < i_rFrom.m_TrajectoryIDs.size() && i_rFrom.m_TrajectoryIDs[ From ] == TrajectoryID )
+        {
+          InterpolateChannels( i_rFrom.m_Translations[ From ].data(), i_rTo.m_Translations[ To ].data(), u, 3, o_rOutput.m_Translations[ To ].data() );
+        }
+        else
+        {
+          o_rOutput.m_Translations[ To ] = i_rTo.m_Translations[ To ];
+        }
+      }
+    }
+
+    VSubjectPose::EResult VRetimingCore::PredictMarkers( const VMarkerInput & i_rInput, double i_Time, VRetimedMarkers & o_rOutput ) const
+    {
+      static const std::string s_MarkersName( "Markers" );
+
+      o_rOutput.Time = i_Time;
+      o_rOutput.m_Labeled.Clear();
+      o_rOutput.m_Unlabeled.Clear();
+
+      if( !i_rInput.m_pPrevious || !i_rInput.m_pLatest )
+      {
+        o_rOutput.Result = VSubjectPose::ENoData;
+        return o_rOutput.Result;
+      }
+
+      const VMarkerFrame & rPrevious = *i_rInput.m_pPrevious;
+      const VMarkerFrame & rLatest = *i_rInput.m_pLatest;
+
+      if( rLatest.ReceiptTime <= rPrevious.ReceiptTime )
+      {
+        o_rOutput.Result = VSubjectPose::EInvalid;
+        m_DebugLog.Log( VRetimerDebugLog::EInvalidReceiptTime, s_MarkersName, i_Time, rPrevious.ReceiptTime, rLatest.ReceiptTime );
+      }
+      else if( i_Time < rPrevious.ReceiptTime )
+      {
+        o_rOutput.Result = VSubjectPose::EEarly;
+        m_DebugLog.Log( VRetimerDebugLog::EEarly, s_MarkersName, i_Time, rPrevious.ReceiptTime, rLatest.ReceiptTime );
+      }
+      else if( i_Time - rLatest.ReceiptTime > m_MaxPredictionTime )
+      {
+        o_rOutput.Result = VSubjectPose::ELate;
+        m_DebugLog.Log( VRetimerDebugLog::ELate, s_MarkersName, i_Time, rPrevious.ReceiptTime, rLatest.ReceiptTime, m_MaxPredictionTime );
+      }
+      else
+      {
+        const double u = ( i_Time - rPrevious.ReceiptTime ) / ( rLatest.ReceiptTime - rPrevious.ReceiptTime );
+        InterpolateMarkers( rPrevious.m_Labeled, rLatest.m_Labeled, u, o_rOutput.m_Labeled );
+        InterpolateMarkers( rPrevious.m_Unlabeled, rLatest.m_Unlabeled, u, o_rOutput.m_Unlabeled );
+        o_rOutput.Result = VSubjectPose::ESuccess;
+      }
+
+      return o_rOutput.Result;
+    }
+
+    VSubjectPose::EResult VRetimingCore::ResampleDevice( const VDeviceInput & i_rInput, double i_Time, double i_Period, unsigned int i_Count, VRetimedDevice & o_rOutput ) const
+    {
+      const std::deque< std::shared_ptr< const VDeviceFrame > > & rFrames = i_rInput.m_Frames;
+      const VDeviceFrame & rNewest = *rFrames.back();
+      const size_t ChannelCount = rNewest.m_pChannels->ChannelCount();
+      const double InputPeriod = 1000.0 / rNewest.FrameRate;
+
+      // The subsamples of a frame are spread evenly over its period, the last at the end. Frames are placed back from the
+      // newest receipt time by frame number.
+      auto SampleTime = [ & ]( size_t i_Frame, unsigned int i_Subsample )
+      {
+        const VDeviceFrame & rFrame = *rFrames[ i_Frame ];
+        const double FrameEnd = rNewest.ReceiptTime - ( rNewest.FrameNumber - rFrame.FrameNumber ) * InputPeriod;
+        return FrameEnd - InputPeriod + ( i_Subsample + 1 ) * InputPeriod / rFrame.SubsampleCount;
+      };
+
+      o_rOutput.Time = i_Time;
+
+      VDeviceFrame & rSamples = o_rOutput.m_Samples;
+      rSamples.m_pChannels = rNewest.m_pChannels;
+      rSamples.m_Occluded = rNewest.m_Occluded;
+      rSamples.FrameNumber = rNewest.FrameNumber + ( i_Time - rNewest.ReceiptTime ) / InputPeriod;
+      rSamples.ReceiptTime = i_Time;
+      rSamples.FrameRate = i_Period > 0.0 ? 1000.0 / i_Period : rNewest.FrameRate;
+      rSamples.SubsampleCount = 0;
+      rSamples.m_Values.clear();
+
+      if( i_Time < SampleTime( 0, 0 ) )
+      {
+        o_rOutput.Result = VSubjectPose::EEarly;
+        return o_rOutput.Result;
+      }
+
+      if( i_Time - rNewest.ReceiptTime > m_MaxPredictionTime )
+      {
+        o_rOutput.Result = VSubjectPose::ELate;
+        return o_rOutput.Result;
+      }
+
+      rSamples.SubsampleCount = i_Count;
+      rSamples.m_Values.resize( i_Count * ChannelCount );
+
+      // Output times only increase, so a single pass over the input brackets them all
+      size_t Frame = 0;
+      unsigned int Subsample = 0;
+      const double * pPrevious = nullptr;
+      double PreviousTime = 0.0;
+
+      for( unsigned int OutputIndex = 0; OutputIndex < i_Count; ++OutputIndex )
+      {
+        const double Time = i_Time - i_Period + ( OutputIndex + 1 ) * i_Period / i_Count;
+        double * pOutput = rSamples.m_Values.data() + OutputIndex * ChannelCount;
+
+        // Move on to the first input subsample at or after the output time
+        double NextTime = 0.0;
+        while( Frame < rFrames.size() && ( NextTime = SampleTime( Frame, Subsample ) ) < Time )
+        {
+          pPrevious = rFrames[ Frame ]->Subsample( Subsample );
+          PreviousTime = NextTime;
+          if( ++Subsample == rFrames[ Frame ]->SubsampleCount )
+          {
+            Subsample = 0;
+            ++Frame;
+          }
+        }
+
+        if( Frame == rFrames.size() )
+        {
+          // Beyond the newest subsample it is held; extrapolating analog signals would only amplify their noise
+          std::copy( pPrevious, pPrevious + ChannelCount, pOutput );
+        }
+        else if( !pPrevious )
+        {
+          const double * pNext = rFrames[ Frame ]->Subsample( Subsample );
+          std::copy( pNext, pNext + ChannelCount, pOutput );
+        }
+        else
+        {
+          InterpolateChannels( pPrevious, rFrames[ Frame ]->Subsample( Subsample ), ( Time - PreviousTime ) / ( NextTime - PreviousTime ), ChannelCount, pOutput );
+        }
+      }
+
+      o_rOutput.Result = VSubjectPose::ESuccess;
+      return o_rOutput.Result;
+    }
+
+    VSubjectPose::EResult VRetimingCore::UpdateFrameAtTime( double i_rTime )
+    {
+      // Only one update at a time may use the output pools; adding data carries on alongside
+      boost::mutex::scoped_lock UpdateLock( m_UpdateMutex );
+      TReadLock Lock( m_DataMutex );
+
+      const size_t SlotCount = m_Slots.size();
+      const size_t WorkerCount = m_pPredictionPool ? m_pPredictionPool->ThreadCount() : 0;
+      const size_t TaskCount = std::min( WorkerCount + 1, ( SlotCount + s_MinSubjectsPerTask - 1 ) / s_MinSubjectsPerTask );
+
+      bool bSuccess = false;
+      if( TaskCount <= 1 )
+      {
+        bSuccess = UpdateSlots( 0, SlotCount, i_rTime );
+      }
+      else
+      {
+        // Slots are independent, so split them into contiguous ranges. This thread takes the first range rather
+        // than waiting idle, and collects the rest once it is done.
+        std::atomic< bool > bAnySuccess( false );
+        size_t Pending = TaskCount - 1;
+        boost::mutex PendingMutex;
+        boost::condition_variable PendingDone;
+
+        for( size_t Task = 1; Task < TaskCount; ++Task )
+        {
+          const size_t Begin = ( SlotCount * Task ) / TaskCount;
+          const size_t End = ( SlotCount * ( Task + 1 ) ) / TaskCount;
+          m_pPredictionPool->Post( [ this, Begin, End, i_rTime, &bAnySuccess, &Pending, &PendingMutex, &PendingDone ]()
+          {
+            if( UpdateSlots( Begin, End, i_rTime ) )
+            {
+              bAnySuccess = true;
+            }
+
+            boost::mutex::scoped_lock PendingLock( PendingMutex );
+            if( --Pending == 0 )
+            {
+              PendingDone.notify_one();
+            }
+          } );
+        }
+
+        bSuccess = UpdateSlots( 0, SlotCount / TaskCount, i_rTime );
+
+        boost::mutex::scoped_lock PendingLock( PendingMutex );
+        while( Pending != 0 )
+        {
+          PendingDone.wait( PendingLock );
+        }
+
+        bSuccess = bSuccess || bAnySuccess;
+      }
+
+      m_OutputSubjectCount = static_cast< unsigned int >( SlotCount );
+
+      std::shared_ptr< const VMarkerInput > pMarkerInput = std::atomic_load( &m_pMarkerInput );
+      if( pMarkerInput )
+      {
+        std::shared_ptr< VRetimedMarkers > pMarkers = m_MarkerOutputPool.Acquire( s_OutputPoolSize );
+        if( PredictMarkers( *pMarkerInput, i_rTime, *pMarkers ) == VSubjectPose::ESuccess )
+        {
+          bSuccess = true;
+        }
+
+        std::atomic_store( &m_pLatestMarkers, std::shared_ptr< const VRetimedMarkers >( pMarkers ) );
+      }
+
+      // Device samples are resampled over the interval since the previous update. The first update, or one after a
+      // long gap, covers a single input frame instead.
+      double OutputPeriod = 0.0;
+      if( m_bHasLastUpdateTime && i_rTime > m_LastUpdateTime && i_rTime - m_LastUpdateTime <= s_PurgeLimit )
+      {
+        OutputPeriod = i_rTime - m_LastUpdateTime;
+      }
+      m_LastUpdateTime = i_rTime;
+      m_bHasLastUpdateTime = true;
+
+      for( const auto & rpSlot : m_DeviceSlots )
+      {
+        std::shared_ptr< const VDeviceInput > pInput = std::atomic_load( &rpSlot->m_pInput );
+
+        std::shared_ptr< const VRetimedDevice > pLatest;
+        if( pInput && !pInput->m_Frames.empty() )
+        {
+          // Keep the rate at which the device was sampled
+          const VDeviceFrame & rNewest = *pInput->m_Frames.back();
+          const double InputPeriod = 1000.0 / rNewest.FrameRate;
+          const double Period = OutputPeriod > 0.0 ? OutputPeriod : InputPeriod;
+          const unsigned int Count = std::max( 1u, static_cast< unsigned int >( std::lround( Period * rNewest.SubsampleCount / InputPeriod ) ) );
+
+          std::shared_ptr< VRetimedDevice > pDevice = rpSlot->m_OutputPool.Acquire( s_OutputPoolSize );
+          if( ResampleDevice( *pInput, i_rTime, Period, Count, *pDevice ) == VSubjectPose::ESuccess )
+          {
+            bSuccess = true;
+          }
+
+          pLatest = pDevice;
+        }
+
+        std::atomic_store( &rpSlot->m_pLatestOutput, pLatest );
+      }
+
+      m_OutputDeviceCount = static_cast< unsigned int >( m_DeviceSlots.size() );
+
+      // Return success if prediction was successful for any of the subjects, markers or devices.
+      // The individual poses will contain the result for that specific subject
+      return bSuccess ? VSubjectPose::ESuccess : VSubjectPose::ENoData;
+    }
+
+    bool VRetimingCore::UpdateSlots( size_t i_Begin, size_t i_End, double i_Time )
+    {
+      bool bSuccess = false;
+
+      for( size_t SlotIndex = i_Begin; SlotIndex < i_End; ++SlotIndex )
+      {
+        VSubjectSlot & rSlot = *m_Slots[ SlotIndex ];
+        std::shared_ptr< const VSubjectInput > pInput = std::atomic_load( &rSlot.m_pInput );
+
+        std::shared_ptr< const VSubjectPose > pLatest;
+        if( pInput && pInput->m_Samples.Size() >= 2 )
+        {
+          std::shared_ptr< VSubjectPose > pPose = rSlot.AcquireOutputPose();
+          pPose->Result = VSubjectPose::EInvalid;
+          Predict( *pInput, i_Time, *pPose );
+
+          if( pPose->Result == VSubjectPose::ESuccess )
+          {
+            bSuccess = true;
+          }
+
+          pLatest = pPose;
+        }
+
+        std::atomic_store( &rSlot.m_pLatestOutput, pLatest );
+      }
+
+      return bSuccess;
+    }
+
+    VSubjectPose::EResult VRetimingCore::SampleAt( double i_Time, std::shared_ptr< const VRetimedFrame > & o_rpFrame ) const
+    {
+      std::shared_ptr< VRetimedFrame > pFrame = std::make_shared< VRetimedFrame >();
+      pFrame->Time = i_Time;
+
+      {
+        TReadLock Lock( m_DataMutex );
+
+        for( const auto & rpSlot : m_Slots )
+        {
+          std::shared_ptr< const VSubjectPose > & rpSubject = pFrame->m_Subjects[ rpSlot->m_Name ];
+
+          std::shared_ptr< const VSubjectInput > pInput = std::atomic_load( &rpSlot->m_pInput );
+          if( pInput && pInput->m_Samples.Size() >= 2 )
+          {
+            // Each frame owns its poses, so nothing shared is written and readers may sample concurrently
+            std::shared_ptr< VSubjectPose > pPose = std::make_shared< VSubjectPose >();
+            Predict( *pInput, i_Time, *pPose );
 
-      for( const auto& rpData : i_pData )
-      {
+            if( pPose->Result == VSubjectPose::ESuccess )
+            {
+              pFrame->Result = pPose->Result;
+            }
 
-        if( rpData )
-        {
-          // Print all input data to the output log, even if it's occluded and we're not going to add it to
-          // the retimer.
-          OutputLog( rpData );
+            rpSubject = pPose;
+          }
         }
 
-        // DSSDK-210. Don't add occluded data, as we will be able to interpolate from good data
-        // as long as gaps are not too long. If an object becomes occluded for a significant time,
-        // Predict will return ELate when the data becomes too stale.
-        bool bOccluded = false;
-        // For multi-segment subjects, don't add if any segments are occluded.
-        for( const auto& rSegment : rpData->m_Segments )
+        std::shared_ptr< const VMarkerInput > pMarkerInput = std::atomic_load( &m_pMarkerInput );
+        if( pMarkerInput )
         {
-          if( rSegment.second->bOccluded )
+          std::shared_ptr< VRetimedMarkers > pMarkers = std::make_shared< VRetimedMarkers >();
+          if( PredictMarkers( *pMarkerInput, i_Time, *pMarkers ) == VSubjectPose::ESuccess )
           {
-            bOccluded = true;
-            break;
+            pFrame->Result = VSubjectPose::ESuccess;
           }
+
+          pFrame->m_pMarkers = pMarkers;
         }
 
-        if( !bOccluded )
+        for( const auto & rpSlot : m_DeviceSlots )
         {
-          auto& rData = m_Data[ rpData->Name ];
-          rData.push_back( rpData );
+          std::shared_ptr< const VRetimedDevice > & rpDevice = pFrame->m_Devices[ rpSlot->m_Name ];
 
-          while( rData.size() > s_BufSize )
+          std::shared_ptr< const VDeviceInput > pInput = std::atomic_load( &rpSlot->m_pInput );
+          if( pInput && !pInput->m_Frames.empty() )
           {
-            rData.pop_front();
+            std::shared_ptr< VRetimedDevice > pDevice = std::make_shared< VRetimedDevice >();
+            if( ResampleDevice( *pInput, i_Time, 0.0, 1, *pDevice ) == VSubjectPose::ESuccess )
+            {
+              pFrame->Result = VSubjectPose::ESuccess;
+            }
+
+            rpDevice = pDevice;
           }
         }
       }
+
+      o_rpFrame = pFrame;
+      return pFrame->Result;
     }
 
-    std::shared_ptr< const VSubjectPose > VRetimingCore::Predict( std::shared_ptr< const VSubjectPose > p1, std::shared_ptr< const VSubjectPose > p2, double t ) const
+    VSubjectPose::EResult VRetimedFrame::GetSubject( const std::string & i_rSubjectName, std::shared_ptr< const VSubjectPose > & o_rpSubject ) const
     {
-      std::shared_ptr< VSubjectPose > pOutput( new VSubjectPose() );
-
-      if( !p1 || !p2 )
+      auto SubjectIt = m_Subjects.find( i_rSubjectName );
+      if( SubjectIt == m_Subjects.end() )
       {
-        return pOutput;
+        return VSubjectPose::EUnknownSubject;
       }
 
-      // Calculate the input frame number that corresponds to this requested time
-      double Sample1Index = p1->ReceiptTime;
-      double Sample2Index = p2->ReceiptTime;
-      double PredictionIndex = t;
-      double MaximumPredictionValue = m_MaxPredictionTime;
+      o_rpSubject = SubjectIt->second;
+      return o_rpSubject ? o_rpSubject->Result : VSubjectPose::ENoData;
+    }
 
-      if( Sample2Index < Sample1Index )
+    VSubjectPose::EResult VRetimedFrame::GetDevice( const std::string & i_rDeviceName, std::shared_ptr< const VRetimedDevice > & o_rpDevice ) const
+    {
+      auto DeviceIt = m_Devices.find( i_rDeviceName );
+      if( DeviceIt == m_Devices.end() )
       {
-        pOutput->Result = VSubjectPose::EInvalid;
-        DebugLog( str( boost::format( "Invalid Receipt Time, %s, %d, %d, %d" ) % p1->Name % PredictionIndex % Sample1Index % Sample2Index ) );
-        return pOutput;
+        return VSubjectPose::EUnknownSubject;
       }
 
-      if( PredictionIndex < Sample1Index )
+      o_rpDevice = DeviceIt->second;
+      return o_rpDevice ? o_rpDevice->Result : VSubjectPose::ENoData;
+    }
+
+    VSubjectPose::EResult VRetimingCore::GetSubjectCount( unsigned int& o_rSubjectCount ) const
+    {
+      TReadLock Lock( m_DataMutex );
+
+      o_rSubjectCount = 0;
+
+      if( m_Slots.size() != 0 )
       {
-        pOutput->Result = VSubjectPose::EEarly;
-        const std::string Msg = str(boost::format("Early data requested, %d, %d, %d, %d") % p1->Name % PredictionIndex % Sample1Index % Sample2Index);
-        DebugLog( Msg );
-        return pOutput;
+        o_rSubjectCount = m_OutputSubjectCount;
+        return VSubjectPose::ESuccess;
       }
-
-      if( PredictionIndex > Sample2Index )
+      else
       {
-        if( PredictionIndex - Sample2Index > MaximumPredictionValue )
-        {
-          pOutput->Result = VSubjectPose::ELate;
-          DebugLog( str( boost::format( "Late data requested, %s, %d, %d, %d, %d" ) % p1->Name % PredictionIndex % Sample1Index % Sample2Index % MaximumPredictionValue ) );
-          return pOutput;
-        }
+        return VSubjectPose::ENoData;
       }
+    }
 
-      DebugLog(str(boost::format("Prediction to time from samples, %d, %d, %d") % PredictionIndex % ( PredictionIndex - Sample1Index ) % ( PredictionIndex - Sample2Index ) ));
-
-      pOutput->FrameTime = t;
-      pOutput->ReceiptTime = t;
-      pOutput->Result = VSubjectPose::ESuccess;
+    VSubjectPose::EResult VRetimingCore::GetSubjectName( const unsigned int i_SubjectIndex, std::string& o_rSubjectName ) const
+    {
+      TReadLock Lock( m_DataMutex );
 
-      // Copy over input data
-      pOutput->RootSegment = p1->RootSegment;
-      pOutput->Name = p1->Name;
-      for( const auto Latency : p1->Latencies )
+      if( i_SubjectIndex >= m_OutputSubjectCount )
       {
-        pOutput->Latencies.insert( Latency );
+        return VSubjectPose::EUnknownSubject;
       }
-      pOutput->FrameRate = p1->FrameRate;
 
+      o_rSubjectName = m_Slots[ i_SubjectIndex ]->m_Name;
+      return VSubjectPose::ESuccess;
+    }
 
-      double PredictedFrameNumber = ClientUtils::PredictVal( p1->FrameNumber, p1->ReceiptTime, p2->FrameNumber, p2->ReceiptTime, t );
-      pOutput->FrameNumber = PredictedFrameNumber;
+    VSubjectPose::EResult VRetimingCore::GetSubjectIndex( const std::string & i_rSubjectName, unsigned int & o_rSubjectIndex ) const
+    {
+      TReadLock Lock( m_DataMutex );
 
-      for( const auto SegIt : p1->m_Segments )
+      auto SlotIt = m_SlotIndex.find( i_rSubjectName );
+      if( SlotIt == m_SlotIndex.end() || SlotIt->second >= m_OutputSubjectCount )
       {
-        // Get corresponding segment from p2->
-        for( const auto SegIt2 : p2->m_Segments )
-        {
-          std::shared_ptr< VSegmentPose > pSegment = SegIt.second;
-          std::shared_ptr< VSegmentPose > pSegment2 = SegIt2.second;
-
-          if( pSegment2->Name == pSegment->Name )
-          {
-
-            std::shared_ptr< VSegmentPose > pOutputSegment( new VSegmentPose() );
-            pOutputSegment->Name = pSegment->Name;
-            pOutputSegment->Parent = pSegment->Parent;
-            std::copy( pSegment->T_Stat.begin(), pSegment->T_Stat.end(), pOutputSegment->T_Stat.begin() );
-            std::copy( pSegment->R_Stat.begin(), pSegment->R_Stat.end(), pOutputSegment->R_Stat.begin() );
-
-            pOutputSegment->m_Children.reserve( pSegment->m_Children.size() );
-            std::copy( pSegment->m_Children.begin(), pSegment->m_Children.end(), std::back_inserter( pOutputSegment->m_Children ) );
+        return VSubjectPose::EUnknownSubject;
+      }
 
-            pOutputSegment->bOccluded = pSegment->bOccluded || pSegment2->bOccluded;
+      o_rSubjectIndex = SlotIt->second;
+      return VSubjectPose::ESuccess;
+    }
 
-            pOutputSegment->T = ClientUtils::PredictDisplacement( pSegment->T, Sample1Index, pSegment2->T, Sample2Index, PredictionIndex );
-            pOutputSegment->R = ClientUtils::PredictRotation( pSegment->R, Sample1Index, pSegment2->R, Sample2Index, PredictionIndex );
-            pOutputSegment->T_Rel = ClientUtils::PredictDisplacement( pSegment->T_Rel, Sample1Index, pSegment2->T_Rel, Sample2Index, PredictionIndex );
-            pOutputSegment->R_Rel = ClientUtils::PredictRotation( pSegment->R_Rel, Sample1Index, pSegment2->R_Rel, Sample2Index, PredictionIndex );
+    VSubjectPose::EResult VRetimingCore::GetSubject( const std::string& i_rSubjectName, std::shared_ptr< const VSubjectPose >& o_rpSubject ) const
+    {
+      unsigned int SubjectIndex = 0;
+      VSubjectPose::EResult OutputResult = GetSubjectIndex( i_rSubjectName, SubjectIndex );
+      if( OutputResult == VSubjectPose::ESuccess )
+      {
+        OutputResult = GetSubject( SubjectIndex, o_rpSubject );
+      }
 
-            pOutput->m_Segments[ pSegment->Name ] = pOutputSegment;
+      return OutputResult;
+    }
 
-            break;
-          }
-        }
-      }
+    VSubjectPose::EResult VRetimingCore::GetSubject( unsigned int i_SubjectIndex, std::shared_ptr< const VSubjectPose > & o_rpSubject ) const
+    {
+      TReadLock Lock( m_DataMutex );
 
-      if( pOutput->Result != VSubjectPose::ESuccess )
+      if( i_SubjectIndex >= m_OutputSubjectCount )
       {
-        DebugLog( str( boost::format( "Failed to update frame for, %s, %d, %d, %d, %s" ) % p1->Name % PredictionIndex % Sample1Index % Sample2Index % VSubjectPose::ResultString( pOutput->Result ) ) );
+        return VSubjectPose::EUnknownSubject;
       }
-      return pOutput;
+
+      o_rpSubject = std::atomic_load( &m_Slots[ i_SubjectIndex ]->m_pLatestOutput );
+      return o_rpSubject ? o_rpSubject->Result : VSubjectPose::ENoData;
     }
 
-    VSubjectPose::EResult VRetimingCore::UpdateFrameAtTime( double i_rTime )
+    VSubjectPose::EResult VRetimingCore::GetSubjectStatic( const std::string& i_rSubjectName, std::shared_ptr< const VSubjectPose >& o_rpSubject ) const
     {
-      boost::recursive_mutex::scoped_lock Lock( m_DataMutex );
-
-      m_LatestOutputPoses.clear();
+      TReadLock Lock( m_DataMutex );
 
-      VSubjectPose::EResult Result = VSubjectPose::ENoData;
+      VSubjectPose::EResult OutputResult = VSubjectPose::EUnknownSubject;
 
-      for( const auto& Pair : m_Data )
+      auto SlotIt = m_SlotIndex.find( i_rSubjectName );
+      if( SlotIt != m_SlotIndex.end() )
       {
-        std::shared_ptr< const VSubjectPose > pPose;
-        const auto& rData = Pair.second;
-        if( rData.size() >= 2 )
+        std::shared_ptr< const VSubjectInput > pInput = std::atomic_load( &m_Slots[ SlotIt->second ]->m_pInput );
+        if( pInput && !pInput->m_Samples.Empty() )
         {
-          pPose = Predict( rData.front(), rData.back(), i_rTime );
-
-          // Return success if prediction was successful for any of the subjects.
-          // The individual poses will contain the result for that specific subject
-          if( pPose->Result == VSubjectPose::ESuccess )
-          {
-            Result = pPose->Result;
-          }
+          // Use the most recent input data.
+          o_rpSubject = pInput->m_Samples.Back();
         }
 
-        m_LatestOutputPoses[ Pair.first ] = pPose;
+        if( o_rpSubject )
+        {
+          OutputResult = o_rpSubject->Result;
+        }
+        else
+        {
+          OutputResult = VSubjectPose::ENoData;
+        }
       }
 
-      return Result;
+      return OutputResult;
     }
 
-    VSubjectPose::EResult VRetimingCore::GetSubjectCount( unsigned int& o_rSubjectCount ) const
+    VSubjectPose::EResult VRetimingCore::GetMarkers( std::shared_ptr< const VRetimedMarkers > & o_rpMarkers ) const
     {
-      boost::recursive_mutex::scoped_lock Lock( m_DataMutex );
+      o_rpMarkers = std::atomic_load( &m_pLatestMarkers );
+      return o_rpMarkers ? o_rpMarkers->Result : VSubjectPose::ENoData;
+    }
 
-      o_rSubjectCount = 0;
+    VSubjectPose::EResult VRetimingCore::GetDeviceCount( unsigned int & o_rDeviceCount ) const
+    {
+      TReadLock Lock( m_DataMutex );
 
-      if( m_Data.size() != 0 )
-      {
-        o_rSubjectCount = static_cast< unsigned int >( m_LatestOutputPoses.size() );
-        return VSubjectPose::ESuccess;
-      }
-      else
+      o_rDeviceCount = 0;
+
+      if( m_DeviceSlots.empty() )
       {
         return VSubjectPose::ENoData;
       }
+
+      o_rDeviceCount = m_OutputDeviceCount;
+      return VSubjectPose::ESuccess;
     }
 
-    VSubjectPose::EResult VRetimingCore::GetSubjectName( const unsigned int i_SubjectIndex, std::string& o_rSubjectName ) const
+    VSubjectPose::EResult VRetimingCore::GetDeviceName( const unsigned int i_DeviceIndex, std::string & o_rDeviceName ) const
     {
-      boost::recursive_mutex::scoped_lock Lock( m_DataMutex );
+      TReadLock Lock( m_DataMutex );
 
-      if( i_SubjectIndex >= m_LatestOutputPoses.size() )
+      if( i_DeviceIndex >= m_OutputDeviceCount )
       {
         return VSubjectPose::EUnknownSubject;
       }
 
-      auto rPair = m_LatestOutputPoses.begin();
-      std::advance( rPair, i_SubjectIndex );
-      o_rSubjectName = rPair->first;
+      o_rDeviceName = m_DeviceSlots[ i_DeviceIndex ]->m_Name;
       return VSubjectPose::ESuccess;
     }
 
-    VSubjectPose::EResult VRetimingCore::GetSubject( const std::string& i_rSubjectName, std::shared_ptr< const VSubjectPose >& o_rpSubject ) const
+    VSubjectPose::EResult VRetimingCore::GetDevice( const std::string & i_rDeviceName, std::shared_ptr< const VRetimedDevice > & o_rpDevice ) const
     {
-      boost::recursive_mutex::scoped_lock Lock( m_DataMutex );
+      TReadLock Lock( m_DataMutex );
 
-      VSubjectPose::EResult OutputResult = VSubjectPose::EUnknownSubject;
-
-      auto DataIt = m_LatestOutputPoses.find( i_rSubjectName );
-      if( DataIt != m_LatestOutputPoses.end() )
+      auto SlotIt = m_DeviceSlotIndex.find( i_rDeviceName );
+      if( SlotIt == m_DeviceSlotIndex.end() || SlotIt->second >= m_OutputDeviceCount )
       {
-        o_rpSubject = DataIt->second;
+        return VSubjectPose::EUnknownSubject;
+      }
 
-        if( o_rpSubject )
-        {
-          OutputResult = o_rpSubject->Result;
-        }
-        else
-        {
-          OutputResult = VSubjectPose::ENoData;
-        }
+      o_rpDevice = std::atomic_load( &m_DeviceSlots[ SlotIt->second ]->m_pLatestOutput );
+      return o_rpDevice ? o_rpDevice->Result : VSubjectPose::ENoData;
+    }
+
+    void VMarkerSet::Clear()
+    {
+      m_TrajectoryIDs.clear();
+      m_Translations.clear();
+    }
+
+    void VMarkerSet::Add( unsigned int i_TrajectoryID, const std::array< double, 3 > & i_rTranslation )
+    {
+      m_TrajectoryIDs.push_back( i_TrajectoryID );
+      m_Translations.push_back( i_rTranslation );
+    }
+
+    void VMarkerSet::Sort()
+    {
+      if( std::is_sorted( m_TrajectoryIDs.begin(), m_TrajectoryIDs.end() ) )
+      {
+        return;
       }
 
-      return OutputResult;
+      std::vector< size_t > Order( m_TrajectoryIDs.size() );
+      std::iota( Order.begin(), Order.end(), 0 );
+      std::sort( Order.begin(), Order.end(), [ this ]( size_t i_Left, size_t i_Right )
+      {
+        return m_TrajectoryIDs[ i_Left ] < m_TrajectoryIDs[ i_Right ];
+      } );
+
+      VMarkerSet Sorted;
+      Sorted.m_TrajectoryIDs.reserve( Order.size() );
+      Sorted.m_Translations.reserve( Order.size() );
+      for( size_t Index : Order )
+      {
+        Sorted.Add( m_TrajectoryIDs[ Index ], m_Translations[ Index ] );
+      }
+      *this = std::move( Sorted );
     }
 
-    VSubjectPose::EResult VRetimingCore::GetSubjectStatic( const std::string& i_rSubjectName, std::shared_ptr< const VSubjectPose >& o_rpSubject ) const
+    bool VMarkerSet::Find( unsigned int i_TrajectoryID, std::array< double, 3 > & o_rTranslation ) const
     {
-      boost::recursive_mutex::scoped_lock Lock( m_DataMutex );
+      auto It = std::lower_bound( m_TrajectoryIDs.begin(), m_TrajectoryIDs.end(), i_TrajectoryID );
+      if( It == m_TrajectoryIDs.end() || *It != i_TrajectoryID )
+      {
+        return false;
+      }
 
-      VSubjectPose::EResult OutputResult = VSubjectPose::EUnknownSubject;
+      o_rTranslation = m_Translations[ It - m_TrajectoryIDs.begin() ];
+      return true;
+    }
 
-      auto DataIt = m_Data.find( i_rSubjectName );
-      if( DataIt != m_Data.end() )
+    bool VDeviceChannels::ChannelIndex( const std::string & i_rOutputName, const std::string & i_rComponentName, unsigned int & o_rIndex ) const
+    {
+      for( unsigned int Channel = 0; Channel < ChannelCount(); ++Channel )
       {
-        if( !DataIt->second.empty() )
+        if( m_ComponentNames[ Channel ] == i_rComponentName && m_OutputNames[ Channel ] == i_rOutputName )
         {
-          // Use the most recent input data.
-          o_rpSubject = DataIt->second.back();
+          o_rIndex = Channel;
+          return true;
         }
+      }
 
-        if( o_rpSubject )
-        {
-          OutputResult = o_rpSubject->Result;
-        }
-        else
-        {
-          OutputResult = VSubjectPose::ENoData;
-        }
+      return false;
+    }
+
+    bool VDeviceChannels::operator==( const VDeviceChannels & i_rOther ) const
+    {
+      return Name == i_rOther.Name
+          && Type == i_rOther.Type
+          && m_OutputNames == i_rOther.m_OutputNames
+          && m_ComponentNames == i_rOther.m_ComponentNames
+          && m_Units == i_rOther.m_Units;
+    }
+
+    unsigned int VSubjectTopology::AddSegment( const std::string & i_rName, const std::string & i_rParent, const std::vector< std::string > & i_rChildren )
+    {
+      const unsigned int Index = SegmentCount();
+      m_SegmentNames.push_back( i_rName );
+      m_Parents.push_back( i_rParent );
+      m_Children.push_back( i_rChildren );
+      m_SegmentIndex[ i_rName ] = Index;
+      return Index;
+    }
+
+    bool VSubjectTopology::SegmentIndex( const std::string & i_rName, unsigned int & o_rIndex ) const
+    {
+      auto It = m_SegmentIndex.find( i_rName );
+      if( It == m_SegmentIndex.end() )
+      {
+        return false;
       }
 
-      return OutputResult;
+      o_rIndex = It->second;
+      return true;
+    }
+
+    bool VSubjectTopology::operator==( const VSubjectTopology & i_rOther ) const
+    {
+      return Name == i_rOther.Name
+          && RootSegment == i_rOther.RootSegment
+          && m_SegmentNames == i_rOther.m_SegmentNames
+          && m_Parents == i_rOther.m_Parents
+          && m_Children == i_rOther.m_Children;
+    }
+
+    static const std::string s_EmptyString;
+
+    const std::string & VSubjectPose::Name() const
+    {
+      return m_pTopology ? m_pTopology->Name : s_EmptyString;
+    }
+
+    const std::string & VSubjectPose::RootSegment() const
+    {
+      return m_pTopology ? m_pTopology->RootSegment : s_EmptyString;
     }
 
-    bool VSubjectPose::operator==( const VSubjectPose& i_rOther )
+    const VSegmentPose * VSubjectPose::Segment( const std::string & i_rSegmentName ) const
+    {
+      unsigned int Index = 0;
+      if( m_pTopology && m_pTopology->SegmentIndex( i_rSegmentName, Index ) && Index < m_Segments.size() )
+      {
+        return &m_Segments[ Index ];
+      }
+      return nullptr;
+    }
+
+    bool VSubjectPose::operator==( const VSubjectPose& i_rOther ) const
     {
       bool bMatches = true;
 
       bMatches = ( i_rOther.Result == Result );
-      bMatches = bMatches && ( i_rOther.Name == Name );
-      bMatches = bMatches && ( i_rOther.RootSegment == RootSegment );
+      if( m_pTopology != i_rOther.m_pTopology )
+      {
+        bMatches = bMatches && m_pTopology && i_rOther.m_pTopology && ( *i_rOther.m_pTopology == *m_pTopology );
+      }
 
-      bMatches = bMatches && ( i_rOther.Latencies == Latencies );
+      const TLatencies NoLatencies;
+      bMatches = bMatches && ( ( i_rOther.m_pLatencies ? *i_rOther.m_pLatencies : NoLatencies ) == ( m_pLatencies ? *m_pLatencies : NoLatencies ) );
       bMatches = bMatches && ( i_rOther.FrameTime == FrameTime );
       bMatches = bMatches && ( i_rOther.FrameNumber == FrameNumber );
       bMatches = bMatches && ( i_rOther.ReceiptTime == ReceiptTime );
       bMatches = bMatches && ( i_rOther.FrameRate == FrameRate );
 
-      if( i_rOther.m_Segments.size() == m_Segments.size() )
-      {
-        auto SegmentIt = m_Segments.begin();
-        auto OtherIt = i_rOther.m_Segments.begin();
-        for (; SegmentIt != m_Segments.end() && OtherIt != i_rOther.m_Segments.end(); ++SegmentIt, ++OtherIt)
-        {
-          bMatches = bMatches && ( SegmentIt->first == OtherIt->first );
-          bMatches = bMatches && ( *SegmentIt->second == *OtherIt->second );
-        }
-      }
-      else
-      {
-        bMatches = false;
-      }
+      bMatches = bMatches && ( i_rOther.m_Segments == m_Segments );
 
       return bMatches;
     }
@@ -391,9 +1242,12 @@ namespace ViconDataStreamSDK
     std::string VSubjectPose::OutputHeader( const std::shared_ptr< VSubjectPose >& i_rPose )
     {
       std::string HeaderString = "FrameNumber, Result, Frame Rate, ReceiptTime, #Latencies, ";
-      for( const auto Latency : i_rPose->Latencies )
+      if( i_rPose && i_rPose->m_pLatencies )
       {
-        HeaderString += Latency.first + ", ";
+        for( const auto & rLatency : *i_rPose->m_pLatencies )
+        {
+          HeaderString += rLatency.first + ", ";
+        }
       }
       HeaderString += "Name, RootSegment, #Segments, "
                       "Segment Name, Segment Parent, Segment Occluded, T[0], T[1], T[2], R[0], R[1], R[2], R[3], "
@@ -409,31 +1263,56 @@ namespace ViconDataStreamSDK
                 << i_Pose.Result << ", "
                 << i_Pose.FrameRate << ", "
                 << i_Pose.ReceiptTime << ", "
-                << i_Pose.Latencies.size() << ", ";
+                << ( i_Pose.m_pLatencies ? i_Pose.m_pLatencies->size() : 0 ) << ", ";
 
-      for( const auto LatencySample : i_Pose.Latencies )
+      if( i_Pose.m_pLatencies )
       {
-        o_rStream << LatencySample.second << ", ";
+        for( const auto & rLatencySample : *i_Pose.m_pLatencies )
+        {
+          o_rStream << rLatencySample.second << ", ";
+        }
       }
 
-      o_rStream << i_Pose.Name << ", "
-                << i_Pose.RootSegment << ", "
+      o_rStream << i_Pose.Name() << ", "
+                << i_Pose.RootSegment() << ", "
                 << i_Pose.m_Segments.size();
 
-      for( const auto rSegment : i_Pose.m_Segments )
+      for( size_t SegmentIndex = 0; SegmentIndex < i_Pose.m_Segments.size(); ++SegmentIndex )
       {
-        o_rStream << *rSegment.second;
+        const VSegmentPose & rSegment = i_Pose.m_Segments[ SegmentIndex ];
+        const bool bHasTopology = i_Pose.m_pTopology && SegmentIndex < i_Pose.m_pTopology->SegmentCount();
+
+        o_rStream << ", " << ( bHasTopology ? i_Pose.m_pTopology->m_SegmentNames[ SegmentIndex ] : s_EmptyString )
+                  << ", " << ( bHasTopology ? i_Pose.m_pTopology->m_Parents[ SegmentIndex ] : s_EmptyString )
+                  << ", " << rSegment.bOccluded << ", "
+                  << rSegment.T[ 0 ] << ", " << rSegment.T[ 1 ] << ", " << rSegment.T[ 2 ] << ", "
+                  << rSegment.R[ 0 ] << ", " << rSegment.R[ 1 ] << ", " << rSegment.R[ 2 ] << ", " << rSegment.R[ 3 ] << ", "
+                  << rSegment.T_Rel[ 0 ] << ", " << rSegment.T_Rel[ 1 ] << ", " << rSegment.T_Rel[ 2 ] << ", "
+                  << rSegment.R_Rel[ 0 ] << ", " << rSegment.R_Rel[ 1 ] << ", " << rSegment.R_Rel[ 2 ] << ", " << rSegment.R_Rel[ 3 ] << ", "
+                  << rSegment.T_Stat[ 0 ] << ", " << rSegment.T_Stat[ 1 ] << ", " << rSegment.T_Stat[ 2 ] << ", "
+                  << rSegment.R_Stat[ 0 ] << ", " << rSegment.R_Stat[ 1 ] << ", " << rSegment.R_Stat[ 2 ] << ", " << rSegment.R_Stat[ 3 ] << ", ";
+
+        if( bHasTopology )
+        {
+          const auto & rChildren = i_Pose.m_pTopology->m_Children[ SegmentIndex ];
+          o_rStream << rChildren.size();
+          for( const auto& rChild : rChildren )
+          {
+            o_rStream << ", " << rChild;
+          }
+        }
+        else
+        {
+          o_rStream << 0;
+        }
       }
       return o_rStream;
     }
 
-    bool VSegmentPose::operator==( const VSegmentPose& i_rOther )
+    bool VSegmentPose::operator==( const VSegmentPose& i_rOther ) const
     {
       bool bMatches = true;
 
-      bMatches = bMatches && ( i_rOther.Name == Name );
-      bMatches = bMatches && ( i_rOther.Parent == Parent );
-
       bMatches = bMatches && ( i_rOther.T == T );
       bMatches = bMatches && ( i_rOther.R == R );
 
@@ -443,34 +1322,22 @@ namespace ViconDataStreamSDK
       bMatches = bMatches && ( i_rOther.T_Stat == T_Stat );
       bMatches = bMatches && ( i_rOther.R_Stat == R_Stat );
 
-      bMatches = bMatches && ( i_rOther.m_Children == m_Children );
-
       bMatches = bMatches && ( i_rOther.bOccluded == bOccluded );
 
       return bMatches;
     }
 
-    std::ostream& operator<<( std::ostream& o_rStream, const VSegmentPose& i_Pose )
-    {
-      o_rStream << ", " << i_Pose.Name << ", " << i_Pose.Parent << ", " << i_Pose.bOccluded << ", "
-                << i_Pose.T[ 0 ] << ", " << i_Pose.T[ 1 ] << ", " << i_Pose.T[ 2 ] << ", "
-                << i_Pose.R[ 0 ] << ", " << i_Pose.R[ 1 ] << ", " << i_Pose.R[ 2 ] << ", " << i_Pose.R[ 3 ] << ", "
-                << i_Pose.T_Rel[ 0 ] << ", " << i_Pose.T_Rel[ 1 ] << ", " << i_Pose.T_Rel[ 2 ] << ", "
-                << i_Pose.R_Rel[ 0 ] << ", " << i_Pose.R_Rel[ 1 ] << ", " << i_Pose.R_Rel[ 2 ] << ", " << i_Pose.R_Rel[ 3 ] << ", "
-                << i_Pose.T_Stat[ 0 ] << ", " << i_Pose.T_Stat[ 1 ] << ", " << i_Pose.T_Stat[ 2 ] << ", "
-                << i_Pose.R_Stat[ 0 ] << ", " << i_Pose.R_Stat[ 1 ] << ", " << i_Pose.R_Stat[ 2 ] << ", " << i_Pose.R_Stat[ 3 ] << ", "
-                << i_Pose.m_Children.size();
-      for( const auto& rChild : i_Pose.m_Children )
-      {
-        o_rStream << ", " << rChild;
-      }
-      return o_rStream;
-    }
-
     void VRetimingCore::OutputLogFunction( const std::shared_ptr< VSubjectPose > i_pSubjectPose ) const
     {
       boost::mutex::scoped_lock LogLock( m_OutputLogMutex );
-      if( m_OutputLog.good() )
+      if( m_pBinaryOutputLog )
+      {
+        if( i_pSubjectPose )
+        {
+          m_pBinaryOutputLog->Write( *i_pSubjectPose );
+        }
+      }
+      else if( m_OutputLog.good() )
       {
         if( !m_bOutputLogHeaderWritten )
         {
@@ -487,34 +1354,39 @@ namespace ViconDataStreamSDK
 
     void VRetimingCore::OutputLog( const std::shared_ptr< VSubjectPose > i_pSubjectPose ) const
     {
-      if( m_pPostalService )
-      {
-        m_pPostalService->Post( std::bind( &VRetimingCore::OutputLogFunction, this, i_pSubjectPose ) );
-      }
-
+      m_OutputLogService.Post( i_pSubjectPose );
     }
 
-    bool VRetimingCore::CreateOutputLog( const std::string& i_rFilename )
+    bool VRetimingCore::CreateOutputLog( const std::string& i_rFilename, OutputLogFormat::Enum i_Format )
     {
       boost::mutex::scoped_lock LogLock( m_OutputLogMutex );
 
       bool bSuccess = false;
       m_bOutputLogHeaderWritten = false;
 
-      if( !m_OutputLog.is_open() )
+      if( !m_OutputLog.is_open() && !m_pBinaryOutputLog )
       {
-        m_OutputLog.open( i_rFilename );
-        bSuccess = m_OutputLog.good();
+        if( i_Format == OutputLogFormat::Text )
+        {
+          m_OutputLog.open( i_rFilename );
+          bSuccess = m_OutputLog.good();
+        }
+        else
+        {
+          std::unique_ptr< VSubjectPoseLogWriter > pWriter( new VSubjectPoseLogWriter() );
+          bSuccess = pWriter->Open( i_rFilename, i_Format == OutputLogFormat::CompressedBinary );
+          if( bSuccess )
+          {
+            m_pBinaryOutputLog = std::move( pWriter );
+          }
+        }
       }
 
       if( bSuccess )
       {
-        if( !m_pPostalService )
-        {
-          m_pPostalService = std::make_shared< VCGStreamPostalService >();
-        }
-
-        bSuccess = m_pPostalService->StartService();
+        // The output log is for offline analysis, so a full box holds the retimer back rather than leaving gaps
+        bSuccess = m_OutputLogService.StartService( [this]( std::shared_ptr< VSubjectPose > & i_rpPose ){ OutputLogFunction( i_rpPose ); },
+                                                    VCGStreamPostalService< std::shared_ptr< VSubjectPose > >::TPostBox::EWait );
       }
 
       return bSuccess;
@@ -522,91 +1394,20 @@ namespace ViconDataStreamSDK
 
     void VRetimingCore::CloseOutputLog()
     {
+      // Let the poses already posted reach the log, and stop the service thread before it can outlive us
+      m_OutputLogService.StopService();
+
       boost::mutex::scoped_lock LogLock( m_OutputLogMutex );
 
       if( m_OutputLog.is_open() )
       {
         m_OutputLog.close();
       }
-    }
-
-    void VRetimingCore::DebugLogFunction( const std::string & i_rLogMessage ) const
-    {
-      boost::mutex::scoped_lock LogLock( m_DebugLogMutex );
-      if( m_DebugLog.good() )
-      {
-        m_DebugLog << i_rLogMessage << std::endl;
-      }
-    }
-
-    void VRetimingCore::DebugLog( const std::string & i_rLogMessage ) const
-    {
-      if( m_pPostalService )
-      {
-        m_pPostalService->Post( std::bind( &VRetimingCore::DebugLogFunction, this, i_rLogMessage ) );
-      }
-    }
-
-    bool VRetimingCore::CreateDebugLog( const std::string& i_rFilename )
-    {
-      boost::mutex::scoped_lock LogLock( m_DebugLogMutex );
-
-      bool bSuccess = false;
-
-      if( !m_DebugLog.is_open() )
-      {
-        m_DebugLog.open( i_rFilename );
-        bSuccess = m_DebugLog.good();
-      }
-
-      if( bSuccess )
-      {
-        if( !m_pPostalService )
-        {
-          m_pPostalService = std::make_shared< VCGStreamPostalService >();
-        }
-
-        bSuccess = m_pPostalService->StartService();
-      }
-
-      return bSuccess;
-    }
-
-    void VRetimingCore::CloseDebugLog()
-    {
-      boost::mutex::scoped_lock LogLock( m_DebugLogMutex );
-
-      if( m_DebugLog.is_open() )
-      {
-        m_DebugLog.close();
-      }
-    }
-
-    void VRetimingCore::PurgeOldData( double i_TimeNow )
-    {
-      boost::recursive_mutex::scoped_lock Lock( m_DataMutex );
-      std::vector< std::string > Subjects;
-      for( const auto& rSubject : m_Data )
-      {
-        Subjects.emplace_back(rSubject.first);
-      }
 
-      for( auto& rSubject : Subjects )
+      if( m_pBinaryOutputLog )
       {
-        auto& rPoses = m_Data[ rSubject ];
-        auto PoseIt = rPoses.begin();
-        while(  PoseIt != rPoses.end() )
-        {
-          auto pPose = *PoseIt;
-          if( !pPose || pPose->ReceiptTime > i_TimeNow || ( i_TimeNow - pPose->ReceiptTime ) > s_PurgeLimit )
-          {
-            PoseIt = rPoses.erase(PoseIt);
-          }
-          else
-          {
-            ++PoseIt;
-          }
-        }
+        m_pBinaryOutputLog->Close();
+        m_pBinaryOutputLog.reset();
       }
     }
   } // namespace Core
@@ -27,8 +27,10 @@
 #include <boost/thread.hpp>
 #include <boost/thread/condition.hpp>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <map>
@@ -40,7 +42,11 @@
 
 #include <ViconDataStreamSDKCoreUtils/Constants.h>
 
-class VCGStreamPostalService;
+#include "RetimerDebugLog.h"
+#include "RetimerItemPool.h"
+#include "RetimerPredictor.h"
+
+class VCGStreamDecodePool;
 
 namespace ViconCGStreamClientSDK
 {
@@ -52,7 +58,38 @@ namespace ViconDataStreamSDK
 
   namespace Core
   {
+    class VSubjectPoseLogWriter;
+
+    // Subject metadata which does not change from frame to frame. A single instance is shared by every pose
+    // of a subject, and the per-frame segment data in VSubjectPose is indexed by the segment slot held here.
+    class VSubjectTopology
+    {
+    public:
+
+      std::string Name;
+      std::string RootSegment;
+
+      // Store the segment names in an ordered container, to allow us to present the segment indexing in a consistent way to the non-retimed client
+      std::vector< std::string > m_SegmentNames;
+      std::vector< std::string > m_Parents;
+      std::vector< std::vector< std::string > > m_Children;
 
+      // Add a segment; returns the slot it occupies
+      unsigned int AddSegment( const std::string & i_rName, const std::string & i_rParent, const std::vector< std::string > & i_rChildren );
+
+      unsigned int SegmentCount() const
+      {
+        return static_cast< unsigned int >( m_SegmentNames.size() );
+      }
+
+      bool SegmentIndex( const std::string & i_rName, unsigned int & o_rIndex ) const;
+
+      bool operator==( const VSubjectTopology & i_rOther ) const;
+
+    private:
+
+      std::map< std::string, unsigned int > m_SegmentIndex;
+    };
 
     class VSegmentPose
     {
@@ -61,12 +98,10 @@ namespace ViconDataStreamSDK
       static const unsigned int NumElements = 25;
 
       VSegmentPose() 
-        : Scale({ 1.0, 1.0, 1.0 } )
+        : bHasScale( false )
+        , Scale({ 1.0, 1.0, 1.0 } )
         , bOccluded(false) {}
 
-      std::string Name;
-      std::string Parent;
-
       std::array< double, 3 > T;
       std::array< double, 4 > R;
 
@@ -79,13 +114,9 @@ namespace ViconDataStreamSDK
       bool bHasScale;
       std::array< double, 3 > Scale;
 
-      std::vector< std::string > m_Children;
-
       bool   bOccluded;
 
-      bool operator==(const VSegmentPose & i_rOther);
-
-      friend std::ostream & operator<<(std::ostream & o_rStream, const VSegmentPose & i_Pose);
+      bool operator==(const VSegmentPose & i_rOther) const;
     };
 
     class VSubjectPose
@@ -140,19 +171,27 @@ namespace ViconDataStreamSDK
 
       EResult Result;
 
-      std::string Name;
-      std::string RootSegment;
+      // Shared topology; segment data below is indexed by slot in this
+      std::shared_ptr< const VSubjectTopology > m_pTopology;
+
+      const std::string & Name() const;
+      const std::string & RootSegment() const;
+
+      // Latencies are the same for every subject in a frame, so all poses from that frame share a single map
+      typedef std::map< std::string, double > TLatencies;
+      std::shared_ptr< const TLatencies > m_pLatencies;
 
-      std::map< std::string, double > Latencies;
       double TotalLatency() const
       {
         double Total = 0;
-        for( const auto & rLatency : Latencies )
+        if( m_pLatencies )
         {
-          Total += rLatency.second;
+          for( const auto & rLatency : *m_pLatencies )
+          {
+            Total += rLatency.second;
+          }
         }
         return Total;
-        //return std::accumulate(Latencies.begin(), Latencies.end(), 0, [] ( double value, const std::map< std::string, double >::value_type & p ) { return value + p.second; } );
       }
 
       double       FrameTime;
@@ -160,17 +199,182 @@ namespace ViconDataStreamSDK
       double       ReceiptTime;
       double       FrameRate;
 
-      bool operator==(const VSubjectPose & i_rOther);
+      bool operator==(const VSubjectPose & i_rOther) const;
 
       friend std::ostream & operator<<(std::ostream & o_rStream, const VSubjectPose & i_Pose);
 
-      // Segment data
-      std::map< std::string, std::shared_ptr< VSegmentPose > > m_Segments;
+      // Segment data, indexed by topology slot
+      std::vector< VSegmentPose > m_Segments;
 
-      // Store the segment names in an ordered container, to allow us to present the segment indexing in a consistent way to the non-retimed client
-      std::vector< std::string > m_SegmentNames;
+      // Look up a segment by name; returns null if the segment is not present
+      const VSegmentPose * Segment( const std::string & i_rSegmentName ) const;
+    };
+
+    // Reconstructed markers keyed by trajectory ID. The IDs are held in ascending order with the translations in
+    // the same order, so that two sets can be matched marker for marker in a single pass.
+    class VMarkerSet
+    {
+    public:
+
+      std::vector< unsigned int > m_TrajectoryIDs;
+      std::vector< std::array< double, 3 > > m_Translations;
+
+      unsigned int Size() const
+      {
+        return static_cast< unsigned int >( m_TrajectoryIDs.size() );
+      }
+
+      void Clear();
+
+      // Add a marker in any order; call Sort once all have been added
+      void Add( unsigned int i_TrajectoryID, const std::array< double, 3 > & i_rTranslation );
+      void Sort();
+
+      bool Find( unsigned int i_TrajectoryID, std::array< double, 3 > & o_rTranslation ) const;
+    };
+
+    // The labeled and unlabeled markers of one frame
+    class VMarkerFrame
+    {
+    public:
+
+      VMarkerFrame()
+        : FrameNumber( 0 )
+        , ReceiptTime( 0 )
+        , FrameRate( 0 )
+      {}
+
+      double FrameNumber;
+      double ReceiptTime;
+      double FrameRate;
+
+      VMarkerSet m_Labeled;
+      VMarkerSet m_Unlabeled;
+    };
+
+    // Device metadata which does not change from frame to frame. Each channel is one component of a device output;
+    // a single instance is shared by every frame of the device.
+    class VDeviceChannels
+    {
+    public:
+
+      VDeviceChannels()
+        : Type( DeviceType::Unknown )
+      {}
+
+      std::string Name;
+      DeviceType::Enum Type;
+
+      // Indexed by channel
+      std::vector< std::string > m_OutputNames;
+      std::vector< std::string > m_ComponentNames;
+      std::vector< Unit::Enum > m_Units;
+
+      unsigned int ChannelCount() const
+      {
+        return static_cast< unsigned int >( m_ComponentNames.size() );
+      }
+
+      bool ChannelIndex( const std::string & i_rOutputName, const std::string & i_rComponentName, unsigned int & o_rIndex ) const;
+
+      bool operator==( const VDeviceChannels & i_rOther ) const;
+    };
+
+    // The subsamples of one device over one frame. Values are held subsample-major, so that every channel of a
+    // subsample is contiguous and the channels can be interpolated together.
+    class VDeviceFrame
+    {
+    public:
+
+      VDeviceFrame()
+        : FrameNumber( 0 )
+        , ReceiptTime( 0 )
+        , FrameRate( 0 )
+        , SubsampleCount( 0 )
+      {}
+
+      std::shared_ptr< const VDeviceChannels > m_pChannels;
+
+      double FrameNumber;
+      double ReceiptTime;
+      double FrameRate;
+
+      unsigned int SubsampleCount;
+      std::vector< double > m_Values;
+
+      // Indexed by channel
+      std::vector< bool > m_Occluded;
+
+      const double * Subsample( unsigned int i_Subsample ) const
+      {
+        return m_Values.data() + static_cast< size_t >( i_Subsample ) * m_pChannels->ChannelCount();
+      }
+    };
+
+    // Markers interpolated or predicted to one time. Markers seen only in the newest frame are held at their last position.
+    class VRetimedMarkers
+    {
+    public:
+
+      VRetimedMarkers()
+        : Result( VSubjectPose::ENoData )
+        , Time( 0 )
+      {}
+
+      VSubjectPose::EResult Result;
+      double Time;
+
+      VMarkerSet m_Labeled;
+      VMarkerSet m_Unlabeled;
+    };
+
+    // Device channels resampled onto the output timeline. The subsamples are evenly spaced over the output period
+    // ending at Time, the last falling on Time itself.
+    class VRetimedDevice
+    {
+    public:
+
+      VRetimedDevice()
+        : Result( VSubjectPose::ENoData )
+        , Time( 0 )
+      {}
+
+      VSubjectPose::EResult Result;
+      double Time;
+
+      // FrameRate is the output rate, so the sample rate is FrameRate * SubsampleCount as for input frames
+      VDeviceFrame m_Samples;
     };
     
+    // Predicted poses of every subject at one time. A frame is never modified once it has been returned, so may
+    // be read from any thread.
+    class VRetimedFrame
+    {
+    public:
+
+      VRetimedFrame()
+      : Result( VSubjectPose::ENoData )
+      , Time( 0 )
+      {}
+
+      // Success if any subject, marker set or device was predicted successfully
+      VSubjectPose::EResult Result;
+      double Time;
+
+      // Subjects by name; the pose is null for a subject without enough data to predict from
+      std::map< std::string, std::shared_ptr< const VSubjectPose > > m_Subjects;
+
+      // Null if no markers have been received
+      std::shared_ptr< const VRetimedMarkers > m_pMarkers;
+
+      // Devices by name, each holding a single subsample at Time
+      std::map< std::string, std::shared_ptr< const VRetimedDevice > > m_Devices;
+
+      VSubjectPose::EResult GetSubject( const std::string & i_rSubjectName, std::shared_ptr< const VSubjectPose > & o_rpSubject ) const;
+
+      VSubjectPose::EResult GetDevice( const std::string & i_rDeviceName, std::shared_ptr< const VRetimedDevice > & o_rpDevice ) const;
+    };
+
     class VRetimingCore
     {
     public:
@@ -184,61 +388,214 @@ namespace ViconDataStreamSDK
       // Return the maximum prediction used by the system
       double MaximumPrediction() const;
 
+      // Set the number of input samples kept per subject for prediction. At least two are always kept.
+      void SetHistoryDepth( unsigned int i_Depth );
+
+      unsigned int HistoryDepth() const;
+
+      // Select the model used to predict poses from the sample history
+      void SetPredictionModel( PredictionModel::Enum i_Model );
+
+      PredictionModel::Enum GetPredictionModel() const;
+
+      // Set the number of worker threads which UpdateFrameAtTime shares subjects with. Zero, the default, predicts
+      // every subject on the calling thread.
+      void SetPredictionThreadCount( unsigned int i_ThreadCount );
+
+      unsigned int PredictionThreadCount() const;
+
       // Set a log file to write debug output about performance to
       bool SetDebugLogFile(const std::string & i_rLogFile);
 
-      // Write our data to an output file, to allow for offline running
-      bool SetOutputFile(const std::string & i_rLogFile);
+      // Write our data to an output file, to allow for offline running.
+      // The binary formats are much smaller and faster to load; VSegmentPoseReader reads all of them.
+      bool SetOutputFile(const std::string & i_rLogFile, OutputLogFormat::Enum i_Format = OutputLogFormat::Text );
 
       void AddData( std::vector< std::shared_ptr< VSubjectPose > > i_pData );
 
-      // Store a predicted pose for all subjects at the specified time
+      // Markers and device samples are retimed alongside the subjects by UpdateFrameAtTime and SampleAt
+      void AddMarkers( const std::shared_ptr< const VMarkerFrame > & i_pFrame );
+
+      void AddDevices( std::vector< std::shared_ptr< VDeviceFrame > > i_Frames );
+
+      // Store a predicted pose for all subjects, markers and devices at the specified time. Device samples are resampled
+      // over the interval since the previous call, at the rate at which they were received.
       VSubjectPose::EResult UpdateFrameAtTime(double i_Time);
 
+      // Predict all subjects at the specified time without changing the stored frame. Any number of threads may
+      // sample at once, each at its own times.
+      VSubjectPose::EResult SampleAt( double i_Time, std::shared_ptr< const VRetimedFrame > & o_rpFrame ) const;
+
       VSubjectPose::EResult GetSubjectCount(unsigned int & o_rSubjectCount) const;
 
       VSubjectPose::EResult GetSubjectName(const unsigned int i_SubjectIndex, std::string& o_rSubjectName) const;
 
       VSubjectPose::EResult GetSubject(const std::string & i_rSubjectName, std::shared_ptr< const VSubjectPose > & o_rpSubject) const;
 
+      // Subjects keep the index they are first given for the life of the retimer, so a caller may resolve a name once
+      // and then fetch by index, as GetSubjectName does
+      VSubjectPose::EResult GetSubjectIndex( const std::string & i_rSubjectName, unsigned int & o_rSubjectIndex ) const;
+
+      VSubjectPose::EResult GetSubject( unsigned int i_SubjectIndex, std::shared_ptr< const VSubjectPose > & o_rpSubject ) const;
+
       VSubjectPose::EResult GetSubjectStatic(const std::string & i_rSubjectName, std::shared_ptr< const VSubjectPose > & o_rpSubject) const;
 
+      VSubjectPose::EResult GetMarkers( std::shared_ptr< const VRetimedMarkers > & o_rpMarkers ) const;
+
+      // Devices keep their index for the life of the retimer, in the same way as subjects
+      VSubjectPose::EResult GetDeviceCount( unsigned int & o_rDeviceCount ) const;
+
+      VSubjectPose::EResult GetDeviceName( const unsigned int i_DeviceIndex, std::string & o_rDeviceName ) const;
+
+      VSubjectPose::EResult GetDevice( const std::string & i_rDeviceName, std::shared_ptr< const VRetimedDevice > & o_rpDevice ) const;
+
     public:
 
-      // This needs to be public, or make the unit test a friend
+      // These need to be public, or make the unit test a friend. They predict from a pair of samples at constant velocity,
+      // whatever model is selected.
       std::shared_ptr< const VSubjectPose > Predict(std::shared_ptr< const VSubjectPose > p1, std::shared_ptr< const VSubjectPose > p2, double t) const;
 
+      // Predict into an existing pose. p1 and p2 must share a topology; o_rOutput's segment storage is reused.
+      VSubjectPose::EResult Predict( const VSubjectPose & i_rP1, const VSubjectPose & i_rP2, double i_Time, VSubjectPose & o_rOutput ) const;
+
     private:
 
-      void PurgeOldData( double i_TimeNow );
+      class VSubjectInput;
+      class VSubjectSlot;
+      class VMarkerInput;
+      class VDeviceInput;
+      class VDeviceSlot;
+
+      // Check that a prediction at i_Time can be made from samples spanning i_rOldest to i_rNewest, and if so fill
+      // everything in o_rOutput except the predicted segment poses
+      VSubjectPose::EResult PreparePrediction( const VSubjectPose & i_rOldest, const VSubjectPose & i_rNewest, double i_Time, VSubjectPose & o_rOutput ) const;
+
+      VSubjectPose::EResult Predict( const VSubjectInput & i_rInput, double i_Time, VSubjectPose & o_rOutput ) const;
+
+      void AddSample( VSubjectSlot & io_rSlot, const std::shared_ptr< VSubjectPose > & i_rpData );
+
+      // Update the latest output of slots [i_Begin, i_End); returns true if any prediction succeeded
+      bool UpdateSlots( size_t i_Begin, size_t i_End, double i_Time );
+
+      VSubjectPose::EResult PredictMarkers( const VMarkerInput & i_rInput, double i_Time, VRetimedMarkers & o_rOutput ) const;
+
+      void AddDeviceFrame( VDeviceSlot & io_rSlot, const std::shared_ptr< VDeviceFrame > & i_rpFrame );
+
+      // Resample a device at i_Count times evenly spaced over the i_Period milliseconds ending at i_Time
+      VSubjectPose::EResult ResampleDevice( const VDeviceInput & i_rInput, double i_Time, double i_Period, unsigned int i_Count, VRetimedDevice & o_rOutput ) const;
 
-      mutable boost::recursive_mutex m_DataMutex;
-      std::map< std::string, std::deque< std::shared_ptr< const VSubjectPose > > > m_Data;
-      std::map< std::string, std::shared_ptr< const VSubjectPose > > m_LatestOutputPoses;
+      // The input state of a subject. A published state is never modified: AddData builds the next one in a recycled
+      // instance and swaps the pointer, so readers predict from a consistent history without waiting for the writer.
+      class VSubjectInput
+      {
+      public:
+        VPoseHistory m_Samples;
+        std::unique_ptr< VPosePredictor > m_pPredictor;
+        std::shared_ptr< const VSubjectTopology > m_pTopology;
+
+        void CopyFrom( const VSubjectInput & i_rOther );
+      };
+
+      class VSubjectSlot
+      {
+      public:
+        std::string m_Name;
+
+        // Accessed only through std::atomic_load and std::atomic_store
+        std::shared_ptr< const VSubjectInput > m_pInput;
+        std::shared_ptr< const VSubjectPose > m_pLatestOutput;
+
+        // Serialises writers of m_pInput
+        boost::mutex m_InputMutex;
+
+        // States and output poses are recycled once nothing else holds a reference to them
+        VRetimerItemPool< VSubjectInput > m_InputPool;
+        std::shared_ptr< VSubjectInput > AcquireInput();
+
+        VRetimerItemPool< VSubjectPose > m_OutputPool;
+        std::shared_ptr< VSubjectPose > AcquireOutputPose();
+      };
+
+      // The slot table and settings only change when a subject is first seen or a setting is changed, which take the
+      // lock exclusively. Adding data, updating and reading all share it, so input and output do not wait on each other.
+      typedef boost::shared_lock< boost::shared_mutex > TReadLock;
+      typedef boost::unique_lock< boost::shared_mutex > TWriteLock;
+      mutable boost::shared_mutex m_DataMutex;
+      std::vector< std::unique_ptr< VSubjectSlot > > m_Slots;
+      std::map< std::string, unsigned int > m_SlotIndex;
+
+      // Serialises UpdateFrameAtTime, which owns the output pools and the prediction workers
+      mutable boost::mutex m_UpdateMutex;
+      std::unique_ptr< VCGStreamDecodePool > m_pPredictionPool;
+
+      // Number of slots covered by the latest UpdateFrameAtTime
+      std::atomic< unsigned int > m_OutputSubjectCount;
+
+      // The newest two marker frames
+      class VMarkerInput
+      {
+      public:
+        std::shared_ptr< const VMarkerFrame > m_pPrevious;
+        std::shared_ptr< const VMarkerFrame > m_pLatest;
+      };
+
+      // Accessed only through std::atomic_load and std::atomic_store; m_MarkerInputMutex serialises writers
+      std::shared_ptr< const VMarkerInput > m_pMarkerInput;
+      std::shared_ptr< const VRetimedMarkers > m_pLatestMarkers;
+      boost::mutex m_MarkerInputMutex;
+      VRetimerItemPool< VRetimedMarkers > m_MarkerOutputPool;
+
+      // Device frames received within the purge limit, oldest first. Frames are consecutive unless some were dropped,
+      // so subsample times follow from frame numbers rather than from the jitter in receipt times.
+      class VDeviceInput
+      {
+      public:
+        std::deque< std::shared_ptr< const VDeviceFrame > > m_Frames;
+      };
+
+      // Devices are published in the same way as subjects
+      class VDeviceSlot
+      {
+      public:
+        std::string m_Name;
+
+        std::shared_ptr< const VDeviceInput > m_pInput;
+        std::shared_ptr< const VRetimedDevice > m_pLatestOutput;
+
+        boost::mutex m_InputMutex;
+
+        VRetimerItemPool< VDeviceInput > m_InputPool;
+        VRetimerItemPool< VRetimedDevice > m_OutputPool;
+      };
+
+      std::vector< std::unique_ptr< VDeviceSlot > > m_DeviceSlots;
+      std::map< std::string, unsigned int > m_DeviceSlotIndex;
+      std::atomic< unsigned int > m_OutputDeviceCount;
+
+      // Time of the previous UpdateFrameAtTime, from which device output periods are measured; guarded by m_UpdateMutex
+      double m_LastUpdateTime;
+      bool m_bHasLastUpdateTime;
 
 
       // Maximum time we should predict forwards (in milliseconds)
       double m_MaxPredictionTime;
 
-      // Postal service for logging
-      std::shared_ptr< VCGStreamPostalService > m_pPostalService;
+      unsigned int m_HistoryDepth;
+      PredictionModel::Enum m_PredictionModel;
 
-      // Output logs
+      // Output logs; poses are handed to the writer thread through a preallocated post box
       void OutputLogFunction( const std::shared_ptr< VSubjectPose > i_pSubjectPose ) const;
+      mutable VCGStreamPostalService< std::shared_ptr< VSubjectPose > > m_OutputLogService;
       void OutputLog( const std::shared_ptr< VSubjectPose > i_pPose ) const;
-      bool CreateOutputLog( const std::string& i_rFilename );
+      bool CreateOutputLog( const std::string& i_rFilename, OutputLogFormat::Enum i_Format );
       void CloseOutputLog();
       mutable boost::mutex m_OutputLogMutex;
       mutable std::ofstream m_OutputLog;
+      std::unique_ptr< VSubjectPoseLogWriter > m_pBinaryOutputLog;
       mutable bool m_bOutputLogHeaderWritten;
 
-
-      void DebugLogFunction( const std::string & i_rLogMessage ) const;
-      void DebugLog( const std::string & i_rLogMessage ) const;
-      bool CreateDebugLog( const std::string& i_rFilename );
-      void CloseDebugLog();
-      mutable boost::mutex m_DebugLogMutex;
-      mutable std::ofstream m_DebugLog;
+      // Debug log; records are only built when it is open
+      mutable VRetimerDebugLog m_DebugLog;
     };
 
 
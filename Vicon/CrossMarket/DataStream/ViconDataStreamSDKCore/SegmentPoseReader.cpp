@@ -23,6 +23,7 @@
 // SOFTWARE.
 //////////////////////////////////////////////////////////////////////////////////
 #include "SegmentPoseReader.h"
+#include "SubjectPoseLog.h"
 
 #include <ViconDataStreamSDKCoreUtils/ClientUtils.h>
 
@@ -44,6 +45,12 @@ VSegmentPoseReader::VSegmentPoseReader()
 
 bool VSegmentPoseReader::Load(const std::string & i_rFile)
 {
+  if( VSubjectPoseLogReader::IsBinaryLog( i_rFile ) )
+  {
+    VSubjectPoseLogReader LogReader;
+    return LogReader.Read( i_rFile, [this]( const std::shared_ptr< VSubjectPose > & i_rpPose ){ AddPose( i_rpPose ); } );
+  }
+
   std::ifstream FileReader;
   FileReader.open(i_rFile);
 
@@ -57,10 +64,8 @@ bool VSegmentPoseReader::Load(const std::string & i_rFile)
 
 bool VSegmentPoseReader::Read( std::istream & i_rStream )
 {
-  unsigned int CurrentFrameNumber = -1;
-  double CurrentFrameTime;
-
-  std::map< std::string, std::shared_ptr< VSubjectPose > > FrameMap;
+  // Poses of the same subject share a topology while it is unchanged
+  std::map< std::string, std::shared_ptr< const VSubjectTopology > > Topologies;
 
   std::vector< std::string > HeaderItems;
 
@@ -78,26 +83,17 @@ bool VSegmentPoseReader::Read( std::istream & i_rStream )
     std::shared_ptr< VSubjectPose > pPose = ReadLine(LineString, HeaderItems );
     if (pPose)
     {
-      if (std::find(m_Subjects.begin(), m_Subjects.end(), pPose->Name) == m_Subjects.end())
+      auto & rpTopology = Topologies[ pPose->Name() ];
+      if( rpTopology && *rpTopology == *pPose->m_pTopology )
       {
-        m_Subjects.push_back(pPose->Name);
+        pPose->m_pTopology = rpTopology;
       }
-
-      if (pPose->FrameNumber != CurrentFrameNumber)
+      else
       {
-        constexpr unsigned int NoFrameNumber(-1);
-        if (CurrentFrameNumber != NoFrameNumber)
-        {
-          m_Data[ CurrentFrameNumber ] = FrameMap;
-          m_FrameToTime[ CurrentFrameTime ] = static_cast< unsigned int >( CurrentFrameNumber );
-          FrameMap.clear();
-        }
-
-        CurrentFrameNumber = static_cast< unsigned int >( pPose->FrameNumber );
-        CurrentFrameTime = pPose->ReceiptTime;
+        rpTopology = pPose->m_pTopology;
       }
 
-      FrameMap[ pPose->Name ] = pPose;
+      AddPose( pPose );
     }
     else
     {
@@ -105,13 +101,27 @@ bool VSegmentPoseReader::Read( std::istream & i_rStream )
     }
   }
 
-  // Add the last frame
-  if (!FrameMap.empty())
+  return true;
+}
+
+void VSegmentPoseReader::AddPose( const std::shared_ptr< VSubjectPose > & i_rpPose )
+{
+  if( std::find( m_Subjects.begin(), m_Subjects.end(), i_rpPose->Name() ) == m_Subjects.end() )
   {
-    m_Data[ CurrentFrameNumber ] = FrameMap;
+    m_Subjects.push_back( i_rpPose->Name() );
   }
 
-  return true;
+  // We will only cope with sequences that start numbering from zero
+  i_rpPose->FrameTime = i_rpPose->FrameNumber / i_rpPose->FrameRate * 1000.0;
+
+  // A frame is timed by the first of its poses to arrive
+  const unsigned int FrameNumber = static_cast< unsigned int >( i_rpPose->FrameNumber );
+  auto & rFrame = m_Data[ FrameNumber ];
+  if( rFrame.empty() )
+  {
+    m_FrameToTime[ i_rpPose->ReceiptTime ] = FrameNumber;
+  }
+  rFrame[ i_rpPose->Name() ] = i_rpPose;
 }
 
 void VSegmentPoseReader::GenerateTestData(unsigned int i_NumFrames, double i_FrameRate, double i_TransmissionLatency, double i_TransmissionJitter, double i_TransmissionSpike, int i_TransmissionSpikeFrequency )
@@ -125,32 +135,37 @@ void VSegmentPoseReader::GenerateTestData(unsigned int i_NumFrames, double i_Fra
 
   m_Subjects.push_back( SubjectName );
 
+  std::shared_ptr< VSubjectTopology > pTopology = std::make_shared< VSubjectTopology >();
+  pTopology->Name = SubjectName;
+  pTopology->RootSegment = "Root";
+  pTopology->AddSegment( "Root", "", std::vector< std::string >() );
+
   for (unsigned int FrameNum = 0; FrameNum < i_NumFrames; ++FrameNum)
   {
     std::shared_ptr< VSubjectPose > pPose = std::make_shared< VSubjectPose >();
     pPose->Result = VSubjectPose::ESuccess;
     pPose->FrameNumber = FrameNum;
     pPose->FrameRate = i_FrameRate;
-    pPose->Name = SubjectName;
+    pPose->m_pTopology = pTopology;
     double FramePeriod = 1.0 / i_FrameRate * 1000;
-    pPose->Latencies[ "Network" ] = ClientUtils::JitterVal( JitterGenerator, i_TransmissionLatency, i_TransmissionJitter, i_TransmissionSpike, i_TransmissionSpikeFrequency );
-    pPose->Latencies[ "Processing" ] = ClientUtils::JitterVal(JitterGenerator, FramePeriod, FramePeriod / 10.0, 0.0, 0 );
+    std::shared_ptr< VSubjectPose::TLatencies > pLatencies = std::make_shared< VSubjectPose::TLatencies >();
+    ( *pLatencies )[ "Network" ] = ClientUtils::JitterVal( JitterGenerator, i_TransmissionLatency, i_TransmissionJitter, i_TransmissionSpike, i_TransmissionSpikeFrequency );
+    ( *pLatencies )[ "Processing" ] = ClientUtils::JitterVal(JitterGenerator, FramePeriod, FramePeriod / 10.0, 0.0, 0 );
+    pPose->m_pLatencies = pLatencies;
     pPose->FrameTime = static_cast<double>(FrameNum) / i_FrameRate * 1000.0;
     pPose->ReceiptTime = pPose->FrameTime + pPose->TotalLatency();
 
-    std::shared_ptr< VSegmentPose > pRoot = std::make_shared< VSegmentPose >();
-    pRoot->bOccluded = false;
-    pRoot->Name = "Root";
-    pRoot->Parent = "";
+    VSegmentPose Root;
+    Root.bOccluded = false;
 
-    pRoot->T[0] = 10.0 * sin( ( FrameNum % 360 ) * 3.1415 / 180.0 );
-    pRoot->T[1] = 10.0 * cos( ( FrameNum % 360 ) * 3.1415 / 180.0);
-    pRoot->T[2] = 10.0 * sin( 2 * ( FrameNum % 360 ) * 3.1415 / 180.0 );
+    Root.T[0] = 10.0 * sin( ( FrameNum % 360 ) * 3.1415 / 180.0 );
+    Root.T[1] = 10.0 * cos( ( FrameNum % 360 ) * 3.1415 / 180.0);
+    Root.T[2] = 10.0 * sin( 2 * ( FrameNum % 360 ) * 3.1415 / 180.0 );
 
-    pPose->m_Segments.insert(std::make_pair( pRoot->Name, pRoot ) );
+    pPose->m_Segments.push_back( Root );
 
     std::map < std::string, std::shared_ptr< VSubjectPose > > FrameData;
-    FrameData.insert( std::make_pair( pPose->Name, pPose ) );
+    FrameData.insert( std::make_pair( SubjectName, pPose ) );
     m_Data[ FrameNum ] = FrameData;
     m_FrameToTime[ pPose->ReceiptTime ] = FrameNum;
   }
@@ -179,7 +194,8 @@ std::shared_ptr< VSubjectPose > VSegmentPoseReader::ReadLine(const std::string &
   boost::algorithm::split(Tokens, i_rLine, boost::is_any_of(","));
 
   std::shared_ptr< VSubjectPose > pPose(new VSubjectPose());
-
+  std::shared_ptr< VSubjectTopology > pTopology = std::make_shared< VSubjectTopology >();
+  std::shared_ptr< VSubjectPose::TLatencies > pLatencies = std::make_shared< VSubjectPose::TLatencies >();
 
   bool bOK = true;
 
@@ -210,16 +226,10 @@ std::shared_ptr< VSubjectPose > VSegmentPoseReader::ReadLine(const std::string &
         LatencyType = i_rHeaderItems[TokenIndex];
       }
       bOK = bOK && ReadValue< double >( Tokens[ TokenIndex++ ], Latency );
-      if( bOK ) pPose->Latencies[LatencyType] = Latency;
-    }
-    bOK = bOK && ReadValue< std::string >(Tokens[TokenIndex++], pPose->Name);
-    bOK = bOK && ReadValue< std::string >(Tokens[TokenIndex++], pPose->RootSegment);
-
-    if (bOK)
-    {
-      // We will only cope with sequences that start numbering from zero
-      pPose->FrameTime = pPose->FrameNumber / pPose->FrameRate * 1000.0;
+      if( bOK ) ( *pLatencies )[LatencyType] = Latency;
     }
+    bOK = bOK && ReadValue< std::string >(Tokens[TokenIndex++], pTopology->Name);
+    bOK = bOK && ReadValue< std::string >(Tokens[TokenIndex++], pTopology->RootSegment);
 
     size_t NumSegments;
     if (bOK && ReadValue<size_t>(Tokens[TokenIndex++], NumSegments))
@@ -228,16 +238,19 @@ std::shared_ptr< VSubjectPose > VSegmentPoseReader::ReadLine(const std::string &
       {
         for (size_t SegmentIndex = 0; SegmentIndex < NumSegments; ++SegmentIndex)
         {
-          std::shared_ptr< VSegmentPose > pSegment(new VSegmentPose());
-          bOK = bOK && ReadValue< std::string >(Tokens[TokenIndex++], pSegment->Name);
-          bOK = bOK && ReadValue< std::string >(Tokens[TokenIndex++], pSegment->Parent);
-          bOK = bOK && ReadValue<bool>(Tokens[TokenIndex++], pSegment->bOccluded);
-          for (unsigned int i = 0; i < 3; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], pSegment->T[i]);
-          for (unsigned int i = 0; i < 4; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], pSegment->R[i]);
-          for (unsigned int i = 0; i < 3; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], pSegment->T_Rel[i]);
-          for (unsigned int i = 0; i < 4; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], pSegment->R_Rel[i]);
-          for (unsigned int i = 0; i < 3; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], pSegment->T_Stat[i]);
-          for (unsigned int i = 0; i < 4; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], pSegment->R_Stat[i]);
+          VSegmentPose Segment;
+          std::string SegmentName;
+          std::string ParentName;
+          std::vector< std::string > Children;
+          bOK = bOK && ReadValue< std::string >(Tokens[TokenIndex++], SegmentName);
+          bOK = bOK && ReadValue< std::string >(Tokens[TokenIndex++], ParentName);
+          bOK = bOK && ReadValue<bool>(Tokens[TokenIndex++], Segment.bOccluded);
+          for (unsigned int i = 0; i < 3; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], Segment.T[i]);
+          for (unsigned int i = 0; i < 4; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], Segment.R[i]);
+          for (unsigned int i = 0; i < 3; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], Segment.T_Rel[i]);
+          for (unsigned int i = 0; i < 4; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], Segment.R_Rel[i]);
+          for (unsigned int i = 0; i < 3; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], Segment.T_Stat[i]);
+          for (unsigned int i = 0; i < 4; ++i)  bOK = bOK && ReadValue<double>(Tokens[TokenIndex++], Segment.R_Stat[i]);
           size_t NumChildren;
           if (bOK && ReadValue<size_t>(Tokens[TokenIndex++], NumChildren))
           {
@@ -246,14 +259,15 @@ std::shared_ptr< VSubjectPose > VSegmentPoseReader::ReadLine(const std::string &
               std::string ChildName;
               if (bOK && ReadValue< std::string >(Tokens[TokenIndex++], ChildName))
               {
-                pSegment->m_Children.push_back(ChildName);
+                Children.push_back(ChildName);
               }
             }
           }
 
           if (bOK)
           {
-            pPose->m_Segments.insert(std::make_pair(pSegment->Name, pSegment));
+            pTopology->AddSegment( SegmentName, ParentName, Children );
+            pPose->m_Segments.push_back( Segment );
           }
         }
       }
@@ -262,6 +276,8 @@ std::shared_ptr< VSubjectPose > VSegmentPoseReader::ReadLine(const std::string &
 
   if( bOK )
   { 
+    pPose->m_pTopology = pTopology;
+    pPose->m_pLatencies = pLatencies;
     return pPose;
   }
   else
@@ -57,6 +57,7 @@ namespace ViconDataStreamSDK
     private:
 
       std::shared_ptr< VSubjectPose > ReadLine(const std::string & i_rLine, const std::vector< std::string > & i_rHeaderItems ) const;
+      void AddPose( const std::shared_ptr< VSubjectPose > & i_rpPose );
 
       std::vector< std::string > m_Subjects;
       std::map< unsigned int, std::map< std::string, std::shared_ptr< VSubjectPose > > > m_Data;
@@ -0,0 +1,614 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include "SubjectPoseLog.h"
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include <cstring>
+#include <new>
+
+namespace ViconDataStreamSDK
+{
+  namespace Core
+  {
+    namespace
+    {
+      const char s_Magic[ 4 ] = { 'V', 'S', 'P', 'L' };
+      const uint32_t s_Version = 1;
+
+      // Written natively; a reader on a machine of the other byte order will not recognise it
+      const uint32_t s_ByteOrder = 0x01020304;
+
+      const uint32_t s_FlagCompressed = 1;
+
+      // Blocks are written once they reach this size, which is large enough to compress well
+      const size_t s_BlockSize = 256 * 1024;
+
+      // Deflate cannot expand data by more than this, so a block claiming a larger raw size is damaged
+      const uint64_t s_MaxCompressionRatio = 1032;
+
+      // Subject indices are given out in order, so an index beyond this is taken to be damage rather than a
+      // reason to grow the topology table
+      const uint32_t s_MaxSubjectIndex = UINT16_MAX;
+
+      enum ERecordType : uint8_t
+      {
+        ETopology = 1,
+        ELatencyName = 2,
+        EPose = 3
+      };
+
+      enum ESegmentFlags : uint8_t
+      {
+        EOccluded = 1,
+        EHasScale = 2
+      };
+
+      struct VFileHeader
+      {
+        char     m_Magic[ 4 ];
+        uint32_t m_Version;
+        uint32_t m_ByteOrder;
+        uint32_t m_Flags;
+      };
+
+      struct VBlockHeader
+      {
+        uint32_t m_RawSize;
+        uint32_t m_StoredSize;
+      };
+
+      // Bounds checked reads from a block
+      class VCursor
+      {
+      public:
+        VCursor( const char * i_pBegin, const char * i_pEnd )
+          : m_pPosition( i_pBegin )
+          , m_pEnd( i_pEnd )
+        {
+        }
+
+        template< typename T >
+        bool Read( T & o_rValue )
+        {
+          if( static_cast< size_t >( m_pEnd - m_pPosition ) < sizeof( T ) )
+          {
+            return false;
+          }
+          std::memcpy( &o_rValue, m_pPosition, sizeof( T ) );
+          m_pPosition += sizeof( T );
+          return true;
+        }
+
+        bool Read( std::string & o_rValue )
+        {
+          uint16_t Length = 0;
+          if( !Read( Length ) || static_cast< size_t >( m_pEnd - m_pPosition ) < Length )
+          {
+            return false;
+          }
+          o_rValue.assign( m_pPosition, Length );
+          m_pPosition += Length;
+          return true;
+        }
+
+        bool Read( std::array< double, 3 > & o_rValue )
+        {
+          return Read( o_rValue[ 0 ] ) && Read( o_rValue[ 1 ] ) && Read( o_rValue[ 2 ] );
+        }
+
+        bool Read( std::array< double, 4 > & o_rValue )
+        {
+          return Read( o_rValue[ 0 ] ) && Read( o_rValue[ 1 ] ) && Read( o_rValue[ 2 ] ) && Read( o_rValue[ 3 ] );
+        }
+
+        const char * Position() const
+        {
+          return m_pPosition;
+        }
+
+        size_t Remaining() const
+        {
+          return static_cast< size_t >( m_pEnd - m_pPosition );
+        }
+
+        bool AtEnd() const
+        {
+          return m_pPosition == m_pEnd;
+        }
+
+      private:
+        const char * m_pPosition;
+        const char * m_pEnd;
+      };
+    }
+
+    VSubjectPoseLogWriter::VSubjectPoseLogWriter()
+      : m_bCompress( false )
+    {
+    }
+
+    VSubjectPoseLogWriter::~VSubjectPoseLogWriter()
+    {
+      Close();
+    }
+
+    bool VSubjectPoseLogWriter::Open( const std::string & i_rFilename, bool i_bCompress )
+    {
+      Close();
+
+      m_File.open( i_rFilename, std::ios::binary | std::ios::trunc );
+      if( !m_File.good() )
+      {
+        m_File.close();
+        return false;
+      }
+
+      m_bCompress = i_bCompress;
+
+      VFileHeader Header;
+      std::memcpy( Header.m_Magic, s_Magic, sizeof( s_Magic ) );
+      Header.m_Version = s_Version;
+      Header.m_ByteOrder = s_ByteOrder;
+      Header.m_Flags = m_bCompress ? s_FlagCompressed : 0;
+      m_File.write( reinterpret_cast< const char * >( &Header ), sizeof( Header ) );
+
+      m_Block.reserve( s_BlockSize + s_BlockSize / 4 );
+      return m_File.good();
+    }
+
+    void VSubjectPoseLogWriter::Close()
+    {
+      if( m_File.is_open() )
+      {
+        FlushBlock();
+        m_File.close();
+      }
+
+      m_SubjectIndices.clear();
+      m_Topologies.clear();
+      m_LatencyIndices.clear();
+    }
+
+    template< typename T >
+    void VSubjectPoseLogWriter::WriteValue( const T & i_rValue )
+    {
+      const char * pValue = reinterpret_cast< const char * >( &i_rValue );
+      m_Block.insert( m_Block.end(), pValue, pValue + sizeof( T ) );
+    }
+
+    void VSubjectPoseLogWriter::WriteString( const std::string & i_rString )
+    {
+      const uint16_t Length = static_cast< uint16_t >( std::min< size_t >( i_rString.size(), UINT16_MAX ) );
+      WriteValue( Length );
+      m_Block.insert( m_Block.end(), i_rString.begin(), i_rString.begin() + Length );
+    }
+
+    size_t VSubjectPoseLogWriter::BeginRecord( uint8_t i_Type )
+    {
+      const size_t Start = m_Block.size();
+      WriteValue( uint32_t( 0 ) );
+      WriteValue( i_Type );
+      return Start;
+    }
+
+    void VSubjectPoseLogWriter::EndRecord( size_t i_Start )
+    {
+      // The length excludes the length field itself
+      const uint32_t Length = static_cast< uint32_t >( m_Block.size() - i_Start - sizeof( uint32_t ) );
+      std::memcpy( &m_Block[ i_Start ], &Length, sizeof( Length ) );
+    }
+
+    uint32_t VSubjectPoseLogWriter::SubjectIndex( const VSubjectPose & i_rPose )
+    {
+      auto It = m_SubjectIndices.find( i_rPose.Name() );
+      if( It == m_SubjectIndices.end() )
+      {
+        It = m_SubjectIndices.insert( std::make_pair( i_rPose.Name(), static_cast< uint32_t >( m_Topologies.size() ) ) ).first;
+        m_Topologies.push_back( std::shared_ptr< const VSubjectTopology >() );
+      }
+
+      // Write the topology if it is new to this subject. Poses normally share their topology, so comparing
+      // pointers is enough to skip the check.
+      std::shared_ptr< const VSubjectTopology > & rpTopology = m_Topologies[ It->second ];
+      const std::shared_ptr< const VSubjectTopology > & rpPoseTopology = i_rPose.m_pTopology;
+      if( rpPoseTopology && rpTopology != rpPoseTopology && !( rpTopology && *rpTopology == *rpPoseTopology ) )
+      {
+        const size_t Start = BeginRecord( ETopology );
+        WriteValue( It->second );
+        WriteString( rpPoseTopology->Name );
+        WriteString( rpPoseTopology->RootSegment );
+        WriteValue( static_cast< uint32_t >( rpPoseTopology->SegmentCount() ) );
+        for( unsigned int Segment = 0; Segment < rpPoseTopology->SegmentCount(); ++Segment )
+        {
+          WriteString( rpPoseTopology->m_SegmentNames[ Segment ] );
+          WriteString( rpPoseTopology->m_Parents[ Segment ] );
+          const std::vector< std::string > & rChildren = rpPoseTopology->m_Children[ Segment ];
+          WriteValue( static_cast< uint32_t >( rChildren.size() ) );
+          for( const std::string & rChild : rChildren )
+          {
+            WriteString( rChild );
+          }
+        }
+        EndRecord( Start );
+      }
+
+      if( rpPoseTopology )
+      {
+        rpTopology = rpPoseTopology;
+      }
+
+      return It->second;
+    }
+
+    uint16_t VSubjectPoseLogWriter::LatencyIndex( const std::string & i_rName )
+    {
+      auto It = m_LatencyIndices.find( i_rName );
+      if( It == m_LatencyIndices.end() )
+      {
+        const uint16_t Index = static_cast< uint16_t >( m_LatencyIndices.size() );
+        It = m_LatencyIndices.insert( std::make_pair( i_rName, Index ) ).first;
+
+        const size_t Start = BeginRecord( ELatencyName );
+        WriteValue( Index );
+        WriteString( i_rName );
+        EndRecord( Start );
+      }
+      return It->second;
+    }
+
+    void VSubjectPoseLogWriter::Write( const VSubjectPose & i_rPose )
+    {
+      if( !m_File.is_open() )
+      {
+        return;
+      }
+
+      // Definitions go ahead of the pose that uses them
+      const uint32_t Subject = SubjectIndex( i_rPose );
+
+      uint8_t LatencyCount = 0;
+      uint16_t LatencyIndices[ UINT8_MAX ];
+      if( i_rPose.m_pLatencies )
+      {
+        for( const auto & rLatency : *i_rPose.m_pLatencies )
+        {
+          if( LatencyCount == UINT8_MAX )
+          {
+            break;
+          }
+          LatencyIndices[ LatencyCount++ ] = LatencyIndex( rLatency.first );
+        }
+      }
+
+      const size_t Start = BeginRecord( EPose );
+      WriteValue( Subject );
+      WriteValue( i_rPose.FrameNumber );
+      WriteValue( static_cast< uint8_t >( i_rPose.Result ) );
+      WriteValue( i_rPose.FrameRate );
+      WriteValue( i_rPose.ReceiptTime );
+
+      WriteValue( LatencyCount );
+      if( i_rPose.m_pLatencies )
+      {
+        auto LatencyIt = i_rPose.m_pLatencies->begin();
+        for( uint8_t Latency = 0; Latency < LatencyCount; ++Latency, ++LatencyIt )
+        {
+          WriteValue( LatencyIndices[ Latency ] );
+          WriteValue( LatencyIt->second );
+        }
+      }
+
+      WriteValue( static_cast< uint32_t >( i_rPose.m_Segments.size() ) );
+      for( const VSegmentPose & rSegment : i_rPose.m_Segments )
+      {
+        const uint8_t Flags = ( rSegment.bOccluded ? EOccluded : 0 ) | ( rSegment.bHasScale ? EHasScale : 0 );
+        WriteValue( Flags );
+        WriteValue( rSegment.T );
+        WriteValue( rSegment.R );
+        WriteValue( rSegment.T_Rel );
+        WriteValue( rSegment.R_Rel );
+        WriteValue( rSegment.T_Stat );
+        WriteValue( rSegment.R_Stat );
+        if( rSegment.bHasScale )
+        {
+          WriteValue( rSegment.Scale );
+        }
+      }
+      EndRecord( Start );
+
+      if( m_Block.size() >= s_BlockSize )
+      {
+        FlushBlock();
+      }
+    }
+
+    void VSubjectPoseLogWriter::FlushBlock()
+    {
+      if( m_Block.empty() )
+      {
+        return;
+      }
+
+      VBlockHeader Header;
+      Header.m_RawSize = static_cast< uint32_t >( m_Block.size() );
+      const std::vector< char > * pStored = &m_Block;
+
+      if( m_bCompress )
+      {
+        m_Compressed.clear();
+        boost::iostreams::filtering_ostream Compressor;
+        Compressor.push( boost::iostreams::zlib_compressor( boost::iostreams::zlib::best_speed ) );
+        Compressor.push( boost::iostreams::back_inserter( m_Compressed ) );
+        Compressor.write( m_Block.data(), m_Block.size() );
+        Compressor.reset();
+
+        // Store the block as it was if it did not shrink
+        if( m_Compressed.size() < m_Block.size() )
+        {
+          pStored = &m_Compressed;
+        }
+      }
+
+      Header.m_StoredSize = static_cast< uint32_t >( pStored->size() );
+      m_File.write( reinterpret_cast< const char * >( &Header ), sizeof( Header ) );
+      m_File.write( pStored->data(), pStored->size() );
+      m_Block.clear();
+    }
+
+    bool VSubjectPoseLogReader::IsBinaryLog( const std::string & i_rFilename )
+    {
+      std::ifstream File( i_rFilename, std::ios::binary );
+      VFileHeader Header;
+      return File.read( reinterpret_cast< char * >( &Header ), sizeof( Header ) )
+          && std::memcmp( Header.m_Magic, s_Magic, sizeof( s_Magic ) ) == 0;
+    }
+
+    bool VSubjectPoseLogReader::Read( const std::string & i_rFilename, const TPoseCallback & i_rCallback )
+    {
+      m_Topologies.clear();
+      m_LatencyNames.clear();
+
+      boost::iostreams::mapped_file_source File;
+      try
+      {
+        File.open( i_rFilename );
+      }
+      catch( std::exception & )
+      {
+        return false;
+      }
+
+      if( !File.is_open() || File.size() < sizeof( VFileHeader ) )
+      {
+        return false;
+      }
+
+      VCursor Cursor( File.data(), File.data() + File.size() );
+      VFileHeader Header;
+      Cursor.Read( Header );
+      if( std::memcmp( Header.m_Magic, s_Magic, sizeof( s_Magic ) ) != 0 || Header.m_Version != s_Version || Header.m_ByteOrder != s_ByteOrder )
+      {
+        return false;
+      }
+
+      const char * pEnd = File.data() + File.size();
+      while( !Cursor.AtEnd() )
+      {
+        VBlockHeader Block;
+        if( !Cursor.Read( Block ) || static_cast< size_t >( pEnd - Cursor.Position() ) < Block.m_StoredSize )
+        {
+          return false;
+        }
+
+        const char * pBlock = Cursor.Position();
+
+        bool bBlockOK = false;
+        if( Block.m_StoredSize == Block.m_RawSize )
+        {
+          // Uncompressed blocks are parsed straight from the mapping
+          bBlockOK = ReadBlock( pBlock, pBlock + Block.m_StoredSize, i_rCallback );
+        }
+        else if( Block.m_RawSize <= Block.m_StoredSize * s_MaxCompressionRatio )
+        {
+          try
+          {
+            m_Decompressed.clear();
+            m_Decompressed.reserve( Block.m_RawSize );
+            boost::iostreams::filtering_istream Decompressor;
+            Decompressor.push( boost::iostreams::zlib_decompressor() );
+            Decompressor.push( boost::iostreams::array_source( pBlock, Block.m_StoredSize ) );
+            boost::iostreams::copy( Decompressor, boost::iostreams::back_inserter( m_Decompressed ) );
+          }
+          catch( std::exception & )
+          {
+            return false;
+          }
+
+          bBlockOK = m_Decompressed.size() == Block.m_RawSize
+                  && ReadBlock( m_Decompressed.data(), m_Decompressed.data() + m_Decompressed.size(), i_rCallback );
+        }
+
+        if( !bBlockOK )
+        {
+          return false;
+        }
+
+        Cursor = VCursor( pBlock + Block.m_StoredSize, pEnd );
+      }
+
+      return true;
+    }
+
+    bool VSubjectPoseLogReader::ReadBlock( const char * i_pBegin, const char * i_pEnd, const TPoseCallback & i_rCallback )
+    {
+      // Counts read from the file are bounded by what the record could hold, but a damaged file may still ask
+      // for more memory than there is
+      try
+      {
+        return ReadRecords( i_pBegin, i_pEnd, i_rCallback );
+      }
+      catch( std::bad_alloc & )
+      {
+        return false;
+      }
+    }
+
+    bool VSubjectPoseLogReader::ReadRecords( const char * i_pBegin, const char * i_pEnd, const TPoseCallback & i_rCallback )
+    {
+      VCursor Block( i_pBegin, i_pEnd );
+      while( !Block.AtEnd() )
+      {
+        uint32_t Length = 0;
+        if( !Block.Read( Length ) || static_cast< size_t >( i_pEnd - Block.Position() ) < Length )
+        {
+          return false;
+        }
+
+        VCursor Record( Block.Position(), Block.Position() + Length );
+        Block = VCursor( Block.Position() + Length, i_pEnd );
+
+        // Unknown record types are skipped, so that later versions can add them
+        uint8_t Type = 0;
+        bool bOK = Record.Read( Type );
+
+        if( bOK && Type == ETopology )
+        {
+          uint32_t Subject = 0;
+          uint32_t SegmentCount = 0;
+          std::shared_ptr< VSubjectTopology > pTopology = std::make_shared< VSubjectTopology >();
+          bOK = Record.Read( Subject ) && Record.Read( pTopology->Name ) && Record.Read( pTopology->RootSegment ) && Record.Read( SegmentCount );
+          for( uint32_t Segment = 0; bOK && Segment < SegmentCount; ++Segment )
+          {
+            std::string Name;
+            std::string Parent;
+            uint32_t ChildCount = 0;
+            // Each child name takes at least its length field
+            bOK = Record.Read( Name ) && Record.Read( Parent ) && Record.Read( ChildCount )
+               && ChildCount <= Record.Remaining() / sizeof( uint16_t );
+
+            std::vector< std::string > Children( bOK ? ChildCount : 0 );
+            for( std::string & rChild : Children )
+            {
+              bOK = bOK && Record.Read( rChild );
+            }
+            if( bOK )
+            {
+              pTopology->AddSegment( Name, Parent, Children );
+            }
+          }
+
+          bOK = bOK && Subject <= s_MaxSubjectIndex;
+          if( bOK )
+          {
+            if( Subject >= m_Topologies.size() )
+            {
+              m_Topologies.resize( static_cast< size_t >( Subject ) + 1 );
+            }
+            m_Topologies[ Subject ] = pTopology;
+          }
+        }
+        else if( bOK && Type == ELatencyName )
+        {
+          uint16_t Index = 0;
+          std::string Name;
+          bOK = Record.Read( Index ) && Record.Read( Name );
+          if( bOK )
+          {
+            if( Index >= m_LatencyNames.size() )
+            {
+              m_LatencyNames.resize( Index + 1 );
+            }
+            m_LatencyNames[ Index ] = Name;
+          }
+        }
+        else if( bOK && Type == EPose )
+        {
+          std::shared_ptr< VSubjectPose > pPose = std::make_shared< VSubjectPose >();
+          std::shared_ptr< VSubjectPose::TLatencies > pLatencies = std::make_shared< VSubjectPose::TLatencies >();
+
+          uint32_t Subject = 0;
+          uint8_t Result = 0;
+          uint8_t LatencyCount = 0;
+          bOK = Record.Read( Subject ) && Subject < m_Topologies.size() && m_Topologies[ Subject ]
+             && Record.Read( pPose->FrameNumber ) && Record.Read( Result ) && Record.Read( pPose->FrameRate ) && Record.Read( pPose->ReceiptTime )
+             && Record.Read( LatencyCount );
+
+          for( uint8_t Latency = 0; bOK && Latency < LatencyCount; ++Latency )
+          {
+            uint16_t Index = 0;
+            double Value = 0.0;
+            bOK = Record.Read( Index ) && Index < m_LatencyNames.size() && Record.Read( Value );
+            if( bOK )
+            {
+              ( *pLatencies )[ m_LatencyNames[ Index ] ] = Value;
+            }
+          }
+
+          uint32_t SegmentCount = 0;
+          bOK = bOK && Record.Read( SegmentCount ) && SegmentCount == m_Topologies[ Subject ]->SegmentCount();
+          if( bOK )
+          {
+            pPose->m_Segments.resize( SegmentCount );
+          }
+          for( uint32_t Segment = 0; bOK && Segment < SegmentCount; ++Segment )
+          {
+            VSegmentPose & rSegment = pPose->m_Segments[ Segment ];
+            uint8_t Flags = 0;
+            bOK = Record.Read( Flags )
+               && Record.Read( rSegment.T ) && Record.Read( rSegment.R )
+               && Record.Read( rSegment.T_Rel ) && Record.Read( rSegment.R_Rel )
+               && Record.Read( rSegment.T_Stat ) && Record.Read( rSegment.R_Stat );
+            rSegment.bOccluded = ( Flags & EOccluded ) != 0;
+            rSegment.bHasScale = ( Flags & EHasScale ) != 0;
+            if( bOK && rSegment.bHasScale )
+            {
+              bOK = Record.Read( rSegment.Scale );
+            }
+          }
+
+          if( bOK )
+          {
+            pPose->Result = static_cast< VSubjectPose::EResult >( Result );
+            pPose->m_pTopology = m_Topologies[ Subject ];
+            pPose->m_pLatencies = pLatencies;
+            i_rCallback( pPose );
+          }
+        }
+
+        if( !bOK )
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  }
+}
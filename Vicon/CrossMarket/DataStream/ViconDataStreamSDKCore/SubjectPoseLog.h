@@ -0,0 +1,112 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include "RetimingCore.h"
+
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ViconDataStreamSDK
+{
+  namespace Core
+  {
+    // Binary form of the retimer output log.
+    // The file is a short header followed by blocks, each holding a run of length-prefixed records. A block may be
+    // zlib compressed. Subject topologies and latency names are written once, when first seen or changed, and poses
+    // refer to them by index, so a pose record holds little more than its segment values.
+    class VSubjectPoseLogWriter
+    {
+    public:
+
+      VSubjectPoseLogWriter();
+      ~VSubjectPoseLogWriter();
+
+      bool Open( const std::string & i_rFilename, bool i_bCompress );
+      void Close();
+
+      bool IsOpen() const
+      {
+        return m_File.is_open();
+      }
+
+      void Write( const VSubjectPose & i_rPose );
+
+    private:
+
+      template< typename T >
+      void WriteValue( const T & i_rValue );
+      void WriteString( const std::string & i_rString );
+
+      size_t BeginRecord( uint8_t i_Type );
+      void EndRecord( size_t i_Start );
+
+      uint32_t SubjectIndex( const VSubjectPose & i_rPose );
+      uint16_t LatencyIndex( const std::string & i_rName );
+
+      void FlushBlock();
+
+      std::ofstream m_File;
+      bool m_bCompress;
+
+      std::vector< char > m_Block;
+      std::vector< char > m_Compressed;
+
+      std::map< std::string, uint32_t > m_SubjectIndices;
+      std::vector< std::shared_ptr< const VSubjectTopology > > m_Topologies;
+      std::map< std::string, uint16_t > m_LatencyIndices;
+    };
+
+    // Reads a binary output log from a memory mapped file
+    class VSubjectPoseLogReader
+    {
+    public:
+
+      typedef std::function< void( const std::shared_ptr< VSubjectPose > & ) > TPoseCallback;
+
+      // True if the file starts with the binary log header
+      static bool IsBinaryLog( const std::string & i_rFilename );
+
+      // Calls i_rCallback with each pose in the order it was written.
+      // Poses of a subject share a topology until it changes. Returns false if the file is not a binary log or is
+      // damaged; poses up to the damage will have been passed on.
+      bool Read( const std::string & i_rFilename, const TPoseCallback & i_rCallback );
+
+    private:
+
+      bool ReadBlock( const char * i_pBegin, const char * i_pEnd, const TPoseCallback & i_rCallback );
+      bool ReadRecords( const char * i_pBegin, const char * i_pEnd, const TPoseCallback & i_rCallback );
+
+      std::vector< std::shared_ptr< const VSubjectTopology > > m_Topologies;
+      std::vector< std::string > m_LatencyNames;
+      std::vector< char > m_Decompressed;
+    };
+  }
+}
@@ -0,0 +1,271 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include <ViconDataStreamSDKCore/RetimingCore.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ViconDataStreamSDK::Core;
+
+namespace
+{
+  typedef std::chrono::steady_clock hrc;
+
+  // Input arrives at 100Hz; the output runs at twice that, predicting a few milliseconds past the newest frame
+  const double s_InputPeriod = 10.0;
+  const double s_OutputPeriod = 5.0;
+  const double s_PredictionOffset = 4.0;
+
+  std::vector< unsigned int > ParseList( const std::string & i_rList )
+  {
+    std::vector< unsigned int > Values;
+    std::stringstream Stream( i_rList );
+    std::string Value;
+    while( std::getline( Stream, Value, ',' ) )
+    {
+      Values.push_back( boost::lexical_cast< unsigned int >( Value ) );
+    }
+    return Values;
+  }
+
+  bool ParseModel( const std::string & i_rName, PredictionModel::Enum & o_rModel )
+  {
+    if( i_rName == "velocity" )          o_rModel = PredictionModel::ConstantVelocity;
+    else if( i_rName == "acceleration" ) o_rModel = PredictionModel::ConstantAcceleration;
+    else if( i_rName == "spline" )       o_rModel = PredictionModel::Spline;
+    else if( i_rName == "alphabeta" )    o_rModel = PredictionModel::AlphaBeta;
+    else return false;
+    return true;
+  }
+
+  std::vector< std::shared_ptr< const VSubjectTopology > > MakeTopologies( unsigned int i_SubjectCount, unsigned int i_SegmentCount )
+  {
+    std::vector< std::shared_ptr< const VSubjectTopology > > Topologies;
+    for( unsigned int Subject = 0; Subject < i_SubjectCount; ++Subject )
+    {
+      std::shared_ptr< VSubjectTopology > pTopology = std::make_shared< VSubjectTopology >();
+      pTopology->Name = "Subject" + std::to_string( Subject );
+      pTopology->RootSegment = "Segment0";
+
+      // A simple chain
+      for( unsigned int Segment = 0; Segment < i_SegmentCount; ++Segment )
+      {
+        std::vector< std::string > Children;
+        if( Segment + 1 < i_SegmentCount )
+        {
+          Children.push_back( "Segment" + std::to_string( Segment + 1 ) );
+        }
+        pTopology->AddSegment( "Segment" + std::to_string( Segment ), Segment == 0 ? "" : "Segment" + std::to_string( Segment - 1 ), Children );
+      }
+      Topologies.push_back( pTopology );
+    }
+    return Topologies;
+  }
+
+  // One input frame: every subject turns on its own circle
+  std::vector< std::shared_ptr< VSubjectPose > > MakeFrame( const std::vector< std::shared_ptr< const VSubjectTopology > > & i_rTopologies, unsigned int i_FrameNumber, double i_Time )
+  {
+    std::vector< std::shared_ptr< VSubjectPose > > Frame;
+    Frame.reserve( i_rTopologies.size() );
+
+    std::shared_ptr< VSubjectPose::TLatencies > pLatencies = std::make_shared< VSubjectPose::TLatencies >();
+    ( *pLatencies )[ "Benchmark" ] = 0.0;
+
+    for( size_t Subject = 0; Subject < i_rTopologies.size(); ++Subject )
+    {
+      std::shared_ptr< VSubjectPose > pPose = std::make_shared< VSubjectPose >();
+      pPose->Result = VSubjectPose::ESuccess;
+      pPose->m_pTopology = i_rTopologies[ Subject ];
+      pPose->m_pLatencies = pLatencies;
+      pPose->FrameNumber = i_FrameNumber;
+      pPose->FrameRate = 1000.0 / s_InputPeriod;
+      pPose->FrameTime = i_Time;
+      pPose->ReceiptTime = i_Time;
+
+      const double Angle = 0.002 * i_Time + 0.1 * Subject;
+      pPose->m_Segments.resize( i_rTopologies[ Subject ]->SegmentCount() );
+      for( size_t Segment = 0; Segment < pPose->m_Segments.size(); ++Segment )
+      {
+        VSegmentPose & rSegment = pPose->m_Segments[ Segment ];
+        rSegment.T = { { 1000.0 * std::cos( Angle ), 1000.0 * std::sin( Angle ), 100.0 * Segment } };
+        rSegment.R = { { 0.0, 0.0, std::sin( Angle / 2 ), std::cos( Angle / 2 ) } };
+        rSegment.T_Rel = { { 100.0, 0.0, 0.0 } };
+        rSegment.R_Rel = { { 0.0, 0.0, 0.0, 1.0 } };
+        rSegment.T_Stat = rSegment.T_Rel;
+        rSegment.R_Stat = rSegment.R_Rel;
+      }
+      Frame.push_back( pPose );
+    }
+    return Frame;
+  }
+
+  class VTickTimes
+  {
+  public:
+    VTickTimes() : Mean( 0 ), Median( 0 ), Maximum( 0 ) {}
+    double Mean;
+    double Median;
+    double Maximum;
+  };
+
+  VTickTimes Run( unsigned int i_SubjectCount, unsigned int i_SegmentCount, unsigned int i_ThreadCount, unsigned int i_TickCount,
+                  unsigned int i_HistoryDepth, PredictionModel::Enum i_Model )
+  {
+    VRetimingCore Retimer;
+    Retimer.SetHistoryDepth( i_HistoryDepth );
+    Retimer.SetPredictionModel( i_Model );
+    Retimer.SetPredictionThreadCount( i_ThreadCount );
+
+    const auto Topologies = MakeTopologies( i_SubjectCount, i_SegmentCount );
+
+    // Fill the history before timing anything
+    unsigned int FrameNumber = 0;
+    double InputTime = 0.0;
+    for( ; FrameNumber < i_HistoryDepth; ++FrameNumber, InputTime += s_InputPeriod )
+    {
+      Retimer.AddData( MakeFrame( Topologies, FrameNumber, InputTime ) );
+    }
+
+    std::vector< double > Durations;
+    Durations.reserve( i_TickCount );
+
+    double OutputTime = InputTime - s_InputPeriod + s_PredictionOffset;
+    for( unsigned int Tick = 0; Tick < i_TickCount; ++Tick, OutputTime += s_OutputPeriod )
+    {
+      // Input is added outside the timed region, as it happens on another thread in the client
+      while( InputTime <= OutputTime - s_PredictionOffset )
+      {
+        Retimer.AddData( MakeFrame( Topologies, FrameNumber++, InputTime ) );
+        InputTime += s_InputPeriod;
+      }
+
+      const hrc::time_point Start = hrc::now();
+      Retimer.UpdateFrameAtTime( OutputTime );
+      Durations.push_back( std::chrono::duration< double, std::micro >( hrc::now() - Start ).count() );
+    }
+
+    VTickTimes Times;
+    if( !Durations.empty() )
+    {
+      double Total = 0.0;
+      for( double Duration : Durations )
+      {
+        Total += Duration;
+      }
+      Times.Mean = Total / Durations.size();
+
+      std::sort( Durations.begin(), Durations.end() );
+      Times.Median = Durations[ Durations.size() / 2 ];
+      Times.Maximum = Durations.back();
+    }
+    return Times;
+  }
+}
+
+int main( int argc, char* argv[] )
+{
+  std::cout << "DSSDK Retimer Benchmark" << std::endl;
+
+  std::vector< unsigned int > SubjectCounts = { 1, 10, 50, 100, 200, 500 };
+  std::vector< unsigned int > ThreadCounts = { 0, 1, 2, 4 };
+  unsigned int SegmentCount = 1;
+  unsigned int TickCount = 2000;
+  unsigned int HistoryDepth = 2;
+  PredictionModel::Enum Model = PredictionModel::ConstantVelocity;
+
+  for( int a = 1; a < argc; ++a )
+  {
+    std::string arg = argv[a];
+    try
+    {
+      if( arg == "--help" )
+      {
+        std::cout << argv[0] << ": allowed options include:\n --subjects <n,n,...> --threads <n,n,...> --segments <n> --ticks <n> --history <n>"
+                     " --model <velocity|acceleration|spline|alphabeta>" << std::endl;
+        return 0;
+      }
+      else if( arg == "--subjects" && a + 1 < argc )
+      {
+        SubjectCounts = ParseList( argv[++a] );
+      }
+      else if( arg == "--threads" && a + 1 < argc )
+      {
+        ThreadCounts = ParseList( argv[++a] );
+      }
+      else if( arg == "--segments" && a + 1 < argc )
+      {
+        SegmentCount = std::max( boost::lexical_cast< unsigned int >( argv[++a] ), 1u );
+      }
+      else if( arg == "--ticks" && a + 1 < argc )
+      {
+        TickCount = boost::lexical_cast< unsigned int >( argv[++a] );
+      }
+      else if( arg == "--history" && a + 1 < argc )
+      {
+        HistoryDepth = boost::lexical_cast< unsigned int >( argv[++a] );
+      }
+      else if( arg == "--model" && a + 1 < argc )
+      {
+        if( !ParseModel( argv[++a], Model ) )
+        {
+          std::cerr << "Unknown model " << argv[a] << std::endl;
+          return 1;
+        }
+      }
+    }
+    catch( boost::bad_lexical_cast & e )
+    {
+      std::cerr << arg << ": " << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "Segments per subject: " << SegmentCount << ", history: " << HistoryDepth << ", ticks: " << TickCount << std::endl;
+  std::cout << "Times are for one UpdateFrameAtTime call, in microseconds" << std::endl << std::endl;
+  std::cout << std::setw( 10 ) << "Subjects" << std::setw( 10 ) << "Threads"
+            << std::setw( 12 ) << "Mean" << std::setw( 12 ) << "Median" << std::setw( 12 ) << "Max" << std::setw( 14 ) << "Per subject" << std::endl;
+
+  std::cout << std::fixed << std::setprecision( 2 );
+  for( unsigned int SubjectCount : SubjectCounts )
+  {
+    for( unsigned int ThreadCount : ThreadCounts )
+    {
+      const VTickTimes Times = Run( SubjectCount, SegmentCount, ThreadCount, TickCount, HistoryDepth, Model );
+      std::cout << std::setw( 10 ) << SubjectCount << std::setw( 10 ) << ThreadCount
+                << std::setw( 12 ) << Times.Mean << std::setw( 12 ) << Times.Median << std::setw( 12 ) << Times.Maximum
+                << std::setw( 14 ) << Times.Mean / std::max( SubjectCount, 1u ) << std::endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,412 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include <ViconDataStreamSDKCore/RetimingCore.h>
+#include <ViconDataStreamSDKCore/SegmentPoseReader.h>
+
+#include <boost/lexical_cast.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace ViconDataStreamSDK::Core;
+
+// Count every heap allocation made by the process, so that the replay can report how many the retimer makes
+namespace
+{
+  std::atomic< size_t > s_AllocationCount( 0 );
+  std::atomic< size_t > s_AllocatedBytes( 0 );
+
+  void* CountedAlloc( size_t i_Size )
+  {
+    ++s_AllocationCount;
+    s_AllocatedBytes += i_Size;
+    void* pMemory = std::malloc( i_Size ? i_Size : 1 );
+    if( !pMemory )
+    {
+      throw std::bad_alloc();
+    }
+    return pMemory;
+  }
+}
+
+void* operator new( size_t i_Size ) { return CountedAlloc( i_Size ); }
+void* operator new[]( size_t i_Size ) { return CountedAlloc( i_Size ); }
+void operator delete( void* i_pMemory ) noexcept { std::free( i_pMemory ); }
+void operator delete[]( void* i_pMemory ) noexcept { std::free( i_pMemory ); }
+void operator delete( void* i_pMemory, size_t ) noexcept { std::free( i_pMemory ); }
+void operator delete[]( void* i_pMemory, size_t ) noexcept { std::free( i_pMemory ); }
+
+namespace
+{
+  typedef std::chrono::steady_clock hrc;
+
+  bool ParseModel( const std::string & i_rName, PredictionModel::Enum & o_rModel )
+  {
+    if( i_rName == "velocity" )          o_rModel = PredictionModel::ConstantVelocity;
+    else if( i_rName == "acceleration" ) o_rModel = PredictionModel::ConstantAcceleration;
+    else if( i_rName == "spline" )       o_rModel = PredictionModel::Spline;
+    else if( i_rName == "alphabeta" )    o_rModel = PredictionModel::AlphaBeta;
+    else return false;
+    return true;
+  }
+
+  // Allocations and time spent in one kind of call
+  class VCallStats
+  {
+  public:
+    VCallStats() : Calls( 0 ), Microseconds( 0 ), Allocations( 0 ), Bytes( 0 ) {}
+
+    template< typename TFunction >
+    void Measure( TFunction i_Function )
+    {
+      const size_t AllocationsBefore = s_AllocationCount;
+      const size_t BytesBefore = s_AllocatedBytes;
+      const hrc::time_point Start = hrc::now();
+      i_Function();
+      Microseconds += std::chrono::duration< double, std::micro >( hrc::now() - Start ).count();
+      Allocations += s_AllocationCount - AllocationsBefore;
+      Bytes += s_AllocatedBytes - BytesBefore;
+      ++Calls;
+    }
+
+    void Print( const std::string & i_rName ) const
+    {
+      const double Count = static_cast< double >( std::max< size_t >( Calls, 1 ) );
+      std::cout << std::setw( 20 ) << i_rName << std::setw( 10 ) << Calls
+                << std::setw( 14 ) << Microseconds / Count
+                << std::setw( 14 ) << Allocations / Count
+                << std::setw( 14 ) << Bytes / Count << std::endl;
+    }
+
+    size_t Calls;
+    double Microseconds;
+    size_t Allocations;
+    size_t Bytes;
+  };
+
+  // Position error of retimed segments against the recorded motion, in mm
+  class VErrorStats
+  {
+  public:
+    void Add( double i_Error )
+    {
+      m_Errors.push_back( i_Error );
+    }
+
+    void Print() const
+    {
+      if( m_Errors.empty() )
+      {
+        std::cout << "No retimed segments to compare" << std::endl;
+        return;
+      }
+
+      std::vector< double > Errors = m_Errors;
+      std::sort( Errors.begin(), Errors.end() );
+
+      double Total = 0.0;
+      double TotalSquared = 0.0;
+      for( double Error : Errors )
+      {
+        Total += Error;
+        TotalSquared += Error * Error;
+      }
+
+      std::cout << "Segment position error (mm) over " << Errors.size() << " samples:"
+                << " mean " << Total / Errors.size()
+                << ", rms " << std::sqrt( TotalSquared / Errors.size() )
+                << ", 95% " << Errors[ Errors.size() * 95 / 100 ]
+                << ", max " << Errors.back() << std::endl;
+    }
+
+  private:
+    std::vector< double > m_Errors;
+  };
+
+  // The recorded input, as it would arrive over the network
+  class VReplayFrame
+  {
+  public:
+    double ArrivalTime;
+    std::vector< std::shared_ptr< VSubjectPose > > m_Poses;
+  };
+
+  std::vector< VReplayFrame > MakeReplayFrames( const VSegmentPoseReader & i_rReader, double & o_rMeanLatency )
+  {
+    std::vector< VReplayFrame > Frames;
+
+    double TotalLatency = 0.0;
+    unsigned int LatencyCount = 0;
+    double LastArrival = -std::numeric_limits< double >::max();
+
+    for( unsigned int FrameNumber = i_rReader.StartFrame(); FrameNumber <= i_rReader.EndFrame(); ++FrameNumber )
+    {
+      VReplayFrame Frame;
+      Frame.ArrivalTime = LastArrival;
+      for( unsigned int Subject = 0; Subject < i_rReader.SubjectCount(); ++Subject )
+      {
+        std::string SubjectName;
+        i_rReader.SubjectName( Subject, SubjectName );
+        std::shared_ptr< VSubjectPose > pPose = i_rReader.PoseAt( FrameNumber, SubjectName );
+        if( !pPose )
+        {
+          continue;
+        }
+
+        TotalLatency += pPose->ReceiptTime - pPose->FrameTime;
+        ++LatencyCount;
+
+        // Frames arrive in order over the stream, so a delayed frame holds back those after it.
+        // The retimer adopts the topology of its input, so give it copies rather than the reader's poses.
+        std::shared_ptr< VSubjectPose > pCopy = std::make_shared< VSubjectPose >( *pPose );
+        pCopy->ReceiptTime = std::max( pCopy->ReceiptTime, LastArrival );
+        Frame.ArrivalTime = std::max( Frame.ArrivalTime, pCopy->ReceiptTime );
+        Frame.m_Poses.push_back( pCopy );
+      }
+
+      if( !Frame.m_Poses.empty() )
+      {
+        LastArrival = Frame.ArrivalTime;
+        Frames.push_back( Frame );
+      }
+    }
+
+    o_rMeanLatency = LatencyCount ? TotalLatency / LatencyCount : 0.0;
+    return Frames;
+  }
+
+  // The recorded pose of a subject at a capture time, interpolated between frames
+  bool GroundTruth( const VSegmentPoseReader & i_rReader, const std::string & i_rSubject, double i_FrameTime, double i_FrameRate,
+                    std::vector< std::array< double, 3 > > & o_rTranslations )
+  {
+    const double Frame = i_FrameTime * i_FrameRate / 1000.0;
+    if( Frame < 0.0 )
+    {
+      return false;
+    }
+
+    const unsigned int Before = static_cast< unsigned int >( Frame );
+    const std::shared_ptr< VSubjectPose > pBefore = i_rReader.PoseAt( Before, i_rSubject );
+    const std::shared_ptr< VSubjectPose > pAfter = i_rReader.PoseAt( Before + 1, i_rSubject );
+    if( !pBefore || !pAfter || pBefore->Result != VSubjectPose::ESuccess || pAfter->Result != VSubjectPose::ESuccess
+        || pBefore->m_Segments.size() != pAfter->m_Segments.size() )
+    {
+      return false;
+    }
+
+    const double u = Frame - Before;
+    o_rTranslations.resize( pBefore->m_Segments.size() );
+    for( size_t Segment = 0; Segment < o_rTranslations.size(); ++Segment )
+    {
+      const VSegmentPose & rBefore = pBefore->m_Segments[ Segment ];
+      const VSegmentPose & rAfter = pAfter->m_Segments[ Segment ];
+      if( rBefore.bOccluded || rAfter.bOccluded )
+      {
+        return false;
+      }
+      for( unsigned int Axis = 0; Axis < 3; ++Axis )
+      {
+        o_rTranslations[ Segment ][ Axis ] = rBefore.T[ Axis ] + u * ( rAfter.T[ Axis ] - rBefore.T[ Axis ] );
+      }
+    }
+    return true;
+  }
+}
+
+int main( int argc, char* argv[] )
+{
+  std::cout << "DSSDK Retimer Replay" << std::endl;
+
+  std::string File;
+  unsigned int FrameCount = 10000;
+  double FrameRate = 100.0;
+  double Latency = 10.0;
+  double Jitter = 2.0;
+  double Spike = 30.0;
+  int SpikeFrequency = 100;
+  double OutputRate = 200.0;
+  double OutputLatency = 0.0;
+  unsigned int HistoryDepth = 2;
+  unsigned int ThreadCount = 0;
+  PredictionModel::Enum Model = PredictionModel::ConstantVelocity;
+
+  for( int a = 1; a < argc; ++a )
+  {
+    std::string arg = argv[a];
+    try
+    {
+      if( arg == "--help" )
+      {
+        std::cout << argv[0] << ": allowed options include:\n --file <output log> | --frames <n> --rate <Hz> --latency <ms> --jitter <ms> --spike <ms> --spikefrequency <n>\n"
+                     " --outputrate <Hz> --outputlatency <ms> --history <n> --threads <n> --model <velocity|acceleration|spline|alphabeta>" << std::endl;
+        return 0;
+      }
+      else if( arg == "--file" && a + 1 < argc )           File = argv[++a];
+      else if( arg == "--frames" && a + 1 < argc )         FrameCount = boost::lexical_cast< unsigned int >( argv[++a] );
+      else if( arg == "--rate" && a + 1 < argc )           FrameRate = boost::lexical_cast< double >( argv[++a] );
+      else if( arg == "--latency" && a + 1 < argc )        Latency = boost::lexical_cast< double >( argv[++a] );
+      else if( arg == "--jitter" && a + 1 < argc )         Jitter = boost::lexical_cast< double >( argv[++a] );
+      else if( arg == "--spike" && a + 1 < argc )          Spike = boost::lexical_cast< double >( argv[++a] );
+      else if( arg == "--spikefrequency" && a + 1 < argc ) SpikeFrequency = boost::lexical_cast< int >( argv[++a] );
+      else if( arg == "--outputrate" && a + 1 < argc )     OutputRate = boost::lexical_cast< double >( argv[++a] );
+      else if( arg == "--outputlatency" && a + 1 < argc )  OutputLatency = boost::lexical_cast< double >( argv[++a] );
+      else if( arg == "--history" && a + 1 < argc )        HistoryDepth = boost::lexical_cast< unsigned int >( argv[++a] );
+      else if( arg == "--threads" && a + 1 < argc )        ThreadCount = boost::lexical_cast< unsigned int >( argv[++a] );
+      else if( arg == "--model" && a + 1 < argc )
+      {
+        if( !ParseModel( argv[++a], Model ) )
+        {
+          std::cerr << "Unknown model " << argv[a] << std::endl;
+          return 1;
+        }
+      }
+    }
+    catch( boost::bad_lexical_cast & e )
+    {
+      std::cerr << arg << ": " << e.what() << std::endl;
+      return 1;
+    }
+  }
+
+  if( FrameRate <= 0.0 || OutputRate <= 0.0 )
+  {
+    std::cerr << "Frame rates must be positive" << std::endl;
+    return 1;
+  }
+
+  VSegmentPoseReader Reader;
+  if( File.empty() )
+  {
+    Reader.GenerateTestData( FrameCount, FrameRate, Latency, Jitter, Spike, SpikeFrequency );
+    std::cout << "Generated " << FrameCount << " frames at " << FrameRate << "Hz, latency " << Latency << "ms, jitter " << Jitter
+              << "ms, spike " << Spike << "ms every ~" << SpikeFrequency << " frames" << std::endl;
+  }
+  else
+  {
+    if( !Reader.Load( File ) )
+    {
+      std::cerr << "Failed to load " << File << std::endl;
+      return 1;
+    }
+    std::cout << "Loaded " << Reader.SubjectCount() << " subjects, frames " << Reader.StartFrame() << " to " << Reader.EndFrame() << " from " << File << std::endl;
+  }
+
+  double MeanLatency = 0.0;
+  const std::vector< VReplayFrame > Frames = MakeReplayFrames( Reader, MeanLatency );
+  if( Frames.size() < 2 )
+  {
+    std::cerr << "Not enough frames to replay" << std::endl;
+    return 1;
+  }
+
+  const double InputFrameRate = Frames.front().m_Poses.front()->FrameRate;
+
+  VRetimingCore Retimer;
+  Retimer.SetHistoryDepth( HistoryDepth );
+  Retimer.SetPredictionModel( Model );
+  Retimer.SetPredictionThreadCount( ThreadCount );
+
+  VCallStats AddStats;
+  VCallStats UpdateStats;
+  VErrorStats Errors;
+  std::map< VSubjectPose::EResult, size_t > Results;
+  std::vector< std::array< double, 3 > > Truth;
+
+  // Step a simulated clock through the recording at the output rate, delivering each frame once it has arrived
+  const double OutputPeriod = 1000.0 / OutputRate;
+  const double StartTime = Frames.front().ArrivalTime;
+  const double EndTime = Frames.back().ArrivalTime;
+  size_t NextFrame = 0;
+
+  const hrc::time_point ReplayStart = hrc::now();
+  for( double Now = StartTime; Now <= EndTime; Now += OutputPeriod )
+  {
+    for( ; NextFrame < Frames.size() && Frames[ NextFrame ].ArrivalTime <= Now; ++NextFrame )
+    {
+      const std::vector< std::shared_ptr< VSubjectPose > > & rPoses = Frames[ NextFrame ].m_Poses;
+      AddStats.Measure( [&]() { Retimer.AddData( rPoses ); } );
+    }
+
+    const double OutputTime = Now - OutputLatency;
+    UpdateStats.Measure( [&]() { Retimer.UpdateFrameAtTime( OutputTime ); } );
+
+    // A pose retimed to OutputTime shows the subject as it was captured one mean latency earlier
+    for( unsigned int Subject = 0; Subject < Reader.SubjectCount(); ++Subject )
+    {
+      std::string SubjectName;
+      Reader.SubjectName( Subject, SubjectName );
+
+      std::shared_ptr< const VSubjectPose > pPose;
+      const VSubjectPose::EResult Result = Retimer.GetSubject( SubjectName, pPose );
+      ++Results[ Result ];
+
+      if( Result == VSubjectPose::ESuccess && pPose
+          && GroundTruth( Reader, SubjectName, OutputTime - MeanLatency, InputFrameRate, Truth ) && Truth.size() == pPose->m_Segments.size() )
+      {
+        for( size_t Segment = 0; Segment < Truth.size(); ++Segment )
+        {
+          const auto & rT = pPose->m_Segments[ Segment ].T;
+          Errors.Add( std::sqrt( ( rT[ 0 ] - Truth[ Segment ][ 0 ] ) * ( rT[ 0 ] - Truth[ Segment ][ 0 ] )
+                               + ( rT[ 1 ] - Truth[ Segment ][ 1 ] ) * ( rT[ 1 ] - Truth[ Segment ][ 1 ] )
+                               + ( rT[ 2 ] - Truth[ Segment ][ 2 ] ) * ( rT[ 2 ] - Truth[ Segment ][ 2 ] ) ) );
+        }
+      }
+    }
+  }
+  const double WallTime = std::chrono::duration< double >( hrc::now() - ReplayStart ).count();
+  const double ReplayedTime = ( EndTime - StartTime ) / 1000.0;
+
+  std::cout << std::fixed << std::setprecision( 3 );
+  std::cout << "Replayed " << ReplayedTime << "s of input in " << WallTime << "s (" << ReplayedTime / std::max( WallTime, 1e-9 ) << "x real time), "
+            << UpdateStats.Calls / std::max( WallTime, 1e-9 ) << " output frames/s" << std::endl;
+  std::cout << "Mean input latency " << MeanLatency << "ms, output latency " << OutputLatency << "ms" << std::endl << std::endl;
+
+  std::cout << std::setw( 20 ) << "Call" << std::setw( 10 ) << "Count" << std::setw( 14 ) << "Mean (us)"
+            << std::setw( 14 ) << "Allocations" << std::setw( 14 ) << "Bytes" << std::endl;
+  AddStats.Print( "AddData" );
+  UpdateStats.Print( "UpdateFrameAtTime" );
+  std::cout << std::endl;
+
+  std::cout << "Output results:";
+  for( const auto & rResult : Results )
+  {
+    std::cout << " " << VSubjectPose::ResultString( rResult.first ) << " " << rResult.second;
+  }
+  std::cout << std::endl;
+  Errors.Print();
+
+  return 0;
+}
@@ -0,0 +1,244 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#define BOOST_TEST_MODULE ViconDataStreamSDKCoreRetimerUnitTest
+#include <boost/test/included/unit_test.hpp>
+
+#include <ViconDataStreamSDKCore/RetimingCore.h>
+#include <ViconDataStreamSDKCore/SubjectPoseLog.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ViconDataStreamSDK::Core;
+
+namespace
+{
+  std::shared_ptr< const VSubjectTopology > SingleSegmentTopology( const std::string & i_rName )
+  {
+    std::shared_ptr< VSubjectTopology > pTopology( new VSubjectTopology() );
+    pTopology->Name = i_rName;
+    pTopology->RootSegment = "Root";
+    pTopology->AddSegment( "Root", "", std::vector< std::string >() );
+    return pTopology;
+  }
+
+  // A pose of the single root segment at X along the x axis, received at i_Time
+  std::shared_ptr< VSubjectPose > PoseAt( const std::shared_ptr< const VSubjectTopology > & i_rpTopology, double i_Time, double i_X )
+  {
+    std::shared_ptr< VSubjectPose > pPose( new VSubjectPose() );
+    pPose->Result = VSubjectPose::ESuccess;
+    pPose->m_pTopology = i_rpTopology;
+    pPose->ReceiptTime = i_Time;
+    pPose->FrameNumber = i_Time;
+    pPose->FrameRate = 100;
+
+    VSegmentPose Segment;
+    Segment.T = { { i_X, 0, 0 } };
+    Segment.R = { { 0, 0, 0, 1 } };
+    Segment.T_Rel = Segment.T;
+    Segment.R_Rel = Segment.R;
+    Segment.T_Stat = { { 0, 0, 0 } };
+    Segment.R_Stat = { { 0, 0, 0, 1 } };
+    pPose->m_Segments.push_back( Segment );
+    return pPose;
+  }
+
+  double SampledX( const VRetimingCore & i_rCore, const std::string & i_rName, double i_Time )
+  {
+    std::shared_ptr< const VRetimedFrame > pFrame;
+    BOOST_REQUIRE( i_rCore.SampleAt( i_Time, pFrame ) == VSubjectPose::ESuccess );
+
+    std::shared_ptr< const VSubjectPose > pSubject;
+    BOOST_REQUIRE( pFrame->GetSubject( i_rName, pSubject ) == VSubjectPose::ESuccess );
+    BOOST_REQUIRE_EQUAL( pSubject->m_Segments.size(), 1u );
+    return pSubject->m_Segments[ 0 ].T[ 0 ];
+  }
+}
+
+// Frames delivered together can share a receipt time; only the newest of them is kept, so that prediction always
+// has an interval to work over
+BOOST_AUTO_TEST_CASE( EqualReceiptTimeKeepsNewestSample )
+{
+  VRetimingCore Core;
+  Core.SetPredictionModel( PredictionModel::ConstantVelocity );
+  Core.SetMaximumPrediction( 100 );
+
+  auto pTopology = SingleSegmentTopology( "Subject" );
+  Core.AddData( { PoseAt( pTopology, 0, 0 ) } );
+  Core.AddData( { PoseAt( pTopology, 10, 10 ) } );
+  Core.AddData( { PoseAt( pTopology, 10, 20 ) } );
+
+  // Predicting from the samples at 0 and the newer one at 10 gives a velocity of 2 per unit time
+  BOOST_CHECK_CLOSE( SampledX( Core, "Subject", 20 ), 40.0, 1e-6 );
+}
+
+// A repeated time replaces the latest measurement in the alpha-beta filter rather than restarting it at rest
+BOOST_AUTO_TEST_CASE( AlphaBetaVelocitySurvivesEqualTimes )
+{
+  VRetimingCore Core;
+  Core.SetPredictionModel( PredictionModel::AlphaBeta );
+  Core.SetMaximumPrediction( 100 );
+
+  auto pTopology = SingleSegmentTopology( "Subject" );
+  Core.AddData( { PoseAt( pTopology, 0, 0 ) } );
+  Core.AddData( { PoseAt( pTopology, 10, 10 ) } );
+  Core.AddData( { PoseAt( pTopology, 20, 20 ) } );
+  Core.AddData( { PoseAt( pTopology, 20, 20 ) } );
+
+  // Moving at 1 per unit time, with no residual for the filter to correct
+  BOOST_CHECK_CLOSE( SampledX( Core, "Subject", 30 ), 30.0, 1e-6 );
+
+  // The second of two samples is also replaced in place, giving the velocity from the newer one
+  VRetimingCore Replaced;
+  Replaced.SetPredictionModel( PredictionModel::AlphaBeta );
+  Replaced.SetMaximumPrediction( 100 );
+  Replaced.AddData( { PoseAt( pTopology, 0, 0 ) } );
+  Replaced.AddData( { PoseAt( pTopology, 10, 10 ) } );
+  Replaced.AddData( { PoseAt( pTopology, 10, 20 ) } );
+
+  BOOST_CHECK_CLOSE( SampledX( Replaced, "Subject", 20 ), 40.0, 1e-6 );
+}
+
+namespace
+{
+  // A binary pose log in a temporary file, removed when the test finishes
+  class VPoseLogFile
+  {
+  public:
+
+    explicit VPoseLogFile( bool i_bCompress )
+      : m_Path( boost::filesystem::temp_directory_path() / boost::filesystem::unique_path( "%%%%-%%%%-%%%%.vspl" ) )
+    {
+      auto pTopology = SingleSegmentTopology( "Subject" );
+
+      VSubjectPoseLogWriter Writer;
+      BOOST_REQUIRE( Writer.Open( m_Path.string(), i_bCompress ) );
+      for( unsigned int Frame = 0; Frame < 3; ++Frame )
+      {
+        Writer.Write( *PoseAt( pTopology, Frame * 10.0, Frame ) );
+      }
+      Writer.Close();
+
+      std::ifstream File( m_Path.string(), std::ios::binary );
+      m_Contents.assign( std::istreambuf_iterator< char >( File ), std::istreambuf_iterator< char >() );
+    }
+
+    ~VPoseLogFile()
+    {
+      boost::system::error_code Error;
+      boost::filesystem::remove( m_Path, Error );
+    }
+
+    // Replace the file with the first i_Size bytes of the log as written
+    void Truncate( size_t i_Size )
+    {
+      Save( std::vector< char >( m_Contents.begin(), m_Contents.begin() + i_Size ) );
+    }
+
+    // Replace the file with the log as written, overwritten at i_Offset
+    void Patch( size_t i_Offset, uint32_t i_Value )
+    {
+      std::vector< char > Contents = m_Contents;
+      std::memcpy( &Contents[ i_Offset ], &i_Value, sizeof( i_Value ) );
+      Save( Contents );
+    }
+
+    size_t Size() const
+    {
+      return m_Contents.size();
+    }
+
+    // Number of poses read, or -1 if the reader reported damage
+    int Read() const
+    {
+      int Count = 0;
+      VSubjectPoseLogReader Reader;
+      const bool bOK = Reader.Read( m_Path.string(), [&Count]( const std::shared_ptr< VSubjectPose > & ){ ++Count; } );
+      return bOK ? Count : -1;
+    }
+
+  private:
+
+    void Save( const std::vector< char > & i_rContents )
+    {
+      std::ofstream File( m_Path.string(), std::ios::binary | std::ios::trunc );
+      File.write( i_rContents.data(), i_rContents.size() );
+    }
+
+    boost::filesystem::path m_Path;
+    std::vector< char > m_Contents;
+  };
+
+  // Offsets into a log of the single segment subject above: a 16 byte file header and 8 byte block header, then
+  // the topology record's length and type, subject index, subject and root names, segment count, and the root
+  // segment's name and empty parent, before its child count
+  const size_t s_BlockRawSizeOffset = 16;
+  const size_t s_TopologySubjectOffset = 16 + 8 + 4 + 1;
+  const size_t s_TopologyChildCountOffset = s_TopologySubjectOffset + 4 + ( 2 + 7 ) + ( 2 + 4 ) + 4 + ( 2 + 4 ) + 2;
+}
+
+BOOST_AUTO_TEST_CASE( PoseLogRoundTrip )
+{
+  VPoseLogFile Uncompressed( false );
+  BOOST_CHECK_EQUAL( Uncompressed.Read(), 3 );
+
+  VPoseLogFile Compressed( true );
+  BOOST_CHECK_EQUAL( Compressed.Read(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( PoseLogTruncated )
+{
+  VPoseLogFile Log( false );
+  Log.Truncate( Log.Size() - 1 );
+  BOOST_CHECK_EQUAL( Log.Read(), -1 );
+
+  Log.Truncate( s_BlockRawSizeOffset + 4 );
+  BOOST_CHECK_EQUAL( Log.Read(), -1 );
+}
+
+BOOST_AUTO_TEST_CASE( PoseLogCorruptSizes )
+{
+  VPoseLogFile Log( false );
+
+  // A subject index which would wrap when the topology table is grown to hold it
+  Log.Patch( s_TopologySubjectOffset, UINT32_MAX );
+  BOOST_CHECK_EQUAL( Log.Read(), -1 );
+
+  // More children than the record has room for
+  Log.Patch( s_TopologyChildCountOffset, 0x7FFFFFFF );
+  BOOST_CHECK_EQUAL( Log.Read(), -1 );
+
+  // A compressed block claiming to expand to far more than it could
+  VPoseLogFile Compressed( true );
+  Compressed.Patch( s_BlockRawSizeOffset, UINT32_MAX );
+  BOOST_CHECK_EQUAL( Compressed.Read(), -1 );
+}
@@ -72,6 +72,27 @@ namespace StreamMode
   };
 }
 
+namespace PredictionModel
+{
+  enum Enum
+  {
+    ConstantVelocity,
+    ConstantAcceleration,
+    Spline,
+    AlphaBeta
+  };
+}
+
+namespace OutputLogFormat
+{
+  enum Enum
+  {
+    Text,
+    Binary,
+    CompressedBinary
+  };
+}
+
 namespace TimecodeStandard
 {
   enum Enum
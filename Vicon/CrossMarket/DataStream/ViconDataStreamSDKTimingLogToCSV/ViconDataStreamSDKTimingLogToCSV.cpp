@@ -0,0 +1,83 @@
+
+//////////////////////////////////////////////////////////////////////////////////
+// MIT License
+//
+// Copyright (c) 2017 Vicon Motion Systems Ltd
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//////////////////////////////////////////////////////////////////////////////////
+#include <ViconCGStreamClient/CGStreamTimingLog.h>
+#include <ViconDataStreamSDKCore/CoreClientTimingLog.h>
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+using namespace ViconDataStreamSDK::Core;
+
+// Converts a binary client or stream timing log, as written by SetTimingLogFile with Binary set, to the text
+// that a text log would have contained.
+int main( int argc, char* argv[] )
+{
+  if( argc < 2 || argc > 3 || std::string( argv[ 1 ] ) == "--help" )
+  {
+    std::cout << argv[ 0 ] << ": <binary timing log> [<output csv>]\n"
+                 " Writes to standard output if no output file is given." << std::endl;
+    return argc == 2 ? 0 : 1;
+  }
+
+  const std::string Input = argv[ 1 ];
+
+  std::ofstream OutputFile;
+  if( argc == 3 )
+  {
+    OutputFile.open( argv[ 2 ] );
+    if( !OutputFile.good() )
+    {
+      std::cerr << "Unable to open " << argv[ 2 ] << std::endl;
+      return 1;
+    }
+  }
+  std::ostream & rOutput = OutputFile.is_open() ? OutputFile : std::cout;
+
+  bool bOk = false;
+  if( VClientTimingLog::IsBinaryLog( Input ) )
+  {
+    bOk = VClientTimingLog::WriteText( Input, rOutput );
+  }
+  else if( VCGStreamRecordLog< VCGStreamTimingRecord >::IsBinaryLog( Input, VCGStreamTimingRecord::s_Magic ) )
+  {
+    bOk = VCGStreamRecordLog< VCGStreamTimingRecord >::WriteText( Input, VCGStreamTimingRecord::s_Magic, VCGStreamTimingRecord::TextHeader(),
+                                                                   &VCGStreamTimingRecord::WriteText, rOutput );
+  }
+  else
+  {
+    std::cerr << Input << " is not a binary timing log" << std::endl;
+    return 1;
+  }
+
+  rOutput.flush();
+  if( !bOk || !rOutput.good() )
+  {
+    std::cerr << "Failed to convert " << Input << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
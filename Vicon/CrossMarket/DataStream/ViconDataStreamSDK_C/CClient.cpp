@@ -235,6 +235,12 @@ void  Client_GetLatencyTotal(CClient* client, COutput_GetLatencyTotal* outptr)
   outptr->Result = outp.Result;
   outptr->Total = outp.Total;
 }
+void  Client_GetFrameReceiptTime(CClient* client, COutput_GetFrameReceiptTime* outptr)
+{
+  const Output_GetFrameReceiptTime& outp = ((Client*) client)->GetFrameReceiptTime();
+  outptr->Result = outp.Result;
+  outptr->ReceiptTime = outp.ReceiptTime;
+}
 
 void Client_GetSubjectCount(CClient* client, COutput_GetSubjectCount* outptr)
 {
@@ -145,6 +145,7 @@ CDLL_EXPORT CEnum  Client_GetLatencySampleName(CClient* client, unsigned int Lat
                         int sizeOfBuffer, char* outstr );
 CDLL_EXPORT void Client_GetLatencySampleValue(CClient* client, CString LatencySampleName, COutput_GetLatencySampleValue* outptr );
 CDLL_EXPORT void Client_GetLatencyTotal(CClient* client, COutput_GetLatencyTotal* outptr);
+CDLL_EXPORT void Client_GetFrameReceiptTime(CClient* client, COutput_GetFrameReceiptTime* outptr);
 
 CDLL_EXPORT void Client_GetSubjectCount(CClient* client, COutput_GetSubjectCount* outptr);
 CDLL_EXPORT CEnum Client_GetSubjectName(CClient* client, unsigned int SubjectIndex, int sizeOfBuffer, char* outstr );
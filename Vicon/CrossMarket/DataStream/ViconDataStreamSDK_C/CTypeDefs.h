@@ -235,6 +235,13 @@ typedef struct COutput_GetLatencyTotal
   double       Total;
 } COutput_GetLatencyTotal;
 
+/** @private */
+typedef struct COutput_GetFrameReceiptTime
+{
+  CEnum Result;
+  double       ReceiptTime;
+} COutput_GetFrameReceiptTime;
+
 /** @private */
 typedef struct COutput_GetSubjectCount
 {
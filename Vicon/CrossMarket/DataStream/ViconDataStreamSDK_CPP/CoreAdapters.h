@@ -93,6 +93,44 @@ inline ViconDataStreamSDK::Core::StreamMode::Enum Adapt(ViconDataStreamSDK::CPP:
   }
 }
 
+// This function is provided to insulate us from changes to ViconDataStreamSDK::CPP::PredictionModel::Enum 
+inline ViconDataStreamSDK::Core::PredictionModel::Enum Adapt(ViconDataStreamSDK::CPP::PredictionModel::Enum i_Model)
+{
+  switch (i_Model)
+  {
+  default:
+  case ViconDataStreamSDK::CPP::PredictionModel::ConstantVelocity: return ViconDataStreamSDK::Core::PredictionModel::ConstantVelocity;
+  case ViconDataStreamSDK::CPP::PredictionModel::ConstantAcceleration: return ViconDataStreamSDK::Core::PredictionModel::ConstantAcceleration;
+  case ViconDataStreamSDK::CPP::PredictionModel::Spline: return ViconDataStreamSDK::Core::PredictionModel::Spline;
+  case ViconDataStreamSDK::CPP::PredictionModel::AlphaBeta: return ViconDataStreamSDK::Core::PredictionModel::AlphaBeta;
+  }
+}
+
+// This function is provided to insulate us from changes to ViconDataStreamSDK::CPP::OutputLogFormat::Enum 
+inline ViconDataStreamSDK::Core::OutputLogFormat::Enum Adapt(ViconDataStreamSDK::CPP::OutputLogFormat::Enum i_Format)
+{
+  switch (i_Format)
+  {
+  default:
+  case ViconDataStreamSDK::CPP::OutputLogFormat::Text: return ViconDataStreamSDK::Core::OutputLogFormat::Text;
+  case ViconDataStreamSDK::CPP::OutputLogFormat::Binary: return ViconDataStreamSDK::Core::OutputLogFormat::Binary;
+  case ViconDataStreamSDK::CPP::OutputLogFormat::CompressedBinary: return ViconDataStreamSDK::Core::OutputLogFormat::CompressedBinary;
+  }
+}
+
+// This function is provided to insulate us from changes to ViconDataStreamSDK::Core::PredictionModel::Enum 
+inline ViconDataStreamSDK::CPP::PredictionModel::Enum Adapt(ViconDataStreamSDK::Core::PredictionModel::Enum i_Model)
+{
+  switch (i_Model)
+  {
+  default:
+  case ViconDataStreamSDK::Core::PredictionModel::ConstantVelocity: return ViconDataStreamSDK::CPP::PredictionModel::ConstantVelocity;
+  case ViconDataStreamSDK::Core::PredictionModel::ConstantAcceleration: return ViconDataStreamSDK::CPP::PredictionModel::ConstantAcceleration;
+  case ViconDataStreamSDK::Core::PredictionModel::Spline: return ViconDataStreamSDK::CPP::PredictionModel::Spline;
+  case ViconDataStreamSDK::Core::PredictionModel::AlphaBeta: return ViconDataStreamSDK::CPP::PredictionModel::AlphaBeta;
+  }
+}
+
 // This function is provided to insulate us from changes to ViconDataStreamSDK::Core::Result::Enum 
 inline ViconDataStreamSDK::CPP::Result::Enum Adapt(ViconDataStreamSDK::Core::Result::Enum i_Result)
 {
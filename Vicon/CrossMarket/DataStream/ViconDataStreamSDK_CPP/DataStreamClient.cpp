@@ -27,6 +27,7 @@
 #define _EXPORTING
 
 #include "DataStreamClient.h"
+#include <cstddef>
 #include <memory>
 #include <ViconDataStreamSDKCore/CoreClient.h>
 #include "StringFactory.h"
@@ -611,6 +612,16 @@ namespace CPP
     return Output;
   }
 
+  // GetFrameReceiptTime
+  CLASS_DECLSPEC
+  Output_GetFrameReceiptTime Client::GetFrameReceiptTime() const
+  {
+    Output_GetFrameReceiptTime Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->GetFrameReceiptTime( Output.ReceiptTime ) );
+
+    return Output;
+  }
+
   // GetHardwareFrameNumber
   CLASS_DECLSPEC
   Output_GetHardwareFrameNumber Client::GetHardwareFrameNumber() const
@@ -1570,6 +1581,43 @@ namespace CPP
 
     return Output;
   }
+
+  CLASS_DECLSPEC
+  Output_GetCentroids Client::GetCentroids( const std::string & i_rCameraName ) const
+  {
+    Output_GetCentroids Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->GetCentroids( i_rCameraName, Output.CameraIDs, Output.CameraOffsets,
+                                                                       Output.Positions, Output.Radii, Output.Weights, Output.TrackIDs ) );
+
+    return Output;
+  }
+
+  CLASS_DECLSPEC
+  Output_GetUndistortedCentroids Client::GetUndistortedCentroids( const std::string & i_rCameraName ) const
+  {
+    Output_GetUndistortedCentroids Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->GetUndistortedCentroids( i_rCameraName, Output.Positions ) );
+
+    return Output;
+  }
+
+  CLASS_DECLSPEC
+  Output_GetCentroidRays Client::GetCentroidRays( const std::string & i_rCameraName ) const
+  {
+    Output_GetCentroidRays Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->GetCentroidRays( i_rCameraName, Output.Origin, Output.Directions ) );
+
+    return Output;
+  }
+
+  CLASS_DECLSPEC
+  Output_ProjectPoints Client::ProjectPoints( const std::vector< double > & i_rPoints ) const
+  {
+    Output_ProjectPoints Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->ProjectPoints( i_rPoints, Output.CameraIDs, Output.Positions ) );
+
+    return Output;
+  }
   
   CLASS_DECLSPEC
   Output_GetGreyscaleBlobCount Client::GetGreyscaleBlobCount( const std::string & i_rCameraName ) const
@@ -1604,6 +1652,41 @@ namespace CPP
     return Output;
   }
 
+  // The lines are handed out in place, so the public line has to match the stream's line exactly
+  typedef ViconCGStream::VGreyscaleBlobsPacked::VLine TPackedLine;
+  static_assert( sizeof( Output_GetGreyscaleBlobs::Line ) == sizeof( TPackedLine ), "Greyscale line layouts differ" );
+  static_assert( offsetof( Output_GetGreyscaleBlobs::Line, PixelOffset ) == offsetof( TPackedLine, m_PixelOffset ), "Greyscale line layouts differ" );
+  static_assert( offsetof( Output_GetGreyscaleBlobs::Line, PixelCount ) == offsetof( TPackedLine, m_PixelCount ), "Greyscale line layouts differ" );
+  static_assert( offsetof( Output_GetGreyscaleBlobs::Line, Position ) == offsetof( TPackedLine, m_Position ), "Greyscale line layouts differ" );
+
+  CLASS_DECLSPEC
+  Output_GetGreyscaleBlobs Client::GetGreyscaleBlobs( const std::string & i_rCameraName ) const
+  {
+    ViconCGStreamClientSDK::VGreyscaleBlobsPtr BlobsPtr;
+
+    Output_GetGreyscaleBlobs Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->GetGreyscaleBlobs( i_rCameraName, BlobsPtr ) );
+    Output.BlobCount = 0;
+    Output.BlobLines = nullptr;
+    Output.LineCount = 0;
+    Output.Lines = nullptr;
+    Output.PixelCount = 0;
+    Output.Pixels = nullptr;
+
+    if( Output.Result == Result::Success && BlobsPtr )
+    {
+      Output.BlobCount = static_cast< unsigned int >( BlobsPtr->BlobCount() );
+      Output.BlobLines = BlobsPtr->m_BlobLines.data();
+      Output.LineCount = static_cast< unsigned int >( BlobsPtr->m_Lines.size() );
+      Output.Lines = reinterpret_cast< const Output_GetGreyscaleBlobs::Line * >( BlobsPtr->m_Lines.data() );
+      Output.PixelCount = static_cast< unsigned int >( BlobsPtr->m_Pixels.size() );
+      Output.Pixels = BlobsPtr->m_Pixels.data();
+      Output.Blobs = BlobsPtr;
+    }
+
+    return Output;
+  }
+
   CLASS_DECLSPEC
   Output_GetVideoFrame Client::GetVideoFrame( const std::string & i_rCameraName ) const
   {
@@ -1663,6 +1746,63 @@ namespace CPP
     return Output;
   }
 
+  CLASS_DECLSPEC
+  Output_RemoveFromSubjectFilter Client::RemoveFromSubjectFilter( const String & SubjectName )
+  {
+    Output_RemoveFromSubjectFilter Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->RemoveFromSubjectFilter( SubjectName ) );
+    return Output;
+  }
+
+  CLASS_DECLSPEC
+  Output_AddToCameraFilter Client::AddToCameraFilter( const unsigned int CameraId, const bool Centroids, const bool Blobs, const bool Video )
+  {
+    Output_AddToCameraFilter Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->AddToCameraFilter( CameraId, Centroids, Blobs, Video ) );
+    return Output;
+  }
+
+  CLASS_DECLSPEC
+  Output_RemoveFromCameraFilter Client::RemoveFromCameraFilter( const unsigned int CameraId, const bool Centroids, const bool Blobs, const bool Video )
+  {
+    Output_RemoveFromCameraFilter Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->RemoveFromCameraFilter( CameraId, Centroids, Blobs, Video ) );
+    return Output;
+  }
+
+  CLASS_DECLSPEC
+  Output_ClearDeviceFilter Client::ClearDeviceFilter()
+  {
+    Output_ClearDeviceFilter Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->ClearDeviceFilter() );
+    return Output;
+  }
+
+  CLASS_DECLSPEC
+  Output_AddToDeviceFilter Client::AddToDeviceFilter( const String & DeviceName )
+  {
+    Output_AddToDeviceFilter Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->AddToDeviceFilter( DeviceName ) );
+    return Output;
+  }
+
+  CLASS_DECLSPEC
+  Output_RemoveFromDeviceFilter Client::RemoveFromDeviceFilter( const String & DeviceName )
+  {
+    Output_RemoveFromDeviceFilter Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->RemoveFromDeviceFilter( DeviceName ) );
+    return Output;
+  }
+
+  CLASS_DECLSPEC
+  Output_GetBytesReceived Client::GetBytesReceived() const
+  {
+    Output_GetBytesReceived Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->GetBytesReceived( Output.CameraBytes, Output.SubjectBytes,
+                                                                           Output.DeviceBytes, Output.OtherBytes ) );
+    return Output;
+  }
+
   CLASS_DECLSPEC
   Output_SetTimingLogFile Client::SetTimingLogFile(const String & ClientLog, const String & StreamLog)
   {
@@ -1671,6 +1811,14 @@ namespace CPP
     return Output;
   };
 
+  CLASS_DECLSPEC
+  Output_SetTimingLogFile Client::SetTimingLogFile( const String & ClientLog, const String & StreamLog, const bool Binary )
+  {
+    Output_SetTimingLogFile Output;
+    Output.Result = Adapt( m_pClientImpl->m_pCoreClient->SetTimingLog( ClientLog, StreamLog, Binary ) );
+    return Output;
+  };
+
   CLASS_DECLSPEC
   Output_ConfigureWireless Client::ConfigureWireless()
   {
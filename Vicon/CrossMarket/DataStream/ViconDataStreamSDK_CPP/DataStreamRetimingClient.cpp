@@ -465,6 +465,169 @@ namespace ViconDataStreamSDK
       return Output;
     }
 
+    CLASS_DECLSPEC
+    Output_EnableMarkerData RetimingClient::EnableMarkerData()
+    {
+      Output_EnableMarkerData Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreClient->EnableMarkerData() );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_EnableUnlabeledMarkerData RetimingClient::EnableUnlabeledMarkerData()
+    {
+      Output_EnableUnlabeledMarkerData Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreClient->EnableUnlabeledMarkerData() );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_EnableDeviceData RetimingClient::EnableDeviceData()
+    {
+      Output_EnableDeviceData Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreClient->EnableDeviceData() );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_DisableMarkerData RetimingClient::DisableMarkerData()
+    {
+      Output_DisableMarkerData Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreClient->DisableMarkerData() );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_DisableUnlabeledMarkerData RetimingClient::DisableUnlabeledMarkerData()
+    {
+      Output_DisableUnlabeledMarkerData Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreClient->DisableUnlabeledMarkerData() );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_DisableDeviceData RetimingClient::DisableDeviceData()
+    {
+      Output_DisableDeviceData Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreClient->DisableDeviceData() );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetLabeledMarkerCount RetimingClient::GetLabeledMarkerCount() const
+    {
+      Output_GetLabeledMarkerCount Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetLabeledMarkerCount( Output.MarkerCount ) );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetLabeledMarkerGlobalTranslation RetimingClient::GetLabeledMarkerGlobalTranslation( const unsigned int MarkerIndex ) const
+    {
+      Output_GetLabeledMarkerGlobalTranslation Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetLabeledMarkerGlobalTranslation( MarkerIndex,
+        Output.Translation,
+        Output.MarkerID ) );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetUnlabeledMarkerCount RetimingClient::GetUnlabeledMarkerCount() const
+    {
+      Output_GetUnlabeledMarkerCount Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetUnlabeledMarkerCount( Output.MarkerCount ) );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetUnlabeledMarkerGlobalTranslation RetimingClient::GetUnlabeledMarkerGlobalTranslation( const unsigned int MarkerIndex ) const
+    {
+      Output_GetUnlabeledMarkerGlobalTranslation Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetUnlabeledMarkerGlobalTranslation( MarkerIndex,
+        Output.Translation,
+        Output.MarkerID ) );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetDeviceCount RetimingClient::GetDeviceCount() const
+    {
+      Output_GetDeviceCount Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetDeviceCount( Output.DeviceCount ) );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetDeviceName RetimingClient::GetDeviceName( const unsigned int DeviceIndex ) const
+    {
+      Output_GetDeviceName Output;
+      std::string _DeviceName;
+      ViconDataStreamSDK::Core::DeviceType::Enum _DeviceType = ViconDataStreamSDK::Core::DeviceType::Unknown;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetDeviceName( DeviceIndex, _DeviceName, _DeviceType ) );
+
+      Output.DeviceName.Set( _DeviceName.c_str(), *m_pClientImpl->m_pStringFactory.get() );
+      Output.DeviceType = Adapt( _DeviceType );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetDeviceOutputCount RetimingClient::GetDeviceOutputCount( const String & DeviceName ) const
+    {
+      Output_GetDeviceOutputCount Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetDeviceOutputCount( DeviceName, Output.DeviceOutputCount ) );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetDeviceOutputComponentName RetimingClient::GetDeviceOutputComponentName( const String & DeviceName,
+                                                                                      const unsigned int DeviceOutputIndex ) const
+    {
+      Output_GetDeviceOutputComponentName Output;
+      std::string _DeviceOutputName;
+      std::string _DeviceOutputComponentName;
+      ViconDataStreamSDK::Core::Unit::Enum _DeviceOutputUnit = ViconDataStreamSDK::Core::Unit::Unknown;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetDeviceOutputNameComponent( DeviceName,
+        DeviceOutputIndex,
+        _DeviceOutputName,
+        _DeviceOutputComponentName,
+        _DeviceOutputUnit ) );
+
+      Output.DeviceOutputName.Set( _DeviceOutputName.c_str(), *m_pClientImpl->m_pStringFactory.get() );
+      Output.DeviceOutputComponentName.Set( _DeviceOutputComponentName.c_str(), *m_pClientImpl->m_pStringFactory.get() );
+      Output.DeviceOutputUnit = Adapt( _DeviceOutputUnit );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetDeviceOutputSubsamples RetimingClient::GetDeviceOutputSubsamples( const String & DeviceName,
+                                                                                const String & DeviceOutputName,
+                                                                                const String & DeviceOutputComponentName ) const
+    {
+      Output_GetDeviceOutputSubsamples Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetDeviceOutputSubsamples( DeviceName,
+        DeviceOutputName,
+        DeviceOutputComponentName,
+        Output.DeviceOutputSubsamples,
+        Output.Occluded ) );
+      return Output;
+    }
+
+    CLASS_DECLSPEC
+    Output_GetDeviceOutputValue RetimingClient::GetDeviceOutputValue( const String & DeviceName,
+                                                                      const String & DeviceOutputName,
+                                                                      const String & DeviceOutputComponentName,
+                                                                      const unsigned int Subsample ) const
+    {
+      Output_GetDeviceOutputValue Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetDeviceOutputValue( DeviceName,
+        DeviceOutputName,
+        DeviceOutputComponentName,
+        Subsample,
+        Output.Value,
+        Output.Occluded ) );
+      return Output;
+    }
+
     
     CLASS_DECLSPEC
     void RetimingClient::SetOutputLatency( double i_OutputLatency )
@@ -478,6 +641,33 @@ namespace ViconDataStreamSDK
       return m_pClientImpl->m_pCoreRetimingClient->OutputLatency();
     }
 
+    CLASS_DECLSPEC
+    void RetimingClient::SetOutputSpinTime( double i_SpinTime )
+    {
+      m_pClientImpl->m_pCoreRetimingClient->SetOutputSpinTime( i_SpinTime );
+    }
+
+    CLASS_DECLSPEC
+    double RetimingClient::OutputSpinTime() const
+    {
+      return m_pClientImpl->m_pCoreRetimingClient->OutputSpinTime();
+    }
+
+    CLASS_DECLSPEC
+    Output_GetOutputTimingStatistics RetimingClient::GetOutputTimingStatistics() const
+    {
+      Output_GetOutputTimingStatistics Output;
+      ViconDataStreamSDK::Core::VOutputTimingStatistics Statistics;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreRetimingClient->GetOutputTimingStatistics( Statistics ) );
+      Output.TickCount = static_cast< unsigned int >( Statistics.TickCount );
+      Output.MissedTickCount = static_cast< unsigned int >( Statistics.MissedTickCount );
+      Output.MeanJitter = Statistics.MeanJitter;
+      Output.MinimumJitter = Statistics.MinimumJitter;
+      Output.MaximumJitter = Statistics.MaximumJitter;
+      Output.JitterStandardDeviation = Statistics.JitterStandardDeviation;
+      return Output;
+    }
+
     CLASS_DECLSPEC
     void RetimingClient::SetMaximumPrediction( double i_MaxPrediction )
     {
@@ -490,6 +680,42 @@ namespace ViconDataStreamSDK
       return m_pClientImpl->m_pCoreRetimingClient->MaximumPrediction();
     }
 
+    CLASS_DECLSPEC
+    void RetimingClient::SetHistoryDepth( unsigned int i_HistoryDepth )
+    {
+      m_pClientImpl->m_pCoreRetimingClient->SetHistoryDepth( i_HistoryDepth );
+    }
+
+    CLASS_DECLSPEC
+    unsigned int RetimingClient::HistoryDepth() const
+    {
+      return m_pClientImpl->m_pCoreRetimingClient->HistoryDepth();
+    }
+
+    CLASS_DECLSPEC
+    void RetimingClient::SetPredictionModel( PredictionModel::Enum i_Model )
+    {
+      m_pClientImpl->m_pCoreRetimingClient->SetPredictionModel( Adapt( i_Model ) );
+    }
+
+    CLASS_DECLSPEC
+    PredictionModel::Enum RetimingClient::GetPredictionModel() const
+    {
+      return Adapt( m_pClientImpl->m_pCoreRetimingClient->GetPredictionModel() );
+    }
+
+    CLASS_DECLSPEC
+    void RetimingClient::SetPredictionThreadCount( unsigned int i_ThreadCount )
+    {
+      m_pClientImpl->m_pCoreRetimingClient->SetPredictionThreadCount( i_ThreadCount );
+    }
+
+    CLASS_DECLSPEC
+    unsigned int RetimingClient::PredictionThreadCount() const
+    {
+      return m_pClientImpl->m_pCoreRetimingClient->PredictionThreadCount();
+    }
+
     CLASS_DECLSPEC
     bool RetimingClient::SetDebugLogFile(const String & LogFile)
     {
@@ -502,6 +728,12 @@ namespace ViconDataStreamSDK
       return m_pClientImpl->m_pCoreRetimingClient->SetOutputFile(LogFile);
     }
 
+    CLASS_DECLSPEC
+    bool RetimingClient::SetOutputFile(const String & LogFile, OutputLogFormat::Enum Format)
+    {
+      return m_pClientImpl->m_pCoreRetimingClient->SetOutputFile(LogFile, Adapt(Format));
+    }
+
     CLASS_DECLSPEC
     Output_ClearSubjectFilter RetimingClient::ClearSubjectFilter()
     {
@@ -526,5 +758,13 @@ namespace ViconDataStreamSDK
       return Output;
     }
 
+    CLASS_DECLSPEC
+    Output_SetTimingLogFile RetimingClient::SetTimingLogFile( const String & ClientLog, const String & StreamLog, const bool Binary )
+    {
+      Output_SetTimingLogFile Output;
+      Output.Result = Adapt( m_pClientImpl->m_pCoreClient->SetTimingLog( ClientLog, StreamLog, Binary ) );
+      return Output;
+    }
+
   }
   }
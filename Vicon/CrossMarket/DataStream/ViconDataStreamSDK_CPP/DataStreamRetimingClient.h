@@ -1941,6 +1941,152 @@ namespace ViconDataStreamSDK
       Output_GetSegmentLocalRotationEulerXYZ GetSegmentLocalRotationEulerXYZ(const String & SubjectName,
         const String & SegmentName) const;
 
+      /// Enable labeled reconstructed marker data in the Vicon DataStream, so that the markers are retimed along with the subjects.
+      /// Markers are matched between frames by trajectory ID, and interpolated or predicted in the same way as segments. 
+      /// A marker which has only just appeared is held at the position it was last seen.
+      ///
+      /// See Also: DisableMarkerData(), GetLabeledMarkerCount(), GetLabeledMarkerGlobalTranslation()
+      ///
+      /// C++ example
+      ///      
+      ///      ViconDataStreamSDK::CPP::RetimingClient MyClient;
+      ///      MyClient.EnableMarkerData();
+      ///      MyClient.Connect( "localhost" );
+      /// -----
+      /// \return An Output_EnableMarkerData class containing the result of the operation.
+      Output_EnableMarkerData EnableMarkerData();
+
+      /// Enable unlabeled reconstructed marker data in the Vicon DataStream, so that the markers are retimed along with the subjects.
+      ///
+      /// See Also: DisableUnlabeledMarkerData(), GetUnlabeledMarkerCount(), GetUnlabeledMarkerGlobalTranslation()
+      /// \return An Output_EnableUnlabeledMarkerData class containing the result of the operation.
+      Output_EnableUnlabeledMarkerData EnableUnlabeledMarkerData();
+
+      /// Enable device data in the Vicon DataStream, so that force plates, eye trackers and other devices are retimed along with the subjects.
+      /// Device subsamples are resampled onto the output frames at the rate the device was sampled: an analog device sampled at 1000 Hz
+      /// with output at 200 Hz has five subsamples in each output frame, the last of which is at the output time.
+      ///
+      /// See Also: DisableDeviceData(), GetDeviceCount(), GetDeviceOutputSubsamples(), GetDeviceOutputValue()
+      ///
+      /// C++ example
+      ///      
+      ///      ViconDataStreamSDK::CPP::RetimingClient MyClient;
+      ///      MyClient.EnableDeviceData();
+      ///      MyClient.Connect( "localhost", 200.0 );
+      ///      MyClient.WaitForFrame();
+      ///      Output_GetDeviceOutputSubsamples Subsamples = MyClient.GetDeviceOutputSubsamples( "AMTI", "Force", "Fx" );
+      ///      for( unsigned int Subsample = 0; Subsample < Subsamples.DeviceOutputSubsamples; ++Subsample )
+      ///      {
+      ///        Output_GetDeviceOutputValue Value = MyClient.GetDeviceOutputValue( "AMTI", "Force", "Fx", Subsample );
+      ///      }
+      /// -----
+      /// \return An Output_EnableDeviceData class containing the result of the operation.
+      Output_EnableDeviceData EnableDeviceData();
+
+      /// Disable labeled reconstructed marker data in the Vicon DataStream.
+      /// \return An Output_DisableMarkerData class containing the result of the operation.
+      Output_DisableMarkerData DisableMarkerData();
+
+      /// Disable unlabeled reconstructed marker data in the Vicon DataStream.
+      /// \return An Output_DisableUnlabeledMarkerData class containing the result of the operation.
+      Output_DisableUnlabeledMarkerData DisableUnlabeledMarkerData();
+
+      /// Disable device data in the Vicon DataStream.
+      /// \return An Output_DisableDeviceData class containing the result of the operation.
+      Output_DisableDeviceData DisableDeviceData();
+
+      /// Return the number of retimed labeled markers. The markers are ordered by trajectory ID.
+      ///
+      /// See Also: EnableMarkerData(), GetLabeledMarkerGlobalTranslation()
+      /// \return An Output_GetLabeledMarkerCount class containing the result of the operation and the number of markers.
+      ///         - The Result will be:
+      ///           + Success
+      ///           + NotConnected
+      ///           + NoFrame
+      ///           + EarlyDataRequested
+      ///           + LateDataRequested
+      Output_GetLabeledMarkerCount GetLabeledMarkerCount() const;
+
+      /// Return the retimed translation of a labeled marker in global coordinates, and its trajectory ID.
+      ///
+      /// See Also: EnableMarkerData(), GetLabeledMarkerCount()
+      /// \param  MarkerIndex The index of the marker, between 0 and GetLabeledMarkerCount() - 1
+      /// \return An Output_GetLabeledMarkerGlobalTranslation class containing the result of the operation, the translation and the trajectory ID.
+      ///         - The Result will be as for GetLabeledMarkerCount(), or InvalidIndex.
+      Output_GetLabeledMarkerGlobalTranslation GetLabeledMarkerGlobalTranslation( const unsigned int MarkerIndex ) const;
+
+      /// Return the number of retimed unlabeled markers. The markers are ordered by trajectory ID.
+      ///
+      /// See Also: EnableUnlabeledMarkerData(), GetUnlabeledMarkerGlobalTranslation()
+      /// \return An Output_GetUnlabeledMarkerCount class containing the result of the operation and the number of markers.
+      Output_GetUnlabeledMarkerCount GetUnlabeledMarkerCount() const;
+
+      /// Return the retimed translation of an unlabeled marker in global coordinates, and its trajectory ID.
+      ///
+      /// See Also: EnableUnlabeledMarkerData(), GetUnlabeledMarkerCount()
+      /// \param  MarkerIndex The index of the marker, between 0 and GetUnlabeledMarkerCount() - 1
+      /// \return An Output_GetUnlabeledMarkerGlobalTranslation class containing the result of the operation, the translation and the trajectory ID.
+      Output_GetUnlabeledMarkerGlobalTranslation GetUnlabeledMarkerGlobalTranslation( const unsigned int MarkerIndex ) const;
+
+      /// Return the number of retimed devices. A device keeps its index once it has been seen.
+      ///
+      /// See Also: EnableDeviceData(), GetDeviceName()
+      /// \return An Output_GetDeviceCount class containing the result of the operation and the number of devices.
+      Output_GetDeviceCount GetDeviceCount() const;
+
+      /// Return the name and type of a retimed device.
+      ///
+      /// \param  DeviceIndex The index of the device, between 0 and GetDeviceCount() - 1
+      /// \return An Output_GetDeviceName class containing the result of the operation, the device name and the device type.
+      Output_GetDeviceName GetDeviceName( const unsigned int DeviceIndex ) const;
+
+      /// Return the number of outputs of a device. Each component of an output is counted separately.
+      ///
+      /// \param  DeviceName The name of the device
+      /// \return An Output_GetDeviceOutputCount class containing the result of the operation and the number of outputs.
+      Output_GetDeviceOutputCount GetDeviceOutputCount( const String & DeviceName ) const;
+
+      /// Return the output name, component name and unit of a device output.
+      ///
+      /// \param  DeviceName The name of the device
+      /// \param  DeviceOutputIndex The index of the output, between 0 and GetDeviceOutputCount() - 1
+      /// \return An Output_GetDeviceOutputComponentName class containing the result of the operation, the names and the unit.
+      Output_GetDeviceOutputComponentName GetDeviceOutputComponentName( const String & DeviceName,
+                                                                        const unsigned int DeviceOutputIndex ) const;
+
+      /// Return the number of subsamples of a device output in the current output frame. This depends on the rate at which
+      /// the device was sampled and the output frame rate, rather than on the frame rate of the Vicon system.
+      ///
+      /// \param  DeviceName The name of the device
+      /// \param  DeviceOutputName The name of the output
+      /// \param  DeviceOutputComponentName The name of the output component
+      /// \return An Output_GetDeviceOutputSubsamples class containing the result of the operation, the number of subsamples and whether the output is occluded.
+      ///         - The Result will be:
+      ///           + Success
+      ///           + NotConnected
+      ///           + NoFrame
+      ///           + InvalidDeviceName
+      ///           + InvalidDeviceOutputName
+      ///           + EarlyDataRequested
+      ///           + LateDataRequested
+      Output_GetDeviceOutputSubsamples GetDeviceOutputSubsamples( const String & DeviceName,
+                                                                  const String & DeviceOutputName,
+                                                                  const String & DeviceOutputComponentName ) const;
+
+      /// Return a resampled value of a device output in the current output frame. The subsamples are evenly spaced over the
+      /// period since the previous output frame. Values after the latest received subsample hold that subsample.
+      ///
+      /// \param  DeviceName The name of the device
+      /// \param  DeviceOutputName The name of the output
+      /// \param  DeviceOutputComponentName The name of the output component
+      /// \param  Subsample The subsample, between 0 and GetDeviceOutputSubsamples() - 1
+      /// \return An Output_GetDeviceOutputValue class containing the result of the operation, the value and whether the output is occluded.
+      ///         - The Result will be as for GetDeviceOutputSubsamples(), or InvalidIndex.
+      Output_GetDeviceOutputValue GetDeviceOutputValue( const String & DeviceName,
+                                                        const String & DeviceOutputName,
+                                                        const String & DeviceOutputComponentName,
+                                                        const unsigned int Subsample ) const;
+
 
       /// Sets the maximum amount by which the interpolation engine will predict later than the latest received frame. If required to predict by more than this amount,
       /// the result LateDataRequested will be returned.
@@ -2004,7 +2150,48 @@ namespace ViconDataStreamSDK
       /// \return The maximum prediction allowed in milliseconds
       double MaximumPrediction() const;
 
+      /// Sets the number of frames received for each subject that the interpolation engine keeps, from which it predicts the output pose.
+      /// The higher order prediction models use the extra history to follow acceleration, which allows a larger maximum prediction.
+      /// Values are limited to the range 2 to 64; the default is 2. Frames older than 500 ms are not used, whatever the depth.
+      ///
+      /// C++ example
+      ///      
+      ///      ViconDataStreamSDK::CPP::RetimingClient MyClient;
+      ///      MyClient.SetHistoryDepth( 8 );
+      ///      MyClient.SetPredictionModel( ViconDataStreamSDK::CPP::PredictionModel::Spline );
+      ///      MyClient.Connect( "localhost" );
+      /// -----      
+      /// \param HistoryDepth The number of frames to keep for each subject
+      void SetHistoryDepth( unsigned int HistoryDepth );
+
+      /// Returns the number of frames kept for each subject.
+      /// \return The history depth in frames
+      unsigned int HistoryDepth() const;
+
+      /// Selects how the interpolation engine predicts poses from the frames it has kept.
+      ///  + **ConstantVelocity** Interpolates or extrapolates linearly between a pair of frames. This is the default.
+      ///  + **ConstantAcceleration** Fits a quadratic through three frames.
+      ///  + **Spline** Interpolates along a cubic spline through the kept frames, and extrapolates along its end tangent.
+      ///  + **AlphaBeta** Filters position and velocity as each frame arrives, smoothing measurement noise.
+      /// The models other than ConstantVelocity need a history depth of at least 3 to differ from it.
+      /// \param Model The prediction model to use
+      void SetPredictionModel( PredictionModel::Enum Model );
+
+      /// Returns the prediction model in use.
+      /// \return The prediction model
+      PredictionModel::Enum GetPredictionModel() const;
+
+      /// Set the number of worker threads that the output thread shares subject prediction with. This helps when many subjects
+      /// must be predicted within each output frame. Subjects are only shared out in groups of eight or more, so it has no effect
+      /// on scenes with few subjects. The default is zero, which predicts every subject on the output thread.
+      ///@private
+      void SetPredictionThreadCount( unsigned int ThreadCount );
+
+      ///@private
+      unsigned int PredictionThreadCount() const;
+
       /// Set a debug log file that will contain timing information to allow analysis of the retiming performance
+      /// The log is written as fixed size binary records, and only costs time while it is open.
       /// \return false if the log file could not be opened.
       /// @private
       bool SetDebugLogFile(const String & LogFile);
@@ -2014,6 +2201,12 @@ namespace ViconDataStreamSDK
       /// @private
       bool SetOutputFile(const String & LogFile);
 
+      /// Set an output file as above, choosing its format. The binary formats are a fraction of the size of text
+      /// and much faster to load for offline processing.
+      /// \return false if the file could not be opened.
+      /// @private
+      bool SetOutputFile(const String & LogFile, OutputLogFormat::Enum Format);
+
       /// Clear the subject filter. This will result in all subjects being sent.
       /// @private
       Output_ClearSubjectFilter ClearSubjectFilter();
@@ -2027,12 +2220,31 @@ namespace ViconDataStreamSDK
       /// @private
       Output_SetTimingLogFile SetTimingLogFile(const String & ClientLog, const String & StreamLog);
 
+      /// Output timing information to log files, optionally in a compact binary format
+      /// @private
+      Output_SetTimingLogFile SetTimingLogFile( const String & ClientLog, const String & StreamLog, const bool Binary );
+
       ///@private
       void SetOutputLatency(double OutputLatency);
 
       ///@private
       double OutputLatency() const;
 
+      /// Set the time in milliseconds for which the output thread busy-waits before each output frame.
+      /// Spinning for the last part of the interval gives a steadier output rate than sleeping alone, at the cost of CPU time.
+      /// The default is zero.
+      ///@private
+      void SetOutputSpinTime( double SpinTime );
+
+      ///@private
+      double OutputSpinTime() const;
+
+      /// Return statistics on the output frame timing achieved since StartOutput was called.
+      /// Jitter is the time in milliseconds by which each output frame was late relative to its scheduled time.
+      /// Frames which could not be produced because a whole period had already passed are counted in MissedTickCount.
+      ///@private
+      Output_GetOutputTimingStatistics GetOutputTimingStatistics() const;
+
     private:
       RetimingClientImpl * m_pClientImpl;
     };
@@ -43,6 +43,30 @@ namespace CPP
     std::shared_ptr< std::vector< unsigned char > > m_Data;
   };
 
+  /// Every greyscale blob of a camera, read in place from the frame's packed arrays rather than copied.
+  /// The lines of blob i are Lines[ BlobLines[ i ] ] up to Lines[ BlobLines[ i + 1 ] ], and the greyscale values of a
+  /// line are its PixelCount values of Pixels from PixelOffset. The arrays stay valid for as long as Blobs is held.
+  class Output_GetGreyscaleBlobs
+  {
+  public:
+    class Line
+    {
+    public:
+      unsigned int PixelOffset;
+      unsigned int PixelCount;
+      short Position[ 2 ];
+    };
+
+    Result::Enum Result;
+    unsigned int BlobCount;
+    const unsigned int * BlobLines;
+    unsigned int LineCount;
+    const Line * Lines;
+    unsigned int PixelCount;
+    const unsigned char * Pixels;
+    std::shared_ptr< const void > Blobs;
+  };
+
   class ClientImpl;
 
   ///  Vicon DataStream SDK client.
@@ -2256,6 +2280,51 @@ namespace CPP
     ///           + NoFrame
     Output_GetLatencyTotal        GetLatencyTotal() const;
 
+    /// Return the time at which the current frame was received by the client, in seconds.
+    /// The time is taken from a monotonic clock (std::chrono::steady_clock) with an arbitrary epoch, so it
+    /// is not affected by changes to the system clock. Compare it with the same clock to find the age of a frame.
+    ///
+    /// See Also: GetFrame(), GetLatencyTotal()
+    ///
+    ///
+    /// C example
+    ///      
+    ///      CClient * pClient = Client_Create();
+    ///      Client_Connect( pClient, "localhost" );
+    ///      Client_GetFrame( pClient );
+    ///      COutput_GetFrameReceiptTime _Output_GetFrameReceiptTime;
+    ///      Client_GetFrameReceiptTime( pClient, &_Output_GetFrameReceiptTime );
+    ///      Client_Destroy( pClient );
+    ///      
+    /// C++ example
+    ///      
+    ///      ViconDataStreamSDK::CPP::Client MyClient;
+    ///      MyClient.Connect( "localhost" );
+    ///      MyClient.GetFrame();
+    ///      Output_GetFrameReceiptTime Output = MyClient.GetFrameReceiptTime();
+    ///      const double Age = std::chrono::duration< double >( std::chrono::steady_clock::now().time_since_epoch() ).count() - Output.ReceiptTime;
+    ///      
+    /// MATLAB example
+    ///      
+    ///      MyClient = ViconDataStreamSDK.DotNET.Client();
+    ///      MyClient.Connect( 'localhost' );
+    ///      MyClient.GetFrame();
+    ///      Output = MyClient.GetFrameReceiptTime();
+    ///      
+    /// .NET example
+    ///      
+    ///      ViconDataStreamSDK.DotNET.Client MyClient = new ViconDataStreamSDK.DotNET.Client();
+    ///      MyClient.Connect( "localhost" );
+    ///      MyClient.GetFrame();
+    ///      Output_GetFrameReceiptTime Output = MyClient.GetFrameReceiptTime();
+    /// -----
+    /// \return An Output_GetFrameReceiptTime class containing the result of the operation and the receipt time in seconds.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    ///           + NoFrame
+    Output_GetFrameReceiptTime    GetFrameReceiptTime() const;
+
     /// Returns the hardware frame number as used by the cameras. This is not reset on synchronization.
     ///
     /// See Also: GetFrameNumber()
@@ -7132,6 +7201,68 @@ namespace CPP
     ///           + InvalidCameraName
     ///           + InvalidIndex
     Output_GetCentroidWeight GetCentroidWeight( const std::string & CameraName, const unsigned int CentroidIndex ) const;
+
+    /// Return every centroid of a camera, or of every camera if CameraName is empty, in one call.
+    /// Positions holds x then y for each centroid, and Radii, Weights and TrackIDs one value each. The centroids of camera
+    /// CameraIDs[ i ] start at CameraOffsets[ i ]. Weights are 0.0 where the server sent none, and TrackIDs have every bit
+    /// set where a centroid is not on a track.
+    ///
+    /// See Also: GetCentroidCount(), GetCentroidPosition(), GetCentroidWeight()
+    ///
+    /// \param CameraName The name of the camera, or empty for all cameras.
+    /// \return An Output_GetCentroids class containing the result of the operation and the centroid arrays.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    ///           + NoFrame
+    ///           + InvalidCameraName
+    ///           + InvalidIndex
+    Output_GetCentroids GetCentroids( const std::string & CameraName ) const;
+
+    /// Return every centroid of a camera with lens distortion removed, as x, y pairs in centroid index order.
+    /// This and the other calibrated functions use the camera calibrations, which are sent when centroid data is enabled.
+    ///
+    /// See Also: GetCentroidPosition(), GetCentroidRays(), ProjectPoints()
+    ///
+    /// \param CameraName The name of the camera.
+    /// \return An Output_GetUndistortedCentroids class containing the result of the operation and the undistorted positions.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    ///           + NoFrame
+    ///           + InvalidCameraName
+    ///           + InvalidIndex
+    Output_GetUndistortedCentroids GetUndistortedCentroids( const std::string & CameraName ) const;
+
+    /// Return the ray through every centroid of a camera, in the axes set by SetAxisMapping(). Every ray starts at the
+    /// camera centre, Origin, and Directions holds a unit x, y, z direction per centroid.
+    ///
+    /// See Also: GetUndistortedCentroids(), ProjectPoints()
+    ///
+    /// \param CameraName The name of the camera.
+    /// \return An Output_GetCentroidRays class containing the result of the operation, the ray origin and directions.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    ///           + NoFrame
+    ///           + InvalidCameraName
+    ///           + InvalidIndex
+    Output_GetCentroidRays GetCentroidRays( const std::string & CameraName ) const;
+
+    /// Project points into the image of every calibrated camera, with lens distortion. Points are x, y, z values in the
+    /// axes set by SetAxisMapping(), in millimetres. The image positions for camera CameraIDs[ i ] are x, y pairs, one per point,
+    /// starting at 2 i times the number of points. Points behind a camera give NaN.
+    ///
+    /// See Also: GetUndistortedCentroids(), GetCentroidRays()
+    ///
+    /// \param Points The points to project, three values per point.
+    /// \return An Output_ProjectPoints class containing the result of the operation, the camera IDs and the image positions.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    ///           + NoFrame
+    ///           + InvalidIndex
+    Output_ProjectPoints ProjectPoints( const std::vector< double > & Points ) const;
     
     
     /// Obtain the number of greyscale blobs that are available for the specified camera.
@@ -7272,6 +7403,37 @@ namespace CPP
     ///           + InvalidIndex
     Output_GetGreyscaleBlob GetGreyscaleBlob( const std::string & CameraName, const unsigned int i_BlobIndex ) const;
 
+    /// Return every greyscale blob of a camera in one call, without copying. BlobLines has BlobCount + 1 entries, and the
+    /// lines and pixels are those held by the frame, so they are read in place instead of being copied per line as
+    /// GetGreyscaleBlob() does.
+    ///
+    /// See Also: GetGreyscaleBlobCount(), GetGreyscaleBlob(), GetGreyscaleBlobSubsampleInfo()
+    ///
+    /// C++ example
+    ///
+    ///      ViconDataStreamSDK::CPP::Client MyClient;
+    ///      MyClient.Connect( "localhost" );
+    ///      MyClient.EnableGreyscaleData();
+    ///      MyClient.GetFrame();
+    ///      Output_GetGreyscaleBlobs Blobs = MyClient.GetGreyscaleBlobs( "Camera1" );
+    ///      for( unsigned int Blob = 0; Blob != Blobs.BlobCount; ++Blob )
+    ///      {
+    ///        for( unsigned int Line = Blobs.BlobLines[ Blob ]; Line != Blobs.BlobLines[ Blob + 1 ]; ++Line )
+    ///        {
+    ///          const unsigned char * pValues = Blobs.Pixels + Blobs.Lines[ Line ].PixelOffset;
+    ///        }
+    ///      }
+    ///
+    /// \param CameraName The name of the camera.
+    /// \return An Output_GetGreyscaleBlobs class containing the result of the operation and the blob arrays.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    ///           + NoFrame
+    ///           + InvalidCameraName
+    ///           + InvalidIndex
+    Output_GetGreyscaleBlobs GetGreyscaleBlobs( const std::string & CameraName ) const;
+
     /// Obtains video data for the specified camera.
     ///
     /// See Also: -
@@ -7459,8 +7621,113 @@ namespace CPP
     ///           + InvalidSubjectName
     Output_AddToSubjectFilter AddToSubjectFilter( const String & SubjectName);
 
+    /// Remove a subject from the subject filter, so that it is no longer sent. If the subject filter is empty, every
+    /// other subject in the latest frame is added to it first.
+    ///
+    /// See Also: AddToSubjectFilter(), ClearSubjectFilter()
+    ///
+    /// \param  SubjectName The name of the subject.
+    /// \return An Output_RemoveFromSubjectFilter class containing the result of the operation.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    ///           + NoFrame
+    ///           + InvalidSubjectName
+    Output_RemoveFromSubjectFilter RemoveFromSubjectFilter( const String & SubjectName );
+
+    /// Add a single camera to the camera filter for any of centroids, greyscale blobs and video. Unlike SetCameraFilter(),
+    /// the filters for other cameras are kept, and the change is sent to the server at once, so a viewer can subscribe to
+    /// just the cameras it is showing.
+    ///
+    /// See Also: SetCameraFilter(), RemoveFromCameraFilter()
+    ///
+    /// C++ example
+    ///
+    ///      ViconDataStreamSDK::CPP::Client MyClient;
+    ///      MyClient.Connect( "localhost" );
+    ///      MyClient.GetFrame();
+    ///      Output_GetCameraId CameraId = MyClient.GetCameraId( "Camera1" );
+    ///      MyClient.AddToCameraFilter( CameraId.CameraId, true, false, true );
+    ///
+    /// \param CameraId The id of the camera.
+    /// \param Centroids Whether to add the camera to the centroid filter.
+    /// \param Blobs Whether to add the camera to the greyscale blob filter.
+    /// \param Video Whether to add the camera to the video filter.
+    /// \return An Output_AddToCameraFilter class containing the result of the operation.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    Output_AddToCameraFilter AddToCameraFilter( const unsigned int CameraId, const bool Centroids, const bool Blobs, const bool Video );
+
+    /// Remove a single camera from the camera filter for any of centroids, greyscale blobs and video, and send the change
+    /// to the server at once. Where no filter has been set yet, every other camera in the latest frame is kept.
+    ///
+    /// See Also: SetCameraFilter(), AddToCameraFilter()
+    ///
+    /// \param CameraId The id of the camera.
+    /// \param Centroids Whether to remove the camera from the centroid filter.
+    /// \param Blobs Whether to remove the camera from the greyscale blob filter.
+    /// \param Video Whether to remove the camera from the video filter.
+    /// \return An Output_RemoveFromCameraFilter class containing the result of the operation.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    Output_RemoveFromCameraFilter RemoveFromCameraFilter( const unsigned int CameraId, const bool Centroids, const bool Blobs, const bool Video );
+
+    /// Clear the device filter. This will result in data for all devices being sent.
+    ///
+    /// See Also: AddToDeviceFilter(), RemoveFromDeviceFilter()
+    ///
+    /// \return An Output_ClearDeviceFilter class containing the result of the operation.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    Output_ClearDeviceFilter ClearDeviceFilter();
+
+    /// Add a device to the device filter. Only the voltage, force plate and eye tracker data of devices in the filter
+    /// will be sent. If the device filter is empty, data for all devices will be sent.
+    ///
+    /// See Also: ClearDeviceFilter(), RemoveFromDeviceFilter()
+    ///
+    /// \param DeviceName The name of the device.
+    /// \return An Output_AddToDeviceFilter class containing the result of the operation.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    ///           + NoFrame
+    ///           + InvalidDeviceName
+    Output_AddToDeviceFilter AddToDeviceFilter( const String & DeviceName );
+
+    /// Remove a device from the device filter. If the device filter is empty, every other device in the latest frame is
+    /// added to it first.
+    ///
+    /// See Also: ClearDeviceFilter(), AddToDeviceFilter()
+    ///
+    /// \param DeviceName The name of the device.
+    /// \return An Output_RemoveFromDeviceFilter class containing the result of the operation.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    ///           + NoFrame
+    ///           + InvalidDeviceName
+    Output_RemoveFromDeviceFilter RemoveFromDeviceFilter( const String & DeviceName );
+
+    /// Return the number of bytes received from the server since connecting, split into camera, subject and device data
+    /// and everything else. Comparing the counts before and after changing a filter shows the bandwidth it saves.
+    ///
+    /// \return An Output_GetBytesReceived class containing the result of the operation and the byte counts.
+    ///         - The Result will be:
+    ///           + Success
+    ///           + NotConnected
+    Output_GetBytesReceived GetBytesReceived() const;
+
     virtual Output_SetTimingLogFile SetTimingLogFile(const String & ClientLog, const String & StreamLog );
 
+    /// Output timing information to log files, optionally in a compact binary format.
+    /// Binary logs are cheaper to write at high frame rates; ViconDataStreamSDKTimingLogToCSV converts them to text.
+    /// @private
+    Output_SetTimingLogFile SetTimingLogFile( const String & ClientLog, const String & StreamLog, const bool Binary );
+
     /// Request that the wireless adapters will be optimally configured for streaming data.
     ///
     /// On Windows this will disable background scan and enable streaming.
@@ -184,6 +184,27 @@ namespace StreamMode
   };
 }
 
+namespace PredictionModel
+{
+  enum Enum
+  {
+    ConstantVelocity,
+    ConstantAcceleration,
+    Spline,
+    AlphaBeta
+  };
+}
+
+namespace OutputLogFormat
+{
+  enum Enum
+  {
+    Text,
+    Binary,
+    CompressedBinary
+  };
+}
+
 namespace TimecodeStandard
 {
   enum Enum
@@ -341,6 +362,12 @@ namespace Result
   class Output_SetCameraFilter            : public Output_SimpleResult {};
   class Output_ClearSubjectFilter         : public Output_SimpleResult {};
   class Output_AddToSubjectFilter         : public Output_SimpleResult {};
+  class Output_RemoveFromSubjectFilter    : public Output_SimpleResult {};
+  class Output_AddToCameraFilter          : public Output_SimpleResult {};
+  class Output_RemoveFromCameraFilter     : public Output_SimpleResult {};
+  class Output_ClearDeviceFilter          : public Output_SimpleResult {};
+  class Output_AddToDeviceFilter          : public Output_SimpleResult {};
+  class Output_RemoveFromDeviceFilter     : public Output_SimpleResult {};
   class Output_SetTimingLogFile           : public Output_SimpleResult {};
 
   class Output_EnabledFlag
@@ -438,6 +465,25 @@ namespace Result
     double       Total;
   };
 
+  class Output_GetFrameReceiptTime
+  {
+  public:
+    Result::Enum Result;
+    double       ReceiptTime;
+  };
+
+  class Output_GetOutputTimingStatistics
+  {
+  public:
+    Result::Enum Result;
+    unsigned int TickCount;
+    unsigned int MissedTickCount;
+    double       MeanJitter;
+    double       MinimumJitter;
+    double       MaximumJitter;
+    double       JitterStandardDeviation;
+  };
+
   class Output_GetFrameRateCount
   {
   public:
@@ -936,6 +982,51 @@ namespace Result
     double Weight;
   };
 
+  class Output_GetBytesReceived
+  {
+  public:
+    Result::Enum Result;
+    unsigned long long CameraBytes;
+    unsigned long long SubjectBytes;
+    unsigned long long DeviceBytes;
+    unsigned long long OtherBytes;
+  };
+
+  class Output_GetCentroids
+  {
+  public:
+    Result::Enum Result;
+    std::vector< unsigned int > CameraIDs;
+    std::vector< unsigned int > CameraOffsets;
+    std::vector< double > Positions;
+    std::vector< double > Radii;
+    std::vector< double > Weights;
+    std::vector< unsigned long long > TrackIDs;
+  };
+
+  class Output_GetUndistortedCentroids
+  {
+  public:
+    Result::Enum Result;
+    std::vector< double > Positions;
+  };
+
+  class Output_GetCentroidRays
+  {
+  public:
+    Result::Enum Result;
+    double Origin[ 3 ];
+    std::vector< double > Directions;
+  };
+
+  class Output_ProjectPoints
+  {
+  public:
+    Result::Enum Result;
+    std::vector< unsigned int > CameraIDs;
+    std::vector< double > Positions;
+  };
+
   class Output_GetGreyscaleBlobCount
   {
   public: